@@ -1,6 +1,7 @@
 #include <pcl/features/normal_3d.h>     // for NormalEstimation
 #include <pcl/features/normal_3d_omp.h> // for NormalEstimationOMP
 #include <pcl/io/pcd_io.h>              // for PCDReader
+#include <pcl/kdtree/kdtree_flann.h>    // for KdTreeFLANN
 
 #include <benchmark/benchmark.h>
 
@@ -21,6 +22,65 @@ BM_NormalEstimation(benchmark::State& state, const std::string& file)
   }
 }
 
+// Estimates the normals with a plain loop over the points, searching the neighbors with
+// the std::vector based interface of KdTreeFLANN
+static void
+BM_NormalEstimationKdTreeVectors(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  pcl::KdTreeFLANN<pcl::PointXYZ> tree;
+  tree.setInputCloud(cloud);
+  const unsigned int k = state.range(0);
+  pcl::PointCloud<pcl::Normal> cloud_normals;
+  cloud_normals.resize(cloud->size());
+  pcl::Indices nn_indices(k);
+  std::vector<float> nn_dists(k);
+  Eigen::Vector4f plane_parameters;
+  for (auto _ : state) {
+    // This code gets timed
+    for (std::size_t i = 0; i < cloud->size(); ++i) {
+      if (!pcl::isFinite((*cloud)[i]))
+        continue;
+      tree.nearestKSearch((*cloud)[i], k, nn_indices, nn_dists);
+      pcl::computePointNormal(
+          *cloud, nn_indices, plane_parameters, cloud_normals[i].curvature);
+      cloud_normals[i].getNormalVector3fMap() = plane_parameters.head<3>();
+    }
+  }
+}
+
+// Same as BM_NormalEstimationKdTreeVectors, but reusing KdTreeFLANN::SearchBuffers for
+// all the searches
+static void
+BM_NormalEstimationKdTreeBuffers(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  pcl::KdTreeFLANN<pcl::PointXYZ> tree;
+  tree.setInputCloud(cloud);
+  const unsigned int k = state.range(0);
+  pcl::PointCloud<pcl::Normal> cloud_normals;
+  cloud_normals.resize(cloud->size());
+  pcl::KdTreeFLANN<pcl::PointXYZ>::SearchBuffers buffers;
+  Eigen::Vector4f plane_parameters;
+  for (auto _ : state) {
+    // This code gets timed
+    for (std::size_t i = 0; i < cloud->size(); ++i) {
+      if (!pcl::isFinite((*cloud)[i]))
+        continue;
+      tree.nearestKSearch((*cloud)[i], k, buffers);
+      pcl::computePointNormal(
+          *cloud, buffers.indices, plane_parameters, cloud_normals[i].curvature);
+      cloud_normals[i].getNormalVector3fMap() = plane_parameters.head<3>();
+    }
+  }
+}
+
 #ifdef _OPENMP
 static void
 BM_NormalEstimationOMP(benchmark::State& state, const std::string& file)
@@ -59,6 +119,16 @@ main(int argc, char** argv)
       ->Arg(50)
       ->Arg(100)
       ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark(
+      "BM_NormalEstimationKdTreeVectors_mug", &BM_NormalEstimationKdTreeVectors, argv[1])
+      ->Arg(50)
+      ->Arg(100)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark(
+      "BM_NormalEstimationKdTreeBuffers_mug", &BM_NormalEstimationKdTreeBuffers, argv[1])
+      ->Arg(50)
+      ->Arg(100)
+      ->Unit(benchmark::kMillisecond);
 #ifdef _OPENMP
   benchmark::RegisterBenchmark(
       "BM_NormalEstimationOMP", &BM_NormalEstimationOMP, argv[1])
@@ -0,0 +1,152 @@
+#include <pcl/features/pfh.h>       // for PFHEstimation
+#include <pcl/features/pfh_omp.h>   // for PFHEstimationOMP
+#include <pcl/features/pfh_tools.h> // for computePairFeatures
+#include <pcl/io/pcd_io.h>          // for PCDReader
+#include <pcl/search/kdtree.h>      // for KdTree
+
+#include <benchmark/benchmark.h>
+
+// Computes the features of all the pairs of points of the cloud, one pair at a time
+static void
+BM_PairFeatures(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointNormal> cloud;
+  pcl::PCDReader reader;
+  reader.read(file, cloud);
+  float f1, f2, f3, f4;
+  for (auto _ : state) {
+    // This code gets timed
+    for (const auto& p : cloud) {
+      for (const auto& q : cloud) {
+        pcl::computePairFeatures(p.getVector4fMap(),
+                                 p.getNormalVector4fMap(),
+                                 q.getVector4fMap(),
+                                 q.getNormalVector4fMap(),
+                                 f1,
+                                 f2,
+                                 f3,
+                                 f4);
+        benchmark::DoNotOptimize(f1);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * cloud.size() * cloud.size());
+}
+
+// Same as BM_PairFeatures, but with the batched (SIMD) version, one batch per point, with
+// the SIMD level given by the first argument (0: none, 1: SSE2, 2: AVX, 3: AVX-512).
+// Levels not supported by the CPU run the best one.
+static void
+BM_PairFeaturesBatch(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointNormal> cloud;
+  pcl::PCDReader reader;
+  reader.read(file, cloud);
+  const std::size_t n = cloud.size();
+  std::vector<float> x(n), y(n), z(n), nx(n), ny(n), nz(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    x[i] = cloud[i].x;
+    y[i] = cloud[i].y;
+    z[i] = cloud[i].z;
+    nx[i] = cloud[i].normal_x;
+    ny[i] = cloud[i].normal_y;
+    nz[i] = cloud[i].normal_z;
+  }
+  std::vector<float> f1(n), f2(n), f3(n), f4(n);
+  std::vector<std::uint8_t> valid(n);
+  const auto previous = pcl::getPairFeaturesSimdLevel();
+  const auto level = pcl::setPairFeaturesSimdLevel(
+      static_cast<pcl::PairFeaturesSimdLevel>(state.range(0)));
+  for (auto _ : state) {
+    // This code gets timed
+    for (const auto& p : cloud) {
+      pcl::computePairFeatures(p.getVector4fMap(),
+                               p.getNormalVector4fMap(),
+                               x.data(),
+                               y.data(),
+                               z.data(),
+                               nx.data(),
+                               ny.data(),
+                               nz.data(),
+                               n,
+                               f1.data(),
+                               f2.data(),
+                               f3.data(),
+                               f4.data(),
+                               valid.data());
+      benchmark::DoNotOptimize(f1.data());
+    }
+  }
+  pcl::setPairFeaturesSimdLevel(previous);
+  state.SetItemsProcessed(state.iterations() * n * n);
+  state.counters["level"] = static_cast<int>(level);
+}
+
+static void
+BM_PFHEstimation(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointNormal>::Ptr cloud(new pcl::PointCloud<pcl::PointNormal>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  pcl::PFHEstimation<pcl::PointNormal, pcl::PointNormal> pfh;
+  pfh.setInputCloud(cloud);
+  pfh.setInputNormals(cloud);
+  pfh.setSearchMethod(pcl::search::KdTree<pcl::PointNormal>::Ptr(
+      new pcl::search::KdTree<pcl::PointNormal>));
+  pfh.setKSearch(state.range(0));
+  pcl::PointCloud<pcl::PFHSignature125> pfhs;
+  for (auto _ : state) {
+    // This code gets timed
+    pfh.compute(pfhs);
+  }
+}
+
+// Same as BM_PFHEstimation, with the number of threads given by the second argument
+static void
+BM_PFHEstimationOMP(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointNormal>::Ptr cloud(new pcl::PointCloud<pcl::PointNormal>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  pcl::PFHEstimationOMP<pcl::PointNormal, pcl::PointNormal> pfh(state.range(1));
+  pfh.setInputCloud(cloud);
+  pfh.setInputNormals(cloud);
+  pfh.setSearchMethod(pcl::search::KdTree<pcl::PointNormal>::Ptr(
+      new pcl::search::KdTree<pcl::PointNormal>));
+  pfh.setKSearch(state.range(0));
+  pcl::PointCloud<pcl::PFHSignature125> pfhs;
+  for (auto _ : state) {
+    // This code gets timed
+    pfh.compute(pfhs);
+  }
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "No test file given. Please download `bun0.pcd` and pass its path to "
+                 "the test."
+              << std::endl;
+    return (-1);
+  }
+  benchmark::RegisterBenchmark("BM_PairFeatures", &BM_PairFeatures, argv[1])
+      ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("BM_PairFeaturesBatch", &BM_PairFeaturesBatch, argv[1])
+      ->ArgName("level")
+      ->DenseRange(0, 3)
+      ->Unit(benchmark::kMicrosecond);
+  benchmark::RegisterBenchmark("BM_PFHEstimation", &BM_PFHEstimation, argv[1])
+      ->Arg(30)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("BM_PFHEstimationOMP", &BM_PFHEstimationOMP, argv[1])
+      ->Args({30, 1})
+      ->Args({30, 4})
+      ->Unit(benchmark::kMillisecond);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
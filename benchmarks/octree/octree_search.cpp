@@ -0,0 +1,118 @@
+#include <pcl/filters/filter.h>       // for removeNaNFromPointCloud
+#include <pcl/io/pcd_io.h>            // for PCDReader
+#include <pcl/octree/octree_search.h> // for OctreePointCloudSearch
+
+#include <benchmark/benchmark.h>
+
+using Octree = pcl::octree::OctreePointCloudSearch<pcl::PointXYZ>;
+
+// Builds a new octree for every frame, with contiguous children if the first argument
+// is 1
+static void
+BM_OctreeBuild(benchmark::State& state,
+               const pcl::PointCloud<pcl::PointXYZ>::Ptr& cloud)
+{
+  for (auto _ : state) {
+    // This code gets timed
+    Octree octree(0.005);
+    octree.setContiguousChildren(state.range(0) == 1);
+    octree.setInputCloud(cloud);
+    octree.addPointsFromInputCloud();
+    benchmark::DoNotOptimize(octree.getLeafCount());
+  }
+  state.SetItemsProcessed(state.iterations() * cloud->size());
+}
+
+// Builds a new octree with contiguous children for every frame, computing and sorting
+// the keys of the points with the number of threads given by the first argument
+static void
+BM_OctreeBuildThreads(benchmark::State& state,
+                      const pcl::PointCloud<pcl::PointXYZ>::Ptr& cloud)
+{
+  for (auto _ : state) {
+    // This code gets timed
+    Octree octree(0.005);
+    octree.setContiguousChildren(true);
+    octree.setNumberOfThreads(state.range(0));
+    octree.setInputCloud(cloud);
+    octree.addPointsFromInputCloud();
+    benchmark::DoNotOptimize(octree.getLeafCount());
+  }
+  state.SetItemsProcessed(state.iterations() * cloud->size());
+}
+
+// Refills the same octree for every frame, reusing the memory of its nodes
+static void
+BM_OctreeRebuild(benchmark::State& state,
+                 const pcl::PointCloud<pcl::PointXYZ>::Ptr& cloud)
+{
+  Octree octree(0.005);
+  octree.setContiguousChildren(state.range(0) == 1);
+  octree.setInputCloud(cloud);
+  for (auto _ : state) {
+    // This code gets timed
+    octree.deleteTree();
+    octree.addPointsFromInputCloud();
+    benchmark::DoNotOptimize(octree.getLeafCount());
+  }
+  state.SetItemsProcessed(state.iterations() * cloud->size());
+}
+
+// Searches the neighbours of every 10th point within 2 cm
+static void
+BM_OctreeRadiusSearch(benchmark::State& state,
+                      const pcl::PointCloud<pcl::PointXYZ>::Ptr& cloud)
+{
+  Octree octree(0.005);
+  octree.setContiguousChildren(state.range(0) == 1);
+  octree.setInputCloud(cloud);
+  octree.addPointsFromInputCloud();
+
+  pcl::Indices k_indices;
+  std::vector<float> k_sqr_distances;
+  std::size_t neighbours = 0;
+  for (auto _ : state) {
+    // This code gets timed
+    neighbours = 0;
+    for (std::size_t i = 0; i < cloud->size(); i += 10)
+      neighbours += octree.radiusSearch((*cloud)[i], 0.02, k_indices, k_sqr_distances);
+  }
+  state.counters["neighbours"] = neighbours;
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "No test file given. Please download "
+                 "`table_scene_mug_stereo_textured.pcd` and pass its path to the test."
+              << std::endl;
+    return (-1);
+  }
+
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PCDReader reader;
+  reader.read(argv[1], *cloud);
+  pcl::Indices finite;
+  pcl::removeNaNFromPointCloud(*cloud, *cloud, finite);
+
+  const auto contiguous = [](benchmark::internal::Benchmark* bm) {
+    bm->ArgName("contiguous")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+  };
+  benchmark::RegisterBenchmark("BM_OctreeBuild", &BM_OctreeBuild, cloud)
+      ->Apply(contiguous);
+  benchmark::RegisterBenchmark("BM_OctreeBuildThreads", &BM_OctreeBuildThreads, cloud)
+      ->ArgName("threads")
+      ->Arg(1)
+      ->Arg(2)
+      ->Arg(4)
+      ->UseRealTime()
+      ->Unit(benchmark::kMillisecond);
+  benchmark::RegisterBenchmark("BM_OctreeRebuild", &BM_OctreeRebuild, cloud)
+      ->Apply(contiguous);
+  benchmark::RegisterBenchmark("BM_OctreeRadiusSearch", &BM_OctreeRadiusSearch, cloud)
+      ->Apply(contiguous);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,56 @@
+#include <pcl/io/pcd_io.h>         // for PCDReader
+#include <pcl/registration/ndt.h> // for NormalDistributionsTransform
+
+#include <benchmark/benchmark.h>
+
+static void
+BM_NormalDistributionsTransform(benchmark::State& state,
+                                const std::string& source_file,
+                                const std::string& target_file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ>::Ptr source(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PointCloud<pcl::PointXYZ>::Ptr target(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PCDReader reader;
+  reader.read(source_file, *source);
+  reader.read(target_file, *target);
+
+  pcl::NormalDistributionsTransform<pcl::PointXYZ, pcl::PointXYZ> ndt;
+  ndt.setStepSize(0.05);
+  ndt.setResolution(0.025f);
+  ndt.setMaximumIterations(50);
+  ndt.setTransformationEpsilon(1e-8);
+  ndt.setNumberOfThreads(state.range(0));
+  ndt.setInputSource(source);
+  ndt.setInputTarget(target);
+  pcl::PointCloud<pcl::PointXYZ> output;
+  for (auto _ : state) {
+    // This code gets timed
+    ndt.align(output);
+  }
+  state.counters["iterations"] = ndt.getFinalNumIteration();
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 3) {
+    std::cerr << "No test files given. Please download `bun0.pcd` and `bun4.pcd`, and "
+                 "pass their paths to the test."
+              << std::endl;
+    return (-1);
+  }
+  // The argument is the number of threads, a single thread is the serial path
+  auto* bm = benchmark::RegisterBenchmark("BM_NormalDistributionsTransform",
+                                          &BM_NormalDistributionsTransform,
+                                          argv[1],
+                                          argv[2]);
+#ifdef _OPENMP
+  bm->RangeMultiplier(2)->Range(1, 16);
+#else
+  bm->Arg(1);
+#endif
+  bm->Unit(benchmark::kMillisecond)->UseRealTime();
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,97 @@
+#include <pcl/common/io.h>                           // for copyPointCloud
+#include <pcl/filters/filter.h>                      // for removeNaNFromPointCloud
+#include <pcl/io/pcd_io.h>                           // for PCDReader
+#include <pcl/sample_consensus/sac_model_cylinder.h> // for SampleConsensusModelCylinder
+#include <pcl/sample_consensus/sac_model_line.h>     // for SampleConsensusModelLine
+#include <pcl/sample_consensus/sac_model_plane.h>    // for SampleConsensusModelPlane
+#include <pcl/sample_consensus/sac_model_simd.h>     // for setSacSimdLevel
+#include <pcl/sample_consensus/sac_model_sphere.h>   // for SampleConsensusModelSphere
+
+#include <benchmark/benchmark.h>
+
+// Counts the inliers of a model with the SIMD level given by the first argument
+// (0: scalar, 1: SSE2, 2: AVX2). Levels not supported by the CPU run the best one.
+template <typename ModelT>
+static void
+BM_CountWithinDistance(benchmark::State& state,
+                       const typename ModelT::Ptr& model,
+                       const Eigen::VectorXf& coefficients)
+{
+  const auto previous = pcl::getSacSimdLevel();
+  const auto level = pcl::setSacSimdLevel(static_cast<pcl::SacSimdLevel>(state.range(0)));
+  std::size_t inliers = 0;
+  for (auto _ : state) {
+    // This code gets timed
+    inliers = model->countWithinDistance(coefficients, 0.01);
+    benchmark::DoNotOptimize(inliers);
+  }
+  pcl::setSacSimdLevel(previous);
+  state.SetItemsProcessed(state.iterations() * model->getIndices()->size());
+  state.counters["inliers"] = inliers;
+  state.counters["level"] = static_cast<int>(level);
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "No test file given. Please download "
+                 "`table_scene_mug_stereo_textured.pcd` and pass its path to the test."
+              << std::endl;
+    return (-1);
+  }
+
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ> xyz;
+  pcl::PCDReader reader;
+  reader.read(argv[1], xyz);
+  pcl::Indices finite;
+  pcl::removeNaNFromPointCloud(xyz, xyz, finite);
+  pcl::PointCloud<pcl::PointNormal>::Ptr cloud(new pcl::PointCloud<pcl::PointNormal>);
+  pcl::copyPointCloud(xyz, *cloud);
+  // Only the cylinder uses the normals, they just need to be valid
+  for (auto& point : *cloud) {
+    point.normal_x = point.normal_y = 0.0f;
+    point.normal_z = 1.0f;
+  }
+
+  Eigen::VectorXf plane(4), sphere(4), line(6), cylinder(7);
+  plane << 0.0f, 0.0f, 1.0f, -1.0f;
+  sphere << 0.0f, 0.0f, 1.0f, 0.1f;
+  line << 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f;
+  cylinder << 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.1f;
+
+  using Plane = pcl::SampleConsensusModelPlane<pcl::PointNormal>;
+  using Sphere = pcl::SampleConsensusModelSphere<pcl::PointNormal>;
+  using Line = pcl::SampleConsensusModelLine<pcl::PointNormal>;
+  using Cylinder = pcl::SampleConsensusModelCylinder<pcl::PointNormal, pcl::PointNormal>;
+  Cylinder::Ptr cylinder_model(new Cylinder(cloud));
+  cylinder_model->setInputNormals(cloud);
+  cylinder_model->setNormalDistanceWeight(0.1);
+
+  const auto levels = [](benchmark::internal::Benchmark* bm) {
+    bm->ArgName("level")->Arg(0)->Arg(1)->Arg(2);
+  };
+  benchmark::RegisterBenchmark("BM_CountWithinDistance<Plane>",
+                               &BM_CountWithinDistance<Plane>,
+                               Plane::Ptr(new Plane(cloud)),
+                               plane)
+      ->Apply(levels);
+  benchmark::RegisterBenchmark("BM_CountWithinDistance<Sphere>",
+                               &BM_CountWithinDistance<Sphere>,
+                               Sphere::Ptr(new Sphere(cloud)),
+                               sphere)
+      ->Apply(levels);
+  benchmark::RegisterBenchmark("BM_CountWithinDistance<Line>",
+                               &BM_CountWithinDistance<Line>,
+                               Line::Ptr(new Line(cloud)),
+                               line)
+      ->Apply(levels);
+  benchmark::RegisterBenchmark("BM_CountWithinDistance<Cylinder>",
+                               &BM_CountWithinDistance<Cylinder>,
+                               cylinder_model,
+                               cylinder)
+      ->Apply(levels);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,55 @@
+#include <pcl/filters/filter.h>                 // for removeNaNFromPointCloud
+#include <pcl/io/pcd_io.h>                      // for PCDReader
+#include <pcl/search/kdtree.h>                  // for KdTree
+#include <pcl/segmentation/extract_clusters.h>  // for EuclideanClusterExtraction
+
+#include <benchmark/benchmark.h>
+
+// Extracts the Euclidean clusters of the finite points of the cloud, with the number of
+// threads given by the first argument (1 is the serial breadth-first search)
+static void
+BM_EuclideanClusterExtraction(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  pcl::Indices finite;
+  pcl::removeNaNFromPointCloud(*cloud, *cloud, finite);
+  pcl::EuclideanClusterExtraction<pcl::PointXYZ> ec;
+  ec.setInputCloud(cloud);
+  ec.setSearchMethod(pcl::search::KdTree<pcl::PointXYZ>::Ptr(
+      new pcl::search::KdTree<pcl::PointXYZ>(false)));
+  ec.setClusterTolerance(0.01);
+  ec.setMinClusterSize(100);
+  ec.setNumberOfThreads(state.range(0));
+  std::vector<pcl::PointIndices> clusters;
+  for (auto _ : state) {
+    // This code gets timed
+    clusters.clear();
+    ec.extract(clusters);
+  }
+  state.SetItemsProcessed(state.iterations() * cloud->size());
+  state.counters["clusters"] = clusters.size();
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "No test file given. Please download "
+                 "`table_scene_mug_stereo_textured.pcd` and pass its path to the test."
+              << std::endl;
+    return (-1);
+  }
+  benchmark::RegisterBenchmark(
+      "BM_EuclideanClusterExtraction", &BM_EuclideanClusterExtraction, argv[1])
+      ->ArgName("threads")
+      ->Arg(1)
+      ->Arg(2)
+      ->Arg(4)
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
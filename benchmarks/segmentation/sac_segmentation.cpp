@@ -0,0 +1,52 @@
+#include <pcl/filters/filter.h>                      // for removeNaNFromPointCloud
+#include <pcl/io/pcd_io.h>                           // for PCDReader
+#include <pcl/sample_consensus/method_types.h>       // for SAC_RANSAC, SAC_SPRT
+#include <pcl/sample_consensus/model_types.h>        // for SACMODEL_PLANE
+#include <pcl/segmentation/sac_segmentation.h>       // for SACSegmentation
+
+#include <benchmark/benchmark.h>
+
+// Segments the dominant plane of the finite points of the cloud, with the sample
+// consensus method given by the first argument (SAC_RANSAC or SAC_SPRT)
+static void
+BM_SACSegmentation(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  pcl::Indices finite;
+  pcl::removeNaNFromPointCloud(*cloud, *cloud, finite);
+  pcl::SACSegmentation<pcl::PointXYZ> seg;
+  seg.setInputCloud(cloud);
+  seg.setModelType(pcl::SACMODEL_PLANE);
+  seg.setMethodType(state.range(0));
+  seg.setDistanceThreshold(0.01);
+  seg.setMaxIterations(1000);
+  pcl::PointIndices inliers;
+  pcl::ModelCoefficients coefficients;
+  for (auto _ : state) {
+    // This code gets timed
+    seg.segment(inliers, coefficients);
+  }
+  state.SetItemsProcessed(state.iterations() * cloud->size());
+  state.counters["inliers"] = inliers.indices.size();
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "No test file given. Please download "
+                 "`table_scene_mug_stereo_textured.pcd` and pass its path to the test."
+              << std::endl;
+    return (-1);
+  }
+  benchmark::RegisterBenchmark("BM_SACSegmentation", &BM_SACSegmentation, argv[1])
+      ->ArgName("method")
+      ->Arg(pcl::SAC_RANSAC)
+      ->Arg(pcl::SAC_SPRT)
+      ->Unit(benchmark::kMillisecond);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
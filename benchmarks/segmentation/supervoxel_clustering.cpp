@@ -0,0 +1,46 @@
+#include <pcl/io/pcd_io.h>                           // for PCDReader
+#include <pcl/segmentation/supervoxel_clustering.h>  // for SupervoxelClustering
+
+#include <benchmark/benchmark.h>
+
+// Computes the supervoxels of a frame with the number of threads given by the first
+// argument. The clustering object is created for every frame, as it would be in an
+// online pipeline, so that the timing includes the voxelization
+static void
+BM_SupervoxelClustering(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZRGBA>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZRGBA>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  std::map<std::uint32_t, pcl::Supervoxel<pcl::PointXYZRGBA>::Ptr> supervoxels;
+  for (auto _ : state) {
+    // This code gets timed
+    pcl::SupervoxelClustering<pcl::PointXYZRGBA> super(0.008f, 0.1f);
+    super.setInputCloud(cloud);
+    super.setNumberOfThreads(state.range(0));
+    super.extract(supervoxels);
+  }
+  state.counters["supervoxels"] = supervoxels.size();
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "No test file given. Please download "
+                 "`table_scene_mug_stereo_textured.pcd` and pass its path to the test."
+              << std::endl;
+    return (-1);
+  }
+  benchmark::RegisterBenchmark(
+      "BM_SupervoxelClustering", &BM_SupervoxelClustering, argv[1])
+      ->ArgName("threads")
+      ->Arg(1)
+      ->Arg(2)
+      ->Arg(4)
+      ->Unit(benchmark::kMillisecond)
+      ->UseRealTime();
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
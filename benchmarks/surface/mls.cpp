@@ -0,0 +1,63 @@
+#include <pcl/io/pcd_io.h>      // for PCDReader
+#include <pcl/search/kdtree.h>  // for KdTree
+#include <pcl/surface/mls.h>    // for MovingLeastSquares
+
+#include <benchmark/benchmark.h>
+
+using MLS = pcl::MovingLeastSquares<pcl::PointXYZ, pcl::PointNormal>;
+
+// Runs MovingLeastSquares with the upsampling method given by the first argument and the
+// number of threads given by the second argument
+static void
+BM_MovingLeastSquares(benchmark::State& state, const std::string& file)
+{
+  // Perform setup here
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZ>);
+  pcl::PCDReader reader;
+  reader.read(file, *cloud);
+  MLS mls;
+  mls.setInputCloud(cloud);
+  mls.setComputeNormals(true);
+  mls.setPolynomialOrder(2);
+  mls.setSearchMethod(pcl::search::KdTree<pcl::PointXYZ>::Ptr(
+      new pcl::search::KdTree<pcl::PointXYZ>(false)));
+  mls.setSearchRadius(0.03);
+  mls.setUpsamplingMethod(static_cast<MLS::UpsamplingMethod>(state.range(0)));
+  mls.setUpsamplingRadius(0.025);
+  mls.setUpsamplingStepSize(0.01);
+  mls.setPointDensity(100);
+  mls.setDilationIterations(5);
+  mls.setDilationVoxelSize(0.005f);
+  mls.setDistinctCloud(cloud);
+  mls.setNumberOfThreads(state.range(1));
+  pcl::PointCloud<pcl::PointNormal> output;
+  for (auto _ : state) {
+    // This code gets timed
+    mls.process(output);
+  }
+  state.counters["points"] = output.size();
+}
+
+int
+main(int argc, char** argv)
+{
+  if (argc < 2) {
+    std::cerr << "No test file given. Please download `bun0.pcd` and pass its path to "
+                 "the test."
+              << std::endl;
+    return (-1);
+  }
+  const MLS::UpsamplingMethod methods[] = {MLS::NONE,
+                                           MLS::DISTINCT_CLOUD,
+                                           MLS::SAMPLE_LOCAL_PLANE,
+                                           MLS::RANDOM_UNIFORM_DENSITY,
+                                           MLS::VOXEL_GRID_DILATION};
+  auto* bm = benchmark::RegisterBenchmark(
+      "BM_MovingLeastSquares", &BM_MovingLeastSquares, argv[1]);
+  for (const auto method : methods)
+    for (const int threads : {1, 2, 4})
+      bm->Args({method, threads});
+  bm->ArgNames({"method", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+}
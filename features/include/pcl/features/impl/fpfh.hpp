@@ -45,7 +45,9 @@
 #include <pcl/common/point_tests.h> // for pcl::isFinite
 #include <pcl/features/pfh_tools.h>
 
+#include <cstdint> // for std::uint8_t
 #include <set> // for std::set
+#include <vector>
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT> bool
@@ -66,7 +68,6 @@ pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computePointSPFHSignature (
     pcl::index_t p_idx, int row, const pcl::Indices &indices,
     Eigen::MatrixXf &hist_f1, Eigen::MatrixXf &hist_f2, Eigen::MatrixXf &hist_f3)
 {
-  Eigen::Vector4f pfh_tuple;
   // Get the number of bins from the histograms size
   // @TODO: use arrays
   int nr_bins_f1 = static_cast<int> (hist_f1.cols ());
@@ -76,29 +77,46 @@ pcl::FPFHEstimation<PointInT, PointNT, PointOutT>::computePointSPFHSignature (
   // Factorization constant
   float hist_incr = 100.0f / static_cast<float>(indices.size () - 1);
 
-  // Iterate over all the points in the neighborhood
+  // Gather the neighbors (avoiding unnecessary returns) as a structure of arrays, in order to
+  // compute all the pairs P to NNi at once
+  std::vector<float> soa (10 * indices.size ());
+  float *x = soa.data (), *y = x + indices.size (), *z = y + indices.size ();
+  float *nx = z + indices.size (), *ny = nx + indices.size (), *nz = ny + indices.size ();
+  float *f1 = nz + indices.size (), *f2 = f1 + indices.size (), *f3 = f2 + indices.size (), *f4 = f3 + indices.size ();
+  std::size_t nr_pairs = 0;
   for (const auto &index : indices)
   {
-    // Avoid unnecessary returns
     if (p_idx == index)
-        continue;
+      continue;
+    x[nr_pairs] = cloud[index].x;
+    y[nr_pairs] = cloud[index].y;
+    z[nr_pairs] = cloud[index].z;
+    nx[nr_pairs] = normals[index].normal_x;
+    ny[nr_pairs] = normals[index].normal_y;
+    nz[nr_pairs] = normals[index].normal_z;
+    ++nr_pairs;
+  }
 
-    // Compute the pair P to NNi
-    if (!computePairFeatures (cloud, normals, p_idx, index, pfh_tuple[0], pfh_tuple[1], pfh_tuple[2], pfh_tuple[3]))
-        continue;
+  // As with computePairFeatures, the pairs whose features cannot be computed are binned with
+  // all their features set to 0
+  std::vector<std::uint8_t> valid (nr_pairs);
+  pcl::computePairFeatures (cloud[p_idx].getVector4fMap (), normals[p_idx].getNormalVector4fMap (),
+                            x, y, z, nx, ny, nz, nr_pairs, f1, f2, f3, f4, valid.data ());
 
+  for (std::size_t i = 0; i < nr_pairs; ++i)
+  {
     // Normalize the f1, f2, f3 features and push them in the histogram
-    int h_index = static_cast<int> (std::floor (nr_bins_f1 * ((pfh_tuple[0] + M_PI) * d_pi_)));
+    int h_index = static_cast<int> (std::floor (nr_bins_f1 * ((f1[i] + M_PI) * d_pi_)));
     if (h_index < 0)           h_index = 0;
     if (h_index >= nr_bins_f1) h_index = nr_bins_f1 - 1;
     hist_f1 (row, h_index) += hist_incr;
 
-    h_index = static_cast<int> (std::floor (nr_bins_f2 * ((pfh_tuple[1] + 1.0) * 0.5)));
+    h_index = static_cast<int> (std::floor (nr_bins_f2 * ((f2[i] + 1.0) * 0.5)));
     if (h_index < 0)           h_index = 0;
     if (h_index >= nr_bins_f2) h_index = nr_bins_f2 - 1;
     hist_f2 (row, h_index) += hist_incr;
 
-    h_index = static_cast<int> (std::floor (nr_bins_f3 * ((pfh_tuple[2] + 1.0) * 0.5)));
+    h_index = static_cast<int> (std::floor (nr_bins_f3 * ((f3[i] + 1.0) * 0.5)));
     if (h_index < 0)           h_index = 0;
     if (h_index >= nr_bins_f3) h_index = nr_bins_f3 - 1;
     hist_f3 (row, h_index) += hist_incr;
@@ -0,0 +1,292 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/features/pfh_omp.h>
+#include <pcl/features/pfh_tools.h> // for computePairFeatures
+
+#include <pcl/common/point_tests.h> // for pcl::isFinite
+
+#include <algorithm> // for max
+#include <cstdint> // for uint8_t
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::PairFeatureCache::reset (std::size_t max_size)
+{
+  // Largest power of two not exceeding max_size, so that the table stays within the memory limit
+  max_capacity_ = 1;
+  while (max_capacity_ * 2 <= max_size)
+    max_capacity_ *= 2;
+
+  keys_.clear ();
+  values_.clear ();
+  mask_ = 0;
+  size_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::PairFeatureCache::grow ()
+{
+  std::vector<std::uint64_t> old_keys;
+  std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > old_values;
+  old_keys.swap (keys_);
+  old_values.swap (values_);
+
+  const std::size_t capacity = old_keys.empty () ? std::min<std::size_t> (4096, max_capacity_)
+                                                 : std::min (old_keys.size () * 2, max_capacity_);
+  keys_.assign (capacity, std::uint64_t (empty_key_));
+  values_.resize (capacity);
+  mask_ = capacity - 1;
+  size_ = 0;
+
+  for (std::size_t i = 0; i < old_keys.size (); ++i)
+    if (old_keys[i] != empty_key_)
+      insert (static_cast<int> (old_keys[i] >> 32), static_cast<int> (old_keys[i] & 0xFFFFFFFFu), old_values[i]);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::PairFeatureCache::insert (
+      int p_idx, int q_idx, const Eigen::Vector4f &features)
+{
+  // Keep the load factor under 1/2 until the maximum capacity is reached
+  if (keys_.empty () || (size_ * 2 >= keys_.size () && keys_.size () < max_capacity_))
+    grow ();
+
+  const std::uint64_t key = makeKey (p_idx, q_idx);
+  const std::size_t home = hash (key);
+  std::size_t slot = home;
+  for (unsigned int probe = 0; probe < max_probes_; ++probe, slot = (slot + 1) & mask_)
+  {
+    if (keys_[slot] == empty_key_)
+    {
+      ++size_;
+      keys_[slot] = key;
+      values_[slot] = features;
+      return;
+    }
+    if (keys_[slot] == key)
+    {
+      values_[slot] = features;
+      return;
+    }
+  }
+
+  // The probe sequence is full: evict the pair in the home slot
+  keys_[home] = key;
+  values_[home] = features;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::computePointPFHSignature (
+      const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+      const pcl::Indices &indices, int nr_split, PairFeatureCache *cache,
+      Eigen::VectorXf &pfh_histogram) const
+{
+  // Clear the resultant point histogram
+  pfh_histogram.setZero ();
+
+  // Factorization constant
+  const float hist_incr = 100.0f / static_cast<float> (indices.size () * (indices.size () - 1) / 2);
+
+  // Normalize the f1, f2, f3 features and push them in the histogram
+  const auto bin = [&] (float f1, float f2, float f3)
+  {
+    int f_index[3];
+    f_index[0] = static_cast<int> (std::floor (nr_split * ((f1 + M_PI) * d_pi_)));
+    if (f_index[0] < 0)         f_index[0] = 0;
+    if (f_index[0] >= nr_split) f_index[0] = nr_split - 1;
+
+    f_index[1] = static_cast<int> (std::floor (nr_split * ((f2 + 1.0) * 0.5)));
+    if (f_index[1] < 0)         f_index[1] = 0;
+    if (f_index[1] >= nr_split) f_index[1] = nr_split - 1;
+
+    f_index[2] = static_cast<int> (std::floor (nr_split * ((f3 + 1.0) * 0.5)));
+    if (f_index[2] < 0)         f_index[2] = 0;
+    if (f_index[2] >= nr_split) f_index[2] = nr_split - 1;
+
+    // Copy into the histogram
+    pfh_histogram[f_index[0] + nr_split * (f_index[1] + nr_split * f_index[2])] += hist_incr;
+  };
+
+  // Gather the neighborhood once as a structure of arrays: the pairs (NNi, NNj) for j < i are then
+  // computed at once by the batched computePairFeatures. With a cache, only the pairs missing from
+  // it are gathered in the batch arrays.
+  const std::size_t nr_neighbors = indices.size ();
+  std::vector<float> soa (16 * nr_neighbors);
+  float *x = soa.data (), *y = x + nr_neighbors, *z = y + nr_neighbors;
+  float *nx = z + nr_neighbors, *ny = nx + nr_neighbors, *nz = ny + nr_neighbors;
+  float *batch_x = nz + nr_neighbors, *batch_y = batch_x + nr_neighbors, *batch_z = batch_y + nr_neighbors;
+  float *batch_nx = batch_z + nr_neighbors, *batch_ny = batch_nx + nr_neighbors, *batch_nz = batch_ny + nr_neighbors;
+  float *f1 = batch_nz + nr_neighbors, *f2 = f1 + nr_neighbors, *f3 = f2 + nr_neighbors, *f4 = f3 + nr_neighbors;
+  std::vector<std::uint8_t> finite (nr_neighbors), valid (nr_neighbors);
+  std::vector<std::size_t> batch (cache ? nr_neighbors : 0);
+  for (std::size_t i = 0; i < nr_neighbors; ++i)
+  {
+    finite[i] = isFinite (cloud[indices[i]]);
+    x[i] = cloud[indices[i]].x;
+    y[i] = cloud[indices[i]].y;
+    z[i] = cloud[indices[i]].z;
+    nx[i] = normals[indices[i]].normal_x;
+    ny[i] = normals[indices[i]].normal_y;
+    nz[i] = normals[indices[i]].normal_z;
+  }
+
+  // Iterate over all the points in the neighborhood
+  for (std::size_t i_idx = 0; i_idx < nr_neighbors; ++i_idx)
+  {
+    // If the 3D points are invalid, don't bother estimating, just continue
+    if (!finite[i_idx])
+      continue;
+
+    const Eigen::Vector4f p_i (x[i_idx], y[i_idx], z[i_idx], 0.0f), n_i (nx[i_idx], ny[i_idx], nz[i_idx], 0.0f);
+    if (!cache)
+    {
+      // Compute the pairs NNi to NNj, j < i
+      pcl::computePairFeatures (p_i, n_i, x, y, z, nx, ny, nz, i_idx, f1, f2, f3, f4, valid.data ());
+      for (std::size_t j_idx = 0; j_idx < i_idx; ++j_idx)
+        if (finite[j_idx] && valid[j_idx])
+          bin (f1[j_idx], f2[j_idx], f3[j_idx]);
+      continue;
+    }
+
+    // Check to see if we already estimated the pairs in the cache
+    std::size_t nr_batch = 0;
+    for (std::size_t j_idx = 0; j_idx < i_idx; ++j_idx)
+    {
+      if (!finite[j_idx])
+        continue;
+      const Eigen::Vector4f *cached = cache->find (indices[i_idx], indices[j_idx]);
+      if (cached)
+      {
+        bin ((*cached)[0], (*cached)[1], (*cached)[2]);
+        continue;
+      }
+      batch[nr_batch] = j_idx;
+      batch_x[nr_batch] = x[j_idx];
+      batch_y[nr_batch] = y[j_idx];
+      batch_z[nr_batch] = z[j_idx];
+      batch_nx[nr_batch] = nx[j_idx];
+      batch_ny[nr_batch] = ny[j_idx];
+      batch_nz[nr_batch] = nz[j_idx];
+      ++nr_batch;
+    }
+
+    // Compute the missing pairs, and save them in the cache
+    pcl::computePairFeatures (p_i, n_i, batch_x, batch_y, batch_z, batch_nx, batch_ny, batch_nz, nr_batch,
+                              f1, f2, f3, f4, valid.data ());
+    for (std::size_t b = 0; b < nr_batch; ++b)
+    {
+      if (!valid[b])
+        continue;
+      cache->insert (indices[i_idx], indices[batch[b]], Eigen::Vector4f (f1[b], f2[b], f3[b], f4[b]));
+      bin (f1[b], f2[b], f3[b]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::PFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  const int nr_bins = nr_subdiv_ * nr_subdiv_ * nr_subdiv_;
+  // The maximum cache size is shared among the threads
+  const std::size_t cache_size = std::max<std::size_t> (max_cache_size_ / threads_, 1);
+  const bool check_finite = !input_->is_dense;
+  bool is_dense = output.is_dense;
+
+#pragma omp parallel \
+  num_threads(threads_)
+  {
+    // Thread local state: consecutive query points share most of their pairs, hence the chunked schedule
+    PairFeatureCache cache;
+    if (use_cache_)
+      cache.reset (cache_size);
+    Eigen::VectorXf pfh_histogram (nr_bins);
+    pcl::Indices nn_indices (k_); // \note These resizes are irrelevant for a radiusSearch ().
+    std::vector<float> nn_dists (k_);
+
+#pragma omp for \
+  reduction(&&:is_dense) \
+  schedule(dynamic, 64)
+    for (std::ptrdiff_t idx = 0; idx < static_cast<std::ptrdiff_t> (indices_->size ()); ++idx)
+    {
+      if ((check_finite && !isFinite ((*input_)[(*indices_)[idx]])) ||
+          this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
+      {
+        for (int d = 0; d < nr_bins; ++d)
+          output[idx].histogram[d] = std::numeric_limits<float>::quiet_NaN ();
+
+        is_dense = false;
+        continue;
+      }
+
+      // Estimate the PFH signature at each patch
+      computePointPFHSignature (*surface_, *normals_, nn_indices, nr_subdiv_, use_cache_ ? &cache : nullptr, pfh_histogram);
+
+      // Copy into the resultant cloud
+      for (int d = 0; d < nr_bins; ++d)
+        output[idx].histogram[d] = pfh_histogram[d];
+    }
+  }
+  output.is_dense = is_dense;
+}
+
+#define PCL_INSTANTIATE_PFHEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::PFHEstimationOMP<T,NT,OutT>;
@@ -44,6 +44,9 @@
 #include <pcl/features/pfh.h>
 #include <pcl/features/pfh_tools.h> // for computePairFeatures
 
+#include <cstdint> // for std::uint8_t
+#include <vector>
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT>
 pcl::PPFEstimation<PointInT, PointNT, PointOutT>::PPFEstimation ()
@@ -66,22 +69,42 @@ pcl::PPFEstimation<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut
   output.width = output.size ();
   output.is_dense = true;
 
+  // Gather the points and normals as a structure of arrays, in order to compute the features of all
+  // the pairs (i, j) of a point i at once
+  const std::size_t nr_points = input_->size ();
+  std::vector<float> soa (10 * nr_points);
+  float *x = soa.data (), *y = x + nr_points, *z = y + nr_points;
+  float *nx = z + nr_points, *ny = nx + nr_points, *nz = ny + nr_points;
+  float *f1 = nz + nr_points, *f2 = f1 + nr_points, *f3 = f2 + nr_points, *f4 = f3 + nr_points;
+  std::vector<std::uint8_t> valid (nr_points);
+  for (std::size_t j = 0; j < nr_points; ++j)
+  {
+    x[j] = (*input_)[j].x;
+    y[j] = (*input_)[j].y;
+    z[j] = (*input_)[j].z;
+    nx[j] = (*normals_)[j].normal_x;
+    ny[j] = (*normals_)[j].normal_y;
+    nz[j] = (*normals_)[j].normal_z;
+  }
+
   // Compute point pair features for every pair of points in the cloud
   for (std::size_t index_i = 0; index_i < indices_->size (); ++index_i)
   {
     std::size_t i = (*indices_)[index_i];
-    for (std::size_t j = 0 ; j < input_->size (); ++j)
+    pcl::computePairFeatures ((*input_)[i].getVector4fMap (), (*normals_)[i].getNormalVector4fMap (),
+                              x, y, z, nx, ny, nz, nr_points, f1, f2, f3, f4, valid.data ());
+    for (std::size_t j = 0 ; j < nr_points; ++j)
     {
       PointOutT p;
       if (i != j)
       {
-        if (//pcl::computePPFPairFeature
-            pcl::computePairFeatures ((*input_)[i].getVector4fMap (),
-                                      (*normals_)[i].getNormalVector4fMap (),
-                                      (*input_)[j].getVector4fMap (),
-                                      (*normals_)[j].getNormalVector4fMap (),
-                                      p.f1, p.f2, p.f3, p.f4))
+        if (valid[j])
         {
+          p.f1 = f1[j];
+          p.f2 = f2[j];
+          p.f3 = f3[j];
+          p.f4 = f4[j];
+
           // Calculate alpha_m angle
           Eigen::Vector3f model_reference_point = (*input_)[i].getVector3fMap (),
                           model_reference_normal = (*normals_)[i].getNormalVector3fMap (),
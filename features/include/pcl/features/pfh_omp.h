@@ -0,0 +1,208 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/features/pfh.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief PFHEstimationOMP estimates the Point Feature Histogram (PFH) descriptor for a given point cloud
+    * dataset containing points and normals, in parallel, using the OpenMP standard.
+    *
+    * Each thread keeps its own pair feature cache (see \ref PFHEstimation::setUseInternalCache): a bounded
+    * open-addressing hash table that replaces the global std::map and std::queue of \ref PFHEstimation. The
+    * \ref PFHEstimation::setMaximumCacheSize limit is shared among the threads. The pair features of each
+    * neighborhood are computed in batches by the SIMD version of \ref computePairFeatures. The resultant
+    * features are identical with and without the cache, and for any number of threads.
+    *
+    * \note If you use this code in any academic work, please cite:
+    *
+    *   - R.B. Rusu, N. Blodow, Z.C. Marton, M. Beetz.
+    *     Aligning Point Cloud Views using Persistent Feature Histograms.
+    *     In Proceedings of the 21st IEEE/RSJ International Conference on Intelligent Robots and Systems (IROS),
+    *     Nice, France, September 22-26 2008.
+    *
+    * \attention
+    * The convention for PFH features is:
+    *   - if a query point's nearest neighbors cannot be estimated, the PFH feature will be set to NaN
+    *     (not a number)
+    *   - it is impossible to estimate a PFH descriptor for a point that
+    *     doesn't have finite 3D coordinates. Therefore, any point that contains
+    *     NaN data on x, y, or z, will have its PFH feature property set to NaN.
+    *
+    * \ingroup features
+    */
+  template <typename PointInT, typename PointNT, typename PointOutT = pcl::PFHSignature125>
+  class PFHEstimationOMP : public PFHEstimation<PointInT, PointNT, PointOutT>
+  {
+    public:
+      using Ptr = shared_ptr<PFHEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using ConstPtr = shared_ptr<const PFHEstimationOMP<PointInT, PointNT, PointOutT> >;
+      using Feature<PointInT, PointOutT>::feature_name_;
+      using Feature<PointInT, PointOutT>::getClassName;
+      using Feature<PointInT, PointOutT>::indices_;
+      using Feature<PointInT, PointOutT>::k_;
+      using Feature<PointInT, PointOutT>::search_parameter_;
+      using Feature<PointInT, PointOutT>::surface_;
+      using Feature<PointInT, PointOutT>::input_;
+      using FeatureFromNormals<PointInT, PointNT, PointOutT>::normals_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::nr_subdiv_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::d_pi_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::max_cache_size_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::use_cache_;
+      using PFHEstimation<PointInT, PointNT, PointOutT>::computePointPFHSignature;
+
+      using PointCloudOut = typename Feature<PointInT, PointOutT>::PointCloudOut;
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      PFHEstimationOMP (unsigned int nr_threads = 0)
+      {
+        feature_name_ = "PFHEstimationOMP";
+
+        setNumberOfThreads (nr_threads);
+      }
+
+      /** \brief Initialize the scheduler and set the number of threads to use.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+    protected:
+      /** \brief Bounded cache of pair features, keyed on the (ordered) pair of point indices.
+        *
+        * Open addressing with linear probing over at most \a max_probes_ slots. The table grows
+        * up to its maximum capacity, after which a new pair overwrites the first slot of its
+        * probe sequence. Not thread safe: each thread owns its own cache.
+        */
+      class PairFeatureCache
+      {
+        public:
+          /** \brief Clear the cache and set the maximum number of pairs it holds. */
+          void
+          reset (std::size_t max_size);
+
+          /** \brief Look up the features of the pair (p_idx, q_idx).
+            * \return a pointer to the features, or nullptr if they are not in the cache
+            */
+          inline const Eigen::Vector4f*
+          find (int p_idx, int q_idx) const
+          {
+            if (keys_.empty ())
+              return (nullptr);
+            const std::uint64_t key = makeKey (p_idx, q_idx);
+            std::size_t slot = hash (key);
+            for (unsigned int probe = 0; probe < max_probes_; ++probe, slot = (slot + 1) & mask_)
+            {
+              if (keys_[slot] == key)
+                return (&values_[slot]);
+              if (keys_[slot] == empty_key_)
+                return (nullptr);
+            }
+            return (nullptr);
+          }
+
+          /** \brief Save the features of the pair (p_idx, q_idx). */
+          void
+          insert (int p_idx, int q_idx, const Eigen::Vector4f &features);
+
+        protected:
+          static inline std::uint64_t
+          makeKey (int p_idx, int q_idx)
+          {
+            return ((static_cast<std::uint64_t> (static_cast<std::uint32_t> (p_idx)) << 32) |
+                    static_cast<std::uint32_t> (q_idx));
+          }
+
+          inline std::size_t
+          hash (std::uint64_t key) const
+          {
+            return (static_cast<std::size_t> ((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_);
+          }
+
+          /** \brief Double the size of the table, up to \a max_capacity_. */
+          void
+          grow ();
+
+          /** \brief Marks unused slots: (-1, -1) is not a valid pair of point indices. */
+          static constexpr std::uint64_t empty_key_ = ~static_cast<std::uint64_t> (0);
+          static constexpr unsigned int max_probes_ = 8;
+
+          std::vector<std::uint64_t> keys_;
+          std::vector<Eigen::Vector4f, Eigen::aligned_allocator<Eigen::Vector4f> > values_;
+          std::size_t mask_ = 0;
+          std::size_t size_ = 0;
+          std::size_t max_capacity_ = 0;
+      };
+
+      /** \brief Estimate the PFH signature of a point, using a thread local cache instead of the
+        * member placeholders and feature map of \ref PFHEstimation.
+        * \param[in] cloud the dataset containing the XYZ Cartesian coordinates of the points
+        * \param[in] normals the dataset containing the surface normals at each point in \a cloud
+        * \param[in] indices the k-neighborhood point indices in the dataset
+        * \param[in] nr_split the number of subdivisions for each angular feature interval
+        * \param[in] cache the pair feature cache of the calling thread, or nullptr to disable caching
+        * \param[out] pfh_histogram the resultant (combinatorial) PFH histogram representing the feature at the query point
+        */
+      void
+      computePointPFHSignature (const pcl::PointCloud<PointInT> &cloud, const pcl::PointCloud<PointNT> &normals,
+                                const pcl::Indices &indices, int nr_split, PairFeatureCache *cache,
+                                Eigen::VectorXf &pfh_histogram) const;
+
+    private:
+      /** \brief Estimate the Point Feature Histograms (PFH) descriptors at a set of points given by
+        * <setInputCloud (), setIndices ()> using the surface in setSearchSurface () and the spatial locator in
+        * setSearchMethod ()
+        * \param[out] output the resultant point cloud model dataset that contains the PFH feature estimates
+        */
+      void
+      computeFeature (PointCloudOut &output) override;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/features/impl/pfh_omp.hpp>
+#endif
@@ -44,6 +44,9 @@
 #include <pcl/pcl_exports.h>
 #include <Eigen/Core>
 
+#include <cstddef> // for size_t
+#include <cstdint> // for uint8_t
+
 namespace pcl
 {
   /** \brief Compute the 4-tuple representation containing the three angles and one distance between two points
@@ -67,6 +70,70 @@ namespace pcl
                        const Eigen::Vector4f &p2, const Eigen::Vector4f &n2, 
                        float &f1, float &f2, float &f3, float &f4);
 
+  /** \brief Compute the 4-tuple representation (see above) between one point and a batch of points, stored as
+    * a structure of arrays.
+    *
+    * The pairs are processed several at a time, with the widest SIMD instruction set supported by the CPU
+    * (AVX-512, AVX or SSE2, see \ref setPairFeaturesSimdLevel; NEON on AArch64), or one at a time otherwise. The
+    * features of a pair do not depend on its position in the arrays nor on the SIMD instruction set, and agree with the
+    * ones of the single pair version up to rounding errors.
+    * \param[in] p1 the first XYZ point
+    * \param[in] n1 the first surface normal
+    * \param[in] x2 the x coordinates of the second points
+    * \param[in] y2 the y coordinates of the second points
+    * \param[in] z2 the z coordinates of the second points
+    * \param[in] nx2 the x components of the second surface normals
+    * \param[in] ny2 the y components of the second surface normals
+    * \param[in] nz2 the z components of the second surface normals
+    * \param[in] nr_pairs the number of second points, i.e. the size of all the arrays
+    * \param[out] f1 the first angular features
+    * \param[out] f2 the second angular features
+    * \param[out] f3 the third angular features
+    * \param[out] f4 the distance features
+    * \param[out] valid set to 1 for the pairs whose features could be computed, and to 0 (with all four features
+    * set to 0) for the others, i.e. where the single pair version returns false
+    * \return the number of valid pairs
+    *
+    * \note For efficiency reasons, we assume that the point data passed to the method is finite.
+    * \ingroup features
+    */
+  PCL_EXPORTS std::size_t
+  computePairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n1,
+                       const float *x2, const float *y2, const float *z2,
+                       const float *nx2, const float *ny2, const float *nz2, std::size_t nr_pairs,
+                       float *f1, float *f2, float *f3, float *f4, std::uint8_t *valid);
+
+  /** \brief The instruction sets of the batched \ref computePairFeatures, from the slowest to the fastest.
+    * \ingroup features
+    */
+  enum class PairFeaturesSimdLevel
+  {
+    NONE,  /**< the baseline: one pair at a time, or 4 pairs at a time with NEON on AArch64 */
+    SSE2,  /**< 4 pairs at a time */
+    AVX,   /**< 8 pairs at a time */
+    AVX512 /**< 16 pairs at a time, with AVX-512F */
+  };
+
+  /** \brief Get the instruction set used by the batched \ref computePairFeatures.
+    *
+    * The kernel is compiled once for each instruction set, and the fastest one supported by the CPU is
+    * selected when the program starts, so that a binary built for a baseline architecture still uses
+    * AVX-512 where it is available.
+    * \ingroup features
+    */
+  PCL_EXPORTS PairFeaturesSimdLevel
+  getPairFeaturesSimdLevel ();
+
+  /** \brief Limit the instruction set used by the batched \ref computePairFeatures, e.g. to compare
+    * the speed of the instruction sets.
+    * \param[in] level the fastest instruction set to use. Levels that are not supported by the CPU, or
+    * that PCL was built without, are lowered to the best supported one.
+    * \return the instruction set now in use
+    * \ingroup features
+    */
+  PCL_EXPORTS PairFeaturesSimdLevel
+  setPairFeaturesSimdLevel (PairFeaturesSimdLevel level);
+
   PCL_EXPORTS bool
   computeRGBPairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n1, const Eigen::Vector4i &colors1,
                           const Eigen::Vector4f &p2, const Eigen::Vector4f &n2, const Eigen::Vector4i &colors2,
@@ -38,8 +38,20 @@
 
 #include <pcl/features/pfh_tools.h>
 #include <pcl/features/impl/pfh.hpp>
+#include <pcl/features/impl/pfh_omp.hpp>
 #include <pcl/features/impl/pfhrgb.hpp>
 
+#include <algorithm> // for min, max
+#include <atomic>
+#include <cmath> // for copysign
+
+#if defined (__ARM_NEON) && defined (__aarch64__)
+#include <arm_neon.h>
+#endif
+#if defined (_MSC_VER) && (defined (_M_X64) || defined (_M_IX86))
+#include <intrin.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 bool
 pcl::computePairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n1, 
@@ -163,17 +175,208 @@ pcl::computeRGBPairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n
   return (true);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+  // The baseline kernel: NEON is always available on AArch64, the other instruction sets
+  // are selected at runtime (see pcl::setPairFeaturesSimdLevel)
+#if defined (__ARM_NEON) && defined (__aarch64__)
+  /** \brief Operations on 4 floats, with NEON. */
+  struct Ops
+  {
+    using Vector = float32x4_t;
+    using Mask = uint32x4_t;
+    static constexpr std::size_t width = 4;
+
+    static inline Vector set1 (float v) { return (vdupq_n_f32 (v)); }
+    static inline Vector load (const float *p) { return (vld1q_f32 (p)); }
+    static inline void store (float *p, Vector v) { vst1q_f32 (p, v); }
+    static inline Vector add (Vector a, Vector b) { return (vaddq_f32 (a, b)); }
+    static inline Vector sub (Vector a, Vector b) { return (vsubq_f32 (a, b)); }
+    static inline Vector mul (Vector a, Vector b) { return (vmulq_f32 (a, b)); }
+    static inline Vector div (Vector a, Vector b) { return (vdivq_f32 (a, b)); }
+    static inline Vector sqrt (Vector a) { return (vsqrtq_f32 (a)); }
+    static inline Vector abs (Vector a) { return (vabsq_f32 (a)); }
+    static inline Vector min (Vector a, Vector b) { return (vminq_f32 (a, b)); }
+    static inline Vector max (Vector a, Vector b) { return (vmaxq_f32 (a, b)); }
+    static inline Vector copySign (Vector magnitude, Vector sign)
+    {
+      return (vbslq_f32 (vdupq_n_u32 (0x80000000u), sign, magnitude));
+    }
+    static inline Mask lt (Vector a, Vector b) { return (vcltq_f32 (a, b)); }
+    static inline Mask le (Vector a, Vector b) { return (vcleq_f32 (a, b)); }
+    static inline Mask neq (Vector a, Vector b) { return (vmvnq_u32 (vceqq_f32 (a, b))); }
+    static inline Mask logicalAnd (Mask a, Mask b) { return (vandq_u32 (a, b)); }
+    static inline Vector select (Mask m, Vector a, Vector b) { return (vbslq_f32 (m, a, b)); }
+    static inline unsigned int bits (Mask m)
+    {
+      return ((vgetq_lane_u32 (m, 0) & 1u) | (vgetq_lane_u32 (m, 1) & 2u) |
+              (vgetq_lane_u32 (m, 2) & 4u) | (vgetq_lane_u32 (m, 3) & 8u));
+    }
+  };
+#else
+  struct Ops
+  {
+    using Vector = float;
+    using Mask = bool;
+    static constexpr std::size_t width = 1;
+
+    static inline Vector set1 (float v) { return (v); }
+    static inline Vector load (const float *p) { return (*p); }
+    static inline void store (float *p, Vector v) { *p = v; }
+    static inline Vector add (Vector a, Vector b) { return (a + b); }
+    static inline Vector sub (Vector a, Vector b) { return (a - b); }
+    static inline Vector mul (Vector a, Vector b) { return (a * b); }
+    static inline Vector div (Vector a, Vector b) { return (a / b); }
+    static inline Vector sqrt (Vector a) { return (std::sqrt (a)); }
+    static inline Vector abs (Vector a) { return (std::abs (a)); }
+    static inline Vector min (Vector a, Vector b) { return (std::min (a, b)); }
+    static inline Vector max (Vector a, Vector b) { return (std::max (a, b)); }
+    /** \brief Copy the sign of \a sign on \a magnitude, which must be positive. */
+    static inline Vector copySign (Vector magnitude, Vector sign) { return (std::copysign (magnitude, sign)); }
+    static inline Mask lt (Vector a, Vector b) { return (a < b); }
+    static inline Mask le (Vector a, Vector b) { return (a <= b); }
+    static inline Mask neq (Vector a, Vector b) { return (a != b); }
+    static inline Mask logicalAnd (Mask a, Mask b) { return (a && b); }
+    static inline Vector select (Mask m, Vector a, Vector b) { return (m ? a : b); }
+    static inline unsigned int bits (Mask m) { return (m ? 1u : 0u); }
+  };
+
+#endif
+}
+
+#define PCL_PFH_SIMD_OPS
+#include "pfh_simd_kernels.h"
+
+namespace
+{
+  /** \brief Return whether the CPU supports AVX, and the OS saves the AVX registers. */
+  bool
+  cpuSupportsAVX ()
+  {
+#if defined (_MSC_VER) && (defined (_M_X64) || defined (_M_IX86))
+    int info[4];
+    __cpuid (info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    return (osxsave && avx && (_xgetbv (0) & 0x6) == 0x6);
+#elif (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+    __builtin_cpu_init ();
+    return (__builtin_cpu_supports ("avx"));
+#else
+    return (false);
+#endif
+  }
+
+  /** \brief Return whether the CPU supports AVX-512F, and the OS saves the AVX-512 registers. */
+  bool
+  cpuSupportsAVX512 ()
+  {
+#if defined (_MSC_VER) && (defined (_M_X64) || defined (_M_IX86))
+    int info[4];
+    __cpuid (info, 0);
+    if (info[0] < 7 || !cpuSupportsAVX () || (_xgetbv (0) & 0xe6) != 0xe6)
+      return (false);
+    __cpuidex (info, 7, 0);
+    return ((info[1] & (1 << 16)) != 0);
+#elif (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+    __builtin_cpu_init ();
+    return (__builtin_cpu_supports ("avx512f"));
+#else
+    return (false);
+#endif
+  }
+
+  /** \brief Return whether the CPU supports SSE2. */
+  bool
+  cpuSupportsSSE2 ()
+  {
+#if defined (_M_X64) || defined (__x86_64__)
+    return (true);
+#elif defined (_MSC_VER) && defined (_M_IX86)
+    int info[4];
+    __cpuid (info, 1);
+    return ((info[3] & (1 << 26)) != 0);
+#elif (defined (__GNUC__) || defined (__clang__)) && defined (__i386__)
+    __builtin_cpu_init ();
+    return (__builtin_cpu_supports ("sse2"));
+#else
+    return (false);
+#endif
+  }
+
+  /** \brief The fastest level supported by both PCL and the CPU. */
+  pcl::PairFeaturesSimdLevel
+  detectPairFeaturesSimdLevel ()
+  {
+    if (pcl::detail::getPairFeaturesFunctionsAVX512 () && cpuSupportsAVX512 ())
+      return (pcl::PairFeaturesSimdLevel::AVX512);
+    if (pcl::detail::getPairFeaturesFunctionsAVX () && cpuSupportsAVX ())
+      return (pcl::PairFeaturesSimdLevel::AVX);
+    if (pcl::detail::getPairFeaturesFunctionsSSE2 () && cpuSupportsSSE2 ())
+      return (pcl::PairFeaturesSimdLevel::SSE2);
+    return (pcl::PairFeaturesSimdLevel::NONE);
+  }
+
+  const pcl::PairFeaturesSimdLevel detected_level = detectPairFeaturesSimdLevel ();
+  std::atomic<pcl::PairFeaturesSimdLevel> current_level (detected_level);
+
+  const pcl::detail::PairFeaturesFunctions*
+  getFunctions ()
+  {
+    switch (current_level.load (std::memory_order_relaxed))
+    {
+      case pcl::PairFeaturesSimdLevel::AVX512: return (pcl::detail::getPairFeaturesFunctionsAVX512 ());
+      case pcl::PairFeaturesSimdLevel::AVX: return (pcl::detail::getPairFeaturesFunctionsAVX ());
+      case pcl::PairFeaturesSimdLevel::SSE2: return (pcl::detail::getPairFeaturesFunctionsSSE2 ());
+      case pcl::PairFeaturesSimdLevel::NONE: break;
+    }
+    return (&pcl::detail::functions);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::PairFeaturesSimdLevel
+pcl::getPairFeaturesSimdLevel ()
+{
+  return (current_level.load (std::memory_order_relaxed));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::PairFeaturesSimdLevel
+pcl::setPairFeaturesSimdLevel (PairFeaturesSimdLevel level)
+{
+  if (static_cast<int> (level) > static_cast<int> (detected_level))
+    level = detected_level;
+  current_level.store (level, std::memory_order_relaxed);
+  return (level);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::computePairFeatures (const Eigen::Vector4f &p1, const Eigen::Vector4f &n1,
+                          const float *x2, const float *y2, const float *z2,
+                          const float *nx2, const float *ny2, const float *nz2, std::size_t nr_pairs,
+                          float *f1, float *f2, float *f3, float *f4, std::uint8_t *valid)
+{
+  const float p1_xyz[3] = {p1[0], p1[1], p1[2]};
+  const float n1_xyz[3] = {n1[0], n1[1], n1[2]};
+  return (getFunctions ()->compute (p1_xyz, n1_xyz, x2, y2, z2, nx2, ny2, nz2, nr_pairs, f1, f2, f3, f4, valid));
+}
+
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/point_types.h>
 #include <pcl/impl/instantiate.hpp>
 // Instantiations of specific point types
 #ifdef PCL_ONLY_CORE_POINT_TYPES
   PCL_INSTANTIATE_PRODUCT(PFHEstimation, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGB)(pcl::PointXYZRGBA))((pcl::Normal))((pcl::PFHSignature125)))
+  PCL_INSTANTIATE_PRODUCT(PFHEstimationOMP, ((pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGB)(pcl::PointXYZRGBA))((pcl::Normal))((pcl::PFHSignature125)))
   PCL_INSTANTIATE_PRODUCT(PFHRGBEstimation, ((pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
                           ((pcl::Normal)(pcl::PointXYZRGBNormal))
                           ((pcl::PFHRGBSignature250)))
 #else
   PCL_INSTANTIATE_PRODUCT(PFHEstimation, (PCL_XYZ_POINT_TYPES)(PCL_NORMAL_POINT_TYPES)((pcl::PFHSignature125)))
+  PCL_INSTANTIATE_PRODUCT(PFHEstimationOMP, (PCL_XYZ_POINT_TYPES)(PCL_NORMAL_POINT_TYPES)((pcl::PFHSignature125)))
   PCL_INSTANTIATE_PRODUCT(PFHRGBEstimation, ((pcl::PointXYZRGB)(pcl::PointXYZRGBA)(pcl::PointXYZRGBNormal))
                           (PCL_NORMAL_POINT_TYPES)
                           ((pcl::PFHRGBSignature250)))
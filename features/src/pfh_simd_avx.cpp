@@ -0,0 +1,97 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Compiled with the flags enabling AVX, see pfh_simd_kernels.h. FMA is left disabled,
+// so that the results are the same as with SSE2.
+
+#ifdef __AVX__
+#define PCL_PFH_SIMD_AVX
+#endif
+
+#ifdef PCL_PFH_SIMD_AVX
+#include <cstddef>
+#include <immintrin.h>
+
+namespace
+{
+  /** \brief The vector operations of the kernel, on 8 pairs. */
+  struct Ops
+  {
+    using Vector = __m256;
+    using Mask = __m256;
+    static constexpr std::size_t width = 8;
+
+    static Vector set1 (float v) { return (_mm256_set1_ps (v)); }
+    static Vector load (const float *p) { return (_mm256_loadu_ps (p)); }
+    static void store (float *p, Vector v) { _mm256_storeu_ps (p, v); }
+    static Vector add (Vector a, Vector b) { return (_mm256_add_ps (a, b)); }
+    static Vector sub (Vector a, Vector b) { return (_mm256_sub_ps (a, b)); }
+    static Vector mul (Vector a, Vector b) { return (_mm256_mul_ps (a, b)); }
+    static Vector div (Vector a, Vector b) { return (_mm256_div_ps (a, b)); }
+    static Vector sqrt (Vector a) { return (_mm256_sqrt_ps (a)); }
+    static Vector abs (Vector a) { return (_mm256_andnot_ps (_mm256_set1_ps (-0.0f), a)); }
+    static Vector min (Vector a, Vector b) { return (_mm256_min_ps (a, b)); }
+    static Vector max (Vector a, Vector b) { return (_mm256_max_ps (a, b)); }
+    /** \brief Copy the sign of \a sign on \a magnitude, which must be positive. */
+    static Vector copySign (Vector magnitude, Vector sign)
+    {
+      return (_mm256_or_ps (magnitude, _mm256_and_ps (_mm256_set1_ps (-0.0f), sign)));
+    }
+    static Mask lt (Vector a, Vector b) { return (_mm256_cmp_ps (a, b, _CMP_LT_OQ)); }
+    static Mask le (Vector a, Vector b) { return (_mm256_cmp_ps (a, b, _CMP_LE_OQ)); }
+    static Mask neq (Vector a, Vector b) { return (_mm256_cmp_ps (a, b, _CMP_NEQ_UQ)); }
+    static Mask logicalAnd (Mask a, Mask b) { return (_mm256_and_ps (a, b)); }
+    /** \brief a where mask is set, b elsewhere */
+    static Vector select (Mask m, Vector a, Vector b) { return (_mm256_blendv_ps (b, a, m)); }
+    static unsigned int bits (Mask m) { return (static_cast<unsigned int> (_mm256_movemask_ps (m))); }
+  };
+}
+
+#define PCL_PFH_SIMD_OPS
+#endif // PCL_PFH_SIMD_AVX
+
+#include "pfh_simd_kernels.h"
+
+const pcl::detail::PairFeaturesFunctions*
+pcl::detail::getPairFeaturesFunctionsAVX ()
+{
+#ifdef PCL_PFH_SIMD_AVX
+  return (&functions);
+#else
+  return (nullptr);
+#endif
+}
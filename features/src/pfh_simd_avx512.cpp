@@ -0,0 +1,101 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Compiled with the flags enabling AVX-512F, see pfh_simd_kernels.h. FMA is left
+// disabled, so that the results are the same as with SSE2.
+
+#ifdef __AVX512F__
+#define PCL_PFH_SIMD_AVX512
+#endif
+
+#ifdef PCL_PFH_SIMD_AVX512
+#include <cstddef>
+#include <immintrin.h>
+
+namespace
+{
+  /** \brief The vector operations of the kernel, on 16 pairs. */
+  struct Ops
+  {
+    using Vector = __m512;
+    using Mask = __mmask16;
+    static constexpr std::size_t width = 16;
+
+    static Vector set1 (float v) { return (_mm512_set1_ps (v)); }
+    static Vector load (const float *p) { return (_mm512_loadu_ps (p)); }
+    static void store (float *p, Vector v) { _mm512_storeu_ps (p, v); }
+    static Vector add (Vector a, Vector b) { return (_mm512_add_ps (a, b)); }
+    static Vector sub (Vector a, Vector b) { return (_mm512_sub_ps (a, b)); }
+    static Vector mul (Vector a, Vector b) { return (_mm512_mul_ps (a, b)); }
+    static Vector div (Vector a, Vector b) { return (_mm512_div_ps (a, b)); }
+    static Vector sqrt (Vector a) { return (_mm512_sqrt_ps (a)); }
+    static Vector abs (Vector a)
+    {
+      return (_mm512_castsi512_ps (_mm512_andnot_si512 (_mm512_castps_si512 (_mm512_set1_ps (-0.0f)), _mm512_castps_si512 (a))));
+    }
+    static Vector min (Vector a, Vector b) { return (_mm512_min_ps (a, b)); }
+    static Vector max (Vector a, Vector b) { return (_mm512_max_ps (a, b)); }
+    /** \brief Copy the sign of \a sign on \a magnitude, which must be positive. */
+    static Vector copySign (Vector magnitude, Vector sign)
+    {
+      return (_mm512_castsi512_ps (_mm512_or_si512 (_mm512_castps_si512 (magnitude),
+                                                    _mm512_and_si512 (_mm512_castps_si512 (_mm512_set1_ps (-0.0f)), _mm512_castps_si512 (sign)))));
+    }
+    static Mask lt (Vector a, Vector b) { return (_mm512_cmp_ps_mask (a, b, _CMP_LT_OQ)); }
+    static Mask le (Vector a, Vector b) { return (_mm512_cmp_ps_mask (a, b, _CMP_LE_OQ)); }
+    static Mask neq (Vector a, Vector b) { return (_mm512_cmp_ps_mask (a, b, _CMP_NEQ_UQ)); }
+    static Mask logicalAnd (Mask a, Mask b) { return (static_cast<Mask> (a & b)); }
+    /** \brief a where mask is set, b elsewhere */
+    static Vector select (Mask m, Vector a, Vector b) { return (_mm512_mask_blend_ps (m, b, a)); }
+    static unsigned int bits (Mask m) { return (m); }
+  };
+}
+
+#define PCL_PFH_SIMD_OPS
+#endif // PCL_PFH_SIMD_AVX512
+
+#include "pfh_simd_kernels.h"
+
+const pcl::detail::PairFeaturesFunctions*
+pcl::detail::getPairFeaturesFunctionsAVX512 ()
+{
+#ifdef PCL_PFH_SIMD_AVX512
+  return (&functions);
+#else
+  return (nullptr);
+#endif
+}
@@ -0,0 +1,219 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// The batched pair features kernel, written once over a small set of vector
+// operations. This header is included by one translation unit per instruction set
+// (pfh_simd_sse2.cpp, pfh_simd_avx.cpp, pfh_simd_avx512.cpp), each compiled with the
+// flags of its instruction set and defining the vector operations as `Ops` before
+// including it, and by pfh.cpp for the baseline one. As these translation units may
+// contain instructions the CPU does not support, everything they define has internal
+// linkage and they do not call inline functions of the standard library or of other
+// headers (e.g. Eigen): the linker could otherwise keep their copy of such a function
+// for the whole program.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief The batched pair features kernel compiled for one instruction set. */
+    struct PairFeaturesFunctions
+    {
+      /** \brief Same as the batched pcl::computePairFeatures, with the x, y and z of the
+        * first point and of its normal. */
+      std::size_t (*compute) (const float *p1, const float *n1,
+                              const float *x2, const float *y2, const float *z2,
+                              const float *nx2, const float *ny2, const float *nz2, std::size_t nr_pairs,
+                              float *f1, float *f2, float *f3, float *f4, std::uint8_t *valid);
+    };
+
+    /** \brief Return the kernel of an instruction set, or nullptr if PCL was built
+      * without it. */
+    const PairFeaturesFunctions*
+    getPairFeaturesFunctionsSSE2 ();
+    const PairFeaturesFunctions*
+    getPairFeaturesFunctionsAVX ();
+    const PairFeaturesFunctions*
+    getPairFeaturesFunctionsAVX512 ();
+
+#ifdef PCL_PFH_SIMD_OPS
+    namespace
+    {
+      using Vector = Ops::Vector;
+      constexpr std::size_t Width = Ops::width;
+
+      /** \brief atan2 (y, x) with a maximum error of a few float ulps (Cephes atanf polynomial). */
+      inline Vector
+      atan2 (Vector y, Vector x)
+      {
+        const Vector zero = Ops::set1 (0.0f), one = Ops::set1 (1.0f);
+        const Vector abs_x = Ops::abs (x), abs_y = Ops::abs (y);
+
+        // Reduce to atan (a) with a in [0, 1], then to [0, tan (pi / 8)]
+        const Vector num = Ops::min (abs_x, abs_y), den = Ops::max (abs_x, abs_y);
+        Vector a = Ops::select (Ops::neq (den, zero), Ops::div (num, den), zero);
+        const auto above_pi_8 = Ops::lt (Ops::set1 (0.414213562373095f), a);
+        a = Ops::select (above_pi_8, Ops::div (Ops::sub (a, one), Ops::add (a, one)), a);
+
+        const Vector z = Ops::mul (a, a);
+        Vector r = Ops::set1 (8.05374449538e-2f);
+        r = Ops::sub (Ops::mul (r, z), Ops::set1 (1.38776856032e-1f));
+        r = Ops::add (Ops::mul (r, z), Ops::set1 (1.99777106478e-1f));
+        r = Ops::sub (Ops::mul (r, z), Ops::set1 (3.33329491539e-1f));
+        r = Ops::add (Ops::mul (Ops::mul (r, z), a), a);
+        r = Ops::add (r, Ops::select (above_pi_8, Ops::set1 (0.78539816339744830962f), zero));
+
+        // Undo the reduction: octant, then quadrant
+        r = Ops::select (Ops::lt (abs_x, abs_y), Ops::sub (Ops::set1 (1.57079632679489661923f), r), r);
+        r = Ops::select (Ops::lt (x, zero), Ops::sub (Ops::set1 (3.14159265358979323846f), r), r);
+        return (Ops::copySign (r, y));
+      }
+
+      /** \brief Compute the pair features of Width pairs, starting at i. Same steps as the single pair
+        * pcl::computePairFeatures, one lane per pair. */
+      inline unsigned int
+      computePairFeaturesBatch (const float *p1, const float *n1,
+                                const float *x2, const float *y2, const float *z2,
+                                const float *nx2, const float *ny2, const float *nz2, std::size_t i,
+                                float *f1, float *f2, float *f3, float *f4)
+      {
+        const Vector zero = Ops::set1 (0.0f);
+
+        Vector dx = Ops::sub (Ops::load (x2 + i), Ops::set1 (p1[0]));
+        Vector dy = Ops::sub (Ops::load (y2 + i), Ops::set1 (p1[1]));
+        Vector dz = Ops::sub (Ops::load (z2 + i), Ops::set1 (p1[2]));
+        const Vector dist = Ops::sqrt (Ops::add (Ops::add (Ops::mul (dx, dx), Ops::mul (dy, dy)), Ops::mul (dz, dz)));
+        auto ok = Ops::neq (dist, zero);
+
+        const Vector ax = Ops::set1 (n1[0]), ay = Ops::set1 (n1[1]), az = Ops::set1 (n1[2]);
+        const Vector bx = Ops::load (nx2 + i), by = Ops::load (ny2 + i), bz = Ops::load (nz2 + i);
+        const Vector angle1 = Ops::div (Ops::add (Ops::add (Ops::mul (ax, dx), Ops::mul (ay, dy)), Ops::mul (az, dz)), dist);
+        const Vector angle2 = Ops::div (Ops::add (Ops::add (Ops::mul (bx, dx), Ops::mul (by, dy)), Ops::mul (bz, dz)), dist);
+
+        // Make sure the same point is selected as 1 and 2 for each pair: acos (|angle1|) > acos (|angle2|),
+        // where acos is NaN (and the comparison false) above 1
+        const Vector abs_angle2 = Ops::abs (angle2);
+        const auto swap = Ops::logicalAnd (Ops::lt (Ops::abs (angle1), abs_angle2), Ops::le (abs_angle2, Ops::set1 (1.0f)));
+        const Vector ux = Ops::select (swap, bx, ax), uy = Ops::select (swap, by, ay), uz = Ops::select (swap, bz, az);
+        const Vector mx = Ops::select (swap, ax, bx), my = Ops::select (swap, ay, by), mz = Ops::select (swap, az, bz);
+        dx = Ops::select (swap, Ops::sub (zero, dx), dx);
+        dy = Ops::select (swap, Ops::sub (zero, dy), dy);
+        dz = Ops::select (swap, Ops::sub (zero, dz), dz);
+        const Vector f3_v = Ops::select (swap, Ops::sub (zero, angle2), angle1);
+
+        // Darboux frame u-v-w: u = n1; v = (p2 - p1) x u / || (p2 - p1) x u ||; w = u x v
+        Vector vx = Ops::sub (Ops::mul (dy, uz), Ops::mul (dz, uy));
+        Vector vy = Ops::sub (Ops::mul (dz, ux), Ops::mul (dx, uz));
+        Vector vz = Ops::sub (Ops::mul (dx, uy), Ops::mul (dy, ux));
+        const Vector v_norm = Ops::sqrt (Ops::add (Ops::add (Ops::mul (vx, vx), Ops::mul (vy, vy)), Ops::mul (vz, vz)));
+        ok = Ops::logicalAnd (ok, Ops::neq (v_norm, zero));
+        vx = Ops::div (vx, v_norm);
+        vy = Ops::div (vy, v_norm);
+        vz = Ops::div (vz, v_norm);
+        const Vector wx = Ops::sub (Ops::mul (uy, vz), Ops::mul (uz, vy));
+        const Vector wy = Ops::sub (Ops::mul (uz, vx), Ops::mul (ux, vz));
+        const Vector wz = Ops::sub (Ops::mul (ux, vy), Ops::mul (uy, vx));
+
+        const Vector f2_v = Ops::add (Ops::add (Ops::mul (vx, mx), Ops::mul (vy, my)), Ops::mul (vz, mz));
+        const Vector w_n2 = Ops::add (Ops::add (Ops::mul (wx, mx), Ops::mul (wy, my)), Ops::mul (wz, mz));
+        const Vector u_n2 = Ops::add (Ops::add (Ops::mul (ux, mx), Ops::mul (uy, my)), Ops::mul (uz, mz));
+        const Vector f1_v = atan2 (w_n2, u_n2);
+
+        // Invalid pairs have all their features set to 0
+        Ops::store (f1 + i, Ops::select (ok, f1_v, zero));
+        Ops::store (f2 + i, Ops::select (ok, f2_v, zero));
+        Ops::store (f3 + i, Ops::select (ok, f3_v, zero));
+        Ops::store (f4 + i, Ops::select (ok, dist, zero));
+        return (Ops::bits (ok));
+      }
+
+      std::size_t
+      computePairFeatures (const float *p1, const float *n1,
+                           const float *x2, const float *y2, const float *z2,
+                           const float *nx2, const float *ny2, const float *nz2, std::size_t nr_pairs,
+                           float *f1, float *f2, float *f3, float *f4, std::uint8_t *valid)
+      {
+        std::size_t nr_valid = 0;
+        std::size_t i = 0;
+        for (; i + Width <= nr_pairs; i += Width)
+        {
+          const unsigned int ok = computePairFeaturesBatch (p1, n1, x2, y2, z2, nx2, ny2, nz2, i, f1, f2, f3, f4);
+          for (std::size_t lane = 0; lane < Width; ++lane)
+          {
+            valid[i + lane] = static_cast<std::uint8_t> ((ok >> lane) & 1u);
+            nr_valid += valid[i + lane];
+          }
+        }
+        // Process the remaining pairs (less than Width) in a zero padded batch, so that the
+        // features of a pair do not depend on its position in the arrays
+        if (i < nr_pairs)
+        {
+          const std::size_t nr_remaining = nr_pairs - i;
+          float tail[10][Width] = {};
+          for (std::size_t lane = 0; lane < nr_remaining; ++lane)
+          {
+            tail[0][lane] = x2[i + lane];
+            tail[1][lane] = y2[i + lane];
+            tail[2][lane] = z2[i + lane];
+            tail[3][lane] = nx2[i + lane];
+            tail[4][lane] = ny2[i + lane];
+            tail[5][lane] = nz2[i + lane];
+          }
+          const unsigned int ok = computePairFeaturesBatch (p1, n1, tail[0], tail[1], tail[2], tail[3], tail[4], tail[5], 0,
+                                                            tail[6], tail[7], tail[8], tail[9]);
+          for (std::size_t lane = 0; lane < nr_remaining; ++lane)
+          {
+            f1[i + lane] = tail[6][lane];
+            f2[i + lane] = tail[7][lane];
+            f3[i + lane] = tail[8][lane];
+            f4[i + lane] = tail[9][lane];
+            valid[i + lane] = static_cast<std::uint8_t> ((ok >> lane) & 1u);
+            nr_valid += valid[i + lane];
+          }
+        }
+        return (nr_valid);
+      }
+
+      const PairFeaturesFunctions functions = {&computePairFeatures};
+    }
+#endif // PCL_PFH_SIMD_OPS
+  }
+}
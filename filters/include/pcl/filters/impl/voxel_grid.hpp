@@ -42,7 +42,10 @@
 #include <pcl/common/common.h>
 #include <pcl/common/io.h>
 #include <pcl/filters/voxel_grid.h>
-#include  <boost/sort/spreadsort/integer_sort.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -209,6 +212,140 @@ struct cloud_point_index_idx
   bool operator < (const cloud_point_index_idx &p) const { return (idx < p.idx); }
 };
 
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Fill \a index_vector with the (leaf index, point index) pairs of \a nr_candidates
+      * candidate points, splitting the candidates in \a nr_threads contiguous blocks. The blocks
+      * are appended in order, so the result does not depend on the number of threads.
+      * \param[in] nr_candidates the number of candidate points
+      * \param[in] compute_entry functor taking the position of a candidate and filling in its
+      * (leaf index, point index) pair, returning false if the candidate has to be skipped
+      * \param[in] nr_threads the number of threads to use
+      * \param[out] index_vector the resultant (leaf index, point index) pairs
+      */
+    template <typename EntryFunctor> void
+    computeIndexVector (std::size_t nr_candidates, const EntryFunctor &compute_entry, unsigned int nr_threads,
+                        std::vector<cloud_point_index_idx> &index_vector)
+    {
+      index_vector.clear ();
+      if (nr_threads <= 1)
+      {
+        index_vector.reserve (nr_candidates);
+        cloud_point_index_idx entry;
+        for (std::size_t i = 0; i < nr_candidates; ++i)
+          if (compute_entry (i, entry))
+            index_vector.push_back (entry);
+        return;
+      }
+
+      std::vector<std::vector<cloud_point_index_idx> > block_index_vectors (nr_threads);
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  schedule(static, 1)
+      for (int block = 0; block < static_cast<int> (nr_threads); ++block)
+      {
+        const std::size_t begin = nr_candidates * block / nr_threads;
+        const std::size_t end = nr_candidates * (block + 1) / nr_threads;
+        std::vector<cloud_point_index_idx> &block_index_vector = block_index_vectors[block];
+        block_index_vector.reserve (end - begin);
+        cloud_point_index_idx entry;
+        for (std::size_t i = begin; i < end; ++i)
+          if (compute_entry (i, entry))
+            block_index_vector.push_back (entry);
+      }
+
+      std::vector<std::size_t> block_offsets (nr_threads + 1, 0);
+      for (std::size_t block = 0; block < nr_threads; ++block)
+        block_offsets[block + 1] = block_offsets[block] + block_index_vectors[block].size ();
+
+      index_vector.resize (block_offsets.back ());
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  schedule(static, 1)
+      for (int block = 0; block < static_cast<int> (nr_threads); ++block)
+        std::copy (block_index_vectors[block].begin (), block_index_vectors[block].end (), index_vector.begin () + block_offsets[block]);
+    }
+
+    /** \brief Sort \a index_vector by leaf index with a stable LSD radix sort, splitting every
+      * pass in \a nr_threads contiguous blocks. Since the sort is stable, points of the same
+      * leaf keep their relative order and the result does not depend on the number of threads.
+      * \param[in,out] index_vector the (leaf index, point index) pairs to sort
+      * \param[in] max_idx the largest leaf index present in \a index_vector
+      * \param[in] nr_threads the number of threads to use
+      */
+    inline void
+    radixSortByLeafIndex (std::vector<cloud_point_index_idx> &index_vector, unsigned int max_idx, unsigned int nr_threads)
+    {
+      constexpr unsigned int radix_bits = 11;
+      constexpr std::size_t radix_size = std::size_t (1) << radix_bits;
+      constexpr unsigned int radix_mask = radix_size - 1;
+
+      const std::size_t size = index_vector.size ();
+      // Below a few thousand points per block the histograms cost more than they save
+      nr_threads = static_cast<unsigned int> (std::max<std::size_t> (1, std::min<std::size_t> (nr_threads, size / 8192)));
+
+      std::vector<cloud_point_index_idx> buffer (size);
+      std::vector<std::size_t> offsets (nr_threads * radix_size);
+      const auto block_begin = [size, nr_threads] (unsigned int block) { return (size * block / nr_threads); };
+
+      for (unsigned int shift = 0; shift < 32 && (max_idx >> shift) > 0; shift += radix_bits)
+      {
+        std::fill (offsets.begin (), offsets.end (), 0);
+
+        // Count the occurrences of every digit in every block
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  schedule(static, 1)
+        for (int block = 0; block < static_cast<int> (nr_threads); ++block)
+        {
+          std::size_t *histogram = &offsets[block * radix_size];
+          for (std::size_t i = block_begin (block); i < block_begin (block + 1); ++i)
+            ++histogram[(index_vector[i].idx >> shift) & radix_mask];
+        }
+
+        // Turn the histograms into output offsets, ordered by digit first and block second
+        std::size_t sum = 0;
+        for (std::size_t digit = 0; digit < radix_size; ++digit)
+          for (unsigned int block = 0; block < nr_threads; ++block)
+          {
+            const std::size_t count = offsets[block * radix_size + digit];
+            offsets[block * radix_size + digit] = sum;
+            sum += count;
+          }
+
+        // Scatter every block to its own, disjoint output ranges
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  schedule(static, 1)
+        for (int block = 0; block < static_cast<int> (nr_threads); ++block)
+        {
+          std::size_t *offset = &offsets[block * radix_size];
+          for (std::size_t i = block_begin (block); i < block_begin (block + 1); ++i)
+            buffer[offset[(index_vector[i].idx >> shift) & radix_mask]++] = index_vector[i];
+        }
+
+        index_vector.swap (buffer);
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::VoxelGrid<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
@@ -260,31 +397,33 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
   // Set up the division multiplier
   divb_mul_ = Eigen::Vector4i (1, div_b_[0], div_b_[0] * div_b_[1], 0);
 
-  // Storage for mapping leaf and pointcloud indexes
-  std::vector<cloud_point_index_idx> index_vector;
-  index_vector.reserve (indices_->size ());
-
   // If we don't want to process the entire cloud, but rather filter points far away from the viewpoint first...
+  std::vector<pcl::PCLPointField> fields;
+  int distance_idx = -1;
   if (!filter_field_name_.empty ())
   {
     // Get the distance field index
-    std::vector<pcl::PCLPointField> fields;
-    int distance_idx = pcl::getFieldIndex<PointT> (filter_field_name_, fields);
+    distance_idx = pcl::getFieldIndex<PointT> (filter_field_name_, fields);
     if (distance_idx == -1)
       PCL_WARN ("[pcl::%s::applyFilter] Invalid filter field name. Index is %d.\n", getClassName ().c_str (), distance_idx);
+  }
 
-    // First pass: go over all points and insert them into the index_vector vector
-    // with calculated idx. Points with the same idx value will contribute to the
-    // same point of resulting CloudPoint
-    for (const auto& index : (*indices_))
-    {
-      if (!input_->is_dense)
-        // Check if the point is invalid
-        if (!isXYZFinite ((*input_)[index]))
-          continue;
+  // First pass: go over all points and insert them into the index_vector vector
+  // with calculated idx. Points with the same idx value will contribute to the
+  // same point of resulting CloudPoint
+  const auto compute_entry = [&] (std::size_t i, cloud_point_index_idx &entry)
+  {
+    const index_t index = (*indices_)[i];
+    const PointT &point = (*input_)[index];
+    if (!input_->is_dense)
+      // Check if the point is invalid
+      if (!isXYZFinite (point))
+        return (false);
 
+    if (!filter_field_name_.empty ())
+    {
       // Get the distance value
-      const std::uint8_t* pt_data = reinterpret_cast<const std::uint8_t*> (&(*input_)[index]);
+      const std::uint8_t* pt_data = reinterpret_cast<const std::uint8_t*> (&point);
       float distance_value = 0;
       memcpy (&distance_value, pt_data + fields[distance_idx].offset, sizeof (float));
 
@@ -292,55 +431,38 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
       {
         // Use a threshold for cutting out points which inside the interval
         if ((distance_value < filter_limit_max_) && (distance_value > filter_limit_min_))
-          continue;
+          return (false);
       }
       else
       {
         // Use a threshold for cutting out points which are too close/far away
         if ((distance_value > filter_limit_max_) || (distance_value < filter_limit_min_))
-          continue;
+          return (false);
       }
-      
-      int ijk0 = static_cast<int> (std::floor ((*input_)[index].x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
-      int ijk1 = static_cast<int> (std::floor ((*input_)[index].y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
-      int ijk2 = static_cast<int> (std::floor ((*input_)[index].z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
-
-      // Compute the centroid leaf index
-      int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
-      index_vector.emplace_back(static_cast<unsigned int> (idx), index);
     }
-  }
-  // No distance filtering, process all data
-  else
-  {
-    // First pass: go over all points and insert them into the index_vector vector
-    // with calculated idx. Points with the same idx value will contribute to the
-    // same point of resulting CloudPoint
-    for (const auto& index : (*indices_))
-    {
-      if (!input_->is_dense)
-        // Check if the point is invalid
-        if (!isXYZFinite ((*input_)[index]))
-          continue;
 
-      int ijk0 = static_cast<int> (std::floor ((*input_)[index].x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
-      int ijk1 = static_cast<int> (std::floor ((*input_)[index].y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
-      int ijk2 = static_cast<int> (std::floor ((*input_)[index].z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
+    int ijk0 = static_cast<int> (std::floor (point.x * inverse_leaf_size_[0]) - static_cast<float> (min_b_[0]));
+    int ijk1 = static_cast<int> (std::floor (point.y * inverse_leaf_size_[1]) - static_cast<float> (min_b_[1]));
+    int ijk2 = static_cast<int> (std::floor (point.z * inverse_leaf_size_[2]) - static_cast<float> (min_b_[2]));
 
-      // Compute the centroid leaf index
-      int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
-      index_vector.emplace_back(static_cast<unsigned int> (idx), index);
-    }
-  }
+    // Compute the centroid leaf index
+    int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
+    entry = cloud_point_index_idx (static_cast<unsigned int> (idx), index);
+    return (true);
+  };
+
+  // Storage for mapping leaf and pointcloud indexes
+  std::vector<cloud_point_index_idx> index_vector;
+  pcl::detail::computeIndexVector (indices_->size (), compute_entry, threads_, index_vector);
 
   // Second pass: sort the index_vector vector using value representing target cell as index
-  // in effect all points belonging to the same output cell will be next to each other
-  auto rightshift_func = [](const cloud_point_index_idx &x, const unsigned offset) { return x.idx >> offset; };
-  boost::sort::spreadsort::integer_sort(index_vector.begin(), index_vector.end(), rightshift_func);
+  // in effect all points belonging to the same output cell will be next to each other.
+  // The sort is stable, so the points of a cell keep their input order whatever the number of threads
+  const unsigned int max_idx = static_cast<unsigned int> (div_b_[0] * div_b_[1] * div_b_[2] - 1);
+  pcl::detail::radixSortByLeafIndex (index_vector, max_idx, threads_);
   
   // Third pass: count output cells
   // we need to skip all the same, adjacent idx values
-  unsigned int total = 0;
   unsigned int index = 0;
   // first_and_last_indices_vector[i] represents the index in index_vector of the first point in
   // index_vector belonging to the voxel which corresponds to the i-th output point,
@@ -354,15 +476,12 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
     while (i < index_vector.size () && index_vector[i].idx == index_vector[index].idx) 
       ++i;
     if (i - index >= min_points_per_voxel_)
-    {
-      ++total;
       first_and_last_indices_vector.emplace_back(index, i);
-    }
     index = i;
   }
 
   // Fourth pass: compute centroids, insert them into their final position
-  output.resize (total);
+  output.resize (first_and_last_indices_vector.size ());
   if (save_leaf_layout_)
   {
     try
@@ -389,16 +508,19 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
     }
   }
   
-  index = 0;
-  for (const auto &cp : first_and_last_indices_vector)
+  // Every output point only depends on its own range of index_vector, so they can be computed concurrently
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 256)
+  for (long int cp = 0; cp < static_cast<long int> (first_and_last_indices_vector.size ()); ++cp)
   {
     // calculate centroid - sum values from all input points, that have the same idx value in index_vector array
-  	unsigned int first_index = cp.first;
-  	unsigned int last_index = cp.second;
+    unsigned int first_index = first_and_last_indices_vector[cp].first;
+    unsigned int last_index = first_and_last_indices_vector[cp].second;
 
-    // index is centroid final position in resulting PointCloud
+    // cp is centroid final position in resulting PointCloud
     if (save_leaf_layout_)
-      leaf_layout_[index_vector[first_index].idx] = index;
+      leaf_layout_[index_vector[first_index].idx] = static_cast<int> (cp);
 
     //Limit downsampling to coords
     if (!downsample_all_data_)
@@ -409,7 +531,7 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
         centroid += (*input_)[index_vector[li].cloud_point_index].getVector4fMap ();
 
       centroid /= static_cast<float> (last_index - first_index);
-      output[index].getVector4fMap () = centroid;
+      output[cp].getVector4fMap () = centroid;
     }
     else
     {
@@ -419,10 +541,8 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
       for (unsigned int li = first_index; li < last_index; ++li)
         centroid.add ((*input_)[index_vector[li].cloud_point_index]);  
 
-      centroid.get (output[index]);
+      centroid.get (output[cp]);
     }
-     
-    ++index;
   }
   output.width = output.size ();
 }
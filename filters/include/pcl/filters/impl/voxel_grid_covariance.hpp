@@ -41,6 +41,7 @@
 #include <pcl/common/common.h>
 #include <pcl/common/point_tests.h> // for isXYZFinite
 #include <pcl/filters/voxel_grid_covariance.h>
+#include <pcl/filters/impl/voxel_grid.hpp> // for computeIndexVector, radixSortByLeafIndex
 #include <Eigen/Cholesky>
 #include <Eigen/Eigenvalues> // for SelfAdjointEigenSolver
 #include <boost/mpl/size.hpp> // for size
@@ -123,109 +124,118 @@ pcl::VoxelGridCovariance<PointT>::applyFilter (PointCloud &output)
   }
 
   // If we don't want to process the entire cloud, but rather filter points far away from the viewpoint first...
+  std::vector<pcl::PCLPointField> distance_fields;
+  int distance_idx = -1;
   if (!filter_field_name_.empty ())
   {
     // Get the distance field index
-    std::vector<pcl::PCLPointField> fields;
-    int distance_idx = pcl::getFieldIndex<PointT> (filter_field_name_, fields);
+    distance_idx = pcl::getFieldIndex<PointT> (filter_field_name_, distance_fields);
     if (distance_idx == -1)
       PCL_WARN ("[pcl::%s::applyFilter] Invalid filter field name. Index is %d.\n", getClassName ().c_str (), distance_idx);
+  }
 
-    // First pass: go over all points and insert them into the right leaf
-    for (const auto& point: *input_)
-    {
-      if (!input_->is_dense)
-        // Check if the point is invalid
-        if (!isXYZFinite (point))
-          continue;
+  // First pass: go over all points and compute the index of the leaf they fall into
+  const auto compute_entry = [&] (std::size_t index, cloud_point_index_idx &entry)
+  {
+    const PointT &point = (*input_)[index];
+    if (!input_->is_dense)
+      // Check if the point is invalid
+      if (!isXYZFinite (point))
+        return (false);
 
+    if (!filter_field_name_.empty ())
+    {
       // Get the distance value
       const std::uint8_t* pt_data = reinterpret_cast<const std::uint8_t*> (&point);
       float distance_value = 0;
-      memcpy (&distance_value, pt_data + fields[distance_idx].offset, sizeof (float));
+      memcpy (&distance_value, pt_data + distance_fields[distance_idx].offset, sizeof (float));
 
       if (filter_limit_negative_)
       {
         // Use a threshold for cutting out points which inside the interval
         if ((distance_value < filter_limit_max_) && (distance_value > filter_limit_min_))
-          continue;
+          return (false);
       }
       else
       {
         // Use a threshold for cutting out points which are too close/far away
         if ((distance_value > filter_limit_max_) || (distance_value < filter_limit_min_))
-          continue;
+          return (false);
       }
+    }
 
-      // Compute the centroid leaf index
-      const Eigen::Vector4i ijk =
-          Eigen::floor(point.getArray4fMap() * inverse_leaf_size_.array())
-              .template cast<int>();
-      // divb_mul_[3] = 0 by assignment
-      int idx = (ijk - min_b_).dot(divb_mul_);
+    // Compute the centroid leaf index
+    const Eigen::Vector4i ijk =
+        Eigen::floor(point.getArray4fMap() * inverse_leaf_size_.array())
+            .template cast<int>();
+    // divb_mul_[3] = 0 by assignment
+    int idx = (ijk - min_b_).dot(divb_mul_);
+    entry = cloud_point_index_idx (static_cast<unsigned int> (idx), static_cast<unsigned int> (index));
+    return (true);
+  };
+
+  std::vector<cloud_point_index_idx> index_vector;
+  pcl::detail::computeIndexVector (input_->size (), compute_entry, threads_, index_vector);
+
+  // Group the points by leaf. The sort is stable, so every leaf accumulates its points in input order
+  const unsigned int max_idx = static_cast<unsigned int> (div_b_[0] * div_b_[1] * div_b_[2] - 1);
+  pcl::detail::radixSortByLeafIndex (index_vector, max_idx, threads_);
+
+  // Second pass: create the leaves in increasing voxel index order, together with the range of
+  // index_vector holding their points and their position in the output cloud
+  typename LeafMap::container_type leaves;
+  std::vector<std::pair<unsigned int, unsigned int> > first_and_last_indices_vector;
+  std::vector<int> output_indices;
+  if (searchable_)
+    voxel_centroids_leaf_indices_.reserve (index_vector.size () / min_points_per_voxel_ + 1);
+  if (save_leaf_layout_)
+    leaf_layout_.resize (div_b_[0] * div_b_[1] * div_b_[2], -1);
 
-      Leaf& leaf = leaves_[idx];
-      if (leaf.nr_points == 0)
-      {
-        leaf.centroid.resize (centroid_size);
-        leaf.centroid.setZero ();
-      }
+  int cp = 0;
+  for (unsigned int first_index = 0; first_index < index_vector.size (); )
+  {
+    unsigned int last_index = first_index + 1;
+    while (last_index < index_vector.size () && index_vector[last_index].idx == index_vector[first_index].idx)
+      ++last_index;
 
-      Eigen::Vector3d pt3d = point.getVector3fMap().template cast<double>();
-      // Accumulate point sum for centroid calculation
-      leaf.mean_ += pt3d;
-      // Accumulate x*xT for single pass covariance calculation
-      leaf.cov_ += pt3d * pt3d.transpose ();
+    const unsigned int idx = index_vector[first_index].idx;
+    const int nr_points = static_cast<int> (last_index - first_index);
 
-      // Do we need to process all the fields?
-      if (!downsample_all_data_)
-      {
-        leaf.centroid.template head<3> () += point.getVector3fMap();
-      }
-      else
-      {
-        // Copy all the fields
-        Eigen::VectorXf centroid = Eigen::VectorXf::Zero (centroid_size);
-        pcl::for_each_type<FieldList> (NdCopyPointEigenFunctor<PointT> (point, centroid));
-        // ---[ RGB special case
-        if (rgba_index >= 0)
-        {
-          // Fill r/g/b data, assuming that the order is BGRA
-          const pcl::RGB& rgb = *reinterpret_cast<const RGB*> (reinterpret_cast<const char*> (&point) + rgba_index);
-          centroid[centroid_size - 4] = rgb.a;
-          centroid[centroid_size - 3] = rgb.r;
-          centroid[centroid_size - 2] = rgb.g;
-          centroid[centroid_size - 1] = rgb.b;
-        }
-        leaf.centroid += centroid;
-      }
-      ++leaf.nr_points;
+    // Only voxels with sufficient points end up in the output clouds.
+    // Points with less than the minimum points will have a can not be accuratly approximated using a normal distribution.
+    if (nr_points >= min_points_per_voxel_)
+    {
+      if (save_leaf_layout_)
+        leaf_layout_[idx] = cp;
+
+      // Stores the voxel indice for fast access searching
+      if (searchable_)
+        voxel_centroids_leaf_indices_.push_back (static_cast<int> (leaves.size ()));
+
+      output_indices.push_back (cp++);
     }
+    else
+      output_indices.push_back (-1);
+
+    leaves.emplace_back (idx, Leaf ());
+    first_and_last_indices_vector.emplace_back (first_index, last_index);
+    first_index = last_index;
   }
-  // No distance filtering, process all data
-  else
+  output.resize (cp);
+
+  // Third pass: go over all leaves and compute centroids and covariance matrices. Every leaf
+  // only depends on its own points, so they can be computed concurrently
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 64)
+  for (long int li = 0; li < static_cast<long int> (leaves.size ()); ++li)
   {
-    // First pass: go over all points and insert them into the right leaf
-    for (const auto& point: *input_)
+    Leaf& leaf = leaves[li].second;
+    leaf.centroid.setZero (centroid_size);
+
+    for (unsigned int i = first_and_last_indices_vector[li].first; i < first_and_last_indices_vector[li].second; ++i)
     {
-      if (!input_->is_dense)
-        // Check if the point is invalid
-        if (!isXYZFinite (point))
-          continue;
-
-      // Compute the centroid leaf index
-      const Eigen::Vector4i ijk =
-          Eigen::floor(point.getArray4fMap() * inverse_leaf_size_.array())
-              .template cast<int>();
-      // divb_mul_[3] = 0 by assignment
-      int idx = (ijk - min_b_).dot(divb_mul_);
-
-      Leaf& leaf = leaves_[idx];
-      if (leaf.nr_points == 0)
-      {
-        leaf.centroid.resize (centroid_size);
-        leaf.centroid.setZero ();
-      }
+      const PointT &point = (*input_)[index_vector[i].cloud_point_index];
 
       Eigen::Vector3d pt3d = point.getVector3fMap().template cast<double>();
       // Accumulate point sum for centroid calculation
@@ -257,111 +267,82 @@ pcl::VoxelGridCovariance<PointT>::applyFilter (PointCloud &output)
       }
       ++leaf.nr_points;
     }
-  }
-
-  // Second pass: go over all leaves and compute centroids and covariance matrices
-  output.reserve (leaves_.size ());
-  if (searchable_)
-    voxel_centroids_leaf_indices_.reserve (leaves_.size ());
-  int cp = 0;
-  if (save_leaf_layout_)
-    leaf_layout_.resize (div_b_[0] * div_b_[1] * div_b_[2], -1);
-
-  // Eigen values and vectors calculated to prevent near singluar matrices
-  Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigensolver;
-  Eigen::Matrix3d eigen_val;
-  Eigen::Vector3d pt_sum;
-
-  // Eigen values less than a threshold of max eigen value are inflated to a set fraction of the max eigen value.
-  double min_covar_eigvalue;
-
-  for (typename std::map<std::size_t, Leaf>::iterator it = leaves_.begin (); it != leaves_.end (); ++it)
-  {
-
-    // Normalize the centroid
-    Leaf& leaf = it->second;
 
     // Normalize the centroid
     leaf.centroid /= static_cast<float> (leaf.nr_points);
     // Point sum used for single pass covariance calculation
-    pt_sum = leaf.mean_;
+    const Eigen::Vector3d pt_sum = leaf.mean_;
     // Normalize mean
     leaf.mean_ /= leaf.nr_points;
 
     // If the voxel contains sufficient points, its covariance is calculated and is added to the voxel centroids and output clouds.
-    // Points with less than the minimum points will have a can not be accuratly approximated using a normal distribution.
-    if (leaf.nr_points >= min_points_per_voxel_)
-    {
-      if (save_leaf_layout_)
-        leaf_layout_[it->first] = cp++;
+    const int output_index = output_indices[li];
+    if (output_index < 0)
+      continue;
 
-      output.push_back (PointT ());
-
-      // Do we need to process all the fields?
-      if (!downsample_all_data_)
-      {
-        output.back ().x = leaf.centroid[0];
-        output.back ().y = leaf.centroid[1];
-        output.back ().z = leaf.centroid[2];
-      }
-      else
+    PointT &output_point = output[output_index];
+    // Do we need to process all the fields?
+    if (!downsample_all_data_)
+    {
+      output_point.x = leaf.centroid[0];
+      output_point.y = leaf.centroid[1];
+      output_point.z = leaf.centroid[2];
+    }
+    else
+    {
+      pcl::for_each_type<FieldList> (pcl::NdCopyEigenPointFunctor<PointT> (leaf.centroid, output_point));
+      // ---[ RGB special case
+      if (rgba_index >= 0)
       {
-        pcl::for_each_type<FieldList> (pcl::NdCopyEigenPointFunctor<PointT> (leaf.centroid, output.back ()));
-        // ---[ RGB special case
-        if (rgba_index >= 0)
-        {
-          pcl::RGB& rgb = *reinterpret_cast<RGB*> (reinterpret_cast<char*> (&output.back ()) + rgba_index);
-          rgb.a = leaf.centroid[centroid_size - 4];
-          rgb.r = leaf.centroid[centroid_size - 3];
-          rgb.g = leaf.centroid[centroid_size - 2];
-          rgb.b = leaf.centroid[centroid_size - 1];
-        }
+        pcl::RGB& rgb = *reinterpret_cast<RGB*> (reinterpret_cast<char*> (&output_point) + rgba_index);
+        rgb.a = leaf.centroid[centroid_size - 4];
+        rgb.r = leaf.centroid[centroid_size - 3];
+        rgb.g = leaf.centroid[centroid_size - 2];
+        rgb.b = leaf.centroid[centroid_size - 1];
       }
+    }
 
-      // Stores the voxel indice for fast access searching
-      if (searchable_)
-        voxel_centroids_leaf_indices_.push_back (static_cast<int> (it->first));
-
-      // Single pass covariance calculation
-      leaf.cov_ = (leaf.cov_ - pt_sum * leaf.mean_.transpose()) / (leaf.nr_points - 1.0);
+    // Single pass covariance calculation
+    leaf.cov_ = (leaf.cov_ - pt_sum * leaf.mean_.transpose()) / (leaf.nr_points - 1.0);
 
-      //Normalize Eigen Val such that max no more than 100x min.
-      eigensolver.compute (leaf.cov_);
-      eigen_val = eigensolver.eigenvalues ().asDiagonal ();
-      leaf.evecs_ = eigensolver.eigenvectors ();
+    //Normalize Eigen Val such that max no more than 100x min.
+    // Eigen values and vectors calculated to prevent near singluar matrices
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigensolver (leaf.cov_);
+    Eigen::Matrix3d eigen_val = eigensolver.eigenvalues ().asDiagonal ();
+    leaf.evecs_ = eigensolver.eigenvectors ();
 
-      if (eigen_val (0, 0) < 0 || eigen_val (1, 1) < 0 || eigen_val (2, 2) <= 0)
-      {
-        leaf.nr_points = -1;
-        continue;
-      }
+    if (eigen_val (0, 0) < 0 || eigen_val (1, 1) < 0 || eigen_val (2, 2) <= 0)
+    {
+      leaf.nr_points = -1;
+      continue;
+    }
 
-      // Avoids matrices near singularities (eq 6.11)[Magnusson 2009]
+    // Avoids matrices near singularities (eq 6.11)[Magnusson 2009]
+    // Eigen values less than a threshold of max eigen value are inflated to a set fraction of the max eigen value.
+    const double min_covar_eigvalue = min_covar_eigvalue_mult_ * eigen_val (2, 2);
+    if (eigen_val (0, 0) < min_covar_eigvalue)
+    {
+      eigen_val (0, 0) = min_covar_eigvalue;
 
-      min_covar_eigvalue = min_covar_eigvalue_mult_ * eigen_val (2, 2);
-      if (eigen_val (0, 0) < min_covar_eigvalue)
+      if (eigen_val (1, 1) < min_covar_eigvalue)
       {
-        eigen_val (0, 0) = min_covar_eigvalue;
-
-        if (eigen_val (1, 1) < min_covar_eigvalue)
-        {
-          eigen_val (1, 1) = min_covar_eigvalue;
-        }
-
-        leaf.cov_ = leaf.evecs_ * eigen_val * leaf.evecs_.inverse ();
+        eigen_val (1, 1) = min_covar_eigvalue;
       }
-      leaf.evals_ = eigen_val.diagonal ();
 
-      leaf.icov_ = leaf.cov_.inverse ();
-      if (leaf.icov_.maxCoeff () == std::numeric_limits<float>::infinity ( )
-          || leaf.icov_.minCoeff () == -std::numeric_limits<float>::infinity ( ) )
-      {
-        leaf.nr_points = -1;
-      }
+      leaf.cov_ = leaf.evecs_ * eigen_val * leaf.evecs_.inverse ();
+    }
+    leaf.evals_ = eigen_val.diagonal ();
 
+    leaf.icov_ = leaf.cov_.inverse ();
+    if (leaf.icov_.maxCoeff () == std::numeric_limits<float>::infinity ( )
+        || leaf.icov_.minCoeff () == -std::numeric_limits<float>::infinity ( ) )
+    {
+      leaf.nr_points = -1;
     }
   }
 
+  leaves_.assign (std::move (leaves));
+
   output.width = output.size ();
 }
 
@@ -457,7 +438,7 @@ pcl::VoxelGridCovariance<PointT>::getDisplayCloud (pcl::PointCloud<PointXYZ>& ce
   Eigen::Vector3d dist_point;
 
   // Generate points for each occupied voxel with sufficient points.
-  for (typename std::map<std::size_t, Leaf>::iterator it = leaves_.begin (); it != leaves_.end (); ++it)
+  for (auto it = leaves_.begin (); it != leaves_.end (); ++it)
   {
     Leaf& leaf = it->second;
 
@@ -204,7 +204,8 @@ namespace pcl
         filter_limit_min_ (-FLT_MAX),
         filter_limit_max_ (FLT_MAX),
         filter_limit_negative_ (false),
-        min_points_per_voxel_ (0)
+        min_points_per_voxel_ (0),
+        threads_ (1)
       {
         filter_name_ = "VoxelGrid";
       }
@@ -271,6 +272,17 @@ namespace pcl
       inline unsigned int
       getMinimumPointsNumberPerVoxel () const { return min_points_per_voxel_; }
 
+      /** \brief Set the number of threads used to bin the points and compute the centroids.
+        * The result does not depend on the number of threads.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used to bin the points and compute the centroids. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Set to true if leaf layout information needs to be saved for later access.
         * \param[in] save_leaf_layout the new value (true/false)
         */
@@ -484,6 +496,9 @@ namespace pcl
       /** \brief Minimum number of points per voxel for the centroid to be computed */
       unsigned int min_points_per_voxel_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       using FieldList = typename pcl::traits::fieldList<PointT>::type;
 
       /** \brief Downsample a Point Cloud using a voxelized grid approach
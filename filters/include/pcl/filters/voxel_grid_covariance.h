@@ -38,12 +38,139 @@
 #pragma once
 
 #include <pcl/filters/voxel_grid.h>
-#include <map>
 #include <pcl/point_types.h>
 #include <pcl/kdtree/kdtree_flann.h>
 
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
 namespace pcl
 {
+  namespace detail
+  {
+    /** \brief Flat storage for the leaves of a voxel grid.
+      *
+      * The (voxel index, leaf) pairs are stored contiguously, sorted by voxel index, and an
+      * open addressing hash table maps a voxel index to the position of its leaf. Lookups
+      * therefore take constant time and iterating over the leaves walks linear memory. The
+      * iteration interface mirrors the one of a std::map<std::size_t, LeafT>.
+      */
+    template <typename LeafT>
+    class FlatLeafMap
+    {
+      public:
+        using value_type = std::pair<std::size_t, LeafT>;
+        using container_type = std::vector<value_type>;
+        using iterator = typename container_type::iterator;
+        using const_iterator = typename container_type::const_iterator;
+
+        /** \brief Replace the content of the map and rebuild the lookup table.
+          * \param[in] leaves the (voxel index, leaf) pairs, sorted by voxel index and without duplicates
+          */
+        void
+        assign (container_type &&leaves)
+        {
+          leaves_ = std::move (leaves);
+
+          // Keep the load factor at or below 0.5 so that probe sequences stay short
+          unsigned int bits = 1;
+          while ((std::size_t (1) << bits) < 2 * leaves_.size ())
+            ++bits;
+          shift_ = 64 - bits;
+          table_.assign (std::size_t (1) << bits, Slot ());
+
+          const std::size_t mask = table_.size () - 1;
+          for (std::size_t position = 0; position < leaves_.size (); ++position)
+          {
+            std::size_t slot = hash (leaves_[position].first);
+            while (table_[slot].position != empty_slot)
+              slot = (slot + 1) & mask;
+            table_[slot].voxel_index = leaves_[position].first;
+            table_[slot].position = position;
+          }
+        }
+
+        /** \brief Remove all leaves. */
+        void
+        clear ()
+        {
+          leaves_.clear ();
+          table_.clear ();
+        }
+
+        /** \brief Find the leaf of a voxel.
+          * \param[in] voxel_index the index of the voxel in the grid
+          * \return an iterator to the (voxel index, leaf) pair, or end () if the voxel is empty
+          */
+        iterator
+        find (std::size_t voxel_index) { return (leaves_.begin () + lookup (voxel_index)); }
+
+        /** \brief Find the leaf of a voxel.
+          * \param[in] voxel_index the index of the voxel in the grid
+          * \return an iterator to the (voxel index, leaf) pair, or end () if the voxel is empty
+          */
+        const_iterator
+        find (std::size_t voxel_index) const { return (leaves_.cbegin () + lookup (voxel_index)); }
+
+        iterator begin () { return (leaves_.begin ()); }
+        iterator end () { return (leaves_.end ()); }
+        const_iterator begin () const { return (leaves_.cbegin ()); }
+        const_iterator end () const { return (leaves_.cend ()); }
+        const_iterator cbegin () const { return (leaves_.cbegin ()); }
+        const_iterator cend () const { return (leaves_.cend ()); }
+
+        /** \brief Get the number of leaves. */
+        std::size_t
+        size () const { return (leaves_.size ()); }
+
+        /** \brief Return true if there are no leaves. */
+        bool
+        empty () const { return (leaves_.empty ()); }
+
+      private:
+        static constexpr std::size_t empty_slot = std::numeric_limits<std::size_t>::max ();
+
+        struct Slot
+        {
+          std::size_t voxel_index = 0;
+          std::size_t position = empty_slot;
+        };
+
+        /** \brief Fibonacci hashing of a voxel index to a slot of the lookup table. */
+        inline std::size_t
+        hash (std::size_t voxel_index) const
+        {
+          return (static_cast<std::size_t> ((static_cast<std::uint64_t> (voxel_index) * 0x9E3779B97F4A7C15ull) >> shift_));
+        }
+
+        /** \brief Get the position of the leaf of a voxel, or size () if the voxel is empty. */
+        inline std::size_t
+        lookup (std::size_t voxel_index) const
+        {
+          if (table_.empty ())
+            return (leaves_.size ());
+          const std::size_t mask = table_.size () - 1;
+          for (std::size_t slot = hash (voxel_index); table_[slot].position != empty_slot; slot = (slot + 1) & mask)
+            if (table_[slot].voxel_index == voxel_index)
+              return (table_[slot].position);
+          return (leaves_.size ());
+        }
+
+        /** \brief The (voxel index, leaf) pairs, sorted by voxel index. */
+        container_type leaves_;
+
+        /** \brief Open addressing (linear probing) table mapping voxel indices to positions in \ref leaves_. */
+        std::vector<Slot> table_;
+
+        /** \brief Right shift turning the 64 bit hash product into a slot of \ref table_. */
+        unsigned int shift_ = 63;
+    };
+
+    template <typename LeafT> constexpr std::size_t FlatLeafMap<LeafT>::empty_slot;
+  }
+
   /** \brief A searchable voxel strucure containing the mean and covariance of the data.
     * \note For more information please see
     * <b>Magnusson, M. (2009). The Three-Dimensional Normal-Distributions Transform —
@@ -73,6 +200,7 @@ namespace pcl
       using VoxelGrid<PointT>::inverse_leaf_size_;
       using VoxelGrid<PointT>::div_b_;
       using VoxelGrid<PointT>::divb_mul_;
+      using VoxelGrid<PointT>::threads_;
 
 
       using FieldList = typename pcl::traits::fieldList<PointT>::type;
@@ -190,6 +318,9 @@ namespace pcl
       /** \brief Const pointer to VoxelGridCovariance leaf structure */
       using LeafConstPtr = const Leaf *;
 
+      /** \brief Flat map from voxel index to VoxelGridCovariance leaf structure */
+      using LeafMap = pcl::detail::FlatLeafMap<Leaf>;
+
     public:
 
       /** \brief Constructor.
@@ -298,7 +429,7 @@ namespace pcl
       inline LeafConstPtr
       getLeaf (int index)
       {
-        typename std::map<std::size_t, Leaf>::iterator leaf_iter = leaves_.find (index);
+        const auto leaf_iter = leaves_.find (index);
         if (leaf_iter != leaves_.end ())
         {
           LeafConstPtr ret (&(leaf_iter->second));
@@ -323,7 +454,7 @@ namespace pcl
         int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
 
         // Find leaf associated with index
-        typename std::map<std::size_t, Leaf>::iterator leaf_iter = leaves_.find (idx);
+        const auto leaf_iter = leaves_.find (idx);
         if (leaf_iter != leaves_.end ())
         {
           // If such a leaf exists return the pointer to the leaf structure
@@ -349,7 +480,7 @@ namespace pcl
         int idx = ijk0 * divb_mul_[0] + ijk1 * divb_mul_[1] + ijk2 * divb_mul_[2];
 
         // Find leaf associated with index
-        typename std::map<std::size_t, Leaf>::iterator leaf_iter = leaves_.find (idx);
+        const auto leaf_iter = leaves_.find (idx);
         if (leaf_iter != leaves_.end ())
         {
           // If such a leaf exists return the pointer to the leaf structure
@@ -407,9 +538,9 @@ namespace pcl
       getAllNeighborsAtPoint (const PointT& reference_point, std::vector<LeafConstPtr> &neighbors) const;
 
       /** \brief Get the leaf structure map
-       * \return a map contataining all leaves
+       * \return a map contataining all leaves, iterated in increasing voxel index order
        */
-      inline const std::map<std::size_t, Leaf>&
+      inline const LeafMap&
       getLeaves ()
       {
         return leaves_;
@@ -460,14 +591,7 @@ namespace pcl
         // Find leaves corresponding to neighbors
         k_leaves.reserve (k);
         for (const auto &k_index : k_indices)
-        {
-          auto voxel = leaves_.find(voxel_centroids_leaf_indices_[k_index]);
-          if (voxel == leaves_.end()) {
-            continue;
-          }
-
-          k_leaves.push_back(&voxel->second);
-        }
+          k_leaves.push_back (&(leaves_.begin () + voxel_centroids_leaf_indices_[k_index])->second);
         return k_leaves.size();
       }
 
@@ -519,14 +643,7 @@ namespace pcl
         // Find leaves corresponding to neighbors
         k_leaves.reserve (k);
         for (const auto &k_index : k_indices)
-        {
-          const auto voxel = leaves_.find(voxel_centroids_leaf_indices_[k_index]);
-          if(voxel == leaves_.end()) {
-            continue;
-          }
-
-          k_leaves.push_back(&voxel->second);
-        }
+          k_leaves.push_back (&(leaves_.begin () + voxel_centroids_leaf_indices_[k_index])->second);
         return k_leaves.size();
       }
 
@@ -567,12 +684,12 @@ namespace pcl
       double min_covar_eigvalue_mult_;
 
       /** \brief Voxel structure containing all leaf nodes (includes voxels with less than a sufficient number of points). */
-      std::map<std::size_t, Leaf> leaves_;
+      LeafMap leaves_;
 
       /** \brief Point cloud containing centroids of voxels containing atleast minimum number of points. */
       PointCloudPtr voxel_centroids_;
 
-      /** \brief Indices of leaf structurs associated with each point in \ref voxel_centroids_ (used for searching). */
+      /** \brief Positions in \ref leaves_ of the leaf structures associated with each point in \ref voxel_centroids_ (used for searching). */
       std::vector<int> voxel_centroids_leaf_indices_;
 
       /** \brief KdTree generated using \ref voxel_centroids_ (used for searching). */
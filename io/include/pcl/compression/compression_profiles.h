@@ -65,6 +65,13 @@ namespace pcl
       MANUAL_CONFIGURATION
     };
 
+    // entropy coder backend
+    enum entropy_Coder_e
+    {
+      STATIC_RANGE_CODER, // StaticRangeCoder, original stream format
+      RANS_CODER          // RANSCoder, faster decoding
+    };
+
     // compression configuration profile
     struct configurationProfile_t
     {
@@ -74,6 +81,7 @@ namespace pcl
       unsigned int iFrameRate;
       const unsigned char colorBitResolution;
       bool doColorEncoding;
+      entropy_Coder_e entropyCoder;
     };
 
     // predefined configuration parameters
@@ -85,7 +93,8 @@ namespace pcl
        true, /* doVoxelGridDownDownSampling = */
        50, /* iFrameRate = */
        4, /* colorBitResolution = */
-       false /* doColorEncoding = */
+       false, /* doColorEncoding = */
+       STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: LOW_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.01, /* pointResolution = */
@@ -93,7 +102,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         50, /* iFrameRate = */
         4, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_ONLINE_COMPRESSION_WITHOUT_COLOR
         0.005, /* pointResolution = */
@@ -101,7 +111,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         40, /* iFrameRate = */
         5, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.005, /* pointResolution = */
@@ -109,7 +120,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         40, /* iFrameRate = */
         5, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITHOUT_COLOR
         0.0001, /* pointResolution = */
@@ -117,7 +129,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         30, /* iFrameRate = */
         7, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_ONLINE_COMPRESSION_WITH_COLOR
         0.0001, /* pointResolution = */
@@ -125,7 +138,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         30, /* iFrameRate = */
         7, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: LOW_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.01, /* pointResolution = */
@@ -133,7 +147,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         4, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: LOW_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.01, /* pointResolution = */
@@ -141,7 +156,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         4, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.005, /* pointResolution = */
@@ -149,7 +165,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         5, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: MED_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.005, /* pointResolution = */
@@ -157,7 +174,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         5, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_OFFLINE_COMPRESSION_WITHOUT_COLOR
         0.0001, /* pointResolution = */
@@ -165,7 +183,8 @@ namespace pcl
         true, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         8, /* colorBitResolution = */
-        false /* doColorEncoding = */
+        false, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }, {
     // PROFILE: HIGH_RES_OFFLINE_COMPRESSION_WITH_COLOR
         0.0001, /* pointResolution = */
@@ -173,7 +192,8 @@ namespace pcl
         false, /* doVoxelGridDownDownSampling = */
         100, /* iFrameRate = */
         8, /* colorBitResolution = */
-        true /* doColorEncoding = */
+        true, /* doColorEncoding = */
+        STATIC_RANGE_CODER /* entropyCoder = */
     }};
 
   }
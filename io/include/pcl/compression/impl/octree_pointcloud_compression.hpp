@@ -41,7 +41,10 @@
 #include <pcl/common/io.h> // for getFieldIndex
 #include <pcl/compression/entropy_range_coder.h>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <vector>
 #include <cstring>
 
@@ -49,6 +52,13 @@ namespace pcl
 {
   namespace io
   {
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::setNumberOfThreads (unsigned int nr_threads)
+    {
+      OctreePointCloud<PointT, LeafT, BranchT, OctreeT>::setNumberOfThreads (nr_threads);
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void OctreePointCloudCompression<
         PointT, LeafT, BranchT, OctreeT>::encodePointCloud (
@@ -129,7 +139,10 @@ namespace pcl
         this->writeFrameHeader (compressed_tree_data_out_arg);
 
         // apply entropy coding to the content of all data vectors and send data to output stream
-        this->entropyEncoding (compressed_tree_data_out_arg);
+        if (useChunkedEncoding ())
+          this->entropyEncodingChunked (compressed_tree_data_out_arg);
+        else
+          this->entropyEncoding (compressed_tree_data_out_arg);
 
         // prepare for next frame
         this->switchBuffers ();
@@ -201,7 +214,17 @@ namespace pcl
       this->readFrameHeader (compressed_tree_data_in_arg);
 
       // decode data vectors from stream
-      this->entropyDecoding (compressed_tree_data_in_arg);
+      if (data_chunked_)
+      {
+        if (!this->entropyDecodingChunked (compressed_tree_data_in_arg))
+        {
+          // reject the frame
+          output_->clear ();
+          return;
+        }
+      }
+      else
+        this->entropyDecoding (compressed_tree_data_in_arg);
 
       // initialize color and point encoding
       color_coder_.initializeDecoding ();
@@ -364,12 +387,272 @@ namespace pcl
       }
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+    std::vector<typename OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::EntropyChunk>
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::getEntropyDataVectors (bool with_color)
+    {
+      std::vector<EntropyChunk> vectors;
+      const auto addCharVector = [&vectors] (std::vector<char>& data, bool point_data)
+      {
+        vectors.push_back ({&data, nullptr, 0, data.size (), std::vector<char> (), point_data});
+      };
+
+      // same order as in entropyEncoding
+      addCharVector (binary_tree_data_vector_, true);
+      if (with_color)
+        addCharVector (color_coder_.getAverageDataVector (), false);
+      if (!do_voxel_grid_enDecoding_)
+      {
+        vectors.push_back ({nullptr, &point_count_data_vector_, 0, point_count_data_vector_.size (), std::vector<char> (), true});
+        addCharVector (point_coder_.getDifferentialDataVector (), true);
+        if (with_color)
+          addCharVector (color_coder_.getDifferentialDataVector (), false);
+      }
+      return (vectors);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::entropyEncodingChunked (std::ostream& compressed_tree_data_out_arg)
+    {
+      compressed_point_data_len_ = 0;
+      compressed_color_data_len_ = 0;
+
+      // encode the entropy coder
+      const std::uint8_t entropy_coder_type = static_cast<std::uint8_t> (entropy_coder_backend_);
+      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&entropy_coder_type), sizeof (entropy_coder_type));
+
+      // split the data vectors in chunks, first_chunk[v] being the first chunk of vector v
+      // (chunks of max_chunk_size_ elements if the chunk size is not set)
+      const std::size_t chunk_size = encoding_chunk_size_ > 0 ? (std::min) (encoding_chunk_size_, max_chunk_size_) : max_chunk_size_;
+      const std::vector<EntropyChunk> vectors = getEntropyDataVectors (cloud_with_color_);
+      std::vector<EntropyChunk> chunks;
+      std::vector<std::size_t> first_chunk (vectors.size () + 1);
+      for (std::size_t v = 0; v < vectors.size (); ++v)
+      {
+        first_chunk[v] = chunks.size ();
+        for (std::size_t begin = 0; begin < vectors[v].end;)
+        {
+          EntropyChunk chunk = vectors[v];
+          chunk.begin = begin;
+          chunk.end = begin + (std::min) (chunk_size, vectors[v].end - begin);
+          chunks.push_back (chunk);
+          begin = chunk.end;
+        }
+      }
+      first_chunk.back () = chunks.size ();
+
+      // encode the chunks independently
+#pragma omp parallel for \
+  num_threads(this->threads_) \
+  schedule(dynamic, 1)
+      for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (chunks.size ()); ++c)
+      {
+        EntropyChunk& chunk = chunks[c];
+        if (entropy_coder_backend_ == RANS_CODER)
+        {
+          RANSCoder entropy_coder;
+          if (chunk.char_data)
+            entropy_coder.encode (chunk.char_data->data () + chunk.begin, chunk.end - chunk.begin, chunk.compressed_data);
+          else
+            entropy_coder.encode (chunk.int_data->data () + chunk.begin, chunk.end - chunk.begin, chunk.compressed_data);
+          continue;
+        }
+
+        StaticRangeCoder entropy_coder;
+        std::ostringstream chunk_stream;
+        if (chunk.char_data)
+        {
+          const std::vector<char> data (chunk.char_data->begin () + chunk.begin, chunk.char_data->begin () + chunk.end);
+          entropy_coder.encodeCharVectorToStream (data, chunk_stream);
+        }
+        else
+        {
+          std::vector<unsigned int> data (chunk.int_data->begin () + chunk.begin, chunk.int_data->begin () + chunk.end);
+          entropy_coder.encodeIntVectorToStream (data, chunk_stream);
+        }
+        const std::string compressed_data = chunk_stream.str ();
+        chunk.compressed_data.assign (compressed_data.begin (), compressed_data.end ());
+      }
+
+      // for each data vector: its size, its number of chunks, the number of elements and bytes of each chunk, and the chunks
+      for (std::size_t v = 0; v < vectors.size (); ++v)
+      {
+        const std::uint64_t vector_size = vectors[v].end;
+        const std::uint64_t chunk_count = first_chunk[v + 1] - first_chunk[v];
+        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&vector_size), sizeof (vector_size));
+        compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&chunk_count), sizeof (chunk_count));
+        for (std::size_t c = first_chunk[v]; c < first_chunk[v + 1]; ++c)
+        {
+          const std::uint64_t element_count = chunks[c].end - chunks[c].begin;
+          const std::uint64_t byte_count = chunks[c].compressed_data.size ();
+          compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&element_count), sizeof (element_count));
+          compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&byte_count), sizeof (byte_count));
+        }
+        for (std::size_t c = first_chunk[v]; c < first_chunk[v + 1]; ++c)
+        {
+          compressed_tree_data_out_arg.write (chunks[c].compressed_data.data (), chunks[c].compressed_data.size ());
+          if (chunks[c].point_data)
+            compressed_point_data_len_ += chunks[c].compressed_data.size ();
+          else
+            compressed_color_data_len_ += chunks[c].compressed_data.size ();
+        }
+      }
+
+      // flush output stream
+      compressed_tree_data_out_arg.flush ();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> bool
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::entropyDecodingChunked (std::istream& compressed_tree_data_in_arg)
+    {
+      compressed_point_data_len_ = 0;
+      compressed_color_data_len_ = 0;
+
+      // number of bytes left in the stream, to validate the sizes read from it
+      std::uint64_t remaining_bytes = std::numeric_limits<std::uint64_t>::max ();
+      const std::istream::pos_type position = compressed_tree_data_in_arg.tellg ();
+      if (position != std::istream::pos_type (-1))
+      {
+        compressed_tree_data_in_arg.seekg (0, std::ios::end);
+        remaining_bytes = static_cast<std::uint64_t> (compressed_tree_data_in_arg.tellg () - position);
+        compressed_tree_data_in_arg.seekg (position);
+      }
+
+      // read the entropy coder
+      std::uint8_t entropy_coder_type = 0;
+      compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&entropy_coder_type), sizeof (entropy_coder_type));
+      if (!compressed_tree_data_in_arg || entropy_coder_type > RANS_CODER)
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudCompression::entropyDecodingChunked] Unknown entropy coder!\n");
+        return (false);
+      }
+      remaining_bytes -= sizeof (entropy_coder_type);
+
+      // read the sizes of the data vectors and their chunks
+      const std::uint64_t chunk_table_entry_size = 2 * sizeof (std::uint64_t);
+      const std::vector<EntropyChunk> vectors = getEntropyDataVectors (data_with_color_);
+      std::vector<EntropyChunk> chunks;
+      for (const auto& vector : vectors)
+      {
+        std::uint64_t vector_size = 0;
+        std::uint64_t chunk_count = 0;
+        compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&vector_size), sizeof (vector_size));
+        compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&chunk_count), sizeof (chunk_count));
+        // each chunk has an entry in the stream, and holds at most max_chunk_size_ elements
+        if (!compressed_tree_data_in_arg || remaining_bytes < chunk_table_entry_size ||
+            chunk_count > (remaining_bytes - chunk_table_entry_size) / chunk_table_entry_size)
+        {
+          PCL_ERROR ("[pcl::io::OctreePointCloudCompression::entropyDecodingChunked] Invalid chunk table!\n");
+          return (false);
+        }
+        remaining_bytes -= (chunk_count + 1) * chunk_table_entry_size;
+
+        const std::size_t first_chunk = chunks.size ();
+        std::size_t begin = 0;
+        for (std::uint64_t c = 0; c < chunk_count; ++c)
+        {
+          std::uint64_t element_count = 0;
+          std::uint64_t byte_count = 0;
+          compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&element_count), sizeof (element_count));
+          compressed_tree_data_in_arg.read (reinterpret_cast<char*> (&byte_count), sizeof (byte_count));
+          if (!compressed_tree_data_in_arg || element_count > vector_size - begin ||
+              element_count > max_chunk_size_ || byte_count > remaining_bytes)
+          {
+            PCL_ERROR ("[pcl::io::OctreePointCloudCompression::entropyDecodingChunked] Invalid chunk table!\n");
+            return (false);
+          }
+          remaining_bytes -= byte_count;
+          EntropyChunk chunk = vector;
+          chunk.begin = begin;
+          chunk.end = begin + static_cast<std::size_t> (element_count);
+          chunk.compressed_data.resize (static_cast<std::size_t> (byte_count));
+          chunks.push_back (chunk);
+          begin = chunk.end;
+        }
+        if (begin != vector_size)
+        {
+          PCL_ERROR ("[pcl::io::OctreePointCloudCompression::entropyDecodingChunked] Invalid chunk table!\n");
+          return (false);
+        }
+        if (vector.char_data)
+          vector.char_data->resize (static_cast<std::size_t> (vector_size));
+        else
+          vector.int_data->resize (static_cast<std::size_t> (vector_size));
+
+        for (std::size_t c = first_chunk; c < chunks.size (); ++c)
+        {
+          compressed_tree_data_in_arg.read (chunks[c].compressed_data.data (), chunks[c].compressed_data.size ());
+          if (chunks[c].point_data)
+            compressed_point_data_len_ += chunks[c].compressed_data.size ();
+          else
+            compressed_color_data_len_ += chunks[c].compressed_data.size ();
+        }
+        if (!compressed_tree_data_in_arg)
+        {
+          PCL_ERROR ("[pcl::io::OctreePointCloudCompression::entropyDecodingChunked] Truncated entropy coded data!\n");
+          return (false);
+        }
+      }
+
+      // decode the chunks independently, in place
+      bool valid = true;
+#pragma omp parallel for \
+  num_threads(this->threads_) \
+  schedule(dynamic, 1) \
+  reduction(&&:valid)
+      for (std::ptrdiff_t c = 0; c < static_cast<std::ptrdiff_t> (chunks.size ()); ++c)
+      {
+        const EntropyChunk& chunk = chunks[c];
+        if (entropy_coder_type == RANS_CODER)
+        {
+          RANSCoder entropy_coder;
+          std::size_t read_bytes;
+          if (chunk.char_data)
+            read_bytes = entropy_coder.decode (chunk.compressed_data.data (), chunk.compressed_data.size (),
+                                               chunk.char_data->data () + chunk.begin, chunk.end - chunk.begin);
+          else
+            read_bytes = entropy_coder.decode (chunk.compressed_data.data (), chunk.compressed_data.size (),
+                                               chunk.int_data->data () + chunk.begin, chunk.end - chunk.begin);
+          valid = valid && (read_bytes == chunk.compressed_data.size ());
+          continue;
+        }
+
+        StaticRangeCoder entropy_coder;
+        std::istringstream chunk_stream (std::string (chunk.compressed_data.begin (), chunk.compressed_data.end ()));
+        if (chunk.char_data)
+        {
+          std::vector<char> data (chunk.end - chunk.begin);
+          entropy_coder.decodeStreamToCharVector (chunk_stream, data);
+          std::copy (data.begin (), data.end (), chunk.char_data->begin () + chunk.begin);
+        }
+        else
+        {
+          std::vector<unsigned int> data (chunk.end - chunk.begin);
+          entropy_coder.decodeStreamToIntVector (chunk_stream, data);
+          std::copy (data.begin (), data.end (), chunk.int_data->begin () + chunk.begin);
+        }
+      }
+
+      if (!valid)
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudCompression::entropyDecodingChunked] Invalid entropy coded data!\n");
+        return (false);
+      }
+
+      point_count_data_vector_iterator_ = point_count_data_vector_.begin ();
+      return (true);
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::writeFrameHeader (std::ostream& compressed_tree_data_out_arg)
     {
       // encode header identifier
-      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (frame_header_identifier_), strlen (frame_header_identifier_));
+      const char* header_identifier = useChunkedEncoding () ? chunked_frame_header_identifier_ : frame_header_identifier_;
+      compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (header_identifier), strlen (header_identifier));
       // encode point cloud header id
       compressed_tree_data_out_arg.write (reinterpret_cast<const char*> (&frame_ID_), sizeof (frame_ID_));
       // encode frame type (I/P-frame)
@@ -415,14 +698,27 @@ namespace pcl
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::syncToHeader ( std::istream& compressed_tree_data_in_arg)
     {
-      // sync to frame header
-      unsigned int header_id_pos = 0;
-      while (header_id_pos < strlen (frame_header_identifier_))
+      // sync to frame header: read until the last characters are one of the identifiers
+      const std::string identifier (frame_header_identifier_);
+      const std::string chunked_identifier (chunked_frame_header_identifier_);
+      std::string last_chars;
+      char readChar;
+      while (compressed_tree_data_in_arg.read (static_cast<char*> (&readChar), sizeof (readChar)))
       {
-        char readChar;
-        compressed_tree_data_in_arg.read (static_cast<char*> (&readChar), sizeof (readChar));
-        if (readChar != frame_header_identifier_[header_id_pos++])
-          header_id_pos = (frame_header_identifier_[0]==readChar)?1:0;
+        last_chars.push_back (readChar);
+        if (last_chars.size () > (std::max) (identifier.size (), chunked_identifier.size ()))
+          last_chars.erase (0, 1);
+
+        const auto endsWith = [&last_chars] (const std::string& suffix)
+        {
+          return (last_chars.size () >= suffix.size () &&
+                  last_chars.compare (last_chars.size () - suffix.size (), suffix.size (), suffix) == 0);
+        };
+        if (endsWith (identifier) || endsWith (chunked_identifier))
+        {
+          data_chunked_ = endsWith (chunked_identifier);
+          break;
+        }
       }
     }
 
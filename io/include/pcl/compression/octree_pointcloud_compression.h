@@ -40,11 +40,13 @@
 #include <pcl/octree/octree2buf_base.h>
 #include <pcl/octree/octree_pointcloud.h>
 #include "entropy_range_coder.h"
+#include "rans_coder.h"
 #include "color_coding.h"
 #include "point_coding.h"
 
 #include "compression_profiles.h"
 
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
@@ -56,6 +58,12 @@ namespace pcl
   {
     /** \brief @b Octree pointcloud compression class
      *  \note This class enables compression and decompression of point cloud data based on octree data structures.
+     *  \note With \ref setEncodingChunkSize, the entropy coded data is split in independent chunks, which are
+     *  encoded and decoded in parallel (see \ref setNumberOfThreads). As the data is serialized in depth-first
+     *  order, each chunk covers a contiguous range of voxels, i.e. a set of neighboring subtrees. The decoder
+     *  detects the chunked frames by their header and needs no configuration.
+     *  \note The entropy coder is selected by the compression profile (see \ref entropy_Coder_e). Frames coded
+     *  with \ref RANSCoder are always chunked frames.
      *  \note
      *  \note typename: PointT: type of point used in pointcloud
      *  \author Julius Kammerl (julius@kammerl.de)
@@ -92,6 +100,7 @@ namespace pcl
           * \param doColorEncoding_arg:  enable/disable color coding
           * \param colorBitResolution_arg:  color bit depth
           * \param showStatistics_arg:  output compression statistics
+          * \param entropyCoder_arg:  entropy coder backend
           */
         OctreePointCloudCompression (compression_Profiles_e compressionProfile_arg = MED_RES_ONLINE_COMPRESSION_WITH_COLOR,
                                bool showStatistics_arg = false,
@@ -100,7 +109,8 @@ namespace pcl
                                bool doVoxelGridDownDownSampling_arg = false,
                                const unsigned int iFrameRate_arg = 30,
                                bool doColorEncoding_arg = true,
-                               const unsigned char colorBitResolution_arg = 6) :
+                               const unsigned char colorBitResolution_arg = 6,
+                               entropy_Coder_e entropyCoder_arg = STATIC_RANGE_CODER) :
           OctreePointCloud<PointT, LeafT, BranchT, OctreeT> (octreeResolution_arg),
           output_ (PointCloudPtr ()),
           color_coder_ (),
@@ -112,7 +122,8 @@ namespace pcl
           compressed_point_data_len_ (), compressed_color_data_len_ (), selected_profile_(compressionProfile_arg),
           point_resolution_(pointResolution_arg), octree_resolution_(octreeResolution_arg),
           color_bit_resolution_(colorBitResolution_arg),
-          object_count_(0)
+          object_count_(0), encoding_chunk_size_ (0), data_chunked_ (false),
+          entropy_coder_backend_ (entropyCoder_arg)
         {
           initialization();
         }
@@ -139,6 +150,7 @@ namespace pcl
             point_coder_.setPrecision (static_cast<float> (selectedProfile.pointResolution));
             do_color_encoding_ = selectedProfile.doColorEncoding;
             color_coder_.setBitDepth (selectedProfile.colorBitResolution);
+            entropy_coder_backend_ = selectedProfile.entropyCoder;
 
           }
           else 
@@ -154,14 +166,15 @@ namespace pcl
 
         }
 
-        /** \brief Add point at index from input pointcloud dataset to octree
+        /** \brief Add a point to the container of the leaf node of its voxel
+         * \param[in] leaf_container_arg the container of the leaf node
          * \param[in] pointIdx_arg the index representing the point in the dataset given by \a setInputCloud to be added
          */
         void
-        addPointIdx (const uindex_t pointIdx_arg) override
+        addPointIdxToLeaf (LeafT& leaf_container_arg, const uindex_t pointIdx_arg) override
         {
           ++object_count_;
-          OctreePointCloud<PointT, LeafT, BranchT, OctreeT>::addPointIdx(pointIdx_arg);
+          OctreePointCloud<PointT, LeafT, BranchT, OctreeT>::addPointIdxToLeaf (leaf_container_arg, pointIdx_arg);
         }
 
         /** \brief Provide a pointer to the output data set.
@@ -185,6 +198,32 @@ namespace pcl
           return (output_);
         }
 
+        /** \brief Set the maximum number of elements of the chunks of entropy coded data.
+          * Smaller chunks allow more parallelism, at the cost of a slightly lower compression ratio.
+          * \param[in] chunk_size the number of elements per chunk, at most 2^20. 0 (default) to encode
+          * each data vector in one piece, with the original stream format, except with the rANS coder
+          * whose frames use chunks of 2^20 elements
+          */
+        inline void
+        setEncodingChunkSize (std::size_t chunk_size)
+        {
+          encoding_chunk_size_ = chunk_size;
+        }
+
+        /** \brief Get the maximum number of elements of the chunks of entropy coded data (0 if disabled). */
+        inline std::size_t
+        getEncodingChunkSize () const
+        {
+          return (encoding_chunk_size_);
+        }
+
+        /** \brief Initialize the scheduler and set the number of threads to use to encode and
+          * decode the chunks of entropy coded data, and to build the octree of the encoded clouds.
+          * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        void
+        setNumberOfThreads (unsigned int nr_threads = 0);
+
         /** \brief Encode point cloud to output stream
           * \param cloud_arg:  point cloud to be compressed
           * \param compressed_tree_data_out_arg:  binary output stream containing compressed data
@@ -195,6 +234,7 @@ namespace pcl
         /** \brief Decode point cloud from input stream
           * \param compressed_tree_data_in_arg: binary input stream containing compressed data
           * \param cloud_arg: reference to decoded point cloud
+          * \note If a chunked frame is truncated or invalid, the decoded point cloud is empty.
           */
         void
         decodePointCloud (std::istream& compressed_tree_data_in_arg, PointCloudPtr &cloud_arg);
@@ -213,7 +253,7 @@ namespace pcl
         void
         readFrameHeader (std::istream& compressed_tree_data_in_arg);
 
-        /** \brief Synchronize to frame header
+        /** \brief Synchronize to frame header, original or chunked (see \ref data_chunked_)
           * \param compressed_tree_data_in_arg: binary input stream
           */
         void
@@ -231,6 +271,50 @@ namespace pcl
         void
         entropyDecoding (std::istream& compressed_tree_data_in_arg);
 
+        /** \brief Whether the frames are encoded as chunked frames. */
+        inline bool
+        useChunkedEncoding () const
+        {
+          return (encoding_chunk_size_ > 0 || entropy_coder_backend_ != STATIC_RANGE_CODER);
+        }
+
+        /** \brief A chunk of one of the data vectors, entropy coded independently of the others. */
+        struct EntropyChunk
+        {
+          /** \brief The data vector the chunk belongs to: one of the two is set. */
+          std::vector<char>* char_data;
+          std::vector<unsigned int>* int_data;
+
+          /** \brief The range of elements of the data vector. */
+          std::size_t begin;
+          std::size_t end;
+
+          /** \brief The entropy coded elements. */
+          std::vector<char> compressed_data;
+
+          /** \brief Whether the data is counted as point (or color) data in the statistics. */
+          bool point_data;
+        };
+
+        /** \brief Get the data vectors to entropy code, in stream order, as chunks covering the whole vectors.
+          * \param[in] with_color whether the color vectors are part of the stream
+          */
+        std::vector<EntropyChunk>
+        getEntropyDataVectors (bool with_color);
+
+        /** \brief Apply chunked entropy encoding to the information vectors, in parallel, and output to binary stream
+          * \param compressed_tree_data_out_arg: binary output stream
+          */
+        void
+        entropyEncodingChunked (std::ostream& compressed_tree_data_out_arg);
+
+        /** \brief Chunked entropy decoding of input binary stream, in parallel, and output to information vectors
+          * \param compressed_tree_data_in_arg: binary input stream
+          * \return false if the stream is truncated or invalid
+          */
+        bool
+        entropyDecodingChunked (std::istream& compressed_tree_data_in_arg);
+
         /** \brief Encode leaf node information during serialization
           * \param leaf_arg: reference to new leaf node
           * \param key_arg: octree key of new leaf node
@@ -294,11 +378,33 @@ namespace pcl
 
         std::size_t object_count_;
 
+        /** \brief The maximum number of elements per entropy coded chunk (0 if disabled). */
+        std::size_t encoding_chunk_size_;
+
+        /** \brief Whether the frame being decoded is chunked. */
+        bool data_chunked_;
+
+        // frame header identifier of the chunked frames
+        static const char* chunked_frame_header_identifier_;
+
+        /** \brief The maximum number of elements per entropy coded chunk, which bounds the memory
+          * allocated by the decoder to the length of the stream. */
+        static const std::size_t max_chunk_size_;
+
+        /** \brief The entropy coder of the chunked frames. */
+        entropy_Coder_e entropy_coder_backend_;
+
       };
 
     // define frame identifier
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
       const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::frame_header_identifier_ = "<PCL-OCT-COMPRESSED>";
+
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+      const char* OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::chunked_frame_header_identifier_ = "<PCL-OCT-CHUNKED>";
+
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT>
+      const std::size_t OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::max_chunk_size_ = std::size_t (1) << 20;
   }
 
 }
@@ -0,0 +1,97 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief @b RANSCoder compression class
+    * \note This class provides static range asymmetric numeral systems (rANS) coding of byte
+    * and integer buffers. Like \ref StaticRangeCoder, the symbol frequencies are computed
+    * beforehand and stored with the compressed data, for a similar compression ratio.
+    * \note The data is coded with four interleaved rANS states, and the decoder is table
+    * driven, which makes decoding several times faster than with the range coders.
+    * \ingroup io
+    */
+  class PCL_EXPORTS RANSCoder
+  {
+    public:
+      /** \brief Encode a byte buffer, appending the compressed data to a vector.
+        * \param[in] input the bytes to encode
+        * \param[in] size the number of bytes to encode
+        * \param[out] output the vector the compressed data is appended to
+        * \return the number of bytes appended to \a output
+        */
+      std::size_t
+      encode (const char* input, std::size_t size, std::vector<char>& output) const;
+
+      /** \brief Encode an integer buffer, appending the compressed data to a vector.
+        * \param[in] input the integers to encode
+        * \param[in] size the number of integers to encode
+        * \param[out] output the vector the compressed data is appended to
+        * \return the number of bytes appended to \a output
+        */
+      std::size_t
+      encode (const unsigned int* input, std::size_t size, std::vector<char>& output) const;
+
+      /** \brief Decode a byte buffer.
+        * \param[in] input the compressed data
+        * \param[in] input_size the number of bytes available in \a input
+        * \param[out] output the decoded bytes
+        * \param[in] size the number of bytes to decode, as given to \ref encode
+        * \return the number of bytes read from \a input, 0 if the compressed data is invalid
+        */
+      std::size_t
+      decode (const char* input, std::size_t input_size, char* output, std::size_t size) const;
+
+      /** \brief Decode an integer buffer.
+        * \param[in] input the compressed data
+        * \param[in] input_size the number of bytes available in \a input
+        * \param[out] output the decoded integers
+        * \param[in] size the number of integers to decode, as given to \ref encode
+        * \return the number of bytes read from \a input, 0 if the compressed data is invalid
+        */
+      std::size_t
+      decode (const char* input, std::size_t input_size, unsigned int* output, std::size_t size) const;
+  };
+}
@@ -41,10 +41,12 @@
 #define PCL_IO_PCD_IO_IMPL_H_
 
 #include <boost/algorithm/string/trim.hpp> // for trim
+#include <algorithm> // for find_if
 #include <fstream>
 #include <fcntl.h>
 #include <string>
 #include <cstdlib>
+#include <cstring> // for memcpy
 #include <pcl/common/io.h> // for getFields, ...
 #include <pcl/console/print.h>
 #include <pcl/io/low_level_io.h>
@@ -52,6 +54,84 @@
 
 #include <pcl/io/lzf.h>
 
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Check whether points with the given fields and point step have the same
+      * memory layout as PointT, i.e. can be used as PointT without conversion. */
+    template <typename PointT> bool
+    hasPointLayout (const std::vector<pcl::PCLPointField> &fields, uindex_t point_step)
+    {
+      if (point_step != sizeof (PointT))
+        return (false);
+      for (const auto &point_field : pcl::getFields<PointT> ())
+      {
+        const auto field = std::find_if (fields.cbegin (), fields.cend (), [&point_field] (const pcl::PCLPointField &field)
+        {
+          return (field.name == point_field.name);
+        });
+        if (field == fields.cend () ||
+            field->offset != point_field.offset ||
+            field->datatype != point_field.datatype ||
+            field->count != point_field.count)
+          return (false);
+      }
+      return (true);
+    }
+  }
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::PCDReader::readView (const std::string &file_name, pcl::PointCloudView<PointT> &view, const int offset)
+{
+  pcl::PCLPointCloud2 blob;
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  int pcd_version;
+  std::shared_ptr<const void> mapping;
+  const std::uint8_t *data = nullptr;
+  int res = mapBinary (file_name, blob, origin, orientation, pcd_version, mapping, data, offset);
+  if (res == -1)
+    return (res);
+
+  if (res == 0 && pcl::detail::hasPointLayout<PointT> (blob.fields, blob.point_step))
+  {
+    if (reinterpret_cast<std::uintptr_t> (data) % alignof (PointT) == 0)
+    {
+      view = pcl::PointCloudView<PointT> (std::move (mapping), reinterpret_cast<const PointT*> (data),
+                                          blob.width, blob.height, true);
+    }
+    else
+    {
+      // The points have the right layout but are misaligned: a single copy is enough
+      PCL_DEBUG ("[pcl::PCDReader::readView] The points of %s are not aligned for the point type, copying them.\n", file_name.c_str ());
+      auto cloud = pcl::make_shared<pcl::PointCloud<PointT> > ();
+      cloud->resize (static_cast<std::size_t> (blob.width) * blob.height);
+      memcpy (static_cast<void*> (cloud->data ()), data, cloud->size () * sizeof (PointT));
+      view = pcl::PointCloudView<PointT> (cloud, cloud->data (), blob.width, blob.height);
+    }
+  }
+  else
+  {
+    // Fall back to reading and converting the whole file
+    mapping.reset ();
+    auto cloud = pcl::make_shared<pcl::PointCloud<PointT> > ();
+    res = read (file_name, *cloud, offset);
+    if (res < 0)
+      return (res);
+    view = pcl::PointCloudView<PointT> (cloud, cloud->data (), cloud->width, cloud->height);
+    view.is_dense = cloud->is_dense;
+    origin = cloud->sensor_origin_;
+    orientation = cloud->sensor_orientation_;
+  }
+
+  view.sensor_origin_ = origin;
+  view.sensor_orientation_ = orientation;
+  return (0);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> std::string
 pcl::PCDWriter::generateHeader (const pcl::PointCloud<PointT> &cloud, const int nr_points)
@@ -118,7 +198,8 @@ pcl::PCDWriter::writeBinary (const std::string &file_name,
   }
   int data_idx = 0;
   std::ostringstream oss;
-  oss << generateHeader<PointT> (cloud) << "DATA binary\n";
+  oss << generateHeader<PointT> (cloud);
+  oss << generateBinaryDataLine (static_cast<std::size_t> (oss.tellp ()));
   oss.flush ();
   data_idx = static_cast<int> (oss.tellp ());
 
@@ -595,7 +676,8 @@ pcl::PCDWriter::writeBinary (const std::string &file_name,
   }
   int data_idx = 0;
   std::ostringstream oss;
-  oss << generateHeader<PointT> (cloud, static_cast<int> (indices.size ())) << "DATA binary\n";
+  oss << generateHeader<PointT> (cloud, static_cast<int> (indices.size ()));
+  oss << generateBinaryDataLine (static_cast<std::size_t> (oss.tellp ()));
   oss.flush ();
   data_idx = static_cast<int> (oss.tellp ());
 
@@ -43,6 +43,8 @@
 #include <pcl/pcl_macros.h>
 #include <pcl/point_cloud.h>
 #include <pcl/io/file_io.h>
+#include <pcl/io/point_cloud_view.h>
+#include <algorithm> // for max
 #include <boost/interprocess/sync/file_lock.hpp> // for file_lock
 
 namespace pcl
@@ -55,10 +57,21 @@ namespace pcl
   {
     public:
       /** Empty constructor */
-      PCDReader () {}
+      PCDReader () : threads_ (1) {}
       /** Empty destructor */
       ~PCDReader () {}
 
+      /** \brief Set the number of threads used to decompress files stored in chunks
+        * (see \ref PCDWriter::writeBinaryCompressedChunked). Default: 1
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used to decompress files stored in chunks. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
       /** \brief Various PCD file versions.
         *
         * PCD_V6 represents PCD files with version 0.6, which contain the following fields:
@@ -102,7 +115,8 @@ namespace pcl
         * \param[out] origin the sensor acquisition origin (only for > PCD_V7 - null if not present)
         * \param[out] orientation the sensor acquisition orientation (only for > PCD_V7 - identity if not present)
         * \param[out] pcd_version the PCD version of the file (i.e., PCD_V6, PCD_V7)
-        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed)
+        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed,
+        * 3 = Binary compressed in chunks)
         * \param[out] data_idx the offset of cloud data within the file
         *
         * \return
@@ -114,6 +128,33 @@ namespace pcl
                   Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version,
                   int &data_type, unsigned int &data_idx);
 
+      /** \brief Read a point cloud data header from a PCD-formatted, binary istream,
+        * without allocating the data.
+        *
+        * Same as \ref readHeader, but cloud.data is left untouched and the number of
+        * points is returned instead, e.g. to read the points in batches.
+        *
+        * \param[in] binary_istream a std::istream with openmode set to std::ios::binary.
+        * \param[out] cloud the resultant point cloud dataset (only these
+        *             members will be filled: width, height, point_step,
+        *             row_step, fields[])
+        * \param[out] origin the sensor acquisition origin (only for > PCD_V7 - null if not present)
+        * \param[out] orientation the sensor acquisition orientation (only for > PCD_V7 - identity if not present)
+        * \param[out] pcd_version the PCD version of the file (i.e., PCD_V6, PCD_V7)
+        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed,
+        * 3 = Binary compressed in chunks)
+        * \param[out] data_idx the offset of cloud data within the file
+        * \param[out] nr_points the number of points in the file
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      parseHeader (std::istream &binary_istream, pcl::PCLPointCloud2 &cloud,
+                   Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version,
+                   int &data_type, unsigned int &data_idx, std::size_t &nr_points);
+
       /** \brief Read a point cloud data header from a PCD file.
         *
         * Load only the meta information (number of points, their types, etc),
@@ -130,7 +171,8 @@ namespace pcl
         * \param[out] origin the sensor acquisition origin (only for > PCD_V7 - null if not present)
         * \param[out] orientation the sensor acquisition orientation (only for > PCD_V7 - identity if not present)
         * \param[out] pcd_version the PCD version of the file (i.e., PCD_V6, PCD_V7)
-        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed)
+        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed,
+        * 3 = Binary compressed in chunks)
         * \param[out] data_idx the offset of cloud data within the file
         * \param[in] offset the offset of where to expect the PCD Header in the
         * file (optional parameter). One usage example for setting the offset
@@ -215,6 +257,30 @@ namespace pcl
       readBodyBinary (const unsigned char *data, pcl::PCLPointCloud2 &cloud,
                        int pcd_version, bool compressed, unsigned int data_idx);
 
+      /** \brief Read a range of points of a chunked compressed PCD body from a block of
+        * memory. For use after readHeader(), when the resulting data_type == 3.
+        *
+        * Only the chunks overlapping the range are decompressed, in parallel (see
+        * \ref setNumberOfThreads).
+        *
+        * \param[in] data the memory location from which to read the body.
+        * \param[in] data_size the size of the memory block, used to validate the chunk table.
+        * \param[out] cloud the resultant point cloud dataset to be filled. Its fields and
+        * point_step are the ones set by readHeader(), and it is resized to hold the points
+        * in [\a begin, \a end).
+        * \param[in] data_idx the offset of the body, as reported by readHeader().
+        * \param[in] begin the index of the first point to read
+        * \param[in] end the index after the last point to read
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      readBodyBinaryChunked (const unsigned char *data, std::size_t data_size,
+                             pcl::PCLPointCloud2 &cloud, unsigned int data_idx,
+                             uindex_t begin, uindex_t end);
+
       /** \brief Read a point cloud data from a PCD file and store it into a pcl/PCLPointCloud2.
         * \param[in] file_name the name of the file containing the actual PointCloud data
         * \param[out] cloud the resultant PointCloud message read from disk
@@ -287,6 +353,102 @@ namespace pcl
         return (res);
       }
 
+      /** \brief Map the body of an uncompressed binary PCD file in memory (read-only),
+        * without copying it.
+        * \param[in] file_name the name of the file containing the actual PointCloud data
+        * \param[out] cloud the header of the file. The data of the cloud is left empty.
+        * \param[out] origin the sensor acquisition origin (only for > PCD_V7 - null if not present)
+        * \param[out] orientation the sensor acquisition orientation (only for > PCD_V7 - identity if not present)
+        * \param[out] pcd_version the PCD version of the file (either PCD_V6 or PCD_V7)
+        * \param[out] mapping the mapping of the file, unmapped when its last copy is destroyed
+        * \param[out] data pointer to the first point in the mapping, with the layout given by \a cloud
+        * \param[in] offset the offset of where to expect the PCD Header in the
+        * file (optional parameter)
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * < 0 (-2) if the file is not stored as uncompressed binary data
+        *  * == 0 on success
+        */
+      int
+      mapBinary (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                 Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version,
+                 std::shared_ptr<const void> &mapping, const std::uint8_t *&data,
+                 const int offset = 0);
+
+      /** \brief Read a point cloud data from any PCD file into a read-only view.
+        *
+        * If the file is stored as uncompressed binary data with exactly the memory layout
+        * of PointT, including its padding (as written by \ref PCDWriter::writeBinary from
+        * the output of \ref pcl::toPCLPointCloud2 for the same point type), the view
+        * points directly into a memory mapping of the file: loading is almost
+        * instant, pages are only read when accessed and are shared between processes
+        * mapping the same file. The mapping lives as long as the view (or a copy of it).
+        *
+        * Otherwise, the file is read and converted like in \ref read, and the view owns
+        * the resulting points. If the points have the layout of PointT but are not
+        * suitably aligned for it, they are copied once. \ref PCDWriter pads the header of
+        * binary files so that the points start at a multiple of 64 bytes, hence this only
+        * happens for files written by other tools or read at an offset.
+        * \ref PointCloudView::isMapped tells which case applies.
+        *
+        * \param[in] file_name the name of the file containing the actual PointCloud data
+        * \param[out] view the resultant view on the points of the file
+        * \param[in] offset the offset of where to expect the PCD Header in the
+        * file (optional parameter)
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      template<typename PointT> int
+      readView (const std::string &file_name, pcl::PointCloudView<PointT> &view, const int offset = 0);
+
+      /** \brief Read the points [\a begin, \a end) of a PCD file into a pcl/PCLPointCloud2.
+        *
+        * For files stored in chunks (see \ref PCDWriter::writeBinaryCompressedChunked)
+        * only the chunks overlapping the range are decompressed, and for uncompressed
+        * binary files only the range is read. Other files are read entirely.
+        * \param[in] file_name the name of the file containing the actual PointCloud data
+        * \param[out] cloud the resultant point cloud, unorganized (height = 1)
+        * \param[in] begin the index of the first point to read
+        * \param[in] end the index after the last point to read, clamped to the number of points
+        * \param[in] offset the offset of where to expect the PCD Header in the
+        * file (optional parameter)
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      readRange (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                 uindex_t begin, uindex_t end, const int offset = 0);
+
+      /** \brief Read the points [\a begin, \a end) of a PCD file into a pcl::PointCloud.
+        * \param[in] file_name the name of the file containing the actual PointCloud data
+        * \param[out] cloud the resultant point cloud, unorganized (height = 1)
+        * \param[in] begin the index of the first point to read
+        * \param[in] end the index after the last point to read, clamped to the number of points
+        * \param[in] offset the offset of where to expect the PCD Header in the
+        * file (optional parameter)
+        */
+      template<typename PointT> int
+      readRange (const std::string &file_name, pcl::PointCloud<PointT> &cloud,
+                 uindex_t begin, uindex_t end, const int offset = 0)
+      {
+        pcl::PCLPointCloud2 blob;
+        int res = readRange (file_name, blob, begin, end, offset);
+        if (res < 0)
+          return (res);
+        pcl::fromPCLPointCloud2 (blob, cloud);
+        return (0);
+      }
+
+    private:
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+    public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
 
@@ -297,9 +459,38 @@ namespace pcl
   class PCL_EXPORTS PCDWriter : public FileWriter
   {
     public:
-      PCDWriter() : map_synchronization_(false) {}
+      PCDWriter() : map_synchronization_(false), chunk_size_(65536), threads_(1) {}
       ~PCDWriter() {}
 
+      /** \brief Set the number of threads used to compress the chunks of
+        * \ref writeBinaryCompressedChunked. Default: 1
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads used to compress the chunks. */
+      inline unsigned int
+      getNumberOfThreads () const { return (threads_); }
+
+      /** \brief Set the number of points per chunk written by \ref writeBinaryCompressedChunked.
+        * Smaller chunks allow more parallelism and finer random access, at the cost of
+        * a slightly worse compression ratio. Default: 65536
+        * \param[in] chunk_size the number of points per chunk (at least 1)
+        */
+      void
+      setChunkSize (uindex_t chunk_size)
+      {
+        chunk_size_ = std::max<uindex_t> (chunk_size, 1);
+      }
+
+      /** \brief Get the number of points per chunk written by \ref writeBinaryCompressedChunked. */
+      uindex_t
+      getChunkSize () const
+      {
+        return (chunk_size_);
+      }
+
       /** \brief Set whether mmap() synchornization via msync() is desired before munmap() calls.
         * Setting this to true could prevent NFS data loss (see
         * http://www.pcl-developers.org/PCD-IO-consistency-on-NFS-msync-needed-td4885942.html).
@@ -324,6 +515,14 @@ namespace pcl
                             const Eigen::Vector4f &origin,
                             const Eigen::Quaternionf &orientation);
 
+      /** \brief Generate the DATA line of a BINARY PCD file, preceded by a comment line that
+        * pads the header so that the points start at a multiple of 64 bytes. The points can
+        * then be memory-mapped without a copy (see \ref PCDReader::readView).
+        * \param[in] header_size the size in bytes of the header written before the DATA line
+        */
+      static std::string
+      generateBinaryDataLine (std::size_t header_size);
+
       /** \brief Generate the header of a BINARY_COMPRESSED PCD file format
         * \param[out] os the stream into which to write the header
         * \param[in] cloud the point cloud data message
@@ -432,6 +631,47 @@ namespace pcl
                              const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
                              const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
 
+      /** \brief Save point cloud data to a PCD file containing n-D points, in
+        * BINARY_COMPRESSED_CHUNKED format.
+        *
+        * The points are split in chunks of \ref getChunkSize points, which are transposed
+        * and compressed like in \ref writeBinaryCompressed, but independently of each
+        * other and in parallel (see \ref setNumberOfThreads). The body starts with a
+        * table of the position and size of each chunk, so that they can be decompressed
+        * in parallel and ranges of points can be read without decompressing the whole
+        * file (see \ref PCDReader::readRange). The body is stored in the byte order of
+        * the writer, like the other binary formats.
+        *
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        * \return
+        * (-1) for a general error
+        * (-2) if a chunk is too large for the file format
+        * 0 on success
+        */
+      int
+      writeBinaryCompressedChunked (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+                                    const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
+                                    const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
+      /** \brief Save point cloud data to a std::ostream containing n-D points, in
+        * BINARY_COMPRESSED_CHUNKED format (see \ref writeBinaryCompressedChunked).
+        * \param[out] os the stream into which to write the data
+        * \param[in] cloud the point cloud data message
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        * \return
+        * (-1) for a general error
+        * (-2) if a chunk is too large for the file format
+        * 0 on success
+        */
+      int
+      writeBinaryCompressedChunked (std::ostream &os, const pcl::PCLPointCloud2 &cloud,
+                                    const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
+                                    const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
       /** \brief Save point cloud data to a PCD file containing n-D points
         * \param[in] file_name the output file name
         * \param[in] cloud the point cloud data message
@@ -504,6 +744,24 @@ namespace pcl
       writeBinaryCompressed (const std::string &file_name,
                              const pcl::PointCloud<PointT> &cloud);
 
+      /** \brief Save point cloud data to a PCD file in BINARY_COMPRESSED_CHUNKED format
+        * (see \ref writeBinaryCompressedChunked).
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        * \return
+        * (-1) for a general error
+        * (-2) if a chunk is too large for the file format
+        * 0 on success
+        */
+      template <typename PointT> int
+      writeBinaryCompressedChunked (const std::string &file_name,
+                                    const pcl::PointCloud<PointT> &cloud)
+      {
+        pcl::PCLPointCloud2 blob;
+        pcl::toPCLPointCloud2 (cloud, blob);
+        return (writeBinaryCompressedChunked (file_name, blob, cloud.sensor_origin_, cloud.sensor_orientation_));
+      }
+
       /** \brief Save point cloud data to a PCD file containing n-D points, in BINARY format
         * \param[in] file_name the output file name
         * \param[in] cloud the point cloud data message
@@ -604,6 +862,12 @@ namespace pcl
     private:
       /** \brief Set to true if msync() should be called before munmap(). Prevents data loss on NFS systems. */
       bool map_synchronization_;
+
+      /** \brief The number of points per chunk of the chunked compressed format. */
+      uindex_t chunk_size_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
   };
 
   namespace io
@@ -653,6 +917,19 @@ namespace pcl
       return (p.read (file_name, cloud));
     }
 
+    /** \brief Load a PCD file into a read-only view, memory mapping the file when its
+      * layout allows it (see \ref PCDReader::readView).
+      * \param[in] file_name the name of the file to load
+      * \param[out] view the resultant view on the points of the file
+      * \ingroup io
+      */
+    template<typename PointT> inline int
+    loadPCDFile (const std::string &file_name, pcl::PointCloudView<PointT> &view)
+    {
+      pcl::PCDReader p;
+      return (p.readView (file_name, view));
+    }
+
     /** \brief Save point cloud data to a PCD file containing n-D points
       * \param[in] file_name the output file name
       * \param[in] cloud the point cloud data message
@@ -0,0 +1,348 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/PCLPointCloud2.h>
+#include <pcl/conversions.h> // for fromPCLPointCloud2, toPCLPointCloud2
+#include <pcl/io/pcd_io.h>
+
+#include <Eigen/Geometry> // for Quaternionf
+
+#include <cstddef>
+#include <fstream>
+#include <future>
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Read a PCD file in batches of points, with bounded memory.
+    *
+    * The points are read sequentially, \ref getBatchSize points at a time, so that
+    * files much larger than the available memory can be processed:
+    * \code
+    * pcl::PCDStreamReader reader;
+    * reader.open ("huge.pcd");
+    * pcl::PointCloud<pcl::PointXYZ> batch;
+    * while (reader.read (batch) > 0)
+    *   process (batch);
+    * \endcode
+    *
+    * With read-ahead enabled (default), the next batch is read in the background while
+    * the current one is processed, so at most two batches are held in memory.
+    *
+    * ASCII, binary and binary_compressed_chunked files are read incrementally. The
+    * body of binary_compressed files is a single compressed block, which is decompressed
+    * entirely when the file is opened: use \ref PCDWriter::writeBinaryCompressedChunked
+    * for compressed files that do not fit in memory.
+    *
+    * \ingroup io
+    */
+  class PCL_EXPORTS PCDStreamReader
+  {
+    public:
+      PCDStreamReader () = default;
+      ~PCDStreamReader () { close (); }
+
+      PCDStreamReader (const PCDStreamReader&) = delete;
+      PCDStreamReader& operator= (const PCDStreamReader&) = delete;
+
+      /** \brief Open a PCD file and read its header.
+        * \param[in] file_name the name of the file containing the actual PointCloud data
+        * \param[in] offset the offset of where to expect the PCD Header in the
+        * file (optional parameter)
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      open (const std::string &file_name, const int offset = 0);
+
+      /** \brief Close the file, waiting for a pending read-ahead if any. */
+      void
+      close ();
+
+      /** \brief Return whether a file is open. */
+      inline bool
+      isOpen () const { return (open_); }
+
+      /** \brief Set the maximum number of points per batch. Default: 65536
+        * The batch being read ahead, if any, keeps the previous size.
+        * \param[in] batch_size the number of points per batch (at least 1)
+        */
+      void
+      setBatchSize (std::size_t batch_size);
+
+      /** \brief Get the maximum number of points per batch. */
+      inline std::size_t
+      getBatchSize () const { return (batch_size_); }
+
+      /** \brief Set whether the next batch is read in the background. Default: true
+        * \param[in] read_ahead true to read the next batch while the current one is processed
+        */
+      void
+      setReadAhead (bool read_ahead);
+
+      /** \brief Get whether the next batch is read in the background. */
+      inline bool
+      getReadAhead () const { return (read_ahead_); }
+
+      /** \brief Set the number of threads used to decompress binary_compressed_chunked
+        * files (see \ref PCDReader::setNumberOfThreads). Default: 1
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the header of the open file: its fields, point_step, width and
+        * height. The data is left empty. */
+      inline const pcl::PCLPointCloud2&
+      getHeader () const { return (header_); }
+
+      /** \brief Get the sensor acquisition origin of the open file. */
+      inline const Eigen::Vector4f&
+      getOrigin () const { return (origin_); }
+
+      /** \brief Get the sensor acquisition orientation of the open file. */
+      inline const Eigen::Quaternionf&
+      getOrientation () const { return (orientation_); }
+
+      /** \brief Get the total number of points in the open file. */
+      inline std::size_t
+      getNumberOfPoints () const { return (nr_points_); }
+
+      /** \brief Read the next batch of points.
+        * \param[out] batch the points, as an unorganized cloud of at most \ref getBatchSize points
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 once all the points have been read
+        *  * > 0 the number of points in the batch
+        */
+      int
+      read (pcl::PCLPointCloud2 &batch);
+
+      /** \brief Read the next batch of points.
+        * \param[out] batch the points, as an unorganized cloud of at most \ref getBatchSize points
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 once all the points have been read
+        *  * > 0 the number of points in the batch
+        */
+      template <typename PointT> int
+      read (pcl::PointCloud<PointT> &batch)
+      {
+        int res = read (blob_);
+        if (res < 0)
+          return (res);
+        pcl::fromPCLPointCloud2 (blob_, batch);
+        batch.sensor_origin_ = origin_;
+        batch.sensor_orientation_ = orientation_;
+        return (res);
+      }
+
+    private:
+      /** \brief Read the next batch of points, in the calling thread. */
+      int
+      readNext (pcl::PCLPointCloud2 &batch);
+
+      /** \brief The reader used to parse the header and the points. */
+      pcl::PCDReader reader_;
+
+      /** \brief The stream on ASCII and binary files. */
+      std::ifstream fs_;
+
+      /** \brief The mapping of binary_compressed_chunked files. */
+      std::shared_ptr<const void> mapping_;
+
+      /** \brief The size of \a mapping_. */
+      std::size_t map_size_ = 0;
+
+      /** \brief The decompressed body of binary_compressed files. */
+      pcl::PCLPointCloud2 body_;
+
+      /** \brief Staging buffer for the points of binary files. */
+      std::vector<std::uint8_t> buffer_;
+
+      /** \brief The header of the file, without data. */
+      pcl::PCLPointCloud2 header_;
+
+      Eigen::Vector4f origin_ = Eigen::Vector4f::Zero ();
+      Eigen::Quaternionf orientation_ = Eigen::Quaternionf::Identity ();
+      int pcd_version_ = 0;
+      int data_type_ = 0;
+      unsigned int data_idx_ = 0;
+
+      /** \brief The number of points in the file. */
+      std::size_t nr_points_ = 0;
+
+      /** \brief The index of the first point of the next batch to read from the file. */
+      std::size_t next_point_ = 0;
+
+      std::size_t batch_size_ = 65536;
+      bool read_ahead_ = true;
+      bool open_ = false;
+
+      /** \brief The batch being read in the background, and the result of its read. */
+      pcl::PCLPointCloud2 pending_batch_;
+      std::future<int> pending_;
+
+      /** \brief Conversion buffer for the templated \ref read. */
+      pcl::PCLPointCloud2 blob_;
+
+    public:
+      PCL_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /** \brief Write a binary PCD file in batches of points, with bounded memory.
+    *
+    * The header is written by \ref open with placeholder WIDTH and POINTS values,
+    * which \ref close replaces with the number of points written:
+    * \code
+    * pcl::PCDStreamWriter writer;
+    * writer.open<pcl::PointXYZ> ("huge.pcd");
+    * while (produce (batch))
+    *   writer.write (batch);
+    * writer.close ();
+    * \endcode
+    *
+    * The file is unorganized (HEIGHT 1). As WIDTH is stored on 32 bits, a file holds
+    * at most 2^32 - 1 points.
+    *
+    * \ingroup io
+    */
+  class PCL_EXPORTS PCDStreamWriter
+  {
+    public:
+      PCDStreamWriter () = default;
+      ~PCDStreamWriter () { close (); }
+
+      PCDStreamWriter (const PCDStreamWriter&) = delete;
+      PCDStreamWriter& operator= (const PCDStreamWriter&) = delete;
+
+      /** \brief Create a binary PCD file and write its header.
+        * \param[in] file_name the output file name
+        * \param[in] layout a cloud whose fields and point_step describe the points of the
+        * batches. Its data is not written.
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      open (const std::string &file_name, const pcl::PCLPointCloud2 &layout,
+            const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
+            const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
+      /** \brief Create a binary PCD file for points of type PointT and write its header.
+        * \param[in] file_name the output file name
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        */
+      template <typename PointT> int
+      open (const std::string &file_name,
+            const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (),
+            const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ())
+      {
+        pcl::PCLPointCloud2 layout;
+        pcl::toPCLPointCloud2 (pcl::PointCloud<PointT> (), layout);
+        return (open (file_name, layout, origin, orientation));
+      }
+
+      /** \brief Append a batch of points to the file.
+        * \param[in] batch the points, with the layout given to \ref open
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      write (const pcl::PCLPointCloud2 &batch);
+
+      /** \brief Append a batch of points to the file.
+        * \param[in] batch the points
+        */
+      template <typename PointT> int
+      write (const pcl::PointCloud<PointT> &batch)
+      {
+        pcl::toPCLPointCloud2 (batch, blob_);
+        return (write (blob_));
+      }
+
+      /** \brief Write the number of points in the header and close the file.
+        *
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success, or if no file is open
+        */
+      int
+      close ();
+
+      /** \brief Return whether a file is open. */
+      inline bool
+      isOpen () const { return (fs_.is_open ()); }
+
+      /** \brief Get the number of points written so far. */
+      inline std::size_t
+      getNumberOfPoints () const { return (nr_points_); }
+
+    private:
+      /** \brief The output stream. */
+      std::ofstream fs_;
+
+      /** \brief The fields and point_step of the points. */
+      pcl::PCLPointCloud2 layout_;
+
+      /** \brief The positions of the WIDTH and POINTS values in the header. */
+      std::size_t width_pos_ = 0;
+      std::size_t points_pos_ = 0;
+
+      /** \brief The number of points written so far. */
+      std::size_t nr_points_ = 0;
+
+      /** \brief Conversion buffer for the templated \ref write. */
+      pcl::PCLPointCloud2 blob_;
+  };
+}
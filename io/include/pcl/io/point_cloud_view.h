@@ -0,0 +1,187 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/memory.h>
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+
+#include <Eigen/Geometry> // for Quaternionf
+
+#include <cassert>
+#include <cstddef>
+
+namespace pcl
+{
+  /** \brief PointCloudView is a read-only point cloud whose points live in memory it
+    * does not own, e.g. a memory mapped PCD file (see \ref PCDReader::readView).
+    *
+    * The view keeps the memory holding the points alive: copies of a view are cheap and
+    * share the same points, which are released (e.g. unmapped) when the last copy is
+    * destroyed. The members mirror the ones of \ref PointCloud, and \ref toPointCloud
+    * makes an owning copy if needed.
+    *
+    * \ingroup io
+    */
+  template <typename PointT>
+  class PointCloudView
+  {
+    public:
+      using PointType = PointT;
+      using const_iterator = const PointT*;
+
+      /** \brief Default constructor. Creates an empty view. */
+      PointCloudView () = default;
+
+      /** \brief Create a view on \a width * \a height points.
+        * \param[in] storage the object owning the memory of the points, released when the
+        * last view on it is destroyed
+        * \param[in] points pointer to the first point, must be suitably aligned for PointT
+        * \param[in] width the width of the view
+        * \param[in] height the height of the view
+        * \param[in] mapped whether \a storage is a memory mapped file
+        */
+      PointCloudView (std::shared_ptr<const void> storage, const PointT *points,
+                      uindex_t width, uindex_t height, bool mapped = false)
+        : width (width), height (height), storage_ (std::move (storage)), points_ (points), mapped_ (mapped)
+      {
+      }
+
+      /** \brief Obtain the point given by the (column, row) coordinates. Only works on
+        * organized datasets (those that have height != 1).
+        * \param[in] column the column coordinate
+        * \param[in] row the row coordinate
+        */
+      inline const PointT&
+      at (int column, int row) const
+      {
+        if (this->height > 1)
+          return (points_[row * this->width + column]);
+        throw UnorganizedPointCloudException ("Can't use 2D indexing with an unorganized point cloud");
+      }
+
+      /** \brief Return whether a dataset is organized (e.g., arranged in a structured grid). */
+      inline bool
+      isOrganized () const
+      {
+        return (height > 1);
+      }
+
+      /** \brief Return the number of points in the view. */
+      inline std::size_t
+      size () const { return (static_cast<std::size_t> (width) * height); }
+
+      /** \brief Return whether the view contains no points. */
+      inline bool
+      empty () const { return (size () == 0); }
+
+      /** \brief Return a pointer to the first point. */
+      inline const PointT*
+      data () const { return (points_); }
+
+      inline const_iterator
+      begin () const { return (points_); }
+
+      inline const_iterator
+      end () const { return (points_ + size ()); }
+
+      inline const PointT&
+      operator[] (std::size_t n) const
+      {
+        assert (n < size ());
+        return (points_[n]);
+      }
+
+      inline const PointT&
+      front () const { return (points_[0]); }
+
+      inline const PointT&
+      back () const { return (points_[size () - 1]); }
+
+      /** \brief Return whether the points are stored in a memory mapped file, as opposed to
+        * a copy owned by the view. */
+      inline bool
+      isMapped () const { return (mapped_); }
+
+      /** \brief Copy the points and the metadata of the view in a PointCloud. */
+      PointCloud<PointT>
+      toPointCloud () const
+      {
+        PointCloud<PointT> cloud;
+        cloud.header = header;
+        cloud.points.assign (begin (), end ());
+        cloud.width = width;
+        cloud.height = height;
+        cloud.is_dense = is_dense;
+        cloud.sensor_origin_ = sensor_origin_;
+        cloud.sensor_orientation_ = sensor_orientation_;
+        return (cloud);
+      }
+
+      /** \brief The point cloud header. It contains information about the acquisition time. */
+      pcl::PCLHeader header;
+
+      /** \brief The point cloud width (if organized as an image-structure). */
+      uindex_t width = 0;
+      /** \brief The point cloud height (if organized as an image-structure). */
+      uindex_t height = 0;
+
+      /** \brief True if no points are invalid (e.g., have NaN or Inf values in any of their
+        * floating point fields). Views on mapped files are never scanned for invalid
+        * points, so this is false unless set by the user. */
+      bool is_dense = false;
+
+      /** \brief Sensor acquisition pose (origin/translation). */
+      Eigen::Vector4f sensor_origin_ = Eigen::Vector4f::Zero ();
+      /** \brief Sensor acquisition pose (rotation). */
+      Eigen::Quaternionf sensor_orientation_ = Eigen::Quaternionf::Identity ();
+
+    protected:
+      /** \brief The object owning the memory of the points. */
+      std::shared_ptr<const void> storage_;
+
+      /** \brief Pointer to the first point. */
+      const PointT *points_ = nullptr;
+
+      /** \brief Whether the points are stored in a memory mapped file. */
+      bool mapped_ = false;
+
+    public:
+      PCL_MAKE_ALIGNED_OPERATOR_NEW
+  };
+}
@@ -53,6 +53,10 @@
 #include <boost/filesystem.hpp> // for permissions
 #include <boost/algorithm/string.hpp> // for split
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::PCDWriter::setLockingPermissions (const std::string &file_name,
@@ -105,15 +109,19 @@ pcl::PCDWriter::resetLockingPermissions (const std::string &file_name,
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
-int
-pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
-                            Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, 
-                            int &pcd_version, int &data_type, unsigned int &data_idx)
+/** \brief Parse a PCD header, without allocating the data of the cloud.
+  * See pcl::PCDReader::readHeader for the parameters.
+  * \param[out] nr_points the number of points in the file
+  */
+static int
+parsePCDHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
+                Eigen::Vector4f &origin, Eigen::Quaternionf &orientation,
+                int &pcd_version, int &data_type, unsigned int &data_idx, std::size_t &nr_points)
 {
   // Default values
   data_idx = 0;
   data_type = 0;
-  pcd_version = PCD_V6;
+  pcd_version = pcl::PCDReader::PCD_V6;
   origin      = Eigen::Vector4f::Zero ();
   orientation = Eigen::Quaternionf::Identity ();
   cloud.width = cloud.height = cloud.point_step = cloud.row_step = 0;
@@ -122,7 +130,7 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
   // By default, assume that there are _no_ invalid (e.g., NaN) points
   //cloud.is_dense = true;
 
-  std::size_t nr_points = 0;
+  nr_points = 0;
   std::string line;
 
   // field_sizes represents the size of one element in a field (e.g., float = 4, char = 1)
@@ -230,7 +238,7 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
         for (int i = 0; i < specified_channel_count; ++i)
         {
           field_types[i] = st.at (i + 1).c_str ()[0];
-          cloud.fields[i].datatype = static_cast<std::uint8_t> (getFieldType (field_sizes[i], field_types[i]));
+          cloud.fields[i].datatype = static_cast<std::uint8_t> (pcl::getFieldType (field_sizes[i], field_types[i]));
         }
         continue;
       }
@@ -286,7 +294,7 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
       // Get the acquisition viewpoint
       if (line_type.substr (0, 9) == "VIEWPOINT")
       {
-        pcd_version = PCD_V7;
+        pcd_version = pcl::PCDReader::PCD_V7;
         if (st.size () < 8)
           throw "Not enough number of elements in <VIEWPOINT>! Need 7 values (tx ty tz qw qx qy qz).";
 
@@ -304,8 +312,6 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
         if (!cloud.point_step)
           throw "Number of POINTS specified before COUNT in header!";
         sstream >> nr_points;
-        // Need to allocate: N * point_step
-        cloud.data.resize (nr_points * cloud.point_step);
         continue;
       }
 
@@ -313,7 +319,9 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
       if (line_type.substr (0, 4) == "DATA")
       {
         data_idx = static_cast<int> (fs.tellg ());
-        if (st.at (1).substr (0, 17) == "binary_compressed")
+        if (st.at (1).substr (0, 25) == "binary_compressed_chunked")
+          data_type = 3;
+        else if (st.at (1).substr (0, 17) == "binary_compressed")
          data_type = 2;
         else
           if (st.at (1).substr (0, 6) == "binary")
@@ -371,6 +379,31 @@ pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
   return (0);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::readHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
+                            Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, 
+                            int &pcd_version, int &data_type, unsigned int &data_idx)
+{
+  std::size_t nr_points = 0;
+  int res = parsePCDHeader (fs, cloud, origin, orientation, pcd_version, data_type, data_idx, nr_points);
+  if (res < 0)
+    return (res);
+
+  // Need to allocate: N * point_step
+  cloud.data.resize (nr_points * cloud.point_step);
+  return (0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::parseHeader (std::istream &fs, pcl::PCLPointCloud2 &cloud,
+                             Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version,
+                             int &data_type, unsigned int &data_idx, std::size_t &nr_points)
+{
+  return (parsePCDHeader (fs, cloud, origin, orientation, pcd_version, data_type, data_idx, nr_points));
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 int
 pcl::PCDReader::readHeader (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
@@ -553,6 +586,107 @@ pcl::PCDReader::readBodyASCII (std::istream &fs, pcl::PCLPointCloud2 &cloud, int
   return (0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Collect the fields stored in the compressed formats (all but the "_" padding
+  * fields) and their sizes, and return the size of a packed point. */
+static std::size_t
+getStoredFields (const pcl::PCLPointCloud2 &cloud, std::vector<pcl::PCLPointField> &fields,
+                 std::vector<std::size_t> &fields_sizes)
+{
+  fields.clear ();
+  fields_sizes.clear ();
+  std::size_t fsize = 0;
+  for (const auto &field : cloud.fields)
+  {
+    if (field.name == "_")
+      continue;
+    fields.push_back (field);
+    fields_sizes.push_back (field.count * pcl::getFieldSize (field.datatype));
+    fsize += fields_sizes.back ();
+  }
+  return (fsize);
+}
+
+/** \brief An entry of the chunk table of the binary_compressed_chunked format. The
+  * offset is relative to the end of the table. */
+struct PCDChunk
+{
+  std::uint64_t offset;
+  std::uint32_t compressed_size;
+  std::uint32_t uncompressed_size;
+};
+static_assert (sizeof (PCDChunk) == 16, "The chunk table entries must be packed");
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Go over each field of each point of a binary cloud, and set is_dense to false
+  * if any of them has a NaN/Inf value. */
+static void
+updateIsDense (pcl::PCLPointCloud2 &cloud)
+{
+  int point_size = static_cast<int> (cloud.data.size () / (cloud.height * cloud.width));
+  // Once copied, we need to go over each field and check if it has NaN/Inf values and assign cloud.is_dense to true or false
+  for (pcl::uindex_t i = 0; i < cloud.width * cloud.height; ++i)
+  {
+    for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
+    {
+      for (pcl::uindex_t c = 0; c < cloud.fields[d].count; ++c)
+      {
+        switch (cloud.fields[d].datatype)
+        {
+          case pcl::PCLPointField::INT8:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT8>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+          case pcl::PCLPointField::UINT8:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT8>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+          case pcl::PCLPointField::INT16:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT16>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+          case pcl::PCLPointField::UINT16:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT16>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+          case pcl::PCLPointField::INT32:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT32>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+          case pcl::PCLPointField::UINT32:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT32>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+          case pcl::PCLPointField::FLOAT32:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT32>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+          case pcl::PCLPointField::FLOAT64:
+          {
+            if (!pcl::isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT64>::type> (cloud, i, point_size, d, c))
+              cloud.is_dense = false;
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 int
 pcl::PCDReader::readBodyBinary (const unsigned char *map, pcl::PCLPointCloud2 &cloud,
@@ -628,69 +762,123 @@ pcl::PCDReader::readBodyBinary (const unsigned char *map, pcl::PCLPointCloud2 &c
     memcpy (&cloud.data[0], &map[0] + data_idx, cloud.data.size ());
 
   // Extra checks (not needed for ASCII)
-  int point_size = static_cast<int> (cloud.data.size () / (cloud.height * cloud.width));
-  // Once copied, we need to go over each field and check if it has NaN/Inf values and assign cloud.is_dense to true or false
-  for (uindex_t i = 0; i < cloud.width * cloud.height; ++i)
+  updateIsDense (cloud);
+
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::readBodyBinaryChunked (const unsigned char *map, std::size_t map_size,
+                                       pcl::PCLPointCloud2 &cloud, unsigned int data_idx,
+                                       uindex_t begin, uindex_t end)
+{
+  const std::size_t nr_points = static_cast<std::size_t> (cloud.width) * cloud.height;
+
+  // Layout: nr_chunks, chunk_size, nr_chunks * PCDChunk, compressed chunks
+  std::uint32_t nr_chunks = 0, chunk_size = 0;
+  if (data_idx + 8 > map_size)
   {
-    for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
+    PCL_ERROR ("[pcl::PCDReader::readBodyBinaryChunked] Corrupted PCD file. The file is smaller than expected!\n");
+    return (-1);
+  }
+  memcpy (&nr_chunks, &map[data_idx + 0], 4);
+  memcpy (&chunk_size, &map[data_idx + 4], 4);
+  const std::size_t table_idx = data_idx + 8;
+  const std::size_t payload_idx = table_idx + nr_chunks * sizeof (PCDChunk);
+  if (payload_idx > map_size)
+  {
+    PCL_ERROR ("[pcl::PCDReader::readBodyBinaryChunked] Corrupted PCD file. The file is smaller than expected!\n");
+    return (-1);
+  }
+  if ((chunk_size == 0 && nr_points != 0) ||
+      (chunk_size != 0 && nr_chunks != (nr_points + chunk_size - 1) / chunk_size))
+  {
+    PCL_ERROR ("[pcl::PCDReader::readBodyBinaryChunked] %u chunks of %u points do not match the %zu points of the header! Data corruption?\n",
+               nr_chunks, chunk_size, nr_points);
+    return (-1);
+  }
+
+  end = static_cast<uindex_t> (std::min<std::size_t> (end, nr_points));
+  begin = std::min (begin, end);
+  if (begin != 0 || end != nr_points)
+  {
+    cloud.width = end - begin;
+    cloud.height = 1;
+  }
+  cloud.data.resize (static_cast<std::size_t> (end - begin) * cloud.point_step);
+  cloud.is_dense = true;
+  if (begin == end)
+    return (0);
+
+  std::vector<pcl::PCLPointField> fields;
+  std::vector<std::size_t> fields_sizes;
+  const std::size_t fsize = getStoredFields (cloud, fields, fields_sizes);
+
+  // Only decompress the chunks overlapping [begin, end)
+  const std::uint32_t first_chunk = begin / chunk_size;
+  const std::uint32_t last_chunk = (end - 1) / chunk_size + 1;
+  std::vector<int> chunk_res (last_chunk - first_chunk, 0);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (std::int64_t c = first_chunk; c < static_cast<std::int64_t> (last_chunk); ++c)
+  {
+    PCDChunk chunk;
+    memcpy (&chunk, &map[table_idx + c * sizeof (PCDChunk)], sizeof (PCDChunk));
+    const std::size_t chunk_begin = static_cast<std::size_t> (c) * chunk_size;
+    const std::size_t chunk_points = std::min<std::size_t> (chunk_size, nr_points - chunk_begin);
+    if (chunk.uncompressed_size != chunk_points * fsize ||
+        payload_idx + chunk.offset + chunk.compressed_size > map_size)
     {
-      for (uindex_t c = 0; c < cloud.fields[d].count; ++c)
+      chunk_res[c - first_chunk] = -1;
+      continue;
+    }
+
+    // Chunks which did not compress are stored as is
+    const char *src = reinterpret_cast<const char*> (&map[payload_idx + chunk.offset]);
+    std::vector<char> buf;
+    if (chunk.compressed_size != chunk.uncompressed_size)
+    {
+      buf.resize (chunk.uncompressed_size);
+      if (pcl::lzfDecompress (src, chunk.compressed_size, buf.data (), chunk.uncompressed_size) != chunk.uncompressed_size)
       {
-        switch (cloud.fields[d].datatype)
-        {
-          case pcl::PCLPointField::INT8:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT8>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::UINT8:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT8>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::INT16:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT16>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::UINT16:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT16>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::INT32:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::INT32>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::UINT32:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::UINT32>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::FLOAT32:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT32>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-          case pcl::PCLPointField::FLOAT64:
-          {
-            if (!isValueFinite<pcl::traits::asType<pcl::PCLPointField::FLOAT64>::type> (cloud, i, point_size, d, c))
-              cloud.is_dense = false;
-            break;
-          }
-        }
+        chunk_res[c - first_chunk] = -2;
+        continue;
       }
+      src = buf.data ();
+    }
+
+    // Unpack the xxyyzz of the points in the range to xyz
+    const std::size_t lo = std::max<std::size_t> (begin, chunk_begin);
+    const std::size_t hi = std::min<std::size_t> (end, chunk_begin + chunk_points);
+    const char *plane = src;
+    for (std::size_t j = 0; j < fields.size (); ++j)
+    {
+      for (std::size_t i = lo; i < hi; ++i)
+        memcpy (&cloud.data[(i - begin) * cloud.point_step + fields[j].offset],
+                plane + (i - chunk_begin) * fields_sizes[j], fields_sizes[j]);
+      plane += fields_sizes[j] * chunk_points;
     }
   }
 
+  for (std::size_t c = 0; c < chunk_res.size (); ++c)
+  {
+    if (chunk_res[c] == -1)
+    {
+      PCL_ERROR ("[pcl::PCDReader::readBodyBinaryChunked] Chunk %zu does not match the PCD header! Data corruption?\n", first_chunk + c);
+      return (-1);
+    }
+    if (chunk_res[c] == -2)
+    {
+      PCL_ERROR ("[pcl::PCDReader::readBodyBinaryChunked] Could not decompress chunk %zu! Data corruption?\n", first_chunk + c);
+      return (-1);
+    }
+  }
+
+  // Extra checks (not needed for ASCII)
+  updateIsDense (cloud);
+
   return (0);
 }
 
@@ -754,7 +942,12 @@ pcl::PCDReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
     io::raw_lseek (fd, 0, SEEK_SET);
 
     std::size_t mmap_size = offset + data_idx;   // ...because we mmap from the start of the file.
-    if (data_type == 2)
+    if (data_type == 3)
+    {
+      // The chunks are located by the table at the start of the body: map everything
+      mmap_size = file_size;
+    }
+    else if (data_type == 2)
     {
       // Seek to real start of data.
       long result = io::raw_lseek (fd, offset + data_idx, SEEK_SET);
@@ -820,7 +1013,10 @@ pcl::PCDReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
     }
 #endif
 
-    res = readBodyBinary (map, cloud, pcd_version, data_type == 2, offset + data_idx);
+    if (data_type == 3)
+      res = readBodyBinaryChunked (map, mmap_size, cloud, data_idx, 0, cloud.width * cloud.height);
+    else
+      res = readBodyBinary (map, cloud, pcd_version, data_type == 2, offset + data_idx);
 
     // Unmap the pages of memory
 #ifdef _WIN32
@@ -859,6 +1055,237 @@ pcl::PCDReader::read (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
   return (0);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::mapBinary (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                           Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version,
+                           std::shared_ptr<const void> &mapping, const std::uint8_t *&data,
+                           const int offset)
+{
+  if (file_name.empty() || !boost::filesystem::exists (file_name))
+  {
+    PCL_ERROR ("[pcl::PCDReader::mapBinary] Could not find file '%s'.\n", file_name.c_str ());
+    return (-1);
+  }
+
+  // Parse the header without allocating the data, which stays in the file
+  int data_type;
+  unsigned int data_idx;
+  std::size_t nr_points;
+  {
+    std::ifstream fs;
+    fs.open (file_name.c_str (), std::ios::binary);
+    if (!fs.is_open () || fs.fail ())
+    {
+      PCL_ERROR ("[pcl::PCDReader::mapBinary] Could not open file '%s'! Error : %s\n", file_name.c_str (), strerror (errno));
+      return (-1);
+    }
+    fs.seekg (offset, std::ios::beg);
+    int res = parsePCDHeader (fs, cloud, origin, orientation, pcd_version, data_type, data_idx, nr_points);
+    if (res < 0)
+      return (res);
+  }
+
+  if (data_type != 1)
+    return (-2);
+
+  int fd = io::raw_open (file_name.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    PCL_ERROR ("[pcl::PCDReader::mapBinary] Failure to open file %s\n", file_name.c_str () );
+    return (-1);
+  }
+
+  // Infer file size
+  const std::size_t file_size = io::raw_lseek (fd, 0, SEEK_END);
+  io::raw_lseek (fd, 0, SEEK_SET);
+
+  // We mmap from the start of the file. data_idx is the position of the data in the
+  // file, which already accounts for the offset of the header.
+  const std::size_t mmap_size = data_idx + nr_points * cloud.point_step;
+  if (mmap_size > file_size)
+  {
+    io::raw_close (fd);
+    PCL_ERROR ("[pcl::PCDReader::mapBinary] Corrupted PCD file. The file is smaller than expected!\n");
+    return (-1);
+  }
+
+  // Prepare the map. The file can be closed as soon as it is mapped.
+#ifdef _WIN32
+  HANDLE fm = CreateFileMapping ((HANDLE) _get_osfhandle (fd), NULL, PAGE_READONLY, 0, 0, NULL);
+  unsigned char *map = static_cast<unsigned char*> (MapViewOfFile (fm, FILE_MAP_READ, 0, 0, 0));
+  CloseHandle (fm);
+  io::raw_close (fd);
+  if (map == NULL)
+  {
+    PCL_ERROR ("[pcl::PCDReader::mapBinary] Error mapping view of file, %s\n", file_name.c_str ());
+    return (-1);
+  }
+  mapping.reset (map, [] (const void *map) { UnmapViewOfFile (map); });
+#else
+  unsigned char *map = static_cast<unsigned char*> (::mmap (nullptr, mmap_size, PROT_READ, MAP_SHARED, fd, 0));
+  io::raw_close (fd);
+  if (map == reinterpret_cast<unsigned char*> (-1))    // MAP_FAILED
+  {
+    PCL_ERROR ("[pcl::PCDReader::mapBinary] Error preparing mmap for binary PCD file.\n");
+    return (-1);
+  }
+  mapping.reset (map, [mmap_size] (const void *map)
+  {
+    if (::munmap (const_cast<void*> (map), mmap_size) == -1)
+      PCL_ERROR ("[pcl::PCDReader::mapBinary] Munmap failure\n");
+  });
+#endif
+
+  data = map + data_idx;
+  PCL_DEBUG ("[pcl::PCDReader::mapBinary] Mapped %s with %zu points. Available dimensions: %s.\n",
+             file_name.c_str (), nr_points, pcl::getFieldsList (cloud).c_str ());
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::readRange (const std::string &file_name, pcl::PCLPointCloud2 &cloud,
+                           uindex_t begin, uindex_t end, const int offset)
+{
+  if (file_name.empty() || !boost::filesystem::exists (file_name))
+  {
+    PCL_ERROR ("[pcl::PCDReader::readRange] Could not find file '%s'.\n", file_name.c_str ());
+    return (-1);
+  }
+
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  int pcd_version;
+  int data_type;
+  unsigned int data_idx;
+  std::size_t nr_points;
+  {
+    std::ifstream fs;
+    fs.open (file_name.c_str (), std::ios::binary);
+    if (!fs.is_open () || fs.fail ())
+    {
+      PCL_ERROR ("[pcl::PCDReader::readRange] Could not open file '%s'! Error : %s\n", file_name.c_str (), strerror (errno));
+      return (-1);
+    }
+    fs.seekg (offset, std::ios::beg);
+    int res = parsePCDHeader (fs, cloud, origin, orientation, pcd_version, data_type, data_idx, nr_points);
+    if (res < 0)
+      return (res);
+  }
+
+  end = static_cast<uindex_t> (std::min<std::size_t> (end, nr_points));
+  begin = std::min (begin, end);
+
+  // Uncompressed binary: only read the range
+  if (data_type == 1)
+  {
+    std::ifstream fs;
+    fs.open (file_name.c_str (), std::ios::binary);
+    fs.seekg (data_idx + static_cast<std::size_t> (begin) * cloud.point_step, std::ios::beg);
+    cloud.data.resize (static_cast<std::size_t> (end - begin) * cloud.point_step);
+    if (!cloud.data.empty ())
+      fs.read (reinterpret_cast<char*> (&cloud.data[0]), cloud.data.size ());
+    if (!fs)
+    {
+      PCL_ERROR ("[pcl::PCDReader::readRange] Corrupted PCD file. The file is smaller than expected!\n");
+      return (-1);
+    }
+    cloud.width = end - begin;
+    cloud.height = 1;
+    cloud.is_dense = true;
+    if (begin != end)
+      updateIsDense (cloud);
+    return (0);
+  }
+
+  // Chunked: only decompress the chunks overlapping the range
+  if (data_type == 3)
+  {
+    int fd = io::raw_open (file_name.c_str (), O_RDONLY);
+    if (fd == -1)
+    {
+      PCL_ERROR ("[pcl::PCDReader::readRange] Failure to open file %s\n", file_name.c_str () );
+      return (-1);
+    }
+    const std::size_t file_size = io::raw_lseek (fd, 0, SEEK_END);
+    io::raw_lseek (fd, 0, SEEK_SET);
+#ifdef _WIN32
+    HANDLE fm = CreateFileMapping ((HANDLE) _get_osfhandle (fd), NULL, PAGE_READONLY, 0, 0, NULL);
+    unsigned char *map = static_cast<unsigned char*> (MapViewOfFile (fm, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle (fm);
+    io::raw_close (fd);
+    if (map == NULL)
+    {
+      PCL_ERROR ("[pcl::PCDReader::readRange] Error mapping view of file, %s\n", file_name.c_str ());
+      return (-1);
+    }
+#else
+    unsigned char *map = static_cast<unsigned char*> (::mmap (nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0));
+    io::raw_close (fd);
+    if (map == reinterpret_cast<unsigned char*> (-1))    // MAP_FAILED
+    {
+      PCL_ERROR ("[pcl::PCDReader::readRange] Error preparing mmap for binary PCD file.\n");
+      return (-1);
+    }
+#endif
+
+    // The header may describe an organized cloud, the range is unorganized
+    cloud.width = static_cast<uindex_t> (nr_points);
+    cloud.height = 1;
+    int res = readBodyBinaryChunked (map, file_size, cloud, data_idx, begin, end);
+
+#ifdef _WIN32
+    UnmapViewOfFile (map);
+#else
+    if (::munmap (map, file_size) == -1)
+    {
+      PCL_ERROR ("[pcl::PCDReader::readRange] Munmap failure\n");
+      return (-1);
+    }
+#endif
+    return (res);
+  }
+
+  // ASCII and single block compressed: read everything and keep the range
+  int res = read (file_name, cloud, offset);
+  if (res < 0)
+    return (res);
+  cloud.data.erase (cloud.data.begin () + static_cast<std::size_t> (end) * cloud.point_step, cloud.data.end ());
+  cloud.data.erase (cloud.data.begin (), cloud.data.begin () + static_cast<std::size_t> (begin) * cloud.point_step);
+  cloud.width = end - begin;
+  cloud.height = 1;
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDReader::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDWriter::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 std::string
 pcl::PCDWriter::generateHeaderASCII (const pcl::PCLPointCloud2 &cloud,
@@ -1234,6 +1661,21 @@ pcl::PCDWriter::writeASCII (const std::string &file_name, const pcl::PCLPointClo
   return (0);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::string
+pcl::PCDWriter::generateBinaryDataLine (std::size_t header_size)
+{
+  static const std::string data_line = "DATA binary\n";
+  const std::size_t alignment = 64;
+  // The shortest comment line is "#\n"
+  std::size_t padding = (alignment - (header_size + data_line.size ()) % alignment) % alignment;
+  if (padding == 0)
+    return (data_line);
+  if (padding < 2)
+    padding += alignment;
+  return ("#" + std::string (padding - 2, ' ') + "\n" + data_line);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 int
 pcl::PCDWriter::writeBinary (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
@@ -1248,7 +1690,8 @@ pcl::PCDWriter::writeBinary (const std::string &file_name, const pcl::PCLPointCl
   std::ostringstream oss;
   oss.imbue (std::locale::classic ());
 
-  oss << generateHeaderBinary (cloud, origin, orientation) << "DATA binary\n";
+  oss << generateHeaderBinary (cloud, origin, orientation);
+  oss << generateBinaryDataLine (static_cast<std::size_t> (oss.tellp ()));
   oss.flush();
   data_idx = static_cast<unsigned int> (oss.tellp ());
 
@@ -1558,3 +2001,115 @@ pcl::PCDWriter::writeBinaryCompressed (const std::string &file_name, const pcl::
   return (0);
 }
 
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeBinaryCompressedChunked (std::ostream &os, const pcl::PCLPointCloud2 &cloud,
+                                              const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  if (cloud.data.empty ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Input point cloud has no data!\n");
+    return (-1);
+  }
+
+  if (generateHeaderBinaryCompressed (os, cloud, origin, orientation))
+  {
+    return (-1);
+  }
+
+  std::vector<pcl::PCLPointField> fields;
+  std::vector<std::size_t> fields_sizes;
+  const std::size_t fsize = getStoredFields (cloud, fields, fields_sizes);
+
+  // The sizes of each chunk are stored as 32 bit integers
+  const std::size_t nr_points = static_cast<std::size_t> (cloud.width) * cloud.height;
+  const std::size_t chunk_size = chunk_size_;
+  if (chunk_size * fsize > std::numeric_limits<std::uint32_t>::max ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] A chunk of %zu points exceeds the maximum size of %u bytes, reduce the chunk size.\n",
+               chunk_size, std::numeric_limits<std::uint32_t>::max ());
+    return (-2);
+  }
+  const std::size_t nr_chunks = (nr_points + chunk_size - 1) / chunk_size;
+
+  // Transpose XYZRGBXYZRGB to XXYYZZRGBRGB (see writeBinaryCompressed) and compress
+  // each chunk independently
+  std::vector<std::vector<char>> chunks (nr_chunks);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (std::int64_t c = 0; c < static_cast<std::int64_t> (nr_chunks); ++c)
+  {
+    const std::size_t chunk_begin = static_cast<std::size_t> (c) * chunk_size;
+    const std::size_t chunk_points = std::min (chunk_size, nr_points - chunk_begin);
+    const std::size_t data_size = chunk_points * fsize;
+
+    std::vector<char> only_valid_data (data_size);
+    char *plane = only_valid_data.data ();
+    for (std::size_t j = 0; j < fields.size (); ++j)
+    {
+      for (std::size_t i = chunk_begin; i < chunk_begin + chunk_points; ++i)
+      {
+        memcpy (plane, &cloud.data[i * cloud.point_step + fields[j].offset], fields_sizes[j]);
+        plane += fields_sizes[j];
+      }
+    }
+
+    // Keep the chunk uncompressed if compression does not make it smaller
+    chunks[c].resize (data_size);
+    unsigned int compressed_size = pcl::lzfCompress (only_valid_data.data (),
+                                                     static_cast<unsigned int> (data_size),
+                                                     chunks[c].data (),
+                                                     static_cast<unsigned int> (data_size));
+    if (compressed_size == 0 || compressed_size >= data_size)
+      chunks[c].swap (only_valid_data);
+    else
+      chunks[c].resize (compressed_size);
+  }
+
+  // Chunk table, followed by the chunks
+  std::vector<PCDChunk> table (nr_chunks);
+  std::uint64_t chunk_offset = 0;
+  for (std::size_t c = 0; c < nr_chunks; ++c)
+  {
+    table[c].offset = chunk_offset;
+    table[c].compressed_size = static_cast<std::uint32_t> (chunks[c].size ());
+    table[c].uncompressed_size = static_cast<std::uint32_t> (std::min (chunk_size, nr_points - c * chunk_size) * fsize);
+    chunk_offset += chunks[c].size ();
+  }
+  const std::uint32_t sizes[2] = {static_cast<std::uint32_t> (nr_chunks), static_cast<std::uint32_t> (chunk_size)};
+
+  os.imbue (std::locale::classic ());
+  os << "DATA binary_compressed_chunked\n";
+  os.write (reinterpret_cast<const char*> (sizes), sizeof (sizes));
+  os.write (reinterpret_cast<const char*> (table.data ()), table.size () * sizeof (PCDChunk));
+  for (const auto &chunk : chunks)
+    os.write (chunk.data (), chunk.size ());
+  os.flush ();
+
+  return (os ? 0 : -1);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeBinaryCompressedChunked (const std::string &file_name, const pcl::PCLPointCloud2 &cloud,
+                                              const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  std::ofstream fs;
+  fs.open (file_name.c_str (), std::ios::binary);      // Open file
+  if (!fs.is_open () || fs.fail ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Could not open file '%s' for writing! Error : %s\n", file_name.c_str (), strerror (errno));
+    return (-1);
+  }
+  // Mandatory lock file
+  boost::interprocess::file_lock file_lock;
+  setLockingPermissions (file_name, file_lock);
+
+  int status = writeBinaryCompressedChunked (fs, cloud, origin, orientation);
+
+  fs.close ();              // Close file
+  resetLockingPermissions (file_name, file_lock);
+  return (status);
+}
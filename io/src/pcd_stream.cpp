@@ -0,0 +1,358 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/io/pcd_stream.h>
+#include <pcl/io/low_level_io.h>
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <limits>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::open (const std::string &file_name, const int offset)
+{
+  close ();
+
+  fs_.open (file_name.c_str (), std::ios::binary);
+  if (!fs_.is_open () || fs_.fail ())
+  {
+    PCL_ERROR ("[pcl::PCDStreamReader::open] Could not open file '%s'! Error : %s\n", file_name.c_str (), strerror (errno));
+    fs_.close ();
+    return (-1);
+  }
+  fs_.seekg (offset, std::ios::beg);
+
+  header_ = pcl::PCLPointCloud2 ();
+  if (reader_.parseHeader (fs_, header_, origin_, orientation_, pcd_version_, data_type_, data_idx_, nr_points_) < 0)
+  {
+    fs_.close ();
+    return (-1);
+  }
+  next_point_ = 0;
+
+  // The header parser reads one line past DATA
+  fs_.clear ();
+  fs_.seekg (data_idx_, std::ios::beg);
+
+  // binary_compressed: a single compressed block, which can only be decompressed at once
+  if (data_type_ == 2)
+  {
+    fs_.close ();
+    if (reader_.read (file_name, body_, offset) < 0)
+      return (-1);
+  }
+  // binary_compressed_chunked: the chunks of each batch are decompressed from a mapping
+  else if (data_type_ == 3)
+  {
+    fs_.close ();
+    int fd = io::raw_open (file_name.c_str (), O_RDONLY);
+    if (fd == -1)
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::open] Failure to open file %s\n", file_name.c_str () );
+      return (-1);
+    }
+    map_size_ = io::raw_lseek (fd, 0, SEEK_END);
+    io::raw_lseek (fd, 0, SEEK_SET);
+#ifdef _WIN32
+    HANDLE fm = CreateFileMapping ((HANDLE) _get_osfhandle (fd), NULL, PAGE_READONLY, 0, 0, NULL);
+    unsigned char *map = static_cast<unsigned char*> (MapViewOfFile (fm, FILE_MAP_READ, 0, 0, 0));
+    CloseHandle (fm);
+    io::raw_close (fd);
+    if (map == NULL)
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::open] Error mapping view of file, %s\n", file_name.c_str ());
+      return (-1);
+    }
+    mapping_.reset (map, [] (const void *map) { UnmapViewOfFile (map); });
+#else
+    unsigned char *map = static_cast<unsigned char*> (::mmap (nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0));
+    io::raw_close (fd);
+    if (map == reinterpret_cast<unsigned char*> (-1))    // MAP_FAILED
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::open] Error preparing mmap for binary PCD file.\n");
+      return (-1);
+    }
+    const std::size_t map_size = map_size_;
+    mapping_.reset (map, [map_size] (const void *map)
+    {
+      if (::munmap (const_cast<void*> (map), map_size) == -1)
+        PCL_ERROR ("[pcl::PCDStreamReader::close] Munmap failure\n");
+    });
+#endif
+  }
+
+  open_ = true;
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDStreamReader::close ()
+{
+  if (pending_.valid ())
+    pending_.wait ();
+  pending_ = std::future<int> ();
+  pending_batch_ = pcl::PCLPointCloud2 ();
+  if (fs_.is_open ())
+    fs_.close ();
+  fs_.clear ();
+  mapping_.reset ();
+  map_size_ = 0;
+  body_ = pcl::PCLPointCloud2 ();
+  buffer_.clear ();
+  nr_points_ = next_point_ = 0;
+  open_ = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDStreamReader::setBatchSize (std::size_t batch_size)
+{
+  // The pending batch, if any, is read with the previous size
+  if (pending_.valid ())
+    pending_.wait ();
+  batch_size_ = std::max<std::size_t> (batch_size, 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDStreamReader::setNumberOfThreads (unsigned int nr_threads)
+{
+  // The pending batch, if any, is read with the previous number of threads
+  if (pending_.valid ())
+    pending_.wait ();
+  reader_.setNumberOfThreads (nr_threads);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDStreamReader::setReadAhead (bool read_ahead)
+{
+  read_ahead_ = read_ahead;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::read (pcl::PCLPointCloud2 &batch)
+{
+  if (!open_)
+  {
+    PCL_ERROR ("[pcl::PCDStreamReader::read] No file is open!\n");
+    return (-1);
+  }
+
+  int res;
+  if (pending_.valid ())
+  {
+    res = pending_.get ();
+    std::swap (batch, pending_batch_);
+  }
+  else
+    res = readNext (batch);
+
+  // Only one batch is read ahead, which bounds the memory used by the reader
+  if (res > 0 && read_ahead_ && next_point_ < nr_points_)
+    pending_ = std::async (std::launch::async, [this] { return (readNext (pending_batch_)); });
+  return (res);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::readNext (pcl::PCLPointCloud2 &batch)
+{
+  const std::size_t nr_points = std::min (batch_size_, nr_points_ - next_point_);
+  batch.header = header_.header;
+  batch.fields = header_.fields;
+  batch.point_step = header_.point_step;
+  batch.is_bigendian = header_.is_bigendian;
+  batch.width = static_cast<uindex_t> (nr_points);
+  batch.height = 1;
+  batch.row_step = batch.width * batch.point_step;
+  batch.data.resize (nr_points * batch.point_step);
+  batch.is_dense = true;
+  if (nr_points == 0)
+    return (0);
+
+  int res = 0;
+  switch (data_type_)
+  {
+    case 0:
+    {
+      res = reader_.readBodyASCII (fs_, batch, pcd_version_);
+      break;
+    }
+    case 1:
+    {
+      buffer_.resize (batch.data.size ());
+      fs_.read (reinterpret_cast<char*> (buffer_.data ()), buffer_.size ());
+      if (!fs_)
+      {
+        PCL_ERROR ("[pcl::PCDStreamReader::read] Corrupted PCD file. The file is smaller than expected!\n");
+        return (-1);
+      }
+      res = reader_.readBodyBinary (buffer_.data (), batch, pcd_version_, false, 0);
+      break;
+    }
+    case 2:
+    {
+      res = reader_.readBodyBinary (&body_.data[next_point_ * body_.point_step], batch, pcd_version_, false, 0);
+      break;
+    }
+    case 3:
+    {
+      // The range is relative to all the points of the file
+      batch.width = static_cast<uindex_t> (nr_points_);
+      res = reader_.readBodyBinaryChunked (static_cast<const unsigned char*> (mapping_.get ()), map_size_, batch,
+                                           data_idx_, static_cast<uindex_t> (next_point_),
+                                           static_cast<uindex_t> (next_point_ + nr_points));
+      batch.width = static_cast<uindex_t> (nr_points);
+      break;
+    }
+  }
+  if (res < 0)
+    return (res);
+
+  next_point_ += nr_points;
+  return (static_cast<int> (nr_points));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamWriter::open (const std::string &file_name, const pcl::PCLPointCloud2 &layout,
+                            const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  close ();
+
+  if (layout.fields.empty () || layout.point_step == 0)
+  {
+    PCL_ERROR ("[pcl::PCDStreamWriter::open] The layout has no fields!\n");
+    return (-1);
+  }
+
+  // Generate the header for the largest number of points, so that the placeholders are
+  // wide enough for the final values
+  layout_.fields = layout.fields;
+  layout_.point_step = layout.point_step;
+  layout_.width = std::numeric_limits<std::uint32_t>::max ();
+  layout_.height = 1;
+  PCDWriter writer;
+  std::string header = writer.generateHeaderBinary (layout_, origin, orientation);
+  if (header.empty ())
+    return (-1);
+  width_pos_ = header.find ("\nWIDTH ") + 7;
+  points_pos_ = header.find ("\nPOINTS ") + 8;
+
+  fs_.open (file_name.c_str (), std::ios::binary | std::ios::trunc);
+  if (!fs_.is_open () || fs_.fail ())
+  {
+    PCL_ERROR ("[pcl::PCDStreamWriter::open] Could not open file '%s' for writing! Error : %s\n", file_name.c_str (), strerror (errno));
+    fs_.close ();
+    return (-1);
+  }
+  fs_ << header << PCDWriter::generateBinaryDataLine (header.size ());
+  nr_points_ = 0;
+  return (fs_ ? 0 : -1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamWriter::write (const pcl::PCLPointCloud2 &batch)
+{
+  if (!fs_.is_open ())
+  {
+    PCL_ERROR ("[pcl::PCDStreamWriter::write] No file is open!\n");
+    return (-1);
+  }
+
+  bool same_layout = batch.point_step == layout_.point_step && batch.fields.size () == layout_.fields.size ();
+  for (std::size_t d = 0; same_layout && d < batch.fields.size (); ++d)
+    same_layout = batch.fields[d].name == layout_.fields[d].name &&
+                  batch.fields[d].offset == layout_.fields[d].offset &&
+                  batch.fields[d].datatype == layout_.fields[d].datatype &&
+                  batch.fields[d].count == layout_.fields[d].count;
+  if (!same_layout)
+  {
+    PCL_ERROR ("[pcl::PCDStreamWriter::write] The fields of the batch (%s) differ from the ones of the file!\n",
+               pcl::getFieldsList (batch).c_str ());
+    return (-1);
+  }
+
+  const std::size_t nr_points = static_cast<std::size_t> (batch.width) * batch.height;
+  if (batch.data.size () != nr_points * batch.point_step)
+  {
+    PCL_ERROR ("[pcl::PCDStreamWriter::write] The batch has %zu bytes of data for %zu points!\n", batch.data.size (), nr_points);
+    return (-1);
+  }
+  if (nr_points_ + nr_points > std::numeric_limits<std::uint32_t>::max ())
+  {
+    PCL_ERROR ("[pcl::PCDStreamWriter::write] A PCD file can't hold more than %u points!\n", std::numeric_limits<std::uint32_t>::max ());
+    return (-1);
+  }
+
+  fs_.write (reinterpret_cast<const char*> (batch.data.data ()), batch.data.size ());
+  nr_points_ += nr_points;
+  return (fs_ ? 0 : -1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamWriter::close ()
+{
+  if (!fs_.is_open ())
+    return (0);
+
+  // Overwrite the placeholders, padding the values with spaces
+  std::string nr_points = std::to_string (nr_points_);
+  nr_points.resize (std::to_string (std::numeric_limits<std::uint32_t>::max ()).size (), ' ');
+  fs_.seekp (width_pos_);
+  fs_ << nr_points;
+  fs_.seekp (points_pos_);
+  fs_ << nr_points;
+
+  const bool good = static_cast<bool> (fs_);
+  fs_.close ();
+  if (!good)
+  {
+    PCL_ERROR ("[pcl::PCDStreamWriter::close] Error writing the number of points!\n");
+    return (-1);
+  }
+  return (0);
+}
@@ -0,0 +1,285 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/compression/rans_coder.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  /** \brief The symbol frequencies are normalized to sum to 2^scale_bits. */
+  constexpr unsigned int scale_bits = 14;
+  constexpr std::uint32_t scale = 1u << scale_bits;
+
+  /** \brief Lower bound of the normalization interval of the states, [rans_l, 256 * rans_l). */
+  constexpr std::uint32_t rans_l = 1u << 23;
+
+  /** \brief Number of interleaved states. */
+  constexpr unsigned int nr_states = 4;
+
+  /** \brief Size of the table of present symbols at the beginning of the compressed data. */
+  constexpr std::size_t bitmap_size = 256 / 8;
+
+  /** \brief Scale the symbol counts to frequencies summing to \a scale, keeping a frequency
+    * of at least 1 for every present symbol. */
+  void
+  normalizeFrequencies (const std::size_t counts[256], std::size_t total, std::uint32_t freqs[256])
+  {
+    std::uint32_t sum = 0;
+    int max_symbol = 0;
+    for (int s = 0; s < 256; ++s)
+    {
+      freqs[s] = 0;
+      if (counts[s] == 0)
+        continue;
+      freqs[s] = (std::max) (static_cast<std::uint32_t> (counts[s] * scale / total), 1u);
+      sum += freqs[s];
+      if (counts[s] > counts[max_symbol])
+        max_symbol = s;
+    }
+
+    if (sum < scale)
+      freqs[max_symbol] += scale - sum;
+
+    // Symbols raised to a frequency of 1 may make the sum exceed the scale: take the
+    // excess from the most frequent symbols
+    while (sum > scale)
+    {
+      std::uint32_t* max_freq = std::max_element (freqs, freqs + 256);
+      --(*max_freq);
+      --sum;
+    }
+  }
+
+  std::size_t
+  encodeBytes (const unsigned char* input, std::size_t size, std::vector<char>& output)
+  {
+    std::size_t counts[256] = {};
+    for (std::size_t i = 0; i < size; ++i)
+      ++counts[input[i]];
+
+    std::uint32_t freqs[256] = {};
+    std::uint32_t starts[256] = {};
+    if (size > 0)
+      normalizeFrequencies (counts, size, freqs);
+    for (int s = 1; s < 256; ++s)
+      starts[s] = starts[s - 1] + freqs[s - 1];
+
+    const std::size_t output_start = output.size ();
+
+    // Table of present symbols, and their frequencies
+    unsigned char bitmap[bitmap_size] = {};
+    for (int s = 0; s < 256; ++s)
+      if (freqs[s] > 0)
+        bitmap[s / 8] |= static_cast<unsigned char> (1 << (s % 8));
+    output.insert (output.end (), reinterpret_cast<const char*> (bitmap), reinterpret_cast<const char*> (bitmap) + bitmap_size);
+    for (int s = 0; s < 256; ++s)
+      if (freqs[s] > 0)
+      {
+        const std::uint16_t freq = static_cast<std::uint16_t> (freqs[s]);
+        output.insert (output.end (), reinterpret_cast<const char*> (&freq), reinterpret_cast<const char*> (&freq) + sizeof (freq));
+      }
+
+    // The symbols are encoded backwards, and the bytes written from the end of the buffer,
+    // so that the decoder reads them forwards. A symbol costs at most scale_bits bits.
+    std::vector<unsigned char> buffer (size * scale_bits / 8 + 2 * nr_states * sizeof (std::uint32_t) + 16);
+    unsigned char* ptr = buffer.data () + buffer.size ();
+    std::uint32_t states[nr_states] = {rans_l, rans_l, rans_l, rans_l};
+    for (std::size_t i = size; i-- > 0;)
+    {
+      std::uint32_t& x = states[i % nr_states];
+      const std::uint32_t freq = freqs[input[i]];
+      const std::uint32_t x_max = ((rans_l >> scale_bits) << 8) * freq;
+      while (x >= x_max)
+      {
+        *--ptr = static_cast<unsigned char> (x & 0xff);
+        x >>= 8;
+      }
+      x = ((x / freq) << scale_bits) + (x % freq) + starts[input[i]];
+    }
+
+    // Flush the states, the first one last so that the decoder reads it first
+    for (unsigned int j = nr_states; j-- > 0;)
+    {
+      ptr -= 4;
+      ptr[0] = static_cast<unsigned char> (states[j]);
+      ptr[1] = static_cast<unsigned char> (states[j] >> 8);
+      ptr[2] = static_cast<unsigned char> (states[j] >> 16);
+      ptr[3] = static_cast<unsigned char> (states[j] >> 24);
+    }
+
+    const std::uint32_t payload_size = static_cast<std::uint32_t> (buffer.data () + buffer.size () - ptr);
+    output.insert (output.end (), reinterpret_cast<const char*> (&payload_size), reinterpret_cast<const char*> (&payload_size) + sizeof (payload_size));
+    output.insert (output.end (), ptr, ptr + payload_size);
+    return (output.size () - output_start);
+  }
+
+  std::size_t
+  decodeBytes (const unsigned char* input, std::size_t input_size, unsigned char* output, std::size_t size)
+  {
+    // Table of present symbols, and their frequencies
+    if (input_size < bitmap_size)
+      return (0);
+    const unsigned char* ptr = input;
+    const unsigned char* const input_end = input + input_size;
+    const unsigned char* const bitmap = ptr;
+    ptr += bitmap_size;
+
+    std::uint32_t freqs[256] = {};
+    std::uint32_t starts[256] = {};
+    std::uint32_t sum = 0;
+    for (int s = 0; s < 256; ++s)
+    {
+      if (!(bitmap[s / 8] & (1 << (s % 8))))
+        continue;
+      std::uint16_t freq;
+      if (input_end - ptr < static_cast<std::ptrdiff_t> (sizeof (freq)))
+        return (0);
+      std::memcpy (&freq, ptr, sizeof (freq));
+      ptr += sizeof (freq);
+      freqs[s] = freq;
+      starts[s] = sum;
+      sum += freq;
+    }
+
+    std::uint32_t payload_size;
+    if (input_end - ptr < static_cast<std::ptrdiff_t> (sizeof (payload_size)))
+      return (0);
+    std::memcpy (&payload_size, ptr, sizeof (payload_size));
+    ptr += sizeof (payload_size);
+    if (static_cast<std::size_t> (input_end - ptr) < payload_size)
+      return (0);
+    const unsigned char* const payload_end = ptr + payload_size;
+
+    if (size == 0)
+      return (payload_end - input);
+    if (sum != scale || payload_size < nr_states * 4)
+      return (0);
+
+    // Symbol of each slot of [0, scale)
+    unsigned char symbols[scale];
+    for (int s = 0; s < 256; ++s)
+      std::fill (symbols + starts[s], symbols + starts[s] + freqs[s], static_cast<unsigned char> (s));
+
+    std::uint32_t states[nr_states];
+    for (auto& x : states)
+    {
+      x = static_cast<std::uint32_t> (ptr[0]) | static_cast<std::uint32_t> (ptr[1]) << 8 |
+          static_cast<std::uint32_t> (ptr[2]) << 16 | static_cast<std::uint32_t> (ptr[3]) << 24;
+      ptr += 4;
+    }
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+      std::uint32_t& x = states[i % nr_states];
+      const std::uint32_t slot = x & (scale - 1);
+      const unsigned char s = symbols[slot];
+      x = freqs[s] * (x >> scale_bits) + slot - starts[s];
+      while (x < rans_l && ptr < payload_end)
+        x = (x << 8) | *ptr++;
+      output[i] = s;
+    }
+
+    if (ptr != payload_end)
+      return (0);
+    return (payload_end - input);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::RANSCoder::encode (const char* input, std::size_t size, std::vector<char>& output) const
+{
+  return (encodeBytes (reinterpret_cast<const unsigned char*> (input), size, output));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::RANSCoder::encode (const unsigned int* input, std::size_t size, std::vector<char>& output) const
+{
+  // The integers are split in byte planes, from the least significant one. Only the planes
+  // holding non-zero bytes are encoded.
+  const unsigned int max_value = size > 0 ? *std::max_element (input, input + size) : 0;
+  unsigned char nr_planes = 0;
+  while (nr_planes < sizeof (unsigned int) && (max_value >> (8 * nr_planes)) != 0)
+    ++nr_planes;
+
+  const std::size_t output_start = output.size ();
+  output.push_back (static_cast<char> (nr_planes));
+
+  std::vector<unsigned char> plane (size);
+  for (unsigned char p = 0; p < nr_planes; ++p)
+  {
+    for (std::size_t i = 0; i < size; ++i)
+      plane[i] = static_cast<unsigned char> (input[i] >> (8 * p));
+    encodeBytes (plane.data (), size, output);
+  }
+  return (output.size () - output_start);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::RANSCoder::decode (const char* input, std::size_t input_size, char* output, std::size_t size) const
+{
+  return (decodeBytes (reinterpret_cast<const unsigned char*> (input), input_size, reinterpret_cast<unsigned char*> (output), size));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::RANSCoder::decode (const char* input, std::size_t input_size, unsigned int* output, std::size_t size) const
+{
+  if (input_size < 1)
+    return (0);
+  const unsigned char nr_planes = static_cast<unsigned char> (input[0]);
+  if (nr_planes > sizeof (unsigned int))
+    return (0);
+  std::size_t read_bytes = 1;
+
+  std::fill (output, output + size, 0u);
+  std::vector<unsigned char> plane (size);
+  for (unsigned char p = 0; p < nr_planes; ++p)
+  {
+    const std::size_t plane_bytes = decodeBytes (reinterpret_cast<const unsigned char*> (input) + read_bytes, input_size - read_bytes, plane.data (), size);
+    if (plane_bytes == 0)
+      return (0);
+    read_bytes += plane_bytes;
+    for (std::size_t i = 0; i < size; ++i)
+      output[i] |= static_cast<unsigned int> (plane[i]) << (8 * p);
+  }
+  return (read_bytes);
+}
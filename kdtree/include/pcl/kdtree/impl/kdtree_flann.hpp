@@ -43,6 +43,9 @@
 
 #include <pcl/kdtree/kdtree_flann.h>
 #include <pcl/console/print.h>
+#include <pcl/pcl_base.h> // for UNAVAILABLE
+
+#include <limits>
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist>
@@ -407,6 +410,185 @@ pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius
   return (neighbors_in_radius);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> int
+pcl::KdTreeFLANN<PointT, Dist>::nearestKSearch (const PointT &point, unsigned int k,
+                                                SearchBuffers &buffers) const
+{
+  assert (point_representation_->isValid (point) && "Invalid (NaN, Inf) point coordinates given to nearestKSearch!");
+
+  if (k > total_nr_points_)
+    k = total_nr_points_;
+
+  buffers.indices.resize (k);
+  buffers.sqr_distances.resize (k);
+
+  if (k == 0)
+    return 0;
+
+  buffers.query.resize (dim_);
+  point_representation_->vectorize (point, buffers.query);
+
+  // FLANN always provides the search with std::size_t indices, use a reusable buffer for them
+  buffers.flann_indices.resize (1);
+  buffers.flann_indices[0].resize (k);
+
+  // Wrap the buffers (no data copy)
+  ::flann::Matrix<float> query_mat (&buffers.query[0], 1, dim_);
+  ::flann::Matrix<std::size_t> k_indices_mat (&buffers.flann_indices[0][0], 1, k);
+  ::flann::Matrix<float> k_distances_mat (&buffers.sqr_distances[0], 1, k);
+  flann_index_->knnSearch (query_mat, k_indices_mat, k_distances_mat, k, param_k_);
+
+  // Convert the indices, and do mapping to original point cloud
+  for (std::size_t i = 0; i < static_cast<std::size_t> (k); ++i)
+  {
+    const auto neighbor_index = buffers.flann_indices[0][i];
+    buffers.indices[i] = identity_mapping_ ? static_cast<index_t> (neighbor_index) : index_mapping_[neighbor_index];
+  }
+
+  return (k);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename Dist> int
+pcl::KdTreeFLANN<PointT, Dist>::radiusSearch (const PointT &point, double radius,
+                                              SearchBuffers &buffers, unsigned int max_nn) const
+{
+  assert (point_representation_->isValid (point) && "Invalid (NaN, Inf) point coordinates given to radiusSearch!");
+
+  buffers.query.resize (dim_);
+  point_representation_->vectorize (point, buffers.query);
+
+  // Has max_nn been set properly?
+  if (max_nn == 0 || max_nn > total_nr_points_)
+    max_nn = total_nr_points_;
+
+  ::flann::SearchParams params (param_radius_);
+  if (max_nn == total_nr_points_)
+    params.max_neighbors = -1;  // return all neighbors in radius
+  else
+    params.max_neighbors = max_nn;
+
+  // FLANN resizes the inner vectors only, which keeps their capacity between calls.
+  // The distances are swapped in and out to avoid copying them.
+  buffers.flann_indices.resize (1);
+  buffers.flann_sqr_distances.resize (1);
+  buffers.flann_sqr_distances[0].swap (buffers.sqr_distances);
+
+  ::flann::Matrix<float> query_mat (&buffers.query[0], 1, dim_);
+  const int neighbors_in_radius = flann_index_->radiusSearch (query_mat,
+                                                              buffers.flann_indices,
+                                                              buffers.flann_sqr_distances,
+                                                              static_cast<float> (radius * radius),
+                                                              params);
+
+  buffers.sqr_distances.swap (buffers.flann_sqr_distances[0]);
+
+  // Convert the indices, and do mapping to original point cloud
+  const auto& flann_indices = buffers.flann_indices[0];
+  buffers.indices.resize (flann_indices.size ());
+  for (std::size_t i = 0; i < flann_indices.size (); ++i)
+  {
+    const auto neighbor_index = flann_indices[i];
+    buffers.indices[i] = identity_mapping_ ? static_cast<index_t> (neighbor_index) : index_mapping_[neighbor_index];
+  }
+
+  return (neighbors_in_radius);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+namespace pcl {
+namespace detail {
+// Replace using constexpr in C++17
+template <class IndexT,
+          class A,
+          class B,
+          class D,
+          class F,
+          CompatWithFlann<IndexT> = true>
+int
+knn_search_batch(A& index, B& queries, Indices& k_indices, D& dists, unsigned int k, F& params)
+{
+  // Wrap k_indices vector (no data allocation), with the same row stride as dists
+  ::flann::Matrix<index_t> k_indices_mat(
+      &k_indices[0], queries.rows, k, dists.stride / sizeof(float) * sizeof(index_t));
+  return index.knnSearch(queries, k_indices_mat, dists, k, params);
+}
+
+template <class IndexT,
+          class A,
+          class B,
+          class D,
+          class F,
+          NotCompatWithFlann<IndexT> = true>
+int
+knn_search_batch(A& index, B& queries, Indices& k_indices, D& dists, unsigned int k, F& params)
+{
+  std::vector<std::size_t> indices(queries.rows * k);
+  // Wrap indices vector (no data allocation)
+  ::flann::Matrix<std::size_t> indices_mat(&indices[0], queries.rows, k);
+  auto ret = index.knnSearch(queries, indices_mat, dists, k, params);
+  const std::size_t stride = dists.stride / sizeof(float);
+  for (std::size_t i = 0; i < queries.rows; ++i)
+    std::copy_n(indices.cbegin() + i * k, k, k_indices.begin() + i * stride);
+  return ret;
+}
+} // namespace detail
+} // namespace pcl
+
+template <typename PointT, typename Dist> void
+pcl::KdTreeFLANN<PointT, Dist>::batchNearestKSearch (const PointCloud &cloud,
+                                                     const Indices &indices,
+                                                     unsigned int k,
+                                                     Indices &k_indices,
+                                                     std::vector<float> &k_sqr_distances,
+                                                     unsigned int nr_threads) const
+{
+  const std::size_t nr_queries = indices.empty () ? cloud.size () : indices.size ();
+  k_indices.assign (nr_queries * k, UNAVAILABLE);
+  k_sqr_distances.assign (nr_queries * k, std::numeric_limits<float>::infinity ());
+
+  // The rows of the output keep the requested stride even if fewer points are available
+  const unsigned int stride = k;
+  if (k > total_nr_points_)
+    k = total_nr_points_;
+  if (k == 0 || nr_queries == 0)
+    return;
+
+  std::vector<float> queries (nr_queries * dim_);
+  for (std::size_t i = 0; i < nr_queries; ++i)
+  {
+    const PointT &point = indices.empty () ? cloud[i] : cloud[indices[i]];
+    assert (point_representation_->isValid (point) && "Invalid (NaN, Inf) point coordinates given to batchNearestKSearch!");
+    float* query_ptr = &queries[i * dim_];
+    point_representation_->vectorize (point, query_ptr);
+  }
+
+  ::flann::SearchParams params (param_k_);
+  params.cores = static_cast<int> (nr_threads);
+
+  ::flann::Matrix<float> queries_mat (&queries[0], nr_queries, dim_);
+  // Wrap the k_sqr_distances vector (no data copy)
+  ::flann::Matrix<float> k_distances_mat (&k_sqr_distances[0], nr_queries, k, stride * sizeof (float));
+  detail::knn_search_batch<pcl::index_t> (*flann_index_,
+                                          queries_mat,
+                                          k_indices,
+                                          k_distances_mat,
+                                          k,
+                                          params);
+
+  // Do mapping to original point cloud
+  if (!identity_mapping_)
+  {
+    for (std::size_t i = 0; i < nr_queries; ++i)
+      for (std::size_t j = 0; j < k; ++j)
+      {
+        auto& neighbor_index = k_indices[i * stride + j];
+        neighbor_index = index_mapping_[neighbor_index];
+      }
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename Dist> void
 pcl::KdTreeFLANN<PointT, Dist>::cleanup ()
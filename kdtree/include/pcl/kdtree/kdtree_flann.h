@@ -151,6 +151,26 @@ public:
   using Ptr = shared_ptr<KdTreeFLANN<PointT, Dist>>;
   using ConstPtr = shared_ptr<const KdTreeFLANN<PointT, Dist>>;
 
+  /** \brief Caller-owned buffers holding the results of a search and the scratch space
+   * needed to run it.
+   *
+   * Reusing the same buffers for all the queries of a loop (one per thread) avoids any
+   * memory allocation on the PCL side once the buffers have grown to the size of the
+   * largest result.
+   */
+  struct SearchBuffers {
+    /** \brief The indices of the neighbors found by the last search. */
+    Indices indices;
+    /** \brief The squared distances to the neighbors found by the last search. */
+    std::vector<float> sqr_distances;
+    /** \brief The vectorized query point. */
+    std::vector<float> query;
+    /** \brief The indices in the native index type of FLANN. */
+    std::vector<std::vector<std::size_t>> flann_indices;
+    /** \brief The squared distances as returned by FLANN. */
+    std::vector<std::vector<float>> flann_sqr_distances;
+  };
+
   /** \brief Default Constructor for KdTreeFLANN.
    * \param[in] sorted set to true if the application that the tree will be used for
    * requires sorted nearest neighbor indices (default). False otherwise.
@@ -256,6 +276,70 @@ public:
                std::vector<float>& k_sqr_distances,
                unsigned int max_nn = 0) const override;
 
+  /** \brief Search for k-nearest neighbors for the given query point, storing the
+   * results in caller-owned buffers.
+   *
+   * Contrary to the std::vector based overload, no temporary memory is allocated for
+   * the query point or for the conversion of the indices, so passing the same \a
+   * buffers to every call of a loop makes the search allocation free in steady state.
+   *
+   * \param[in] point a given \a valid (i.e., finite) query point
+   * \param[in] k the number of neighbors to search for
+   * \param[in,out] buffers the buffers receiving the indices and squared distances of
+   * the neighboring points in \a buffers.indices and \a buffers.sqr_distances
+   * \return number of neighbors found
+   */
+  int
+  nearestKSearch(const PointT& point, unsigned int k, SearchBuffers& buffers) const;
+
+  /** \brief Search for all the nearest neighbors of the query point in a given radius,
+   * storing the results in caller-owned buffers.
+   *
+   * Contrary to the std::vector based overload, no temporary memory is allocated for
+   * the query point or for the results returned by FLANN, so passing the same \a
+   * buffers to every call of a loop makes the search allocation free in steady state.
+   *
+   * \param[in] point a given \a valid (i.e., finite) query point
+   * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+   * \param[in,out] buffers the buffers receiving the indices and squared distances of
+   * the neighboring points in \a buffers.indices and \a buffers.sqr_distances
+   * \param[in] max_nn if given, bounds the maximum returned neighbors to this value. If
+   * \a max_nn is set to 0 or to a number higher than the number of points in the input
+   * cloud, all neighbors in \a radius will be returned.
+   * \return number of neighbors found in radius
+   */
+  int
+  radiusSearch(const PointT& point,
+               double radius,
+               SearchBuffers& buffers,
+               unsigned int max_nn = 0) const;
+
+  /** \brief Search for the k-nearest neighbors of several query points at once, using
+   * a single multi-query FLANN search.
+   *
+   * The results are stored in flat buffers: the neighbors of the i-th query point are
+   * at positions [i * k, (i + 1) * k) of \a k_indices and \a k_sqr_distances. If fewer
+   * than \a k points are in the tree, the remaining positions are set to UNAVAILABLE
+   * and to std::numeric_limits<float>::infinity () respectively.
+   *
+   * \param[in] cloud the point cloud containing the \a valid (i.e., finite) query points
+   * \param[in] indices the indices of the query points in \a cloud. If empty, all points
+   * of \a cloud are queried.
+   * \param[in] k the number of neighbors to search for
+   * \param[out] k_indices the resultant indices of the neighboring points
+   * \param[out] k_sqr_distances the resultant squared distances to the neighboring
+   * points
+   * \param[in] nr_threads the number of threads FLANN uses to process the query points
+   * (0 to use all the available processors)
+   */
+  void
+  batchNearestKSearch(const PointCloud& cloud,
+                      const Indices& indices,
+                      unsigned int k,
+                      Indices& k_indices,
+                      std::vector<float>& k_sqr_distances,
+                      unsigned int nr_threads = 1) const;
+
 private:
   /** \brief Internal cleanup method. */
   void
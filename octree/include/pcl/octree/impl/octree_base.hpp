@@ -52,6 +52,7 @@ OctreeBase<LeafContainerT, BranchContainerT>::OctreeBase()
 , depth_mask_(0)
 , octree_depth_(0)
 , dynamic_depth_enabled_(false)
+, contiguous_children_(false)
 {}
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -164,11 +165,54 @@ OctreeBase<LeafContainerT, BranchContainerT>::deleteTree()
   if (root_node_) {
     // reset octree
     deleteBranch(*root_node_);
+    // all the nodes are released - reuse their memory from the start
+    branch_pool_.resetPool();
+    leaf_pool_.resetPool();
     leaf_count_ = 0;
     branch_count_ = 1;
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename LeafContainerT, typename BranchContainerT>
+void
+OctreeBase<LeafContainerT, BranchContainerT>::addRootParent(unsigned char child_idx_arg)
+{
+  BranchNode* new_root = new BranchNode();
+
+  // the root is not allocated from the pool - move it to a child of the new root
+  BranchNode* child_branch = createBranchChild(*new_root, child_idx_arg);
+  child_branch->getContainer() = root_node_->getContainer();
+  for (unsigned char i = 0; i < 8; i++)
+    child_branch->setChildPtr(root_node_->getChildPtr(i), i);
+
+  delete (root_node_);
+  root_node_ = new_root;
+  branch_count_++;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename LeafContainerT, typename BranchContainerT>
+void
+OctreeBase<LeafContainerT, BranchContainerT>::copyBranch(const BranchNode& source_arg,
+                                                         BranchNode& target_arg)
+{
+  target_arg.getContainer() = source_arg.getContainer();
+
+  for (unsigned char i = 0; i < 8; i++) {
+    const OctreeNode* child_node = source_arg.getChildPtr(i);
+    if (!child_node)
+      continue;
+
+    if (child_node->getNodeType() == BRANCH_NODE)
+      copyBranch(*static_cast<const BranchNode*>(child_node),
+                 *createBranchChild(target_arg, i));
+    else
+      createLeafChild(target_arg, i)->getContainer() =
+          static_cast<const LeafNode*>(child_node)->getContainer();
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename LeafContainerT, typename BranchContainerT>
 void
@@ -339,6 +383,68 @@ OctreeBase<LeafContainerT, BranchContainerT>::createLeafRecursive(
   return (depth_mask_arg >> 1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename LeafContainerT, typename BranchContainerT>
+uindex_t
+OctreeBase<LeafContainerT, BranchContainerT>::createLeafRecursive(
+    const OctreeKey& key_arg,
+    uindex_t depth_mask_arg,
+    BranchNode* branch_arg,
+    LeafNode*& return_leaf_arg,
+    BranchNode*& parent_of_leaf_arg,
+    SubtreeNodes& subtree_nodes_arg)
+{
+  // find branch child from key
+  const unsigned char child_idx = key_arg.getChildIdxWithDepthMask(depth_mask_arg);
+
+  OctreeNode* child_node = (*branch_arg)[child_idx];
+
+  if (!child_node) {
+    if ((!dynamic_depth_enabled_) && (depth_mask_arg > 1)) {
+      // if required branch does not exist -> create it
+      BranchNode* child_branch = allocateChild(
+          subtree_nodes_arg.branch_pool, *branch_arg, child_idx, BRANCH_NODE);
+      (*branch_arg)[child_idx] = child_branch;
+      subtree_nodes_arg.branch_count++;
+
+      // recursively proceed with indexed child branch
+      return createLeafRecursive(key_arg,
+                                 depth_mask_arg / 2,
+                                 child_branch,
+                                 return_leaf_arg,
+                                 parent_of_leaf_arg,
+                                 subtree_nodes_arg);
+    }
+    // if leaf node at child_idx does not exist
+    LeafNode* leaf_node =
+        allocateChild(subtree_nodes_arg.leaf_pool, *branch_arg, child_idx, LEAF_NODE);
+    (*branch_arg)[child_idx] = leaf_node;
+    return_leaf_arg = leaf_node;
+    parent_of_leaf_arg = branch_arg;
+    subtree_nodes_arg.leaf_count++;
+  }
+  else {
+    // Node exists already
+    switch (child_node->getNodeType()) {
+    case BRANCH_NODE:
+      // recursively proceed with indexed child branch
+      return createLeafRecursive(key_arg,
+                                 depth_mask_arg / 2,
+                                 static_cast<BranchNode*>(child_node),
+                                 return_leaf_arg,
+                                 parent_of_leaf_arg,
+                                 subtree_nodes_arg);
+
+    case LEAF_NODE:
+      return_leaf_arg = static_cast<LeafNode*>(child_node);
+      parent_of_leaf_arg = branch_arg;
+      break;
+    }
+  }
+
+  return (depth_mask_arg >> 1);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename LeafContainerT, typename BranchContainerT>
 void
@@ -43,7 +43,110 @@
 #include <pcl/octree/impl/octree_base.hpp>
 #include <pcl/types.h>
 
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <utility>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace pcl {
+namespace octree {
+namespace detail {
+//////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Spread the 21 lowest bits of a value, so that they occupy every third bit. */
+inline std::uint64_t
+spreadMortonBits(std::uint64_t value)
+{
+  value &= 0x1fffff;
+  value = (value | (value << 32)) & 0x1f00000000ffff;
+  value = (value | (value << 16)) & 0x1f0000ff0000ff;
+  value = (value | (value << 8)) & 0x100f00f00f00f00f;
+  value = (value | (value << 4)) & 0x10c30c30c30c30c3;
+  value = (value | (value << 2)) & 0x1249249249249249;
+  return value;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Morton code of an octree key of at most 21 bits per axis: the bits of x, y
+ * and z are interleaved like the child indices, so that sorting the codes orders the
+ * keys like a depth-first traversal of the octree. */
+inline std::uint64_t
+getMortonCode(const OctreeKey& key_arg)
+{
+  return (spreadMortonBits(key_arg.x) << 2) | (spreadMortonBits(key_arg.y) << 1) |
+         spreadMortonBits(key_arg.z);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Stable sort of (Morton code, point index) pairs by code, with a parallel LSD
+ * radix sort of the nr_bits lowest bits of the codes. */
+inline void
+sortMortonCodes(std::vector<std::pair<std::uint64_t, index_t>>& codes_arg,
+                unsigned int nr_bits_arg,
+                unsigned int nr_threads_arg)
+{
+  const std::size_t nr_codes = codes_arg.size();
+  // each thread counts and scatters a contiguous chunk of the codes
+  const std::size_t nr_chunks =
+      std::max<std::size_t>(std::min<std::size_t>(nr_threads_arg, nr_codes / 4096), 1);
+  const std::size_t chunk_size = (nr_codes + nr_chunks - 1) / nr_chunks;
+
+  std::vector<std::pair<std::uint64_t, index_t>> buffer(nr_codes);
+  std::vector<std::array<std::size_t, 256>> offsets(nr_chunks);
+
+  for (unsigned int shift = 0; shift < nr_bits_arg; shift += 8) {
+#pragma omp parallel for \
+  default(none) \
+  shared(codes_arg, offsets) \
+  firstprivate(nr_codes, nr_chunks, chunk_size, shift) \
+  num_threads(nr_threads_arg)
+    for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t>(nr_chunks);
+         ++chunk) {
+      auto& counts = offsets[chunk];
+      counts.fill(0);
+      const std::size_t end = std::min(nr_codes, (chunk + 1) * chunk_size);
+      for (std::size_t i = chunk * chunk_size; i < end; ++i)
+        ++counts[(codes_arg[i].first >> shift) & 0xff];
+    }
+
+    // turn the counts into the first position of each digit in each chunk
+    std::size_t position = 0;
+    bool single_digit = false;
+    for (std::size_t digit = 0; digit < 256; ++digit) {
+      const std::size_t digit_begin = position;
+      for (auto& chunk_offsets : offsets) {
+        const std::size_t count = chunk_offsets[digit];
+        chunk_offsets[digit] = position;
+        position += count;
+      }
+      single_digit |= (position - digit_begin == nr_codes);
+    }
+
+    // all the codes have the same digit, they are already sorted by it
+    if (single_digit)
+      continue;
+
+#pragma omp parallel for \
+  default(none) \
+  shared(codes_arg, buffer, offsets) \
+  firstprivate(nr_codes, nr_chunks, chunk_size, shift) \
+  num_threads(nr_threads_arg)
+    for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t>(nr_chunks);
+         ++chunk) {
+      auto& positions = offsets[chunk];
+      const std::size_t end = std::min(nr_codes, (chunk + 1) * chunk_size);
+      for (std::size_t i = chunk * chunk_size; i < end; ++i)
+        buffer[positions[(codes_arg[i].first >> shift) & 0xff]++] = codes_arg[i];
+    }
+    codes_arg.swap(buffer);
+  }
+}
+} // namespace detail
+} // namespace octree
+} // namespace pcl
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT,
@@ -65,6 +168,7 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
 , max_z_(resolution)
 , bounding_box_defined_(false)
 , max_objs_per_leaf_(0)
+, threads_(1)
 {
   assert(resolution > 0.0f);
 }
@@ -77,6 +181,184 @@ template <typename PointT,
 void
 pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
     addPointsFromInputCloud()
+{
+  // the leaves of dynamic depth octrees depend on the order of the points
+  if (this->dynamic_depth_enabled_) {
+    addPointsIncrementally();
+    return;
+  }
+
+  // adopt the bounding box to the points in the same order as addPointIdx, which gives
+  // the same octree
+  Indices valid_indices;
+  if (indices_) {
+    valid_indices.reserve(indices_->size());
+    for (const auto& index : *indices_) {
+      assert((index >= 0) && (static_cast<std::size_t>(index) < input_->size()));
+
+      if (isFinite((*input_)[index])) {
+        adoptBoundingBoxToPoint((*input_)[index]);
+        valid_indices.push_back(index);
+      }
+    }
+  }
+  else {
+    valid_indices.reserve(input_->size());
+    for (index_t i = 0; i < static_cast<index_t>(input_->size()); i++) {
+      if (isFinite((*input_)[i])) {
+        adoptBoundingBoxToPoint((*input_)[i]);
+        valid_indices.push_back(i);
+      }
+    }
+  }
+
+  // Morton codes hold 21 bits per axis
+  if (this->octree_depth_ > 21) {
+    for (const auto& index : valid_indices)
+      this->addPointIdx(index);
+    return;
+  }
+
+  // sort the points by the Morton codes of their voxels
+  std::vector<std::pair<std::uint64_t, index_t>> codes(valid_indices.size());
+#pragma omp parallel for \
+  default(none) \
+  shared(codes, valid_indices) \
+  num_threads(threads_)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(valid_indices.size());
+       ++i) {
+    OctreeKey key;
+    genOctreeKeyforPoint((*input_)[valid_indices[i]], key);
+    codes[i] = std::make_pair(detail::getMortonCode(key), valid_indices[i]);
+  }
+  detail::sortMortonCodes(codes, 3 * this->octree_depth_, threads_);
+
+  if (threads_ > 1)
+    addSortedPointsInParallel(codes);
+  else
+    addSortedPoints(codes);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT,
+          typename LeafContainerT,
+          typename BranchContainerT,
+          typename OctreeT>
+void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
+    addSortedPoints(const std::vector<std::pair<std::uint64_t, index_t>>& codes_arg)
+{
+  // create the leaf of each voxel in depth-first order, and add its points
+  LeafNode* leaf_node = nullptr;
+  BranchNode* parent_branch_of_leaf_node;
+  for (std::size_t i = 0; i < codes_arg.size(); ++i) {
+    if ((i == 0) || (codes_arg[i].first != codes_arg[i - 1].first)) {
+      OctreeKey key;
+      genOctreeKeyforPoint((*input_)[codes_arg[i].second], key);
+      this->createLeafRecursive(key,
+                                this->depth_mask_,
+                                this->root_node_,
+                                leaf_node,
+                                parent_branch_of_leaf_node);
+    }
+
+    addPointIdxToLeaf(leaf_node->getContainer(), codes_arg[i].second);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT,
+          typename LeafContainerT,
+          typename BranchContainerT,
+          typename OctreeT>
+template <typename OctreeBaseT>
+std::enable_if_t<std::is_base_of<pcl::octree::OctreeBase<LeafContainerT, BranchContainerT>,
+                                 OctreeBaseT>::value>
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
+    addSortedPointsInParallel(
+        const std::vector<std::pair<std::uint64_t, index_t>>& codes_arg)
+{
+  if (this->octree_depth_ < 2) {
+    addSortedPoints(codes_arg);
+    return;
+  }
+
+  // the subtrees below split_depth are built in parallel: use enough of them to keep
+  // the threads busy, even if the points are unevenly distributed
+  unsigned int split_depth = 1;
+  while ((split_depth + 1 < this->octree_depth_) &&
+         ((std::size_t(1) << (3 * split_depth)) < 8 * std::size_t(threads_)))
+    split_depth++;
+  const uindex_t subtree_depth_mask = this->depth_mask_ >> split_depth;
+
+  // the codes of each subtree form a range, as they share their highest bits
+  const unsigned int shift = 3 * (this->octree_depth_ - split_depth);
+  std::vector<std::size_t> subtree_begin;
+  for (std::size_t i = 0; i < codes_arg.size(); ++i)
+    if ((i == 0) || ((codes_arg[i].first >> shift) != (codes_arg[i - 1].first >> shift)))
+      subtree_begin.push_back(i);
+  const std::size_t nr_subtrees = subtree_begin.size();
+  subtree_begin.push_back(codes_arg.size());
+
+  // create the branch nodes down to the root of each subtree
+  std::vector<BranchNode*> subtree_roots(nr_subtrees);
+  for (std::size_t subtree = 0; subtree < nr_subtrees; ++subtree) {
+    OctreeKey key;
+    genOctreeKeyforPoint((*input_)[codes_arg[subtree_begin[subtree]].second], key);
+    BranchNode* branch = this->root_node_;
+    for (uindex_t depth_mask = this->depth_mask_; depth_mask > subtree_depth_mask;
+         depth_mask >>= 1) {
+      const unsigned char child_idx = key.getChildIdxWithDepthMask(depth_mask);
+      if (!branch->hasChild(child_idx)) {
+        this->createBranchChild(*branch, child_idx);
+        this->branch_count_++;
+      }
+      branch = static_cast<BranchNode*>((*branch)[child_idx]);
+    }
+    subtree_roots[subtree] = branch;
+  }
+
+  // build each subtree from its own node pools, then hand the nodes to the octree
+  std::vector<typename OctreeT::SubtreeNodes> subtree_nodes(nr_subtrees);
+#pragma omp parallel for \
+  default(none) \
+  shared(codes_arg, subtree_begin, subtree_roots, subtree_nodes) \
+  firstprivate(nr_subtrees, subtree_depth_mask) \
+  schedule(dynamic, 1) \
+  num_threads(threads_)
+  for (std::ptrdiff_t subtree = 0; subtree < static_cast<std::ptrdiff_t>(nr_subtrees);
+       ++subtree) {
+    LeafNode* leaf_node = nullptr;
+    BranchNode* parent_branch_of_leaf_node;
+    const std::size_t begin = subtree_begin[subtree];
+    for (std::size_t i = begin; i < subtree_begin[subtree + 1]; ++i) {
+      if ((i == begin) || (codes_arg[i].first != codes_arg[i - 1].first)) {
+        OctreeKey key;
+        genOctreeKeyforPoint((*input_)[codes_arg[i].second], key);
+        this->createLeafRecursive(key,
+                                  subtree_depth_mask,
+                                  subtree_roots[subtree],
+                                  leaf_node,
+                                  parent_branch_of_leaf_node,
+                                  subtree_nodes[subtree]);
+      }
+
+      addPointIdxToLeaf(leaf_node->getContainer(), codes_arg[i].second);
+    }
+  }
+
+  for (auto& nodes : subtree_nodes)
+    this->mergeSubtreeNodes(nodes);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT,
+          typename LeafContainerT,
+          typename BranchContainerT,
+          typename OctreeT>
+void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
+    addPointsIncrementally()
 {
   if (indices_) {
     for (const auto& index : *indices_) {
@@ -98,6 +380,25 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT,
+          typename LeafContainerT,
+          typename BranchContainerT,
+          typename OctreeT>
+void
+pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>::
+    setNumberOfThreads(unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT,
           typename LeafContainerT,
@@ -540,14 +841,7 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
                                                ((!bUpperBoundViolationY) << 1) |
                                                ((!bUpperBoundViolationZ)));
 
-        BranchNode* newRootBranch;
-
-        newRootBranch = new BranchNode();
-        this->branch_count_++;
-
-        this->setBranchChildPtr(*newRootBranch, child_idx, this->root_node_);
-
-        this->root_node_ = newRootBranch;
+        this->addRootParent(child_idx);
 
         octreeSideLen = static_cast<double>(1 << this->octree_depth_) * resolution_;
 
@@ -690,7 +984,7 @@ pcl::octree::OctreePointCloud<PointT, LeafContainerT, BranchContainerT, OctreeT>
     }
   }
 
-  (*leaf_node)->addPointIndex(point_idx_arg);
+  addPointIdxToLeaf(leaf_node->getContainer(), point_idx_arg);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
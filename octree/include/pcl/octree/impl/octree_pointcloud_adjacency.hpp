@@ -95,7 +95,8 @@ pcl::octree::OctreePointCloudAdjacency<PointT, LeafContainerT, BranchContainerT>
   }
   this->defineBoundingBox(minX, minY, minZ, maxX, maxY, maxZ);
 
-  OctreePointCloud<PointT, LeafContainerT, BranchContainerT>::addPointsFromInputCloud();
+  // the keys depend on the transform function, the points are added one at a time
+  this->addPointsIncrementally();
 
   leaf_vector_.reserve(this->getLeafCount());
   for (auto leaf_itr = this->leaf_depth_begin(); leaf_itr != this->leaf_depth_end();
@@ -808,6 +808,20 @@ protected:
     return new_leaf_child;
   }
 
+  /** \brief Add a level above the root node: a new root branch node is created, and
+   * the current root becomes its child.
+   *  \param child_idx_arg: index of the current root in the new one
+   */
+  inline void
+  addRootParent(unsigned char child_idx_arg)
+  {
+    BranchNode* new_root = new BranchNode();
+    setBranchChildPtr(*new_root, child_idx_arg, root_node_);
+
+    root_node_ = new_root;
+    branch_count_++;
+  }
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // Recursive octree methods
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
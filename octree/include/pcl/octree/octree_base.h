@@ -38,12 +38,15 @@
 
 #pragma once
 
+#include <pcl/console/print.h>
 #include <pcl/octree/octree_container.h>
 #include <pcl/octree/octree_iterator.h>
 #include <pcl/octree/octree_key.h>
+#include <pcl/octree/octree_node_pool.h>
 #include <pcl/octree/octree_nodes.h>
 #include <pcl/pcl_macros.h>
 
+#include <new>
 #include <vector>
 
 namespace pcl {
@@ -95,6 +98,24 @@ protected:
   /** \brief key range */
   OctreeKey max_key_;
 
+  /** \brief Store the children of a branch contiguously **/
+  bool contiguous_children_;
+
+  /** \brief Memory pools of the nodes below the root, reused after deleteTree() **/
+  OctreeNodePool<BranchNode> branch_pool_;
+  OctreeNodePool<LeafNode> leaf_pool_;
+
+  /** \brief Memory pools and counts of the nodes created below a branch. Disjoint
+   * subtrees can be built in parallel, each from its own SubtreeNodes, which are then
+   * merged into the octree with mergeSubtreeNodes().
+   **/
+  struct SubtreeNodes {
+    OctreeNodePool<BranchNode> branch_pool;
+    OctreeNodePool<LeafNode> leaf_pool;
+    std::size_t branch_count = 0;
+    std::size_t leaf_count = 0;
+  };
+
 public:
   // iterators are friends
   friend class OctreeIteratorBase<OctreeT>;
@@ -223,22 +244,29 @@ public:
   OctreeBase(const OctreeBase& source)
   : leaf_count_(source.leaf_count_)
   , branch_count_(source.branch_count_)
-  , root_node_(new (BranchNode)(*(source.root_node_)))
+  , root_node_(new BranchNode())
   , depth_mask_(source.depth_mask_)
   , octree_depth_(source.octree_depth_)
   , dynamic_depth_enabled_(source.dynamic_depth_enabled_)
   , max_key_(source.max_key_)
-  {}
+  , contiguous_children_(source.contiguous_children_)
+  {
+    copyBranch(*(source.root_node_), *root_node_);
+  }
 
   /** \brief Copy operator. */
   OctreeBase&
   operator=(const OctreeBase& source)
   {
+    if (this == &source)
+      return (*this);
+
+    deleteTree();
+    contiguous_children_ = source.contiguous_children_;
+    copyBranch(*(source.root_node_), *root_node_);
+
     leaf_count_ = source.leaf_count_;
     branch_count_ = source.branch_count_;
-    delete root_node_;
-
-    root_node_ = new (BranchNode)(*(source.root_node_));
     depth_mask_ = source.depth_mask_;
     max_key_ = source.max_key_;
     octree_depth_ = source.octree_depth_;
@@ -323,10 +351,40 @@ public:
   }
 
   /** \brief Delete the octree structure and its leaf nodes.
+   * \note The memory of the nodes is kept by the octree, and reused when it is filled
+   * again.
    */
   void
   deleteTree();
 
+  /** \brief Enable storing the children of each branch node contiguously in memory.
+   * The memory of 8 children is reserved when the first one is created, so that the
+   * siblings visited by a search share cache lines. This can speed up the traversal of
+   * dense octrees, at the cost of memory for sparse ones.
+   * \note Can only be changed while the octree is empty, the call is ignored otherwise.
+   * \param contiguous_children_arg: true to store the children contiguously (default:
+   * false)
+   */
+  void
+  setContiguousChildren(bool contiguous_children_arg)
+  {
+    // the children of the existing nodes were not allocated in groups of 8
+    if (getBranchBitPattern(*root_node_) != 0) {
+      PCL_ERROR("[pcl::octree::OctreeBase::setContiguousChildren] The storage of the "
+                "children can only be changed while the octree is empty!\n");
+      return;
+    }
+    contiguous_children_ = contiguous_children_arg;
+  }
+
+  /** \brief Return whether the children of each branch node are stored contiguously.
+   */
+  bool
+  getContiguousChildren() const
+  {
+    return contiguous_children_;
+  }
+
   /** \brief Serialize octree into a binary output vector describing its branch node
    * structure.
    * \param binary_tree_out_arg: reference to output vector for writing binary tree
@@ -503,25 +561,33 @@ protected:
     if (branch_arg.hasChild(child_idx_arg)) {
       OctreeNode* branch_child = branch_arg[child_idx_arg];
 
+      // set branch child pointer to 0
+      branch_arg[child_idx_arg] = nullptr;
+
       switch (branch_child->getNodeType()) {
       case BRANCH_NODE: {
         // free child branch recursively
         deleteBranch(*static_cast<BranchNode*>(branch_child));
         // delete branch node
-        delete branch_child;
+        releaseChild(branch_pool_,
+                     static_cast<BranchNode*>(branch_child),
+                     branch_arg,
+                     child_idx_arg,
+                     BRANCH_NODE);
       } break;
 
       case LEAF_NODE: {
         // delete leaf node
-        delete branch_child;
+        releaseChild(leaf_pool_,
+                     static_cast<LeafNode*>(branch_child),
+                     branch_arg,
+                     child_idx_arg,
+                     LEAF_NODE);
         break;
       }
       default:
         break;
       }
-
-      // set branch child pointer to 0
-      branch_arg[child_idx_arg] = nullptr;
     }
   }
 
@@ -544,7 +610,8 @@ protected:
   BranchNode*
   createBranchChild(BranchNode& branch_arg, unsigned char child_idx_arg)
   {
-    BranchNode* new_branch_child = new BranchNode();
+    BranchNode* new_branch_child =
+        allocateChild(branch_pool_, branch_arg, child_idx_arg, BRANCH_NODE);
     branch_arg[child_idx_arg] = static_cast<OctreeNode*>(new_branch_child);
 
     return new_branch_child;
@@ -558,12 +625,107 @@ protected:
   LeafNode*
   createLeafChild(BranchNode& branch_arg, unsigned char child_idx_arg)
   {
-    LeafNode* new_leaf_child = new LeafNode();
+    LeafNode* new_leaf_child =
+        allocateChild(leaf_pool_, branch_arg, child_idx_arg, LEAF_NODE);
     branch_arg[child_idx_arg] = static_cast<OctreeNode*>(new_leaf_child);
 
     return new_leaf_child;
   }
 
+  /** \brief Hand the nodes of a subtree built with createLeafRecursive() and
+   * subtree_nodes_arg over to the octree.
+   *  \param subtree_nodes_arg: the pools and counts of the nodes of the subtree
+   */
+  void
+  mergeSubtreeNodes(SubtreeNodes& subtree_nodes_arg)
+  {
+    branch_pool_.mergePool(subtree_nodes_arg.branch_pool);
+    leaf_pool_.mergePool(subtree_nodes_arg.leaf_pool);
+    branch_count_ += subtree_nodes_arg.branch_count;
+    leaf_count_ += subtree_nodes_arg.leaf_count;
+    subtree_nodes_arg.branch_count = 0;
+    subtree_nodes_arg.leaf_count = 0;
+  }
+
+  /** \brief Add a level above the root node: a new root branch node is created, and
+   * the current root becomes its child.
+   *  \param child_idx_arg: index of the current root in the new one
+   */
+  void
+  addRootParent(unsigned char child_idx_arg);
+
+  /** \brief Recursively copy the children of a branch.
+   *  \param source_arg: branch to copy
+   *  \param target_arg: branch without children receiving the copy
+   */
+  void
+  copyBranch(const BranchNode& source_arg, BranchNode& target_arg);
+
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  // Node memory management
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /** \brief Return the memory of the contiguous children of a branch, from one of its
+   * children of type node_type_arg other than child_idx_arg.
+   *  \return pointer to the memory of child 0, or nullptr if there is no such child
+   */
+  template <typename NodeT>
+  NodeT*
+  getChildGroup(const BranchNode& branch_arg,
+                unsigned char child_idx_arg,
+                node_type_t node_type_arg) const
+  {
+    for (unsigned char i = 0; i < 8; i++) {
+      OctreeNode* child = branch_arg.getChildPtr(i);
+      if ((i != child_idx_arg) && child && (child->getNodeType() == node_type_arg))
+        return static_cast<NodeT*>(child) - i;
+    }
+    return nullptr;
+  }
+
+  /** \brief Create a node from a pool for the child child_idx_arg of a branch. With
+   * contiguous children, it is placed next to its siblings of the same type.
+   */
+  template <typename NodeT>
+  NodeT*
+  allocateChild(OctreeNodePool<NodeT>& pool_arg,
+                const BranchNode& branch_arg,
+                unsigned char child_idx_arg,
+                node_type_t node_type_arg)
+  {
+    if (!contiguous_children_)
+      return pool_arg.popNode();
+
+    NodeT* siblings = getChildGroup<NodeT>(branch_arg, child_idx_arg, node_type_arg);
+    if (!siblings)
+      siblings = pool_arg.popNodeGroup();
+
+    return new (siblings + child_idx_arg) NodeT();
+  }
+
+  /** \brief Destroy a node created by allocateChild and return its memory to the
+   * pool. The child pointer of the branch must already be reset.
+   */
+  template <typename NodeT>
+  void
+  releaseChild(OctreeNodePool<NodeT>& pool_arg,
+               NodeT* child_arg,
+               const BranchNode& branch_arg,
+               unsigned char child_idx_arg,
+               node_type_t node_type_arg)
+  {
+    if (!contiguous_children_) {
+      pool_arg.pushNode(child_arg);
+      return;
+    }
+
+    child_arg->~NodeT();
+
+    // the memory of the siblings is released with the last of them
+    if (!getChildGroup<NodeT>(branch_arg, child_idx_arg, node_type_arg))
+      pool_arg.pushNodeGroup(child_arg - child_idx_arg);
+  }
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   // Recursive octree methods
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -585,6 +747,26 @@ protected:
                       LeafNode*& return_leaf_arg,
                       BranchNode*& parent_of_leaf_arg);
 
+  /** \brief Create a leaf node at octree key like createLeafRecursive() above, taking
+   * the new nodes from subtree_nodes_arg instead of the pools of the octree. Threads can
+   * thus create leaves below different branches at the same time.
+   * \param key_arg: reference to an octree key
+   * \param depth_mask_arg: depth mask used for octree key analysis and for branch depth
+   * indicator
+   * \param branch_arg: current branch node
+   * \param return_leaf_arg: return pointer to leaf node
+   * \param parent_of_leaf_arg: return pointer to parent of leaf node
+   * \param subtree_nodes_arg: pools and counts of the new nodes
+   * \return depth mask at which leaf node was created
+   **/
+  uindex_t
+  createLeafRecursive(const OctreeKey& key_arg,
+                      uindex_t depth_mask_arg,
+                      BranchNode* branch_arg,
+                      LeafNode*& return_leaf_arg,
+                      BranchNode*& parent_of_leaf_arg,
+                      SubtreeNodes& subtree_nodes_arg);
+
   /** \brief Recursively search for a given leaf node and return a pointer.
    *  \note  If leaf node does not exist, a 0 pointer is returned.
    *  \param key_arg: reference to an octree key
@@ -39,6 +39,12 @@
 
 #include <pcl/pcl_macros.h>
 
+#include <Eigen/Core> // for aligned_allocator
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
 #include <vector>
 
 namespace pcl {
@@ -48,24 +54,33 @@ namespace octree {
 /** \brief @b Octree node pool
  * \note Used to reduce memory allocation and class instantiation events when generating
  * octrees at high rate
+ * \note The nodes are allocated from slabs of growing size, and the memory of the
+ * nodes pushed back to the pool is reused by the next ones. Groups of 8 contiguous
+ * nodes can be allocated as well, to store the children of a branch next to each other.
  * \author Julius Kammerl (julius@kammerl.de)
  */
 template <typename NodeT>
 class OctreeNodePool {
 public:
   /** \brief Empty constructor. */
-  OctreeNodePool() : nodePool_() {}
+  OctreeNodePool() = default;
+
+  OctreeNodePool(const OctreeNodePool&) = delete;
+  OctreeNodePool&
+  operator=(const OctreeNodePool&) = delete;
 
   /** \brief Empty deconstructor. */
   virtual ~OctreeNodePool() { deletePool(); }
 
   /** \brief Push node to pool
+   *  \note The node is destroyed, its memory is reused by the next popNode call.
    *  \param node_arg: add this node to the pool
    *  */
   inline void
   pushNode(NodeT* node_arg)
   {
-    nodePool_.push_back(node_arg);
+    node_arg->~NodeT();
+    free_nodes_.push_back(node_arg);
   }
 
   /** \brief Pop node from pool - Allocates new nodes if pool is empty
@@ -74,38 +89,150 @@ public:
   inline NodeT*
   popNode()
   {
+    NodeT* memory;
 
-    NodeT* newLeafNode;
-
-    if (!nodePool_.size()) {
-      // leaf pool is empty
-      // we need to create a new octree leaf class
-      newLeafNode = new NodeT();
-    }
+    if (free_nodes_.empty())
+      memory = allocate(1);
     else {
-      // reuse leaf node from branch pool
-      newLeafNode = nodePool_.back();
-      nodePool_.pop_back();
-      newLeafNode->reset();
+      // reuse the memory of a node pushed to the pool
+      memory = free_nodes_.back();
+      free_nodes_.pop_back();
     }
 
-    return newLeafNode;
+    return new (memory) NodeT();
+  }
+
+  /** \brief Push the memory of 8 contiguous nodes to the pool
+   *  \param nodes_arg: memory returned by popNodeGroup, whose nodes have all been
+   *  destroyed
+   *  */
+  inline void
+  pushNodeGroup(NodeT* nodes_arg)
+  {
+    free_groups_.push_back(nodes_arg);
+  }
+
+  /** \brief Pop the memory of 8 contiguous nodes from the pool
+   *  \note The nodes are not constructed: they are created with placement new, and
+   *  destroyed explicitly before the group is pushed back to the pool.
+   *  \return Pointer to the memory of the first node
+   *  */
+  inline NodeT*
+  popNodeGroup()
+  {
+    if (free_groups_.empty())
+      return allocate(8);
+
+    NodeT* memory = free_groups_.back();
+    free_groups_.pop_back();
+    return memory;
   }
 
-  /** \brief Delete all nodes in pool
+  /** \brief Take over the memory of another pool, used for instance by another thread
+   *  \note The nodes popped from pool_arg stay valid, and are pushed back to this pool.
+   *  pool_arg is left empty.
+   *  \param pool_arg: the pool whose memory is taken over
    *  */
   void
-  deletePool()
+  mergePool(OctreeNodePool& pool_arg)
   {
-    // delete all branch instances from branch pool
-    while (!nodePool_.empty()) {
-      delete (nodePool_.back());
-      nodePool_.pop_back();
+    // the unused end of the slabs of pool_arg is kept for single nodes
+    for (std::size_t slab = pool_arg.current_slab_; slab < pool_arg.slabs_.size();
+         slab++) {
+      std::size_t slot = (slab == pool_arg.current_slab_) ? pool_arg.next_slot_ : 0;
+      for (; slot < pool_arg.slabs_[slab].second; slot++)
+        free_nodes_.push_back(
+            reinterpret_cast<NodeT*>(pool_arg.slabs_[slab].first + slot));
     }
+    free_nodes_.insert(
+        free_nodes_.end(), pool_arg.free_nodes_.begin(), pool_arg.free_nodes_.end());
+    free_groups_.insert(
+        free_groups_.end(), pool_arg.free_groups_.begin(), pool_arg.free_groups_.end());
+
+    // the slabs of pool_arg are now fully used: keep them before the current slab
+    slabs_.insert(slabs_.begin() + current_slab_,
+                  pool_arg.slabs_.begin(),
+                  pool_arg.slabs_.end());
+    current_slab_ += pool_arg.slabs_.size();
+
+    pool_arg.slabs_.clear();
+    pool_arg.resetPool();
+  }
+
+  /** \brief Mark the memory of all the nodes as unused, and keep it for the next ones
+   *  \note All the nodes popped from the pool must have been pushed back first.
+   *  */
+  void
+  resetPool()
+  {
+    free_nodes_.clear();
+    free_groups_.clear();
+    current_slab_ = 0;
+    next_slot_ = 0;
+  }
+
+  /** \brief Release the memory of the pool
+   *  \note All the nodes popped from the pool must have been pushed back first.
+   *  */
+  void
+  deletePool()
+  {
+    for (const auto& slab : slabs_)
+      Allocator().deallocate(slab.first, slab.second);
+
+    slabs_.clear();
+    resetPool();
   }
 
 protected:
-  std::vector<NodeT*> nodePool_;
+  /** \brief Uninitialized memory for a node. */
+  struct alignas(NodeT) Slot {
+    unsigned char data[sizeof(NodeT)];
+  };
+
+  using Allocator = Eigen::aligned_allocator<Slot>;
+
+  /** \brief Take the memory of count contiguous nodes from the slabs, allocating a new
+   * slab if they are all used. */
+  NodeT*
+  allocate(std::size_t count)
+  {
+    if ((current_slab_ < slabs_.size()) &&
+        (next_slot_ + count > slabs_[current_slab_].second)) {
+      // the end of the slab is still used for single nodes
+      for (; next_slot_ < slabs_[current_slab_].second; next_slot_++)
+        free_nodes_.push_back(
+            reinterpret_cast<NodeT*>(slabs_[current_slab_].first + next_slot_));
+
+      current_slab_++;
+      next_slot_ = 0;
+    }
+
+    if (current_slab_ == slabs_.size()) {
+      const std::size_t slab_size =
+          slabs_.empty() ? 64 : std::min<std::size_t>(2 * slabs_.back().second, 65536);
+      slabs_.emplace_back(Allocator().allocate(slab_size), slab_size);
+    }
+
+    NodeT* memory = reinterpret_cast<NodeT*>(slabs_[current_slab_].first + next_slot_);
+    next_slot_ += count;
+    return memory;
+  }
+
+  /** \brief The slabs, and their number of nodes. */
+  std::vector<std::pair<Slot*, std::size_t>> slabs_;
+
+  /** \brief Index of the slab the next nodes are taken from. */
+  std::size_t current_slab_ = 0;
+
+  /** \brief Index of the first unused node of the current slab. */
+  std::size_t next_slot_ = 0;
+
+  /** \brief Memory of the nodes pushed to the pool. */
+  std::vector<NodeT*> free_nodes_;
+
+  /** \brief Memory of the groups of 8 nodes pushed to the pool. */
+  std::vector<NodeT*> free_groups_;
 };
 
 } // namespace octree
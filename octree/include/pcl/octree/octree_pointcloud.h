@@ -42,6 +42,9 @@
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
 
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace pcl {
@@ -189,10 +192,27 @@ public:
     return this->octree_depth_;
   }
 
-  /** \brief Add points from input point cloud to octree. */
+  /** \brief Add points from input point cloud to octree.
+   * \note Unless dynamic depth is enabled, the octree is built in bulk: the Morton
+   * codes of the voxels of all the points are computed and sorted, and the leaf nodes
+   * are created in depth-first order, once per voxel. With several threads (see \ref
+   * setNumberOfThreads), the subtrees below the first levels of the octree are built
+   * in parallel. The points are added to the leaves with addPointIdxToLeaf, in the
+   * order of the input cloud within each voxel, and addPointIdx is not called. The
+   * voxels are computed once the bounding box has grown to contain all the points.
+   */
   void
   addPointsFromInputCloud();
 
+  /** \brief Set the number of threads used to compute and sort the Morton codes of
+   * the points in addPointsFromInputCloud, and to build the subtrees of the octree.
+   * The resulting octree does not depend on the number of threads. Default: 1
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
   /** \brief Add point at given index from input point cloud to octree. Index will be
    * also added to indices vector.
    * \param[in] point_idx_arg index of point to be added
@@ -424,12 +444,65 @@ public:
 
 protected:
   /** \brief Add point at index from input pointcloud dataset to octree
+   * \note addPointsFromInputCloud does not call this method, unless dynamic depth is
+   * enabled: it adds the points to their leaves with addPointIdxToLeaf directly.
+   * Subclasses customizing how the points are stored should override
+   * addPointIdxToLeaf instead.
    * \param[in] point_idx_arg the index representing the point in the dataset given by
    * \a setInputCloud to be added
    */
   virtual void
   addPointIdx(uindex_t point_idx_arg);
 
+  /** \brief Add a point to the container of the leaf node of its voxel. Called by
+   * addPointIdx and by the bulk construction of addPointsFromInputCloud.
+   * \note With several threads, the bulk construction calls this method concurrently
+   * for the leaves of different subtrees.
+   * \param[in] leaf_container_arg the container of the leaf node
+   * \param[in] point_idx_arg the index representing the point in the dataset given by
+   * \a setInputCloud
+   */
+  virtual void
+  addPointIdxToLeaf(LeafContainerT& leaf_container_arg, uindex_t point_idx_arg)
+  {
+    leaf_container_arg.addPointIndex(point_idx_arg);
+  }
+
+  /** \brief Add the points of the input cloud to the octree one at a time, with
+   * addPointIdx. */
+  void
+  addPointsIncrementally();
+
+  /** \brief Create the leaf nodes of the voxels of points sorted by Morton code, in
+   * depth-first order, and add the points to them.
+   * \param[in] codes_arg the Morton codes of the voxels and the indices of the points
+   */
+  void
+  addSortedPoints(const std::vector<std::pair<std::uint64_t, index_t>>& codes_arg);
+
+  /** \brief Like addSortedPoints, building the subtrees below the first levels of the
+   * octree in parallel, each from its own node pools.
+   * \param[in] codes_arg the Morton codes of the voxels and the indices of the points
+   */
+  template <typename OctreeBaseT = OctreeT>
+  std::enable_if_t<
+      std::is_base_of<OctreeBase<LeafContainerT, BranchContainerT>, OctreeBaseT>::value>
+  addSortedPointsInParallel(
+      const std::vector<std::pair<std::uint64_t, index_t>>& codes_arg);
+
+  /** \brief Octrees other than OctreeBase, such as Octree2BufBase, are built by a
+   * single thread with addSortedPoints.
+   * \param[in] codes_arg the Morton codes of the voxels and the indices of the points
+   */
+  template <typename OctreeBaseT = OctreeT>
+  std::enable_if_t<
+      !std::is_base_of<OctreeBase<LeafContainerT, BranchContainerT>, OctreeBaseT>::value>
+  addSortedPointsInParallel(
+      const std::vector<std::pair<std::uint64_t, index_t>>& codes_arg)
+  {
+    addSortedPoints(codes_arg);
+  }
+
   /** \brief Add point at index from input pointcloud dataset to octree
    * \param[in] leaf_node to be expanded
    * \param[in] parent_branch parent of leaf node to be expanded
@@ -597,6 +670,9 @@ protected:
    *  \note zero indicates a fixed/maximum depth octree structure
    * **/
   std::size_t max_objs_per_leaf_;
+
+  /** \brief The number of threads used by the bulk construction of the octree. */
+  unsigned int threads_;
 };
 
 } // namespace octree
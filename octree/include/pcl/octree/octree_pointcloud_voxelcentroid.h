@@ -152,27 +152,17 @@ public:
 
   ~OctreePointCloudVoxelCentroid() {}
 
-  /** \brief Add DataT object to leaf node at octree key.
-   * \param pointIdx_arg
+  /** \brief Add a point to the centroid of the leaf node of its voxel.
+   * \param[in] leaf_container_arg the container of the leaf node
+   * \param[in] pointIdx_arg the index of the point in the input cloud
    */
   void
-  addPointIdx(const uindex_t pointIdx_arg) override
+  addPointIdxToLeaf(LeafContainerT& leaf_container_arg,
+                    const uindex_t pointIdx_arg) override
   {
-    OctreeKey key;
-
     assert(pointIdx_arg < this->input_->size());
 
-    const PointT& point = (*this->input_)[pointIdx_arg];
-
-    // make sure bounding box is big enough
-    this->adoptBoundingBoxToPoint(point);
-
-    // generate key
-    this->genOctreeKeyforPoint(point, key);
-
-    // add point to octree at key
-    LeafContainerT* container = this->createLeaf(key);
-    container->addPoint(point);
+    leaf_container_arg.addPoint((*this->input_)[pointIdx_arg]);
   }
 
   /** \brief Get centroid for a single voxel addressed by a PointT point.
@@ -408,7 +408,7 @@ public:
   using PointRepresentationConstPtr = typename KdTree::PointRepresentationConstPtr;
 
   /** \brief Empty constructor. */
-  CorrespondenceEstimation() { corr_name_ = "CorrespondenceEstimation"; }
+  CorrespondenceEstimation() : threads_(1) { corr_name_ = "CorrespondenceEstimation"; }
 
   /** \brief Empty destructor */
   ~CorrespondenceEstimation() {}
@@ -443,6 +443,35 @@ public:
     Ptr copy(new CorrespondenceEstimation<PointSource, PointTarget, Scalar>(*this));
     return (copy);
   }
+
+  /** \brief Set the number of threads used to search for correspondences. The
+   * resulting correspondences, including their order, do not depend on the number of
+   * threads.
+   * \note IterativeClosestPoint and its variants set this value from
+   * IterativeClosestPoint::setNumberOfThreads before each alignment.
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
+  /** \brief Get the number of threads used to search for correspondences. */
+  inline unsigned int
+  getNumberOfThreads() const
+  {
+    return (threads_);
+  }
+
+protected:
+  /** \brief Remove the correspondences marked as rejected (index_match set to
+   * UNAVAILABLE), keeping the order of the remaining ones.
+   * \param[in,out] correspondences the correspondences to compact
+   */
+  void
+  removeRejectedCorrespondences(pcl::Correspondences& correspondences) const;
+
+  /** \brief The number of threads the scheduler should use. */
+  unsigned int threads_;
 };
 } // namespace registration
 } // namespace pcl
@@ -76,6 +76,7 @@ public:
   using IterativeClosestPoint<PointSource, PointTarget>::inlier_threshold_;
   using IterativeClosestPoint<PointSource, PointTarget>::min_number_correspondences_;
   using IterativeClosestPoint<PointSource, PointTarget>::update_visualizer_;
+  using IterativeClosestPoint<PointSource, PointTarget>::threads_;
 
   using PointCloudSource = pcl::PointCloud<PointSource>;
   using PointCloudSourcePtr = typename PointCloudSource::Ptr;
@@ -161,6 +162,15 @@ public:
     input_covariances_ = covariances;
   }
 
+  /** \brief Get a pointer to the covariances of the input source, either set with
+   * setSourceCovariances or computed by the last alignment. May be null.
+   */
+  inline MatricesVectorPtr
+  getSourceCovariances() const
+  {
+    return input_covariances_;
+  }
+
   /** \brief Provide a pointer to the input target (e.g., the point cloud that we want
    * to align the input source to) \param[in] target the input point cloud target
    */
@@ -173,8 +183,14 @@ public:
 
   /** \brief Provide a pointer to the covariances of the input target (if computed
    * externally!). If not set, GeneralizedIterativeClosestPoint will compute the
-   * covariances itself. Make sure to set the covariances AFTER setting the input source
-   * point cloud (setting the input source point cloud will reset the covariances).
+   * covariances itself. Make sure to set the covariances AFTER setting the input target
+   * point cloud (setting the input target point cloud will reset the covariances).
+   *
+   * When aligning many scans against the same static target, the covariances computed
+   * by the first alignment can be retrieved with getTargetCovariances and passed here
+   * for the following ones, together with a search method set with
+   * setSearchMethodTarget(tree, true), so that nothing is recomputed on the target
+   * side.
    * \param[in] covariances the input target covariances
    */
   inline void
@@ -183,6 +199,15 @@ public:
     target_covariances_ = covariances;
   }
 
+  /** \brief Get a pointer to the covariances of the input target, either set with
+   * setTargetCovariances or computed by the last alignment. May be null.
+   */
+  inline MatricesVectorPtr
+  getTargetCovariances() const
+  {
+    return target_covariances_;
+  }
+
   /** \brief Estimate a rigid rotation transformation between a source and a target
    * point cloud using an iterative non-linear Levenberg-Marquardt approach. \param[in]
    * cloud_src the source point cloud dataset \param[in] indices_src the vector of
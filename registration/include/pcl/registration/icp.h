@@ -152,6 +152,7 @@ public:
   , use_reciprocal_correspondence_(false)
   , source_has_normals_(false)
   , target_has_normals_(false)
+  , threads_(1)
   {
     reg_name_ = "IterativeClosestPoint";
     transformation_estimation_.reset(
@@ -269,6 +270,24 @@ public:
     return (use_reciprocal_correspondence_);
   }
 
+  /** \brief Set the number of threads used by the registration. It is passed to the
+   * correspondence estimation before each alignment, overriding the value set on it,
+   * if the estimation supports several threads (see
+   * registration::CorrespondenceEstimation::setNumberOfThreads). The result does not
+   * depend on the number of threads.
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
+  /** \brief Return the number of threads used by the registration */
+  unsigned int
+  getNumberOfThreads() const
+  {
+    return threads_;
+  }
+
 protected:
   /** \brief Apply a rigid transform to a given dataset. Here we check whether
    * the dataset has surface normals in addition to XYZ, and rotate normals as well.
@@ -295,6 +314,15 @@ protected:
   virtual void
   determineRequiredBlobData();
 
+  /** \brief Pass the number of threads to a correspondence estimation, if it supports
+   * several threads.
+   * \param[in] correspondence_estimation the correspondence estimation to configure
+   */
+  void
+  setCorrespondenceEstimationThreads(
+      registration::CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>&
+          correspondence_estimation) const;
+
   /** \brief XYZ fields offset. */
   std::size_t x_idx_offset_, y_idx_offset_, z_idx_offset_;
 
@@ -311,6 +339,9 @@ protected:
 
   /** \brief Checks for whether estimators and rejectors need various data */
   bool need_source_blob_, need_target_blob_;
+
+  /** \brief The number of threads the scheduler should use. */
+  unsigned int threads_;
 };
 
 /** \brief @b IterativeClosestPointWithNormals is a special case of
@@ -44,6 +44,12 @@
 #include <pcl/common/copy_point.h>
 #include <pcl/common/io.h>
 
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace pcl {
 
 namespace registration {
@@ -112,6 +118,21 @@ CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>::initComputeRecip
   return (true);
 }
 
+template <typename PointSource, typename PointTarget, typename Scalar>
+void
+CorrespondenceEstimation<PointSource, PointTarget, Scalar>::setNumberOfThreads(
+    unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 template <typename PointSource, typename PointTarget, typename Scalar>
 void
 CorrespondenceEstimation<PointSource, PointTarget, Scalar>::determineCorrespondences(
@@ -122,49 +143,48 @@ CorrespondenceEstimation<PointSource, PointTarget, Scalar>::determineCorresponde
 
   double max_dist_sqr = max_distance * max_distance;
 
+  // Every source index gets its own slot, rejected ones are removed afterwards. This
+  // keeps the correspondences in the order of the source indices, independent of the
+  // number of threads.
   correspondences.resize(indices_->size());
 
-  pcl::Indices index(1);
-  std::vector<float> distance(1);
-  pcl::Correspondence corr;
-  unsigned int nr_valid_correspondences = 0;
-
-  // Check if the template types are the same. If true, avoid a copy.
-  // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT
-  // macro!
-  if (isSamePointType<PointSource, PointTarget>()) {
-    // Iterate over the input set of source indices
-    for (const auto& idx : (*indices_)) {
-      tree_->nearestKSearch((*input_)[idx], 1, index, distance);
-      if (distance[0] > max_dist_sqr)
-        continue;
-
-      corr.index_query = idx;
-      corr.index_match = index[0];
-      corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
-    }
-  }
-  else {
+#pragma omp parallel \
+  num_threads(threads_)
+  {
+    pcl::Indices index(1);
+    std::vector<float> distance(1);
     PointTarget pt;
 
-    // Iterate over the input set of source indices
-    for (const auto& idx : (*indices_)) {
-      // Copy the source data to a target PointTarget format so we can search in the
-      // tree
-      copyPoint((*input_)[idx], pt);
-
-      tree_->nearestKSearch(pt, 1, index, distance);
-      if (distance[0] > max_dist_sqr)
+#pragma omp for \
+  schedule(dynamic, 256)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(indices_->size()); ++i) {
+      const auto& idx = (*indices_)[i];
+      pcl::Correspondence& corr = correspondences[i];
+
+      // Check if the template types are the same. If true, avoid a copy.
+      // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT
+      // macro!
+      if (isSamePointType<PointSource, PointTarget>())
+        tree_->nearestKSearch((*input_)[idx], 1, index, distance);
+      else {
+        // Copy the source data to a target PointTarget format so we can search in the
+        // tree
+        copyPoint((*input_)[idx], pt);
+        tree_->nearestKSearch(pt, 1, index, distance);
+      }
+
+      if (distance[0] > max_dist_sqr) {
+        corr.index_match = UNAVAILABLE;
         continue;
+      }
 
       corr.index_query = idx;
       corr.index_match = index[0];
       corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
     }
   }
-  correspondences.resize(nr_valid_correspondences);
+
+  removeRejectedCorrespondences(correspondences);
   deinitCompute();
 }
 
@@ -183,73 +203,77 @@ CorrespondenceEstimation<PointSource, PointTarget, Scalar>::
     return;
   double max_dist_sqr = max_distance * max_distance;
 
+  // See determineCorrespondences
   correspondences.resize(indices_->size());
-  pcl::Indices index(1);
-  std::vector<float> distance(1);
-  pcl::Indices index_reciprocal(1);
-  std::vector<float> distance_reciprocal(1);
-  pcl::Correspondence corr;
-  unsigned int nr_valid_correspondences = 0;
-  int target_idx = 0;
-
-  // Check if the template types are the same. If true, avoid a copy.
-  // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT
-  // macro!
-  if (isSamePointType<PointSource, PointTarget>()) {
-    // Iterate over the input set of source indices
-    for (const auto& idx : (*indices_)) {
-      tree_->nearestKSearch((*input_)[idx], 1, index, distance);
-      if (distance[0] > max_dist_sqr)
-        continue;
 
-      target_idx = index[0];
-
-      tree_reciprocal_->nearestKSearch(
-          (*target_)[target_idx], 1, index_reciprocal, distance_reciprocal);
-      if (distance_reciprocal[0] > max_dist_sqr || idx != index_reciprocal[0])
-        continue;
-
-      corr.index_query = idx;
-      corr.index_match = index[0];
-      corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
-    }
-  }
-  else {
+#pragma omp parallel \
+  num_threads(threads_)
+  {
+    pcl::Indices index(1);
+    std::vector<float> distance(1);
+    pcl::Indices index_reciprocal(1);
+    std::vector<float> distance_reciprocal(1);
     PointTarget pt_src;
     PointSource pt_tgt;
 
-    // Iterate over the input set of source indices
-    for (const auto& idx : (*indices_)) {
-      // Copy the source data to a target PointTarget format so we can search in the
-      // tree
-      copyPoint((*input_)[idx], pt_src);
-
-      tree_->nearestKSearch(pt_src, 1, index, distance);
+#pragma omp for \
+  schedule(dynamic, 256)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(indices_->size()); ++i) {
+      const auto& idx = (*indices_)[i];
+      pcl::Correspondence& corr = correspondences[i];
+      corr.index_match = UNAVAILABLE;
+
+      // Check if the template types are the same. If true, avoid a copy.
+      // Both point types MUST be registered using the POINT_CLOUD_REGISTER_POINT_STRUCT
+      // macro!
+      if (isSamePointType<PointSource, PointTarget>())
+        tree_->nearestKSearch((*input_)[idx], 1, index, distance);
+      else {
+        // Copy the source data to a target PointTarget format so we can search in the
+        // tree
+        copyPoint((*input_)[idx], pt_src);
+        tree_->nearestKSearch(pt_src, 1, index, distance);
+      }
       if (distance[0] > max_dist_sqr)
         continue;
 
-      target_idx = index[0];
-
-      // Copy the target data to a target PointSource format so we can search in the
-      // tree_reciprocal
-      copyPoint((*target_)[target_idx], pt_tgt);
-
-      tree_reciprocal_->nearestKSearch(
-          pt_tgt, 1, index_reciprocal, distance_reciprocal);
+      const auto target_idx = index[0];
+
+      if (isSamePointType<PointSource, PointTarget>())
+        tree_reciprocal_->nearestKSearch(
+            (*target_)[target_idx], 1, index_reciprocal, distance_reciprocal);
+      else {
+        // Copy the target data to a target PointSource format so we can search in the
+        // tree_reciprocal
+        copyPoint((*target_)[target_idx], pt_tgt);
+        tree_reciprocal_->nearestKSearch(
+            pt_tgt, 1, index_reciprocal, distance_reciprocal);
+      }
       if (distance_reciprocal[0] > max_dist_sqr || idx != index_reciprocal[0])
         continue;
 
       corr.index_query = idx;
-      corr.index_match = index[0];
+      corr.index_match = target_idx;
       corr.distance = distance[0];
-      correspondences[nr_valid_correspondences++] = corr;
     }
   }
-  correspondences.resize(nr_valid_correspondences);
+
+  removeRejectedCorrespondences(correspondences);
   deinitCompute();
 }
 
+template <typename PointSource, typename PointTarget, typename Scalar>
+void
+CorrespondenceEstimation<PointSource, PointTarget, Scalar>::
+    removeRejectedCorrespondences(pcl::Correspondences& correspondences) const
+{
+  const auto last = std::remove_if(
+      correspondences.begin(),
+      correspondences.end(),
+      [](const pcl::Correspondence& corr) { return corr.index_match == UNAVAILABLE; });
+  correspondences.erase(last, correspondences.end());
+}
+
 } // namespace registration
 } // namespace pcl
 
@@ -41,6 +41,7 @@
 #ifndef PCL_REGISTRATION_IMPL_GICP_HPP_
 #define PCL_REGISTRATION_IMPL_GICP_HPP_
 
+#include <pcl/common/eigen.h>
 #include <pcl/registration/exceptions.h>
 
 namespace pcl {
@@ -61,67 +62,69 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeCovariances(
     return;
   }
 
-  Eigen::Vector3d mean;
-  pcl::Indices nn_indecies;
-  nn_indecies.reserve(k_correspondences_);
-  std::vector<float> nn_dist_sq;
-  nn_dist_sq.reserve(k_correspondences_);
-
   // We should never get there but who knows
   if (cloud_covariances.size() < cloud->size())
     cloud_covariances.resize(cloud->size());
 
-  MatricesVector::iterator matrices_iterator = cloud_covariances.begin();
-  for (auto points_iterator = cloud->begin(); points_iterator != cloud->end();
-       ++points_iterator, ++matrices_iterator) {
-    const PointT& query_point = *points_iterator;
-    Eigen::Matrix3d& cov = *matrices_iterator;
-    // Zero out the cov and mean
-    cov.setZero();
-    mean.setZero();
-
-    // Search for the K nearest neighbours
-    kdtree->nearestKSearch(query_point, k_correspondences_, nn_indecies, nn_dist_sq);
-
-    // Find the covariance matrix
-    for (int j = 0; j < k_correspondences_; j++) {
-      const PointT& pt = (*cloud)[nn_indecies[j]];
-
-      mean[0] += pt.x;
-      mean[1] += pt.y;
-      mean[2] += pt.z;
-
-      cov(0, 0) += pt.x * pt.x;
-
-      cov(1, 0) += pt.y * pt.x;
-      cov(1, 1) += pt.y * pt.y;
-
-      cov(2, 0) += pt.z * pt.x;
-      cov(2, 1) += pt.z * pt.y;
-      cov(2, 2) += pt.z * pt.z;
-    }
-
-    mean /= static_cast<double>(k_correspondences_);
-    // Get the actual covariance
-    for (int k = 0; k < 3; k++)
-      for (int l = 0; l <= k; l++) {
-        cov(k, l) /= static_cast<double>(k_correspondences_);
-        cov(k, l) -= mean[k] * mean[l];
-        cov(l, k) = cov(k, l);
+#pragma omp parallel \
+  num_threads(threads_)
+  {
+    pcl::Indices nn_indecies;
+    nn_indecies.reserve(k_correspondences_);
+    std::vector<float> nn_dist_sq;
+    nn_dist_sq.reserve(k_correspondences_);
+
+#pragma omp for \
+  schedule(dynamic, 256)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(cloud->size()); ++i) {
+      const PointT& query_point = (*cloud)[i];
+      Eigen::Matrix3d& cov = cloud_covariances[i];
+      // Zero out the cov and mean
+      cov.setZero();
+      Eigen::Vector3d mean = Eigen::Vector3d::Zero();
+
+      // Search for the K nearest neighbours
+      kdtree->nearestKSearch(query_point, k_correspondences_, nn_indecies, nn_dist_sq);
+
+      // Find the covariance matrix
+      for (int j = 0; j < k_correspondences_; j++) {
+        const PointT& pt = (*cloud)[nn_indecies[j]];
+
+        mean[0] += pt.x;
+        mean[1] += pt.y;
+        mean[2] += pt.z;
+
+        cov(0, 0) += pt.x * pt.x;
+
+        cov(1, 0) += pt.y * pt.x;
+        cov(1, 1) += pt.y * pt.y;
+
+        cov(2, 0) += pt.z * pt.x;
+        cov(2, 1) += pt.z * pt.y;
+        cov(2, 2) += pt.z * pt.z;
       }
 
-    // Compute the SVD (covariance matrix is symmetric so U = V')
-    Eigen::JacobiSVD<Eigen::Matrix3d> svd(cov, Eigen::ComputeFullU);
-    cov.setZero();
-    Eigen::Matrix3d U = svd.matrixU();
-    // Reconstitute the covariance matrix with modified singular values using the column
-    // // vectors in V.
-    for (int k = 0; k < 3; k++) {
-      Eigen::Vector3d col = U.col(k);
-      double v = 1.; // biggest 2 singular values replaced by 1
-      if (k == 2)    // smallest singular value replaced by gicp_epsilon
-        v = gicp_epsilon_;
-      cov += v * col * col.transpose();
+      mean /= static_cast<double>(k_correspondences_);
+      // Get the actual covariance
+      for (int k = 0; k < 3; k++)
+        for (int l = 0; l <= k; l++) {
+          cov(k, l) /= static_cast<double>(k_correspondences_);
+          cov(k, l) -= mean[k] * mean[l];
+          cov(l, k) = cov(k, l);
+        }
+
+      // Compute the eigen decomposition with the closed form solver for symmetric 3x3
+      // matrices, eigenvalues are sorted in increasing order
+      Eigen::Matrix3d eigenvectors;
+      Eigen::Vector3d eigenvalues;
+      pcl::eigen33(cov, eigenvectors, eigenvalues);
+      // Reconstitute the covariance matrix with the biggest 2 eigenvalues replaced by 1
+      // and the smallest one replaced by gicp_epsilon. As the eigenvectors are
+      // orthonormal this is I - (1 - gicp_epsilon) * v * v' with v the eigenvector of
+      // the smallest eigenvalue.
+      const Eigen::Vector3d normal = eigenvectors.col(0);
+      cov = Eigen::Matrix3d::Identity() -
+            (1. - gicp_epsilon_) * normal * normal.transpose();
     }
   }
 }
@@ -398,6 +401,15 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransformatio
   // Set the mahalanobis matrices to identity
   mahalanobis_.resize(N, Eigen::Matrix3d::Identity());
   // Compute target cloud covariance matrices
+  if (target_covariances_ && !target_covariances_->empty() &&
+      target_covariances_->size() != target_->size()) {
+    PCL_WARN("[pcl::%s::computeTransformation] The number of target covariances (%zu) "
+             "differs from the number of target points (%zu), recomputing them!\n",
+             getClassName().c_str(),
+             target_covariances_->size(),
+             static_cast<std::size_t>(target_->size()));
+    target_covariances_.reset();
+  }
   if ((!target_covariances_) || (target_covariances_->empty())) {
     target_covariances_.reset(new MatricesVector);
     computeCovariances<PointTarget>(target_, tree_, *target_covariances_);
@@ -412,9 +424,6 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransformatio
   nr_iterations_ = 0;
   converged_ = false;
   double dist_threshold = corr_dist_threshold_ * corr_dist_threshold_;
-  pcl::Indices nn_indices(1);
-  std::vector<float> nn_dists(1);
-
   pcl::transformPointCloud(output, output, guess);
 
   while (!converged_) {
@@ -431,33 +440,55 @@ GeneralizedIterativeClosestPoint<PointSource, PointTarget>::computeTransformatio
 
     Eigen::Matrix3d R = transform_R.topLeftCorner<3, 3>();
 
-    for (std::size_t i = 0; i < N; i++) {
-      PointSource query = output[i];
-      query.getVector4fMap() = transformation_ * query.getVector4fMap();
+    // Search the nearest neighbors in parallel, marking the points without a neighbor
+    // within the threshold, then gather the correspondences in order
+    std::vector<index_t> nn_matches(N, UNAVAILABLE);
+    std::vector<std::uint8_t> nn_found(N, 0);
+#pragma omp parallel \
+  num_threads(threads_)
+    {
+      pcl::Indices nn_indices(1);
+      std::vector<float> nn_dists(1);
+
+#pragma omp for \
+  schedule(dynamic, 256)
+      for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t>(N); ++i) {
+        PointSource query = output[i];
+        query.getVector4fMap() = transformation_ * query.getVector4fMap();
+
+        if (!searchForNeighbors(query, nn_indices, nn_dists))
+          continue;
+        nn_found[i] = 1;
+
+        // Check if the distance to the nearest neighbor is smaller than the user imposed
+        // threshold
+        if (nn_dists[0] < dist_threshold) {
+          Eigen::Matrix3d& C1 = (*input_covariances_)[i];
+          Eigen::Matrix3d& C2 = (*target_covariances_)[nn_indices[0]];
+          Eigen::Matrix3d& M = mahalanobis_[i];
+          // M = R*C1
+          M = R * C1;
+          // temp = M*R' + C2 = R*C1*R' + C2
+          Eigen::Matrix3d temp = M * R.transpose();
+          temp += C2;
+          // M = temp^-1
+          M = temp.inverse();
+          nn_matches[i] = nn_indices[0];
+        }
+      }
+    }
 
-      if (!searchForNeighbors(query, nn_indices, nn_dists)) {
+    for (std::size_t i = 0; i < N; i++) {
+      if (!nn_found[i]) {
         PCL_ERROR("[pcl::%s::computeTransformation] Unable to find a nearest neighbor "
                   "in the target dataset for point %d in the source!\n",
                   getClassName().c_str(),
                   (*indices_)[i]);
         return;
       }
-
-      // Check if the distance to the nearest neighbor is smaller than the user imposed
-      // threshold
-      if (nn_dists[0] < dist_threshold) {
-        Eigen::Matrix3d& C1 = (*input_covariances_)[i];
-        Eigen::Matrix3d& C2 = (*target_covariances_)[nn_indices[0]];
-        Eigen::Matrix3d& M = mahalanobis_[i];
-        // M = R*C1
-        M = R * C1;
-        // temp = M*R' + C2 = R*C1*R' + C2
-        Eigen::Matrix3d temp = M * R.transpose();
-        temp += C2;
-        // M = temp^-1
-        M = temp.inverse();
+      if (nn_matches[i] != UNAVAILABLE) {
         source_indices[cnt] = static_cast<int>(i);
-        target_indices[cnt] = nn_indices[0];
+        target_indices[cnt] = nn_matches[i];
         cnt++;
       }
     }
@@ -43,8 +43,41 @@
 
 #include <pcl/correspondence.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 namespace pcl {
 
+template <typename PointSource, typename PointTarget, typename Scalar>
+void
+IterativeClosestPoint<PointSource, PointTarget, Scalar>::setNumberOfThreads(
+    unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+template <typename PointSource, typename PointTarget, typename Scalar>
+void
+IterativeClosestPoint<PointSource, PointTarget, Scalar>::
+    setCorrespondenceEstimationThreads(
+        registration::CorrespondenceEstimationBase<PointSource, PointTarget, Scalar>&
+            correspondence_estimation) const
+{
+  using CorrespondenceEstimation =
+      registration::CorrespondenceEstimation<PointSource, PointTarget, Scalar>;
+  auto* estimation = dynamic_cast<CorrespondenceEstimation*>(&correspondence_estimation);
+  if (estimation)
+    estimation->setNumberOfThreads(threads_);
+}
+
 template <typename PointSource, typename PointTarget, typename Scalar>
 void
 IterativeClosestPoint<PointSource, PointTarget, Scalar>::transformCloud(
@@ -141,6 +174,7 @@ IterativeClosestPoint<PointSource, PointTarget, Scalar>::computeTransformation(
     pcl::toPCLPointCloud2(*target_, *target_blob);
 
   // Pass in the default target for the Correspondence Estimation/Rejection code
+  setCorrespondenceEstimationThreads(*correspondence_estimation_);
   correspondence_estimation_->setInputTarget(target_);
   if (correspondence_estimation_->requiresTargetNormals())
     correspondence_estimation_->setTargetNormals(target_blob);
@@ -116,6 +116,7 @@ JointIterativeClosestPoint<PointSource, PointTarget, Scalar>::computeTransformat
   determineRequiredBlobData();
   // Pass in the default target for the Correspondence Estimation/Rejection code
   for (std::size_t i = 0; i < sources_.size(); i++) {
+    this->setCorrespondenceEstimationThreads(*correspondence_estimations_[i]);
     correspondence_estimations_[i]->setInputTarget(targets_[i]);
     if (correspondence_estimations_[i]->requiresTargetNormals()) {
       PCLPointCloud2::Ptr target_blob(new PCLPointCloud2);
@@ -186,6 +186,26 @@ public:
     return nr_iterations_;
   }
 
+  /** \brief Set the number of threads used to evaluate the score, gradient and hessian
+   * over the source points. With more than one thread the points are processed in
+   * blocks of fixed size, whose partial sums are added in order, so the result is the
+   * same for any number of threads greater than one. It may differ from the
+   * single-threaded result by rounding, since a single thread sums the points serially.
+   * \param[in] nr_threads the number of hardware threads to use (0 sets the value back
+   * to automatic)
+   */
+  void
+  setNumberOfThreads(unsigned int nr_threads = 0);
+
+  /** \brief Get the number of threads used to evaluate the score, gradient and hessian.
+   * \return the number of threads
+   */
+  inline unsigned int
+  getNumberOfThreads() const
+  {
+    return threads_;
+  }
+
   /** \brief Convert 6 element transformation vector to affine transformation.
    * \param[in] x transformation vector of the form [x, y, z, roll, pitch, yaw]
    * \param[out] trans affine transform corresponding to given transfomation vector
@@ -289,6 +309,31 @@ protected:
                     const Eigen::Matrix3d& c_inv,
                     bool compute_hessian = true) const;
 
+  /** \brief Compute individual point contirbutions to derivatives of probability
+   * function w.r.t. the transformation vector, using the given point derivatives.
+   * \note Equation 6.10, 6.12 and 6.13 [Magnusson 2009].
+   * \param[in,out] score_gradient the gradient vector of the probability function
+   * w.r.t. the transformation vector
+   * \param[in,out] hessian the hessian matrix of the probability function w.r.t. the
+   * transformation vector
+   * \param[in] point_jacobian the first order derivative of the transformation of the
+   * point, see \ref computePointDerivatives
+   * \param[in] point_hessian the second order derivative of the transformation of the
+   * point, see \ref computePointDerivatives
+   * \param[in] x_trans transformed point minus mean of occupied covariance voxel
+   * \param[in] c_inv covariance of occupied covariance voxel
+   * \param[in] compute_hessian flag to calculate hessian, unnessissary for step
+   * calculation.
+   */
+  double
+  updateDerivatives(Eigen::Matrix<double, 6, 1>& score_gradient,
+                    Eigen::Matrix<double, 6, 6>& hessian,
+                    const Eigen::Matrix<double, 3, 6>& point_jacobian,
+                    const Eigen::Matrix<double, 18, 6>& point_hessian,
+                    const Eigen::Vector3d& x_trans,
+                    const Eigen::Matrix3d& c_inv,
+                    bool compute_hessian = true) const;
+
   /** \brief Precompute anglular components of derivatives.
    * \note Equation 6.19 and 6.21 [Magnusson 2009].
    * \param[in] transform the current transform vector
@@ -308,6 +353,21 @@ protected:
   void
   computePointDerivatives(const Eigen::Vector3d& x, bool compute_hessian = true);
 
+  /** \brief Compute point derivatives into the given matrices.
+   * \note Equation 6.18-21 [Magnusson 2009]. Only the entries depending on the point
+   * are written, the others have to be initialized by the caller.
+   * \param[in] x point from the input cloud
+   * \param[in,out] point_jacobian the first order derivative of the transformation of
+   * the point, \f$ J_E \f$ in Equation 6.18 [Magnusson 2009]
+   * \param[in,out] point_hessian the second order derivative of the transformation of
+   * the point, \f$ H_E \f$ in Equation 6.20 [Magnusson 2009], or nullptr if the hessian
+   * is not needed
+   */
+  void
+  computePointDerivatives(const Eigen::Vector3d& x,
+                          Eigen::Matrix<double, 3, 6>& point_jacobian,
+                          Eigen::Matrix<double, 18, 6>* point_hessian) const;
+
   /** \brief Compute hessian of probability function w.r.t. the transformation vector.
    * \note Equation 6.13 [Magnusson 2009].
    * \param[out] hessian the hessian matrix of the probability function w.r.t. the
@@ -344,6 +404,25 @@ protected:
                 const Eigen::Vector3d& x_trans,
                 const Eigen::Matrix3d& c_inv) const;
 
+  /** \brief Compute individual point contirbutions to hessian of probability function
+   * w.r.t. the transformation vector, using the given point derivatives.
+   * \note Equation 6.13 [Magnusson 2009].
+   * \param[in,out] hessian the hessian matrix of the probability function w.r.t. the
+   * transformation vector
+   * \param[in] point_jacobian the first order derivative of the transformation of the
+   * point, see \ref computePointDerivatives
+   * \param[in] point_hessian the second order derivative of the transformation of the
+   * point, see \ref computePointDerivatives
+   * \param[in] x_trans transformed point minus mean of occupied covariance voxel
+   * \param[in] c_inv covariance of occupied covariance voxel
+   */
+  void
+  updateHessian(Eigen::Matrix<double, 6, 6>& hessian,
+                const Eigen::Matrix<double, 3, 6>& point_jacobian,
+                const Eigen::Matrix<double, 18, 6>& point_hessian,
+                const Eigen::Vector3d& x_trans,
+                const Eigen::Matrix3d& c_inv) const;
+
   /** \brief Compute line search step length and update transform and probability
    * derivatives using More-Thuente method. \note Search Algorithm [More, Thuente 1994]
    * \param[in] transform initial transformation vector, \f$ x \f$ in Equation 1.3
@@ -509,6 +588,12 @@ protected:
    * transform vector, \f$ H_E \f$ in Equation 6.20 [Magnusson 2009]. */
   Eigen::Matrix<double, 18, 6> point_hessian_;
 
+  /** \brief The number of threads the scheduler should use. */
+  unsigned int threads_;
+
+  /** \brief The number of source points per block of the multithreaded evaluation. */
+  static constexpr std::size_t points_per_block_ = 256;
+
 public:
   PCL_MAKE_ALIGNED_OPERATOR_NEW
 };
@@ -58,76 +58,94 @@ pcl::LeastMedianSquares<PointT>::computeModel (int debug_verbosity_level)
   iterations_ = 0;
   double d_best_penalty = std::numeric_limits<double>::max();
 
-  Indices selection;
-  Eigen::VectorXf model_coefficients (sac_model_->getModelSize ());
   std::vector<double> distances;
 
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
-  
+
+  // The hypotheses are drawn in batches of one per thread, and scored in parallel
+  const int threads = this->getEffectiveNumberOfThreads ();
+  std::vector<Hypothesis> hypotheses (threads);
+  std::vector<std::vector<double> > thread_distances (threads);
+  const bool is_dense = sac_model_->getInputCloud ()->is_dense;
+
   // Iterate
-  while ((iterations_ < max_iterations_) && (skipped_count < max_skip))
+  bool done = false;
+  while (!done)
   {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
+    this->drawHypotheses (hypotheses, threads);
 
-    if (selection.empty ())
+    this->scoreHypotheses (hypotheses, threads, [this, &thread_distances, is_dense] (Hypothesis &hypothesis, int thread)
     {
-      PCL_ERROR ("[pcl::LeastMedianSquares::computeModel] No samples could be selected!\n");
-      break;
-    }
+      // Iterate through the 3d points and calculate the distances from them to the model
+      std::vector<double> &model_distances = thread_distances[thread];
+      sac_model_->getDistancesToModel (hypothesis.model_coefficients, model_distances);
 
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
-    {
-      //iterations_++;
-      ++skipped_count;
-      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] The function computeModelCoefficients failed, so continue with next iteration.\n");
-      continue;
-    }
+      // No distances? The model must not respect the user given constraints
+      if (model_distances.empty ())
+        return;
 
-    double d_cur_penalty;
-    // d_cur_penalty = sum (min (dist, threshold))
+      // Move all NaNs in distances to the end
+      const auto new_end = (is_dense ? model_distances.end() : std::partition (model_distances.begin(), model_distances.end(), [](double d){return !std::isnan (d);}));
+      const auto nr_valid_dists = std::distance (model_distances.begin (), new_end);
 
-    // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
-    
-    // No distances? The model must not respect the user given constraints
-    if (distances.empty ())
-    {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
-    // Move all NaNs in distances to the end
-    const auto new_end = (sac_model_->getInputCloud()->is_dense ? distances.end() : std::partition (distances.begin(), distances.end(), [](double d){return !std::isnan (d);}));
-    const auto nr_valid_dists = std::distance (distances.begin (), new_end);
+      // d_cur_penalty = median (distances)
+      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] There are %lu valid distances remaining after removing NaN values.\n", nr_valid_dists);
+      if (nr_valid_dists == 0)
+        return;
 
-    // d_cur_penalty = median (distances)
-    PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] There are %lu valid distances remaining after removing NaN values.\n", nr_valid_dists);
-    if (nr_valid_dists == 0)
-    {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
-    d_cur_penalty = pcl::computeMedian (distances.begin (), new_end, static_cast<double(*)(double)>(std::sqrt));
-
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
-    {
-      d_best_penalty = d_cur_penalty;
-
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
-    }
+      hypothesis.score = pcl::computeMedian (model_distances.begin (), new_end, static_cast<double(*)(double)>(std::sqrt));
+      hypothesis.scored = true;
+    });
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
+    // Go through the hypotheses in order, so that the result does not depend on the number of threads
+    for (const Hypothesis &hypothesis : hypotheses)
     {
-      PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, max_iterations_, d_best_penalty);
+      if (iterations_ >= max_iterations_ || skipped_count >= max_skip)
+      {
+        done = true;
+        break;
+      }
+
+      if (hypothesis.selection.empty ())
+      {
+        PCL_ERROR ("[pcl::LeastMedianSquares::computeModel] No samples could be selected!\n");
+        done = true;
+        break;
+      }
+
+      if (!hypothesis.valid)
+      {
+        //iterations_++;
+        ++skipped_count;
+        PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] The function computeModelCoefficients failed, so continue with next iteration.\n");
+        continue;
+      }
+
+      // No valid distances to compute the median of
+      if (!hypothesis.scored)
+      {
+        //iterations_++;
+        ++skipped_count;
+        continue;
+      }
+
+      // Better match ?
+      if (hypothesis.score < d_best_penalty)
+      {
+        d_best_penalty = hypothesis.score;
+
+        // Save the current model/coefficients selection as being the best so far
+        model_              = hypothesis.selection;
+        model_coefficients_ = hypothesis.model_coefficients;
+      }
+
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+      {
+        PCL_DEBUG ("[pcl::LeastMedianSquares::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, max_iterations_, d_best_penalty);
+      }
     }
   }
 
@@ -60,8 +60,6 @@ pcl::MaximumLikelihoodSampleConsensus<PointT>::computeModel (int debug_verbosity
   double d_best_penalty = std::numeric_limits<double>::max();
   double k = 1.0;
 
-  Indices selection;
-  Eigen::VectorXf model_coefficients (sac_model_->getModelSize ());
   std::vector<double> distances;
 
   // Compute sigma - remember to set threshold_ correctly !
@@ -78,50 +76,38 @@ pcl::MaximumLikelihoodSampleConsensus<PointT>::computeModel (int debug_verbosity
   double v = sqrt (max_pt.dot (max_pt));
 
   int n_inliers_count = 0;
-  std::size_t indices_size;
+  const std::size_t indices_size = sac_model_->getIndices ()->size ();
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
-  
-  // Iterate
-  while (iterations_ < k && skipped_count < max_skip)
-  {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
 
-    if (selection.empty ()) break;
-
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
-    {
-      //iterations_++;
-      ++ skipped_count;
-      continue;
-    }
+  // The hypotheses are drawn in batches of one per thread, and scored in parallel
+  const int threads = this->getEffectiveNumberOfThreads ();
+  std::vector<Hypothesis> hypotheses (threads);
+  std::vector<std::vector<double> > thread_distances (threads);
+  std::vector<std::vector<double> > thread_p_inlier_prob (threads, std::vector<double> (indices_size));
 
+  const auto score = [&, this] (Hypothesis &hypothesis, int thread)
+  {
     // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
+    std::vector<double> &model_distances = thread_distances[thread];
+    sac_model_->getDistancesToModel (hypothesis.model_coefficients, model_distances);
+
+    if (model_distances.empty ())
+      return;
 
-    if (distances.empty ())
-    {
-      //iterations_++;
-      ++skipped_count;
-      continue;
-    }
-    
     // Use Expectation-Maximization to find out the right value for d_cur_penalty
     // ---[ Initial estimate for the gamma mixing parameter = 1/2
     double gamma = 0.5;
     double p_outlier_prob = 0;
 
-    indices_size = sac_model_->getIndices ()->size ();
-    std::vector<double> p_inlier_prob (indices_size);
+    std::vector<double> &p_inlier_prob = thread_p_inlier_prob[thread];
     for (int j = 0; j < iterations_EM_; ++j)
     {
       const double weighted_normalization_factor = gamma * normalization_factor;
       // Likelihood of a datum given that it is an inlier
       for (std::size_t i = 0; i < indices_size; ++i)
-        p_inlier_prob[i] = weighted_normalization_factor * std::exp ( dist_scaling_factor * distances[i] * distances[i] );
+        p_inlier_prob[i] = weighted_normalization_factor * std::exp ( dist_scaling_factor * model_distances[i] * model_distances[i] );
 
       // Likelihood of a datum given that it is an outlier
       p_outlier_prob = (1 - gamma) / v;
@@ -129,46 +115,74 @@ pcl::MaximumLikelihoodSampleConsensus<PointT>::computeModel (int debug_verbosity
       gamma = 0;
       for (std::size_t i = 0; i < indices_size; ++i)
         gamma += p_inlier_prob [i] / (p_inlier_prob[i] + p_outlier_prob);
-      gamma /= static_cast<double>(sac_model_->getIndices ()->size ());
+      gamma /= static_cast<double>(indices_size);
     }
 
     // Find the std::log likelihood of the model -L = -sum [std::log (pInlierProb + pOutlierProb)]
     double d_cur_penalty = 0;
     for (std::size_t i = 0; i < indices_size; ++i)
       d_cur_penalty += std::log (p_inlier_prob[i] + p_outlier_prob);
-    d_cur_penalty = - d_cur_penalty;
+    hypothesis.score = - d_cur_penalty;
 
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
-    {
-      d_best_penalty = d_cur_penalty;
-
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
-
-      n_inliers_count = 0;
-      // Need to compute the number of inliers for this model to adapt k
-      for (const double &distance : distances)
-        if (distance <= 2 * sigma_)
-          n_inliers_count++;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      double w = static_cast<double> (n_inliers_count) / static_cast<double> (sac_model_->getIndices ()->size ());
-      double p_no_outliers = 1 - std::pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = std::log (1 - probability_) / std::log (p_no_outliers);
-    }
+    // Need to compute the number of inliers for this model to adapt k
+    for (const double &distance : model_distances)
+      if (distance <= 2 * sigma_)
+        ++hypothesis.nr_inliers;
+    hypothesis.scored = true;
+  };
+
+  // Iterate
+  bool done = false;
+  while (!done)
+  {
+    this->drawHypotheses (hypotheses, threads);
+    this->scoreHypotheses (hypotheses, threads, score);
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::MaximumLikelihoodSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
-    if (iterations_ > max_iterations_)
+    // Go through the hypotheses in order, so that the result does not depend on the number of threads
+    for (const Hypothesis &hypothesis : hypotheses)
     {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::MaximumLikelihoodSampleConsensus::computeModel] MLESAC reached the maximum number of trials.\n");
-      break;
+      if (iterations_ >= k || skipped_count >= max_skip || hypothesis.selection.empty ())
+      {
+        done = true;
+        break;
+      }
+
+      if (!hypothesis.valid || !hypothesis.scored)
+      {
+        //iterations_++;
+        ++ skipped_count;
+        continue;
+      }
+
+      // Better match ?
+      if (hypothesis.score < d_best_penalty)
+      {
+        d_best_penalty = hypothesis.score;
+
+        // Save the current model/coefficients selection as being the best so far
+        model_              = hypothesis.selection;
+        model_coefficients_ = hypothesis.model_coefficients;
+
+        n_inliers_count = static_cast<int> (hypothesis.nr_inliers);
+
+        // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+        double w = static_cast<double> (n_inliers_count) / static_cast<double> (indices_size);
+        double p_no_outliers = 1 - std::pow (w, static_cast<double> (model_.size ()));
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = std::log (1 - probability_) / std::log (p_no_outliers);
+      }
+
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::MaximumLikelihoodSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
+      if (iterations_ > max_iterations_)
+      {
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::MaximumLikelihoodSampleConsensus::computeModel] MLESAC reached the maximum number of trials.\n");
+        done = true;
+        break;
+      }
     }
   }
 
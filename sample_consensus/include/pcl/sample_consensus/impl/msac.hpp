@@ -58,72 +58,88 @@ pcl::MEstimatorSampleConsensus<PointT>::computeModel (int debug_verbosity_level)
   double d_best_penalty = std::numeric_limits<double>::max();
   double k = 1.0;
 
-  Indices selection;
-  Eigen::VectorXf model_coefficients (sac_model_->getModelSize ());
   std::vector<double> distances;
 
   int n_inliers_count = 0;
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
-  
+
+  // The hypotheses are drawn in batches of one per thread, and scored in parallel
+  const int threads = this->getEffectiveNumberOfThreads ();
+  std::vector<Hypothesis> hypotheses (threads);
+  std::vector<std::vector<double> > thread_distances (threads);
+
   // Iterate
-  while (iterations_ < k && skipped_count < max_skip)
+  bool done = false;
+  while (!done)
   {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
+    this->drawHypotheses (hypotheses, threads);
 
-    if (selection.empty ()) break;
-
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
-    {
-      //iterations_++;
-      ++ skipped_count;
-      continue;
-     }
-
-    double d_cur_penalty = 0;
-    // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
-    
-    if (distances.empty () && k > 1.0)
-      continue;
-
-    for (const double &distance : distances)
-      d_cur_penalty += (std::min) (distance, threshold_);
-
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
+    this->scoreHypotheses (hypotheses, threads, [this, &thread_distances] (Hypothesis &hypothesis, int thread)
     {
-      d_best_penalty = d_cur_penalty;
-
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
-
-      n_inliers_count = 0;
-      // Need to compute the number of inliers for this model to adapt k
-      for (const double &distance : distances)
+      // Iterate through the 3d points and calculate the distances from them to the model
+      std::vector<double> &model_distances = thread_distances[thread];
+      sac_model_->getDistancesToModel (hypothesis.model_coefficients, model_distances);
+
+      for (const double &distance : model_distances)
+      {
+        hypothesis.score += (std::min) (distance, threshold_);
+        // Need to compute the number of inliers for this model to adapt k
         if (distance <= threshold_)
-          ++n_inliers_count;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      double w = static_cast<double> (n_inliers_count) / static_cast<double> (sac_model_->getIndices ()->size ());
-      double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = std::log (1.0 - probability_) / std::log (p_no_outliers);
-    }
+          ++hypothesis.nr_inliers;
+      }
+      hypothesis.scored = !model_distances.empty ();
+    });
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
-    if (iterations_ > max_iterations_)
+    // Go through the hypotheses in order, so that the result does not depend on the number of threads
+    for (const Hypothesis &hypothesis : hypotheses)
     {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
-      break;
+      if (iterations_ >= k || skipped_count >= max_skip || hypothesis.selection.empty ())
+      {
+        done = true;
+        break;
+      }
+
+      if (!hypothesis.valid)
+      {
+        //iterations_++;
+        ++ skipped_count;
+        continue;
+      }
+
+      if (!hypothesis.scored && k > 1.0)
+        continue;
+
+      // Better match ?
+      if (hypothesis.score < d_best_penalty)
+      {
+        d_best_penalty = hypothesis.score;
+
+        // Save the current model/coefficients selection as being the best so far
+        model_              = hypothesis.selection;
+        model_coefficients_ = hypothesis.model_coefficients;
+
+        n_inliers_count = static_cast<int> (hypothesis.nr_inliers);
+
+        // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+        double w = static_cast<double> (n_inliers_count) / static_cast<double> (sac_model_->getIndices ()->size ());
+        double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (model_.size ()));
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = std::log (1.0 - probability_) / std::log (p_no_outliers);
+      }
+
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
+      if (iterations_ > max_iterations_)
+      {
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::MEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
+        done = true;
+        break;
+      }
     }
   }
 
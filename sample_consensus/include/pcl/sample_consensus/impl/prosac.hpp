@@ -83,8 +83,6 @@ pcl::ProgressiveSampleConsensus<PointT>::computeModel (int debug_verbosity_level
   iterations_ = 0;
 
   Indices inliers;
-  Indices selection;
-  Eigen::VectorXf model_coefficients (sac_model_->getModelSize ());
 
   // We will increase the pool so the indices_ vector can only contain m elements at first
   Indices index_pool;
@@ -92,133 +90,180 @@ pcl::ProgressiveSampleConsensus<PointT>::computeModel (int debug_verbosity_level
   for (unsigned int i = 0; i < n; ++i)
     index_pool.push_back (sac_model_->indices_->operator[](i));
 
+  // The hypotheses are drawn in batches of one per thread, and scored in parallel
+  const int threads = this->getEffectiveNumberOfThreads ();
+  std::vector<Hypothesis> hypotheses;
+
   // Iterate
-  while (static_cast<unsigned int> (iterations_) < k_n_star)
+  bool done = false;
+  while (!done)
   {
-    // Choose the samples
-
-    // Step 1
-    // According to Equation 5 in the text text, not the algorithm
-    if ((iterations_ == T_prime_n) && (n < n_star))
+    // Choose the samples. They only depend on the iteration, so the ones of the whole batch
+    // can be drawn before scoring any of them
+    hypotheses.resize (threads);
+    bool pool_exhausted = false;
+    int iteration = iterations_;
+    for (std::size_t i = 0; i < hypotheses.size (); ++i, ++iteration)
     {
-      // Increase the pool
-      ++n;
-      if (n >= N)
-        break;
-      index_pool.push_back (sac_model_->indices_->at(static_cast<unsigned int> (n - 1)));
-      // Update other variables
-      float T_n_minus_1 = T_n;
-      T_n *= (static_cast<float>(n) + 1.0f) / (static_cast<float>(n) + 1.0f - static_cast<float>(m));
-      T_prime_n += std::ceil (T_n - T_n_minus_1);
-    }
+      // Step 1
+      // According to Equation 5 in the text text, not the algorithm
+      if ((iteration == T_prime_n) && (n < n_star))
+      {
+        // Increase the pool
+        ++n;
+        if (n >= N)
+        {
+          pool_exhausted = true;
+          hypotheses.resize (i);
+          break;
+        }
+        index_pool.push_back (sac_model_->indices_->at(static_cast<unsigned int> (n - 1)));
+        // Update other variables
+        float T_n_minus_1 = T_n;
+        T_n *= (static_cast<float>(n) + 1.0f) / (static_cast<float>(n) + 1.0f - static_cast<float>(m));
+        T_prime_n += std::ceil (T_n - T_n_minus_1);
+      }
 
-    // Step 2
-    sac_model_->indices_->swap (index_pool);
-    selection.clear ();
-    sac_model_->getSamples (iterations_, selection);
-    if (T_prime_n < iterations_)
-    {
-      selection.pop_back ();
-      selection.push_back (sac_model_->indices_->at(static_cast<unsigned int> (n - 1)));
-    }
+      // Step 2
+      Indices &selection = hypotheses[i].selection;
+      sac_model_->indices_->swap (index_pool);
+      selection.clear ();
+      int sample_iterations = iteration;
+      sac_model_->getSamples (sample_iterations, selection);
+      if (T_prime_n < iteration && !selection.empty ())
+      {
+        selection.pop_back ();
+        selection.push_back (sac_model_->indices_->at(static_cast<unsigned int> (n - 1)));
+      }
 
-    // Make sure we use the right indices for testing
-    sac_model_->indices_->swap (index_pool);
+      // Make sure we use the right indices for testing
+      sac_model_->indices_->swap (index_pool);
 
-    if (selection.empty ())
-    {
-      PCL_ERROR ("[pcl::ProgressiveSampleConsensus::computeModel] No samples could be selected!\n");
-      break;
+      if (selection.empty ())
+      {
+        hypotheses.resize (i + 1);
+        break;
+      }
     }
 
-    // Search for inliers in the point cloud for the current model
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+    // Search for inliers in the point cloud for the current models
+    this->computeHypotheses (hypotheses, threads);
+    this->scoreHypotheses (hypotheses, threads, [this] (Hypothesis &hypothesis, int)
     {
-      ++iterations_;
-      continue;
-    }
+      hypothesis.nr_inliers = sac_model_->countWithinDistance (hypothesis.model_coefficients, threshold_);
+      hypothesis.scored = true;
+    });
 
-    // Select the inliers that are within threshold_ from the model
-    inliers.clear ();
-    sac_model_->selectWithinDistance (model_coefficients, threshold_, inliers);
+    // Go through the hypotheses in order, so that the result does not depend on the number of threads
+    for (const Hypothesis &hypothesis : hypotheses)
+    {
+      if (static_cast<unsigned int> (iterations_) >= k_n_star)
+      {
+        done = true;
+        break;
+      }
 
-    std::size_t I_N = inliers.size ();
+      if (hypothesis.selection.empty ())
+      {
+        PCL_ERROR ("[pcl::ProgressiveSampleConsensus::computeModel] No samples could be selected!\n");
+        done = true;
+        break;
+      }
 
-    // If we find more inliers than before
-    if (I_N > I_N_best)
-    {
-      I_N_best = I_N;
-
-      // Save the current model/inlier/coefficients selection as being the best so far
-      inliers_ = inliers;
-      model_ = selection;
-      model_coefficients_ = model_coefficients;
-
-      // We estimate I_n_star for different possible values of n_star by using the inliers
-      std::sort (inliers.begin (), inliers.end ());
-
-      // Try to find a better n_star
-      // We minimize k_n_star and therefore maximize epsilon_n_star = I_n_star / n_star
-      std::size_t possible_n_star_best = N, I_possible_n_star_best = I_N;
-      float epsilon_possible_n_star_best = static_cast<float>(I_possible_n_star_best) / static_cast<float>(possible_n_star_best);
-
-      // We only need to compute possible better epsilon_n_star for when _n is just about to be removed an inlier
-      std::size_t I_possible_n_star = I_N;
-      for (auto last_inlier = inliers.crbegin (), inliers_end = inliers.crend ();
-           last_inlier != inliers_end; 
-           ++last_inlier, --I_possible_n_star)
+      if (!hypothesis.valid)
       {
-        // The best possible_n_star for a given I_possible_n_star is the index of the last inlier
-        unsigned int possible_n_star = (*last_inlier) + 1;
-        if (possible_n_star <= m)
-          break;
+        ++iterations_;
+        continue;
+      }
 
-        // If we find a better epsilon_n_star
-        float epsilon_possible_n_star = static_cast<float>(I_possible_n_star) / static_cast<float>(possible_n_star);
-        // Make sure we have a better epsilon_possible_n_star
-        if ((epsilon_possible_n_star > epsilon_n_star) && (epsilon_possible_n_star > epsilon_possible_n_star_best))
+      std::size_t I_N = hypothesis.nr_inliers;
+
+      // If we find more inliers than before
+      if (I_N > I_N_best)
+      {
+        I_N_best = I_N;
+
+        // Select the inliers that are within threshold_ from the model
+        inliers.clear ();
+        sac_model_->selectWithinDistance (hypothesis.model_coefficients, threshold_, inliers);
+        I_N = inliers.size ();
+
+        // Save the current model/inlier/coefficients selection as being the best so far
+        inliers_ = inliers;
+        model_ = hypothesis.selection;
+        model_coefficients_ = hypothesis.model_coefficients;
+
+        // We estimate I_n_star for different possible values of n_star by using the inliers
+        std::sort (inliers.begin (), inliers.end ());
+
+        // Try to find a better n_star
+        // We minimize k_n_star and therefore maximize epsilon_n_star = I_n_star / n_star
+        std::size_t possible_n_star_best = N, I_possible_n_star_best = I_N;
+        float epsilon_possible_n_star_best = static_cast<float>(I_possible_n_star_best) / static_cast<float>(possible_n_star_best);
+
+        // We only need to compute possible better epsilon_n_star for when _n is just about to be removed an inlier
+        std::size_t I_possible_n_star = I_N;
+        for (auto last_inlier = inliers.crbegin (), inliers_end = inliers.crend ();
+             last_inlier != inliers_end; 
+             ++last_inlier, --I_possible_n_star)
         {
-          // Typo in Equation 7, not (n-m choose i-m) but (n choose i-m)
-          std::size_t I_possible_n_star_min = m
-                           + static_cast<std::size_t> (std::ceil (boost::math::quantile (boost::math::complement (boost::math::binomial_distribution<float>(static_cast<float> (possible_n_star), 0.1f), 0.05))));
-          // If Equation 9 is not verified, exit
-          if (I_possible_n_star < I_possible_n_star_min)
+          // The best possible_n_star for a given I_possible_n_star is the index of the last inlier
+          unsigned int possible_n_star = (*last_inlier) + 1;
+          if (possible_n_star <= m)
             break;
 
-          possible_n_star_best = possible_n_star;
-          I_possible_n_star_best = I_possible_n_star;
-          epsilon_possible_n_star_best = epsilon_possible_n_star;
+          // If we find a better epsilon_n_star
+          float epsilon_possible_n_star = static_cast<float>(I_possible_n_star) / static_cast<float>(possible_n_star);
+          // Make sure we have a better epsilon_possible_n_star
+          if ((epsilon_possible_n_star > epsilon_n_star) && (epsilon_possible_n_star > epsilon_possible_n_star_best))
+          {
+            // Typo in Equation 7, not (n-m choose i-m) but (n choose i-m)
+            std::size_t I_possible_n_star_min = m
+                             + static_cast<std::size_t> (std::ceil (boost::math::quantile (boost::math::complement (boost::math::binomial_distribution<float>(static_cast<float> (possible_n_star), 0.1f), 0.05))));
+            // If Equation 9 is not verified, exit
+            if (I_possible_n_star < I_possible_n_star_min)
+              break;
+
+            possible_n_star_best = possible_n_star;
+            I_possible_n_star_best = I_possible_n_star;
+            epsilon_possible_n_star_best = epsilon_possible_n_star;
+          }
+        }
+
+        // Check if we get a better epsilon
+        if (epsilon_possible_n_star_best > epsilon_n_star)
+        {
+          // update the best value
+          epsilon_n_star = epsilon_possible_n_star_best;
+
+          // Compute the new k_n_star
+          float bottom_log = 1 - std::pow (epsilon_n_star, static_cast<float>(m));
+          if (bottom_log == 0)
+            k_n_star = 1;
+          else if (bottom_log == 1)
+            k_n_star = T_N;
+          else
+            k_n_star = static_cast<int> (std::ceil (std::log (0.05) / std::log (bottom_log)));
+          // It seems weird to have very few iterations, so do have a few (totally empirical)
+          k_n_star = (std::max)(k_n_star, 2 * m);
         }
       }
 
-      // Check if we get a better epsilon
-      if (epsilon_possible_n_star_best > epsilon_n_star)
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::ProgressiveSampleConsensus::computeModel] Trial %d out of %d: %d inliers (best is: %d so far).\n", iterations_, k_n_star, I_N, I_N_best);
+      if (iterations_ > max_iterations_)
       {
-        // update the best value
-        epsilon_n_star = epsilon_possible_n_star_best;
-
-        // Compute the new k_n_star
-        float bottom_log = 1 - std::pow (epsilon_n_star, static_cast<float>(m));
-        if (bottom_log == 0)
-          k_n_star = 1;
-        else if (bottom_log == 1)
-          k_n_star = T_N;
-        else
-          k_n_star = static_cast<int> (std::ceil (std::log (0.05) / std::log (bottom_log)));
-        // It seems weird to have very few iterations, so do have a few (totally empirical)
-        k_n_star = (std::max)(k_n_star, 2 * m);
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::ProgressiveSampleConsensus::computeModel] RANSAC reached the maximum number of trials.\n");
+        done = true;
+        break;
       }
     }
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::ProgressiveSampleConsensus::computeModel] Trial %d out of %d: %d inliers (best is: %d so far).\n", iterations_, k_n_star, I_N, I_N_best);
-    if (iterations_ > max_iterations_)
-    {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::ProgressiveSampleConsensus::computeModel] RANSAC reached the maximum number of trials.\n");
-      break;
-    }
+    // The pool of indices cannot be increased anymore
+    if (pool_exhausted)
+      done = true;
   }
 
   if (debug_verbosity_level > 0)
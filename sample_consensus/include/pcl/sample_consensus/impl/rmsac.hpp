@@ -58,90 +58,118 @@ pcl::RandomizedMEstimatorSampleConsensus<PointT>::computeModel (int debug_verbos
   double d_best_penalty = std::numeric_limits<double>::max();
   double k = 1.0;
 
-  Indices selection;
-  Eigen::VectorXf model_coefficients (sac_model_->getModelSize ());
   std::vector<double> distances;
-  std::set<index_t> indices_subset;
 
   int n_inliers_count = 0;
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
-  
+
   // Number of samples to try randomly
   std::size_t fraction_nr_points = pcl_lrint (static_cast<double>(sac_model_->getIndices ()->size ()) * fraction_nr_pretest_ / 100.0);
 
-  // Iterate
-  while (iterations_ < k && skipped_count < max_skip)
-  {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
+  // The hypotheses are drawn in batches of one per thread, and scored in parallel
+  const int threads = this->getEffectiveNumberOfThreads ();
+  std::vector<Hypothesis> hypotheses (threads);
+  std::vector<std::vector<double> > thread_distances (threads);
 
-    if (selection.empty ()) break;
+  const auto score = [this, &thread_distances] (Hypothesis &hypothesis, int thread)
+  {
+    // Iterate through the 3d points and calculate the distances from them to the model
+    std::vector<double> &model_distances = thread_distances[thread];
+    sac_model_->getDistancesToModel (hypothesis.model_coefficients, model_distances);
 
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+    for (const double &distance : model_distances)
     {
-      //iterations_++;
-      ++ skipped_count;
-      continue;
+      hypothesis.score += std::min (distance, threshold_);
+      // Need to compute the number of inliers for this model to adapt k
+      if (distance <= threshold_)
+        ++hypothesis.nr_inliers;
     }
+    hypothesis.scored = !model_distances.empty ();
+  };
+
+  // Iterate
+  bool done = false;
+  while (!done)
+  {
+    this->drawHypotheses (hypotheses, threads);
 
     // RMSAC addon: verify a random fraction of the data
-    // Get X random samples which satisfy the model criterion
-    this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, indices_subset);
+    // Get X random samples which satisfy the model criterion. They are drawn in order too
+    for (Hypothesis &hypothesis : hypotheses)
+      if (hypothesis.valid)
+        this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, hypothesis.pretest_indices);
+
+    // The models failing the pre-test are only scored while no model has been found yet
+    const bool score_unverified = (k == 1.0);
+    this->scoreHypotheses (hypotheses, threads, [this, &score, score_unverified] (Hypothesis &hypothesis, int thread)
+    {
+      hypothesis.verified = sac_model_->doSamplesVerifyModel (hypothesis.pretest_indices, hypothesis.model_coefficients, threshold_);
+      if (hypothesis.verified || score_unverified)
+        score (hypothesis, thread);
+    });
 
-    if (!sac_model_->doSamplesVerifyModel (indices_subset, model_coefficients, threshold_))
+    // Go through the hypotheses in order, so that the result does not depend on the number of threads
+    for (Hypothesis &hypothesis : hypotheses)
     {
-      // Unfortunately we cannot "continue" after the first iteration, because k might not be set, while iterations gets incremented
-      if (k != 1.0)
+      if (iterations_ >= k || skipped_count >= max_skip || hypothesis.selection.empty ())
+      {
+        done = true;
+        break;
+      }
+
+      if (!hypothesis.valid)
       {
-        ++iterations_;
+        //iterations_++;
+        ++ skipped_count;
         continue;
       }
-    }
 
-    double d_cur_penalty = 0;
-    // Iterate through the 3d points and calculate the distances from them to the model
-    sac_model_->getDistancesToModel (model_coefficients, distances);
+      if (!hypothesis.verified)
+      {
+        // Unfortunately we cannot "continue" after the first iteration, because k might not be set, while iterations gets incremented
+        if (k != 1.0)
+        {
+          ++iterations_;
+          continue;
+        }
+        if (!score_unverified)
+          score (hypothesis, 0);
+      }
 
-    if (distances.empty () && k > 1.0)
-      continue;
+      if (!hypothesis.scored && k > 1.0)
+        continue;
 
-    for (const double &distance : distances)
-      d_cur_penalty += std::min (distance, threshold_);
+      // Better match ?
+      if (hypothesis.score < d_best_penalty)
+      {
+        d_best_penalty = hypothesis.score;
 
-    // Better match ?
-    if (d_cur_penalty < d_best_penalty)
-    {
-      d_best_penalty = d_cur_penalty;
+        // Save the current model/coefficients selection as being the best so far
+        model_              = hypothesis.selection;
+        model_coefficients_ = hypothesis.model_coefficients;
 
-      // Save the current model/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
+        n_inliers_count = static_cast<int> (hypothesis.nr_inliers);
 
-      n_inliers_count = 0;
-      // Need to compute the number of inliers for this model to adapt k
-      for (const double &distance : distances)
-        if (distance <= threshold_)
-          n_inliers_count++;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      double w = static_cast<double> (n_inliers_count) / static_cast<double>(sac_model_->getIndices ()->size ());
-      double p_no_outliers = 1 - std::pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = std::log (1 - probability_) / std::log (p_no_outliers);
-    }
+        // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+        double w = static_cast<double> (n_inliers_count) / static_cast<double>(sac_model_->getIndices ()->size ());
+        double p_no_outliers = 1 - std::pow (w, static_cast<double> (model_.size ()));
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = std::log (1 - probability_) / std::log (p_no_outliers);
+      }
 
-    ++iterations_;
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
-    if (iterations_ > max_iterations_)
-    {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
-      break;
+      ++iterations_;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] Trial %d out of %d. Best penalty is %f.\n", iterations_, static_cast<int> (std::ceil (k)), d_best_penalty);
+      if (iterations_ > max_iterations_)
+      {
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::RandomizedMEstimatorSampleConsensus::computeModel] MSAC reached the maximum number of trials.\n");
+        done = true;
+        break;
+      }
     }
   }
 
@@ -58,14 +58,9 @@ pcl::RandomizedRandomSampleConsensus<PointT>::computeModel (int debug_verbosity_
   std::size_t n_best_inliers_count = 0;
   double k = std::numeric_limits<double>::max();
 
-  Indices selection;
-  Eigen::VectorXf model_coefficients (sac_model_->getModelSize ());
-  std::set<index_t> indices_subset;
-
   const double log_probability  = std::log (1.0 - probability_);
   const double one_over_indices = 1.0 / static_cast<double> (sac_model_->getIndices ()->size ());
 
-  std::size_t n_inliers_count;
   unsigned skipped_count = 0;
   // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
   const unsigned max_skip = max_iterations_ * 10;
@@ -73,74 +68,98 @@ pcl::RandomizedRandomSampleConsensus<PointT>::computeModel (int debug_verbosity_
   // Number of samples to try randomly
   const std::size_t fraction_nr_points = pcl_lrint (static_cast<double>(sac_model_->getIndices ()->size ()) * fraction_nr_pretest_ / 100.0);
 
+  // The hypotheses are drawn in batches of one per thread, and scored in parallel
+  const int threads = this->getEffectiveNumberOfThreads ();
+  std::vector<Hypothesis> hypotheses (threads);
+
   // Iterate
-  while (iterations_ < k)
+  bool done = false;
+  while (!done)
   {
-    // Get X samples which satisfy the model criteria
-    sac_model_->getSamples (iterations_, selection);
+    this->drawHypotheses (hypotheses, threads);
+
+    // RRANSAC addon: verify a random fraction of the data
+    // Get X random samples which satisfy the model criterion. They are drawn in order too
+    for (Hypothesis &hypothesis : hypotheses)
+      if (hypothesis.valid)
+        this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, hypothesis.pretest_indices);
 
-    if (selection.empty ())
+    this->scoreHypotheses (hypotheses, threads, [this] (Hypothesis &hypothesis, int)
     {
-      PCL_ERROR ("[pcl::RandomizedRandomSampleConsensus::computeModel] No samples could be selected!\n");
-      break;
-    }
+      hypothesis.verified = sac_model_->doSamplesVerifyModel (hypothesis.pretest_indices, hypothesis.model_coefficients, threshold_);
+      if (!hypothesis.verified)
+        return;
+
+      // Select the inliers that are within threshold_ from the model
+      hypothesis.nr_inliers = sac_model_->countWithinDistance (hypothesis.model_coefficients, threshold_);
+      hypothesis.scored = true;
+    });
 
-    // Search for inliers in the point cloud for the current plane model M
-    if (!sac_model_->computeModelCoefficients (selection, model_coefficients))
+    // Go through the hypotheses in order, so that the result does not depend on the number of threads
+    for (const Hypothesis &hypothesis : hypotheses)
     {
-      //iterations_++;
-      ++skipped_count;
-      if (skipped_count < max_skip)
+      if (iterations_ >= k)
       {
-        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, so continue with next iteration.\n");
-        continue;
+        done = true;
+        break;
       }
-      else
+
+      if (hypothesis.selection.empty ())
       {
-        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, and RRANSAC reached the maximum number of trials.\n");
+        PCL_ERROR ("[pcl::RandomizedRandomSampleConsensus::computeModel] No samples could be selected!\n");
+        done = true;
         break;
       }
-    }
 
-    // RRANSAC addon: verify a random fraction of the data
-    // Get X random samples which satisfy the model criterion
-    this->getRandomSamples (sac_model_->getIndices (), fraction_nr_points, indices_subset);
-    if (!sac_model_->doSamplesVerifyModel (indices_subset, model_coefficients, threshold_))
-    {
-      ++iterations_;
-      PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function doSamplesVerifyModel failed, so continue with next iteration.\n");
-      continue;
-    }
+      if (!hypothesis.valid)
+      {
+        //iterations_++;
+        ++skipped_count;
+        if (skipped_count < max_skip)
+        {
+          PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, so continue with next iteration.\n");
+          continue;
+        }
+        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function computeModelCoefficients failed, and RRANSAC reached the maximum number of trials.\n");
+        done = true;
+        break;
+      }
 
-    // Select the inliers that are within threshold_ from the model
-    n_inliers_count = sac_model_->countWithinDistance (model_coefficients, threshold_);
+      if (!hypothesis.verified)
+      {
+        ++iterations_;
+        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] The function doSamplesVerifyModel failed, so continue with next iteration.\n");
+        continue;
+      }
 
-    // Better match ?
-    if (n_inliers_count > n_best_inliers_count)
-    {
-      n_best_inliers_count = n_inliers_count;
-
-      // Save the current model/inlier/coefficients selection as being the best so far
-      model_              = selection;
-      model_coefficients_ = model_coefficients;
-
-      // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
-      const double w = static_cast<double> (n_inliers_count) * one_over_indices;
-      double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (selection.size ()));
-      p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
-      p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
-      k = log_probability / std::log (p_no_outliers);
-    }
+      // Better match ?
+      if (hypothesis.nr_inliers > n_best_inliers_count)
+      {
+        n_best_inliers_count = hypothesis.nr_inliers;
+
+        // Save the current model/inlier/coefficients selection as being the best so far
+        model_              = hypothesis.selection;
+        model_coefficients_ = hypothesis.model_coefficients;
+
+        // Compute the k parameter (k=std::log(z)/std::log(1-w^n))
+        const double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
+        double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (model_.size ()));
+        p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+        p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+        k = log_probability / std::log (p_no_outliers);
+      }
 
-    ++iterations_;
+      ++iterations_;
 
-    if (debug_verbosity_level > 1)
-      PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] Trial %d out of %d: %u inliers (best is: %u so far).\n", iterations_, static_cast<int> (std::ceil (k)), n_inliers_count, n_best_inliers_count);
-    if (iterations_ > max_iterations_)
-    {
-      if (debug_verbosity_level > 0)
-        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] RRANSAC reached the maximum number of trials.\n");
-      break;
+      if (debug_verbosity_level > 1)
+        PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] Trial %d out of %d: %u inliers (best is: %u so far).\n", iterations_, static_cast<int> (std::ceil (k)), hypothesis.nr_inliers, n_best_inliers_count);
+      if (iterations_ > max_iterations_)
+      {
+        if (debug_verbosity_level > 0)
+          PCL_DEBUG ("[pcl::RandomizedRandomSampleConsensus::computeModel] RRANSAC reached the maximum number of trials.\n");
+        done = true;
+        break;
+      }
     }
   }
 
@@ -132,6 +132,17 @@ pcl::SampleConsensusModelCircle3D<PointT>::getDistancesToModel (const Eigen::Vec
   }
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    // The scalar implementation below moves the point along +N to project it
+    model.c[7] = -model.c[7];
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   // Iterate through the 3d points and calculate the distances from them to the sphere
   for (std::size_t i = 0; i < indices_->size (); ++i)
   // Calculate the distance from the point to the circle:
@@ -223,6 +234,16 @@ pcl::SampleConsensusModelCircle3D<PointT>::countWithinDistance (
   // Check if the model is valid given the user constraints
   if (!isModelValid (model_coefficients))
     return (0);
+
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
+
   std::size_t nr_p = 0;
 
   const auto squared_threshold = threshold * threshold;
@@ -257,6 +278,19 @@ pcl::SampleConsensusModelCircle3D<PointT>::countWithinDistance (
   return (nr_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SampleConsensusModelCircle3D<PointT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::CIRCLE3D;
+  for (int i = 0; i < 7; ++i)
+    model.c[i] = model_coefficients[i];
+  // The point is projected on the plane of the circle with P - (PC.N / N.N) N
+  model.c[7] = static_cast<float> (-1.0 / model_coefficients.segment<3> (4).cast<double> ().squaredNorm ());
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelCircle3D<PointT>::optimizeModelCoefficients (
@@ -155,6 +155,15 @@ pcl::SampleConsensusModelCone<PointT, PointNT>::getDistancesToModel (
 
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   Eigen::Vector4f apex (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
   Eigen::Vector4f axis_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
   float opening_angle = model_coefficients[6];
@@ -271,6 +280,15 @@ pcl::SampleConsensusModelCone<PointT, PointNT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
+
   std::size_t nr_p = 0;
 
   Eigen::Vector4f apex (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
@@ -317,6 +335,28 @@ pcl::SampleConsensusModelCone<PointT, PointNT>::countWithinDistance (
   return (nr_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> void
+pcl::SampleConsensusModelCone<PointT, PointNT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::CONE;
+  for (int i = 0; i < 6; ++i)
+    model.c[i] = model_coefficients[i];
+  const float opening_angle = model_coefficients[6];
+  model.c[6] = tanf (opening_angle);
+  model.c[7] = sinf (opening_angle);
+  model.c[8] = std::cos (opening_angle);
+  // apex . axis is summed in the order of the kernel, so that the apex itself is projected on the apex
+  const Eigen::Vector4f axis_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
+  model.c[9] = (model.c[0] * model.c[3] + model.c[1] * model.c[4]) + model.c[2] * model.c[5];
+  model.c[10] = 1.0f / axis_dir.dot (axis_dir);
+  model.c[11] = axis_dir.dot (axis_dir);
+  model.normal_distance_weight = static_cast<float> (normal_distance_weight_);
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+  pcl::detail::setSacSimdNormals (*normals_, points);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename PointNT> void
 pcl::SampleConsensusModelCone<PointT, PointNT>::optimizeModelCoefficients (
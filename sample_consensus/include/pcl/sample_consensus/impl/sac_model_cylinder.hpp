@@ -149,6 +149,15 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::getDistancesToModel (
 
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
   float ptdotdir = line_pt.dot (line_dir);
@@ -239,6 +248,15 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
+
   std::size_t nr_p = 0;
 
   Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
@@ -272,6 +290,24 @@ pcl::SampleConsensusModelCylinder<PointT, PointNT>::countWithinDistance (
   return (nr_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> void
+pcl::SampleConsensusModelCylinder<PointT, PointNT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::CYLINDER;
+  for (int i = 0; i < 7; ++i)
+    model.c[i] = model_coefficients[i];
+  // line_pt . line_dir is summed in the order of the kernel, so that line_pt is projected on itself
+  const Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
+  model.c[7] = (model.c[0] * model.c[3] + model.c[1] * model.c[4]) + model.c[2] * model.c[5];
+  model.c[8] = 1.0f / line_dir.dot (line_dir);
+  model.c[9] = line_dir.dot (line_dir);
+  model.normal_distance_weight = static_cast<float> (normal_distance_weight_);
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+  pcl::detail::setSacSimdNormals (*normals_, points);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename PointNT> void
 pcl::SampleConsensusModelCylinder<PointT, PointNT>::optimizeModelCoefficients (
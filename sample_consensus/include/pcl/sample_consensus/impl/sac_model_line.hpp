@@ -117,6 +117,15 @@ pcl::SampleConsensusModelLine<PointT>::getDistancesToModel (
 
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   // Obtain the line point and direction
   Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0);
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0);
@@ -178,6 +187,15 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
+
   double sqr_threshold = threshold * threshold;
 
   std::size_t nr_p = 0;
@@ -200,6 +218,21 @@ pcl::SampleConsensusModelLine<PointT>::countWithinDistance (
   return (nr_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SampleConsensusModelLine<PointT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::LINE;
+  const Eigen::Vector3f line_dir = model_coefficients.segment<3> (3).normalized ();
+  for (int i = 0; i < 3; ++i)
+  {
+    model.c[i] = model_coefficients[i];
+    model.c[3 + i] = line_dir[i];
+  }
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelLine<PointT>::optimizeModelCoefficients (
@@ -116,13 +116,34 @@ pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
-#if defined (__AVX__) && defined (__AVX2__)
-  return countWithinDistanceAVX (model_coefficients, threshold);
-#elif defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
-  return countWithinDistanceSSE (model_coefficients, threshold);
-#else
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
   return countWithinDistanceStandard (model_coefficients, threshold);
-#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> void
+pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::NORMAL_PLANE;
+  for (int i = 0; i < 4; ++i)
+    model.c[i] = model_coefficients[i];
+  // The angle is computed with the normalized plane normal
+  const Eigen::Vector3f unit_normal = model_coefficients.head<3> ().normalized ();
+  for (int i = 0; i < 3; ++i)
+    model.c[4 + i] = unit_normal[i];
+  model.normal_distance_weight = static_cast<float> (normal_distance_weight_);
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+  pcl::detail::setSacSimdNormals (*normals_, points);
+  if (!normals_->empty ())
+    points.curvatures = &(*normals_)[0].curvature;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -306,12 +327,21 @@ pcl::SampleConsensusModelNormalPlane<PointT, PointNT>::getDistancesToModel (
     return;
   }
 
+  distances.resize (indices_->size ());
+
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   // Obtain the plane normal
   Eigen::Vector4f coeff = model_coefficients;
   coeff[3] = 0.0f;
 
-  distances.resize (indices_->size ());
-
   // Iterate through the 3d points and calculate the distances from them to the plane
   for (std::size_t i = 0; i < indices_->size (); ++i)
   {
@@ -120,6 +120,14 @@ pcl::SampleConsensusModelNormalSphere<PointT, PointNT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return(0);
 
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
 
   // Obtain the sphere centroid
   Eigen::Vector4f center = model_coefficients;
@@ -156,6 +164,19 @@ pcl::SampleConsensusModelNormalSphere<PointT, PointNT>::countWithinDistance (
   return (nr_p);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename PointNT> void
+pcl::SampleConsensusModelNormalSphere<PointT, PointNT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::NORMAL_SPHERE;
+  for (int i = 0; i < 4; ++i)
+    model.c[i] = model_coefficients[i];
+  model.normal_distance_weight = static_cast<float> (normal_distance_weight_);
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+  pcl::detail::setSacSimdNormals (*normals_, points);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename PointNT> void
 pcl::SampleConsensusModelNormalSphere<PointT, PointNT>::getDistancesToModel (
@@ -180,6 +201,15 @@ pcl::SampleConsensusModelNormalSphere<PointT, PointNT>::getDistancesToModel (
 
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   // Iterate through the 3d points and calculate the distances from them to the sphere
   for (std::size_t i = 0; i < indices_->size (); ++i)
   {
@@ -156,6 +156,15 @@ pcl::SampleConsensusModelPlane<PointT>::getDistancesToModel (
 
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   // Iterate through the 3d points and calculate the distances from them to the plane
   for (std::size_t i = 0; i < indices_->size (); ++i)
   {
@@ -222,13 +231,26 @@ pcl::SampleConsensusModelPlane<PointT>::countWithinDistance (
     PCL_ERROR ("[pcl::SampleConsensusModelPlane::countWithinDistance] Given model is invalid!\n");
     return (0);
   }
-#if defined (__AVX__) && defined (__AVX2__)
-  return countWithinDistanceAVX (model_coefficients, threshold);
-#elif defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
-  return countWithinDistanceSSE (model_coefficients, threshold);
-#else
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
   return countWithinDistanceStandard (model_coefficients, threshold);
-#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SampleConsensusModelPlane<PointT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::PLANE;
+  for (int i = 0; i < 4; ++i)
+    model.c[i] = model_coefficients[i];
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -119,6 +119,15 @@ pcl::SampleConsensusModelRegistration<PointT>::getDistancesToModel (const Eigen:
   }
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   // Get the 4x4 transformation
   Eigen::Matrix4f transform;
   transform.row (0).matrix () = model_coefficients.segment<4>(0);
@@ -222,6 +231,15 @@ pcl::SampleConsensusModelRegistration<PointT>::countWithinDistance (
   {
     return (0);
   }
+
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
   
   Eigen::Matrix4f transform;
   transform.row (0).matrix () = model_coefficients.segment<4>(0);
@@ -284,6 +302,24 @@ pcl::SampleConsensusModelRegistration<PointT>::optimizeModelCoefficients (const
   estimateRigidTransformationSVD (*input_, indices_src, *target_, indices_tgt, optimized_coefficients);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SampleConsensusModelRegistration<PointT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::REGISTRATION;
+  for (int i = 0; i < 16; ++i)
+    model.c[i] = model_coefficients[i];
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+  // The correspondences of the points, in the same form
+  pcl::detail::SacSimdPoints target;
+  pcl::detail::setSacSimdPoints (*target_, *indices_tgt_, target);
+  points.target_xyz = target.xyz;
+  points.target_step = target.xyz_step;
+  points.target_padded = target.xyz_padded;
+  points.target_indices = target.indices;
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelRegistration<PointT>::estimateRigidTransformationSVD (
@@ -167,6 +167,15 @@ pcl::SampleConsensusModelSphere<PointT>::getDistancesToModel (
   }
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   const Eigen::Vector3f center (model_coefficients[0], model_coefficients[1], model_coefficients[2]);
   // Iterate through the 3d points and calculate the distances from them to the sphere
   for (std::size_t i = 0; i < indices_->size (); ++i)
@@ -222,13 +231,29 @@ pcl::SampleConsensusModelSphere<PointT>::countWithinDistance (
   if (!isModelValid (model_coefficients))
     return (0);
 
-#if defined (__AVX__) && defined (__AVX2__)
-  return countWithinDistanceAVX (model_coefficients, threshold);
-#elif defined (__SSE__) && defined (__SSE2__) && defined (__SSE4_1__)
-  return countWithinDistanceSSE (model_coefficients, threshold);
-#else
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    // The points are counted between the inner and the outer spheres, as in countWithinDistanceStandard
+    model.c[4] = (model_coefficients[3] <= threshold ? 0.0f : (model_coefficients[3] - threshold) * (model_coefficients[3] - threshold));
+    model.c[5] = (model_coefficients[3] + threshold) * (model_coefficients[3] + threshold);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
   return countWithinDistanceStandard (model_coefficients, threshold);
-#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SampleConsensusModelSphere<PointT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::SPHERE;
+  for (int i = 0; i < 4; ++i)
+    model.c[i] = model_coefficients[i];
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
 }
 
 //////////////////////////////////////////////////////////////////////////
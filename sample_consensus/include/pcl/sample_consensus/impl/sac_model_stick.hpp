@@ -117,6 +117,21 @@ pcl::SampleConsensusModelStick<PointT>::getDistancesToModel (
   float sqr_threshold = static_cast<float> (radius_max_ * radius_max_);
   distances.resize (indices_->size ());
 
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    // As below, the direction of the line is given by the second point, and the
+    // distances are doubled outside of radius_max_
+    const Eigen::Vector3f line_dir = model_coefficients.segment<3> (3).normalized ();
+    for (int i = 0; i < 3; ++i)
+      model.c[3 + i] = line_dir[i];
+    model.c[6] = sqr_threshold;
+    pcl::detail::sacSimdGetDistancesToModel (model, points, distances.data ());
+    return;
+  }
+
   // Obtain the line point and direction
   Eigen::Vector4f line_pt  (model_coefficients[0], model_coefficients[1], model_coefficients[2], 0.0f);
   Eigen::Vector4f line_dir (model_coefficients[3], model_coefficients[4], model_coefficients[5], 0.0f);
@@ -204,6 +219,16 @@ pcl::SampleConsensusModelStick<PointT>::countWithinDistance (
     return (0);
   }
 
+  // Use the fastest SIMD kernel supported by the CPU, see pcl::getSacSimdLevel
+  if (pcl::detail::sacSimdAvailable ())
+  {
+    pcl::detail::SacSimdModel model;
+    pcl::detail::SacSimdPoints points;
+    getSacSimdModel (model_coefficients, model, points);
+    model.c[6] = static_cast<float> (threshold * threshold);
+    return (pcl::detail::sacSimdCountWithinDistance (model, points, threshold));
+  }
+
   float sqr_threshold = static_cast<float> (threshold * threshold);
 
   std::size_t nr_i = 0, nr_o = 0;
@@ -244,6 +269,21 @@ pcl::SampleConsensusModelStick<PointT>::countWithinDistance (
   return (nr_i <= nr_o ? 0 : nr_i - nr_o);
 }
 
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SampleConsensusModelStick<PointT>::getSacSimdModel (
+      const Eigen::VectorXf &model_coefficients, pcl::detail::SacSimdModel &model, pcl::detail::SacSimdPoints &points) const
+{
+  model.kernel = pcl::detail::SacSimdKernel::STICK;
+  const Eigen::Vector3f line_dir = (model_coefficients.segment<3> (3) - model_coefficients.head<3> ()).normalized ();
+  for (int i = 0; i < 3; ++i)
+  {
+    model.c[i] = model_coefficients[i];
+    model.c[3 + i] = line_dir[i];
+  }
+  pcl::detail::setSacSimdPoints (*input_, *indices_, points);
+}
+
 //////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SampleConsensusModelStick<PointT>::optimizeModelCoefficients (
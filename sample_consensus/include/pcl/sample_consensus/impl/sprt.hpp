@@ -0,0 +1,318 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef PCL_SAMPLE_CONSENSUS_IMPL_SPRT_H_
+#define PCL_SAMPLE_CONSENSUS_IMPL_SPRT_H_
+
+#include <pcl/sample_consensus/sprt.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> double
+pcl::SPRTSampleConsensus<PointT>::computeDecisionThreshold (double epsilon, double delta) const
+{
+  // The test cannot tell the good models from the bad ones
+  if (delta >= epsilon)
+    return (std::numeric_limits<double>::infinity ());
+
+  // Expected log likelihood ratio of a point for a bad model
+  const double c = (1.0 - delta) * std::log ((1.0 - delta) / (1.0 - epsilon)) + delta * std::log (delta / epsilon);
+
+  // A = t_M * C / m_S + 1 + log (A), with one model per sample, solved by fixed point iteration
+  const double a0 = time_model_ * c + 1.0;
+  double a = a0;
+  for (int i = 0; i < 10; ++i)
+    a = a0 + std::log (a);
+  return (a);
+}
+
+//////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::SPRTSampleConsensus<PointT>::computeModel (int)
+{
+  // Warn and exit if no threshold was set
+  if (threshold_ == std::numeric_limits<double>::max())
+  {
+    PCL_ERROR ("[pcl::SPRTSampleConsensus::computeModel] No threshold set!\n");
+    return (false);
+  }
+  if (epsilon_ <= 0.0 || epsilon_ >= 1.0 || delta_ <= 0.0 || delta_ >= 1.0)
+  {
+    PCL_ERROR ("[pcl::SPRTSampleConsensus::computeModel] Invalid initial inlier ratios (%g, %g), they should be in (0, 1)!\n", epsilon_, delta_);
+    return (false);
+  }
+
+  iterations_ = 0;
+  std::size_t n_best_inliers_count = 0;
+  double k = std::numeric_limits<double>::max();
+
+  const IndicesPtr indices = sac_model_->getIndices ();
+  const std::size_t nr_points = indices->size ();
+  const double log_probability  = std::log (1.0 - probability_);
+  const double one_over_indices = 1.0 / static_cast<double> (nr_points);
+
+  unsigned skipped_count = 0;
+
+  // suppress infinite loops by just allowing 10 x maximum allowed iterations for invalid model parameters!
+  const unsigned max_skip = max_iterations_ * 10;
+
+  // The models are first checked against blocks of growing size of random points, after each of which the test
+  // can reject them, and then against all the points. The blocks are swapped in place of the indices of the
+  // sample consensus model, one at a time. The target indices of the registration models follow their indices,
+  // so these are always checked against all the points
+  std::vector<Indices> blocks;
+  const SacModel model_type = sac_model_->getModelType ();
+  if (model_type != SACMODEL_REGISTRATION && model_type != SACMODEL_REGISTRATION_2D)
+  {
+    const std::size_t nr_random_points = (std::min) (nr_points / 4, static_cast<std::size_t> (max_random_points_));
+    for (std::size_t begin = 0, block_size = 32; begin < nr_random_points; begin += block_size, block_size *= 2)
+    {
+      // The points are drawn independently, and sorted for a faster memory access
+      blocks.emplace_back ((std::min) (nr_random_points - begin, block_size));
+      for (auto &index : blocks.back ())
+        index = (*indices)[static_cast<std::size_t> (static_cast<double> (nr_points) * this->rnd ())];
+      std::sort (blocks.back ().begin (), blocks.back ().end ());
+    }
+  }
+
+  // The number of random points checked against the models after each block
+  std::vector<std::size_t> nr_checked (blocks.size ());
+  for (std::size_t b = 0, checked = 0; b < blocks.size (); ++b)
+    nr_checked[b] = (checked += blocks[b].size ());
+
+  // The parameters of the test: the inlier ratios of the good and bad models, and the decision threshold
+  double epsilon = epsilon_;
+  double delta = delta_;
+  double decision_threshold = computeDecisionThreshold (epsilon, delta);
+
+  // Whether the test rejects a model with nr_inliers inliers among nr_random random points
+  const auto rejects = [&] (std::size_t nr_inliers, std::size_t nr_random)
+  {
+    const double log_ratio = static_cast<double> (nr_inliers) * std::log (delta / epsilon) +
+                             static_cast<double> (nr_random - nr_inliers) * std::log ((1.0 - delta) / (1.0 - epsilon));
+    return (log_ratio > std::log (decision_threshold));
+  };
+
+  // Compute the k parameter (k=std::log(z)/std::log(1-w^n(1-1/A))), as good models are rejected with a
+  // probability of 1/A at most
+  const auto compute_iterations = [&] ()
+  {
+    const double w = static_cast<double> (n_best_inliers_count) * one_over_indices;
+    double p_no_outliers = 1.0 - std::pow (w, static_cast<double> (model_.size ())) * (1.0 - 1.0 / decision_threshold);
+    p_no_outliers = (std::max) (std::numeric_limits<double>::epsilon (), p_no_outliers);       // Avoid division by -Inf
+    p_no_outliers = (std::min) (1.0 - std::numeric_limits<double>::epsilon (), p_no_outliers);   // Avoid division by 0.
+    return (log_probability / std::log (p_no_outliers));
+  };
+
+  // The inliers among the random points checked against the rejected models, to estimate delta
+  std::size_t rejected_inliers = 0;
+  std::size_t rejected_points = 0;
+
+  // The hypotheses are drawn in batches of one per thread, and checked in parallel with the test of the start of
+  // the batch. The test is then replayed in order, with the parameters updated after each hypothesis, so that the
+  // result does not depend on the number of threads
+  const int threads = this->getEffectiveNumberOfThreads ();
+  if (threads > 1)
+    PCL_DEBUG ("[pcl::SPRTSampleConsensus::computeModel] Computing in parallel with up to %i threads.\n", threads);
+  else
+    PCL_DEBUG ("[pcl::SPRTSampleConsensus::computeModel] Computing not parallel.\n");
+  std::vector<Hypothesis> hypotheses (threads);
+  // The number of inliers of each hypothesis among the random points of the blocks checked so far
+  std::vector<std::vector<std::size_t> > block_inliers (threads);
+
+  // Count the inliers of a model in the next block of random points
+  const auto check_next_block = [&] (const Hypothesis &hypothesis, std::vector<std::size_t> &inliers)
+  {
+    const std::size_t b = inliers.size ();
+    inliers.push_back ((b == 0 ? 0 : inliers.back ()) +
+                       sac_model_->countWithinDistance (hypothesis.model_coefficients, threshold_)); // This functions has to be thread-safe
+  };
+
+  // Iterate
+  bool done = false;
+  while (!done)
+  {
+    this->drawHypotheses (hypotheses, threads);
+    for (auto &inliers : block_inliers)
+      inliers.clear ();
+
+    // Check the models block by block, until the test rejects them
+    bool pending = true;
+    for (std::size_t b = 0; pending && b < blocks.size (); ++b)
+    {
+      indices->swap (blocks[b]);
+      this->scoreHypotheses (hypotheses, threads, [&] (Hypothesis &hypothesis, int)
+      {
+        if (hypothesis.verified)
+          check_next_block (hypothesis, block_inliers[&hypothesis - hypotheses.data ()]);
+      });
+      indices->swap (blocks[b]);
+
+      pending = false;
+      for (std::size_t i = 0; i < hypotheses.size (); ++i)
+      {
+        Hypothesis &hypothesis = hypotheses[i];
+        if (!hypothesis.valid || !hypothesis.verified)
+          continue;
+        if (rejects (block_inliers[i][b], nr_checked[b]))
+          hypothesis.verified = false;
+        else
+          pending = true;
+      }
+    }
+
+    // Search for inliers in the point cloud for the remaining models. Most work is done here
+    if (pending)
+    {
+      this->scoreHypotheses (hypotheses, threads, [this] (Hypothesis &hypothesis, int)
+      {
+        if (!hypothesis.verified)
+          return;
+        hypothesis.nr_inliers = sac_model_->countWithinDistance (hypothesis.model_coefficients, threshold_); // This functions has to be thread-safe
+        hypothesis.scored = true;
+      });
+    }
+
+    // Go through the hypotheses in order, so that the result does not depend on the number of threads
+    for (std::size_t i = 0; i < hypotheses.size (); ++i)
+    {
+      Hypothesis &hypothesis = hypotheses[i];
+      if (hypothesis.selection.empty ())
+      {
+        PCL_ERROR ("[pcl::SPRTSampleConsensus::computeModel] No samples could be selected!\n");
+        done = true;
+        break;
+      }
+
+      if (!hypothesis.valid)
+      {
+        if (++skipped_count < max_skip)
+          continue;
+        done = true;
+        break;
+      }
+
+      // Replay the test with the current parameters, checking the blocks after a rejection of the parallel
+      // test if needed
+      auto &inliers = block_inliers[i];
+      std::size_t b = 0;
+      for (; b < blocks.size (); ++b)
+      {
+        if (b == inliers.size ())
+        {
+          indices->swap (blocks[b]);
+          check_next_block (hypothesis, inliers);
+          indices->swap (blocks[b]);
+        }
+        if (rejects (inliers[b], nr_checked[b]))
+          break;
+      }
+
+      ++iterations_;
+      if (b < blocks.size ())
+      {
+        PCL_DEBUG ("[pcl::SPRTSampleConsensus::computeModel] Trial %d out of %f: rejected after %lu points.\n", iterations_, k, nr_checked[b]);
+
+        // Update delta if the rejected models disagree with it
+        rejected_inliers += inliers[b];
+        rejected_points += nr_checked[b];
+        const double delta_estimate = (std::max) (static_cast<double> (rejected_inliers) / static_cast<double> (rejected_points), 1e-4);
+        if (std::abs (delta_estimate - delta) > 0.05 * delta)
+        {
+          delta = delta_estimate;
+          decision_threshold = computeDecisionThreshold (epsilon, delta);
+          if (n_best_inliers_count > 0)
+            k = compute_iterations ();
+        }
+      }
+      else
+      {
+        if (!hypothesis.scored)
+          hypothesis.nr_inliers = sac_model_->countWithinDistance (hypothesis.model_coefficients, threshold_);
+
+        // Better match ?
+        if (hypothesis.nr_inliers > n_best_inliers_count)
+        {
+          n_best_inliers_count = hypothesis.nr_inliers;
+
+          // Save the current model/inlier/coefficients selection as being the best so far
+          model_              = hypothesis.selection;
+          model_coefficients_ = hypothesis.model_coefficients;
+
+          // The next models have to be as good as this one
+          epsilon = (std::min) (static_cast<double> (n_best_inliers_count) * one_over_indices, 0.999);
+          decision_threshold = computeDecisionThreshold (epsilon, delta);
+          k = compute_iterations ();
+        }
+        PCL_DEBUG ("[pcl::SPRTSampleConsensus::computeModel] Trial %d out of %f: %lu inliers (best is: %lu so far).\n", iterations_, k, hypothesis.nr_inliers, n_best_inliers_count);
+      }
+
+      if (iterations_ > k)
+      {
+        done = true;
+        break;
+      }
+      if (iterations_ > max_iterations_)
+      {
+        PCL_DEBUG ("[pcl::SPRTSampleConsensus::computeModel] SPRT reached the maximum number of trials.\n");
+        done = true;
+        break;
+      }
+    }
+  }
+
+  PCL_DEBUG ("[pcl::SPRTSampleConsensus::computeModel] Model: %lu size, %lu inliers.\n", model_.size (), n_best_inliers_count);
+
+  if (model_.empty ())
+  {
+    PCL_ERROR ("[pcl::SPRTSampleConsensus::computeModel] SPRT found no model.\n");
+    inliers_.clear ();
+    return (false);
+  }
+
+  // Get the set of inliers that correspond to the best model found so far
+  sac_model_->selectWithinDistance (model_coefficients_, threshold_, inliers_);
+  return (true);
+}
+
+#define PCL_INSTANTIATE_SPRTSampleConsensus(T) template class PCL_EXPORTS pcl::SPRTSampleConsensus<T>;
+
+#endif    // PCL_SAMPLE_CONSENSUS_IMPL_SPRT_H_
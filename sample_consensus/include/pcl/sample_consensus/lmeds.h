@@ -59,6 +59,7 @@ namespace pcl
   class LeastMedianSquares : public SampleConsensus<PointT>
   {
     using SampleConsensusModelPtr = typename SampleConsensusModel<PointT>::Ptr;
+    using Hypothesis = typename SampleConsensus<PointT>::Hypothesis;
 
     public:
       using Ptr = shared_ptr<LeastMedianSquares<PointT> >;
@@ -57,6 +57,7 @@ namespace pcl
   class MaximumLikelihoodSampleConsensus : public SampleConsensus<PointT>
   {
     using SampleConsensusModelPtr = typename SampleConsensusModel<PointT>::Ptr;
+    using Hypothesis = typename SampleConsensus<PointT>::Hypothesis;
     using PointCloudConstPtr = typename SampleConsensusModel<PointT>::PointCloudConstPtr; 
 
     public:
@@ -55,6 +55,7 @@ namespace pcl
   class ProgressiveSampleConsensus : public SampleConsensus<PointT>
   {
     using SampleConsensusModelPtr = typename SampleConsensusModel<PointT>::Ptr;
+    using Hypothesis = typename SampleConsensus<PointT>::Hypothesis;
 
     public:
       using Ptr = shared_ptr<ProgressiveSampleConsensus>;
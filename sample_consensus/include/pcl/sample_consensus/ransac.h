@@ -65,6 +65,7 @@ namespace pcl
   class RandomSampleConsensus : public SampleConsensus<PointT>
   {
     using SampleConsensusModelPtr = typename SampleConsensusModel<PointT>::Ptr;
+    using Hypothesis = typename SampleConsensus<PointT>::Hypothesis;
 
     public:
       using Ptr = shared_ptr<RandomSampleConsensus<PointT> >;
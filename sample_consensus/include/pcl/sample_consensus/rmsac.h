@@ -56,6 +56,7 @@ namespace pcl
   class RandomizedMEstimatorSampleConsensus : public SampleConsensus<PointT>
   {
     using SampleConsensusModelPtr = typename SampleConsensusModel<PointT>::Ptr;
+    using Hypothesis = typename SampleConsensus<PointT>::Hypothesis;
 
     public:
       using Ptr = shared_ptr<RandomizedMEstimatorSampleConsensus<PointT> >;
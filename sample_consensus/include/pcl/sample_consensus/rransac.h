@@ -60,6 +60,7 @@ namespace pcl
   class RandomizedRandomSampleConsensus : public SampleConsensus<PointT>
   {
     using SampleConsensusModelPtr = typename SampleConsensusModel<PointT>::Ptr;
+    using Hypothesis = typename SampleConsensus<PointT>::Hypothesis;
 
     public:
       using Ptr = shared_ptr<RandomizedRandomSampleConsensus<PointT> >;
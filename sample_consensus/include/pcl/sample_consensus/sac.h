@@ -46,9 +46,15 @@
 #include <boost/random/mersenne_twister.hpp> // for mt19937
 #include <boost/random/uniform_01.hpp> // for uniform_01
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <cstddef>
 #include <ctime>
 #include <memory>
 #include <set>
+#include <vector>
 
 namespace pcl
 {
@@ -164,8 +170,13 @@ namespace pcl
       getProbability () const { return (probability_); }
 
       /** \brief Set the number of threads to use or turn off parallelization.
+        *
+        * The hypotheses are drawn in batches of one per thread, always in the same order, and
+        * their model coefficients and scores are computed in parallel. For a given state of
+        * the random number generators, the model found is therefore the same for any number
+        * of threads. Only the state they are left in differs, as up to one batch of samples
+        * is drawn ahead.
         * \param[in] nr_threads the number of hardware threads to use (0 sets the value automatically, a negative number turns parallelization off)
-        * \note Not all SAC methods have a parallel implementation. Some will ignore this setting.
         */
       inline void
       setNumberOfThreads (const int nr_threads = -1) { threads_ = nr_threads; }
@@ -316,6 +327,136 @@ namespace pcl
       getModelCoefficients (Eigen::VectorXf &model_coefficients) const { model_coefficients = model_coefficients_; }
 
     protected:
+      /** \brief A model hypothesis: a sample, the model coefficients computed from it,
+        * and its score.
+        */
+      struct Hypothesis
+      {
+        /** \brief The indices of the sample, empty if no sample could be selected. */
+        Indices selection;
+
+        /** \brief The model coefficients computed from the sample. */
+        Eigen::VectorXf model_coefficients;
+
+        /** \brief Whether the model coefficients could be computed from the sample. */
+        bool valid = false;
+
+        /** \brief The random points of the pre-test of the randomized methods. */
+        std::set<index_t> pretest_indices;
+
+        /** \brief Whether the model passed the pre-test of the randomized methods. */
+        bool verified = true;
+
+        /** \brief Whether the model could be scored, e.g. had distances to the points. */
+        bool scored = false;
+
+        /** \brief The score of the model, its meaning depends on the method. */
+        double score = 0.0;
+
+        /** \brief The number of inliers of the model. */
+        std::size_t nr_inliers = 0;
+      };
+
+      /** \brief Get the number of threads to evaluate the hypotheses with: 1 if
+        * parallelization is turned off or not available.
+        */
+      int
+      getEffectiveNumberOfThreads () const
+      {
+        if (threads_ < 0)
+          return (1);
+#ifdef _OPENMP
+        if (threads_ == 0)
+        {
+          const int threads = omp_get_num_procs ();
+          PCL_DEBUG ("[pcl::SampleConsensus::computeModel] Automatic number of threads requested, choosing %i threads.\n", threads);
+          return (threads);
+        }
+        return (threads_);
+#else
+        PCL_WARN ("[pcl::SampleConsensus::computeModel] Parallelization is requested, but OpenMP is not available! Continuing without parallelization.\n");
+        return (1);
+#endif
+      }
+
+      /** \brief Draw a batch of samples with SampleConsensusModel::getSamples, and compute
+        * the model coefficients of the hypotheses in parallel.
+        *
+        * The samples are drawn serially and in order, so that the hypotheses only depend on
+        * the random seed of the model. Once no sample can be selected, the selections of
+        * the remaining hypotheses are left empty.
+        * \param[in,out] hypotheses the batch of hypotheses to draw
+        * \param[in] nr_threads the number of threads to compute the coefficients with
+        */
+      void
+      drawHypotheses (std::vector<Hypothesis> &hypotheses, int nr_threads)
+      {
+        bool selected = true;
+        for (auto &hypothesis : hypotheses)
+        {
+          hypothesis.selection.clear ();
+          if (selected)
+          {
+            int iterations = iterations_;
+            sac_model_->getSamples (iterations, hypothesis.selection);
+            selected = !hypothesis.selection.empty ();
+          }
+        }
+        computeHypotheses (hypotheses, nr_threads);
+      }
+
+      /** \brief Compute the model coefficients of a batch of samples in parallel.
+        * \param[in,out] hypotheses the hypotheses, whose selections are set
+        * \param[in] nr_threads the number of threads to compute the coefficients with
+        */
+      void
+      computeHypotheses (std::vector<Hypothesis> &hypotheses, int nr_threads)
+      {
+        const auto nr_hypotheses = static_cast<std::ptrdiff_t> (hypotheses.size ());
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  if(nr_threads > 1) \
+  schedule(dynamic, 1)
+        for (std::ptrdiff_t i = 0; i < nr_hypotheses; ++i)
+        {
+          Hypothesis &hypothesis = hypotheses[i];
+          hypothesis.verified = true;
+          hypothesis.scored = false;
+          hypothesis.score = 0.0;
+          hypothesis.nr_inliers = 0;
+          // computeModelCoefficients has to be thread-safe
+          hypothesis.valid = !hypothesis.selection.empty () &&
+                             sac_model_->computeModelCoefficients (hypothesis.selection, hypothesis.model_coefficients);
+        }
+      }
+
+      /** \brief Score a batch of hypotheses in parallel.
+        * \param[in,out] hypotheses the hypotheses
+        * \param[in] nr_threads the number of threads to score the hypotheses with
+        * \param[in] score the thread-safe scoring function, called as score (hypothesis, thread)
+        * on the valid hypotheses, where thread is in [0, nr_threads) and can index
+        * per-thread buffers
+        */
+      template <typename ScoreFunction> void
+      scoreHypotheses (std::vector<Hypothesis> &hypotheses, int nr_threads, const ScoreFunction &score) const
+      {
+        const auto nr_hypotheses = static_cast<std::ptrdiff_t> (hypotheses.size ());
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  if(nr_threads > 1) \
+  schedule(dynamic, 1)
+        for (std::ptrdiff_t i = 0; i < nr_hypotheses; ++i)
+        {
+          if (!hypotheses[i].valid)
+            continue;
+#ifdef _OPENMP
+          score (hypotheses[i], omp_get_thread_num ());
+#else
+          score (hypotheses[i], 0);
+#endif
+        }
+      }
+
       /** \brief The underlying data model used (i.e. what is it that we attempt to search for). */
       SampleConsensusModelPtr sac_model_;
 
@@ -53,6 +53,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/types.h> // for index_t, Indices
 #include <pcl/sample_consensus/model_types.h>
+#include <pcl/sample_consensus/sac_model_simd.h>
 
 #include <pcl/search/search.h>
 
@@ -214,6 +214,14 @@ namespace pcl
       bool
       isSampleGood(const Indices &samples) const override;
 
+      /** \brief Convert the model coefficients and the input points to the form used by
+        * the SIMD distance kernels (see countWithinDistance and getDistancesToModel).
+        */
+      void
+      getSacSimdModel (const Eigen::VectorXf &model_coefficients,
+                       pcl::detail::SacSimdModel &model,
+                       pcl::detail::SacSimdPoints &points) const;
+
     private:
       /** \brief Functor for the optimization function */
       struct OptimizationFunctor : pcl::Functor<double>
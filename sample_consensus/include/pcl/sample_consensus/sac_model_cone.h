@@ -289,6 +289,14 @@ namespace pcl
       bool
       isSampleGood (const Indices &samples) const override;
 
+      /** \brief Convert the model coefficients, the input points and their normals to the
+        * form used by the SIMD distance kernels.
+        */
+      void
+      getSacSimdModel (const Eigen::VectorXf &model_coefficients,
+                       pcl::detail::SacSimdModel &model,
+                       pcl::detail::SacSimdPoints &points) const;
+
     private:
       /** \brief The axis along which we need to search for a cone direction. */
       Eigen::Vector3f axis_;
@@ -192,6 +192,14 @@ namespace pcl
                               const double threshold,
                               std::size_t i = 0) const;
 #endif
+
+      /** \brief Convert the model coefficients, the input points and their normals to the
+        * form used by the SIMD distance kernels.
+        */
+      void
+      getSacSimdModel (const Eigen::VectorXf &model_coefficients,
+                       pcl::detail::SacSimdModel &model,
+                       pcl::detail::SacSimdPoints &points) const;
   };
 }
 
@@ -158,6 +158,14 @@ namespace pcl
       using SampleConsensusModel<PointT>::sample_size_;
       using SampleConsensusModel<PointT>::model_size_;
       using SampleConsensusModelSphere<PointT>::isModelValid;
+
+      /** \brief Convert the model coefficients, the input points and their normals to the
+        * form used by the SIMD distance kernels.
+        */
+      void
+      getSacSimdModel (const Eigen::VectorXf &model_coefficients,
+                       pcl::detail::SacSimdModel &model,
+                       pcl::detail::SacSimdPoints &points) const;
   };
 }
 
@@ -292,6 +292,14 @@ namespace pcl
                               std::size_t i = 0) const;
 #endif
 
+      /** \brief Convert the model coefficients and the input points to the form used by
+        * the SIMD distance kernels (see countWithinDistance and getDistancesToModel).
+        */
+      void
+      getSacSimdModel (const Eigen::VectorXf &model_coefficients,
+                       pcl::detail::SacSimdModel &model,
+                       pcl::detail::SacSimdPoints &points) const;
+
 #ifdef __AVX__
       inline __m256 dist8 (const std::size_t i, const __m256 &a_vec, const __m256 &b_vec, const __m256 &c_vec, const __m256 &d_vec, const __m256 &abs_help) const;
 #endif
@@ -225,6 +225,14 @@ namespace pcl
       bool
       isSampleGood (const Indices &samples) const override;
 
+      /** \brief Convert the model coefficients, the input points and their correspondences
+        * to the form used by the SIMD distance kernels.
+        */
+      void
+      getSacSimdModel (const Eigen::VectorXf &model_coefficients,
+                       pcl::detail::SacSimdModel &model,
+                       pcl::detail::SacSimdPoints &points) const;
+
       /** \brief Computes an "optimal" sample distance threshold based on the
         * principal directions of the input cloud.
         * \param[in] cloud the const boost shared pointer to a PointCloud message
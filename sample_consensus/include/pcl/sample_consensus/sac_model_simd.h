@@ -0,0 +1,204 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/pcl_macros.h>
+#include <pcl/types.h> // for index_t, Indices
+
+#include <cstddef>
+
+namespace pcl
+{
+  template <typename PointT> class PointCloud;
+
+  /** \brief The instruction sets of the SIMD distance kernels used by the sample
+    * consensus models, from the slowest to the fastest.
+    * \ingroup sample_consensus
+    */
+  enum class SacSimdLevel
+  {
+    NONE, /**< no SIMD kernel, the models use their scalar implementation */
+    SSE2, /**< 4 points at a time */
+    AVX2  /**< 8 points at a time */
+  };
+
+  /** \brief Get the instruction set used by the SIMD distance kernels of the sample
+    * consensus models (countWithinDistance and getDistancesToModel).
+    *
+    * The kernels are compiled once for each instruction set, and the fastest one
+    * supported by the CPU is selected when the program starts, so that a binary built
+    * for a baseline architecture still uses AVX2 where it is available.
+    * \ingroup sample_consensus
+    */
+  PCL_EXPORTS SacSimdLevel
+  getSacSimdLevel ();
+
+  /** \brief Limit the instruction set used by the SIMD distance kernels of the sample
+    * consensus models, e.g. to compare their results or their speed.
+    * \param[in] level the fastest instruction set to use. Levels that are not supported
+    * by the CPU, or that PCL was built without, are lowered to the best supported one.
+    * \return the instruction set now in use
+    * \ingroup sample_consensus
+    */
+  PCL_EXPORTS SacSimdLevel
+  setSacSimdLevel (SacSimdLevel level);
+
+  namespace detail
+  {
+    /** \brief The points, and optionally their normals, seen by the SIMD distance
+      * kernels. All the arrays are strided: the coordinates of the point with index i
+      * start at byte i * xyz_step from xyz.
+      */
+    struct SacSimdPoints
+    {
+      /** \brief The x coordinate of the first point, followed by y and z. */
+      const float *xyz = nullptr;
+      std::size_t xyz_step = 0;
+      /** \brief Whether 4 floats can be read from the x coordinate of every point. */
+      bool xyz_padded = false;
+
+      /** \brief The normal_x of the first point, followed by normal_y and normal_z. */
+      const float *normals = nullptr;
+      /** \brief The curvature of the first point, or nullptr. */
+      const float *curvatures = nullptr;
+      std::size_t normal_step = 0;
+      /** \brief Whether 4 floats can be read from the normal_x of every point. */
+      bool normals_padded = false;
+
+      /** \brief The corresponding points, for registration models. */
+      const float *target_xyz = nullptr;
+      std::size_t target_step = 0;
+      bool target_padded = false;
+      const index_t *target_indices = nullptr;
+
+      /** \brief The indices of the points to process, and their number. */
+      const index_t *indices = nullptr;
+      std::size_t size = 0;
+    };
+
+    /** \brief The distance functions implemented by the SIMD kernels, and the layout of
+      * their parameters in SacSimdModel::c. They follow the scalar implementations of
+      * the corresponding models, in single precision.
+      */
+    enum class SacSimdKernel
+    {
+      /** c = (a, b, c, d) */
+      PLANE,
+      /** c = (a, b, c, d, normalized a, b, c). Needs normals and curvatures. */
+      NORMAL_PLANE,
+      /** c = (center x, y, z, radius, squared inner radius, squared outer radius). The
+        * points counted are the ones between the inner and outer radii. */
+      SPHERE,
+      /** c = (center x, y, z, radius). Needs normals. */
+      NORMAL_SPHERE,
+      /** c = (center x, y, radius, squared inner radius, squared outer radius). The
+        * points counted are the ones between the inner and outer radii. */
+      CIRCLE2D,
+      /** c = (center x, y, z, radius, normal x, y, z, s / |normal|^2), where the point
+        * projected on the plane of the circle is p + s (p - center) . normal / |normal|^2 normal */
+      CIRCLE3D,
+      /** c = (point x, y, z, normalized direction x, y, z) */
+      LINE,
+      /** c = (point x, y, z, normalized direction x, y, z, squared radius). The points
+        * counted are the ones closer than the radius, minus the other ones closer than
+        * twice the radius. Outside of the radius, the distance is doubled. */
+      STICK,
+      /** c = (point x, y, z, direction x, y, z, radius, point . direction,
+        * 1 / |direction|^2, |direction|^2). Needs normals. */
+      CYLINDER,
+      /** c = (apex x, y, z, axis x, y, z, tangent, sine and cosine of the opening angle,
+        * apex . axis, 1 / |axis|^2, |axis|^2). Needs normals. */
+      CONE,
+      /** c = the 4x4 transformation, row major. Needs the target points. */
+      REGISTRATION
+    };
+
+    /** \brief A model, in the form used by the SIMD kernels. */
+    struct SacSimdModel
+    {
+      SacSimdKernel kernel = SacSimdKernel::PLANE;
+      /** \brief The parameters of the kernel, see SacSimdKernel. */
+      float c[16] = {};
+      /** \brief The weight of the angular distance, for the models using normals. */
+      float normal_distance_weight = 0.0f;
+    };
+
+    /** \brief Return whether SIMD kernels can be used, i.e. getSacSimdLevel () != NONE. */
+    PCL_EXPORTS bool
+    sacSimdAvailable ();
+
+    /** \brief Count the points whose distance to the model is smaller than threshold,
+      * with the fastest available kernel (see SacSimdKernel for the exceptions).
+      */
+    PCL_EXPORTS std::size_t
+    sacSimdCountWithinDistance (const SacSimdModel &model, const SacSimdPoints &points, double threshold);
+
+    /** \brief Compute the distances from the points to the model, with the fastest
+      * available kernel.
+      * \param[out] distances the distances, must hold points.size values
+      */
+    PCL_EXPORTS void
+    sacSimdGetDistancesToModel (const SacSimdModel &model, const SacSimdPoints &points, double *distances);
+
+    /** \brief Fill the xyz part of a SacSimdPoints from a cloud and indices. */
+    template <typename PointT> inline void
+    setSacSimdPoints (const pcl::PointCloud<PointT> &cloud, const Indices &indices, SacSimdPoints &points)
+    {
+      points.indices = indices.data ();
+      points.size = indices.size ();
+      if (cloud.empty ())
+        return;
+      const PointT &p = cloud[0];
+      points.xyz = &p.x;
+      points.xyz_step = sizeof (PointT);
+      points.xyz_padded = (reinterpret_cast<const char*> (&p.x) - reinterpret_cast<const char*> (&p)) + 4 * sizeof (float) <= sizeof (PointT);
+    }
+
+    /** \brief Fill the normal part of a SacSimdPoints from a cloud of normals. */
+    template <typename PointNT> inline void
+    setSacSimdNormals (const pcl::PointCloud<PointNT> &normals, SacSimdPoints &points)
+    {
+      if (normals.empty ())
+        return;
+      const PointNT &n = normals[0];
+      points.normals = &n.normal_x;
+      points.normal_step = sizeof (PointNT);
+      points.normals_padded = (reinterpret_cast<const char*> (&n.normal_x) - reinterpret_cast<const char*> (&n)) + 4 * sizeof (float) <= sizeof (PointNT);
+    }
+  }
+}
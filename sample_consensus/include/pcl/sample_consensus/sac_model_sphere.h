@@ -262,6 +262,14 @@ namespace pcl
                               std::size_t i = 0) const;
 #endif
 
+      /** \brief Convert the model coefficients and the input points to the form used by
+        * the SIMD distance kernels (see countWithinDistance and getDistancesToModel).
+        */
+      void
+      getSacSimdModel (const Eigen::VectorXf &model_coefficients,
+                       pcl::detail::SacSimdModel &model,
+                       pcl::detail::SacSimdPoints &points) const;
+
     private:
       struct OptimizationFunctor : pcl::Functor<float>
       {
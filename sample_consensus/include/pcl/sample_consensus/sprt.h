@@ -0,0 +1,177 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#pragma once
+
+#include <pcl/sample_consensus/sac.h>
+#include <pcl/sample_consensus/sac_model.h>
+
+namespace pcl
+{
+  /** \brief @b SPRTSampleConsensus represents an implementation of RANSAC with the Wald's Sequential Probability Ratio
+    * Test (SPRT), as described in "Optimal Randomized RANSAC", O. Chum and J. Matas, IEEE Transactions on Pattern
+    * Analysis and Machine Intelligence, vol. 30, no. 8, pp. 1472-1482, 2008.
+    *
+    * The algorithm works similar to RANSAC, but each model is first checked against random points, and rejected as
+    * soon as the ratio of the likelihood that it is a bad model (with a fraction \f$\delta\f$ of points consistent
+    * with it) to the likelihood that it is a good one (with a fraction \f$\epsilon\f$ of inliers) exceeds a
+    * threshold A. Most models are then rejected after a few dozens of points, and only the remaining ones are
+    * checked against the whole cloud. \f$\epsilon\f$ is the inlier ratio of the best model so far, \f$\delta\f$ is
+    * estimated from the rejected models, and A is chosen to minimize the expected run time, from the time to compute
+    * a model. A good model is rejected with a probability of at most 1/A, which the number of iterations accounts for.
+    *
+    * \note The random points are checked in blocks of growing size. The models are checked in parallel (see
+    * setNumberOfThreads), and the test is then replayed in order, so that the result does not depend on the number of
+    * threads. Registration models are always checked against all the points.
+    * \ingroup sample_consensus
+    */
+  template <typename PointT>
+  class SPRTSampleConsensus : public SampleConsensus<PointT>
+  {
+    using SampleConsensusModelPtr = typename SampleConsensusModel<PointT>::Ptr;
+    using Hypothesis = typename SampleConsensus<PointT>::Hypothesis;
+
+    public:
+      using Ptr = shared_ptr<SPRTSampleConsensus<PointT> >;
+      using ConstPtr = shared_ptr<const SPRTSampleConsensus<PointT> >;
+
+      using SampleConsensus<PointT>::max_iterations_;
+      using SampleConsensus<PointT>::threshold_;
+      using SampleConsensus<PointT>::iterations_;
+      using SampleConsensus<PointT>::sac_model_;
+      using SampleConsensus<PointT>::model_;
+      using SampleConsensus<PointT>::model_coefficients_;
+      using SampleConsensus<PointT>::inliers_;
+      using SampleConsensus<PointT>::probability_;
+
+      /** \brief SPRT RANSAC main constructor
+        * \param[in] model a Sample Consensus model
+        */
+      SPRTSampleConsensus (const SampleConsensusModelPtr &model)
+        : SampleConsensus<PointT> (model)
+      {
+        // Maximum number of trials before we give up.
+        max_iterations_ = 10000;
+      }
+
+      /** \brief SPRT RANSAC main constructor
+        * \param[in] model a Sample Consensus model
+        * \param[in] threshold distance to model threshold
+        */
+      SPRTSampleConsensus (const SampleConsensusModelPtr &model, double threshold)
+        : SampleConsensus<PointT> (model, threshold)
+      {
+        // Maximum number of trials before we give up.
+        max_iterations_ = 10000;
+      }
+
+      /** \brief Compute the actual model and find the inliers
+        * \param[in] debug_verbosity_level enable/disable on-screen debug information and set the verbosity level
+        */
+      bool
+      computeModel (int debug_verbosity_level = 0) override;
+
+      /** \brief Set the inlier ratio of a good model (\f$\epsilon\f$) to use until a model is found. Default: 0.1
+        * \param[in] epsilon the initial inlier ratio, in (0, 1)
+        */
+      inline void
+      setInitialInlierRatio (double epsilon) { epsilon_ = epsilon; }
+
+      /** \brief Get the inlier ratio of a good model to use until a model is found. */
+      inline double
+      getInitialInlierRatio () const { return (epsilon_); }
+
+      /** \brief Set the fraction of points consistent with a bad model (\f$\delta\f$) to use until it is estimated
+        * from the rejected models. Default: 0.01
+        * \param[in] delta the initial fraction of points consistent with a bad model, in (0, 1)
+        */
+      inline void
+      setInitialBadModelInlierRatio (double delta) { delta_ = delta; }
+
+      /** \brief Get the fraction of points consistent with a bad model to use until it is estimated. */
+      inline double
+      getInitialBadModelInlierRatio () const { return (delta_); }
+
+      /** \brief Set the time to compute the coefficients of a model, in units of the time to check one point against
+        * it. The higher, the later the models are rejected. Default: 200
+        * \param[in] time_model the relative time to compute a model
+        */
+      inline void
+      setModelComputationTime (double time_model) { time_model_ = time_model; }
+
+      /** \brief Get the time to compute the coefficients of a model, in units of the time to check one point. */
+      inline double
+      getModelComputationTime () const { return (time_model_); }
+
+      /** \brief Set the maximum number of random points to test the models against, before checking them against all
+        * the points. At most a quarter of the points are tested. Default: 8192
+        * \param[in] max_random_points the maximum number of random points
+        */
+      inline void
+      setMaxRandomPoints (unsigned int max_random_points) { max_random_points_ = max_random_points; }
+
+      /** \brief Get the maximum number of random points to test the models against. */
+      inline unsigned int
+      getMaxRandomPoints () const { return (max_random_points_); }
+
+    private:
+      /** \brief Compute the decision threshold A of the SPRT, which minimizes the expected run time.
+        * \param[in] epsilon the inlier ratio of a good model
+        * \param[in] delta the fraction of points consistent with a bad model
+        * \return the threshold, infinite if delta is not smaller than epsilon
+        */
+      double
+      computeDecisionThreshold (double epsilon, double delta) const;
+
+      /** \brief The inlier ratio of a good model, until a model is found. */
+      double epsilon_ = 0.1;
+
+      /** \brief The fraction of points consistent with a bad model, until it is estimated. */
+      double delta_ = 0.01;
+
+      /** \brief The time to compute a model, in units of the time to check one point. */
+      double time_model_ = 200.0;
+
+      /** \brief The maximum number of random points to test the models against. */
+      unsigned int max_random_points_ = 8192;
+  };
+}
+
+#ifdef PCL_NO_PRECOMPILE
+#include <pcl/sample_consensus/impl/sprt.hpp>
+#endif
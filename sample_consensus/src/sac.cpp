@@ -42,6 +42,7 @@
 #include <pcl/sample_consensus/impl/prosac.hpp>
 #include <pcl/sample_consensus/impl/mlesac.hpp>
 #include <pcl/sample_consensus/impl/lmeds.hpp>
+#include <pcl/sample_consensus/impl/sprt.hpp>
 
 #ifndef PCL_NO_PRECOMPILE
 #include <pcl/impl/instantiate.hpp>
@@ -55,6 +56,7 @@
   PCL_INSTANTIATE(ProgressiveSampleConsensus, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
   PCL_INSTANTIATE(MaximumLikelihoodSampleConsensus, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
   PCL_INSTANTIATE(LeastMedianSquares, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointXYZRGBNormal))
+  PCL_INSTANTIATE(SPRTSampleConsensus, (pcl::PointXYZ)(pcl::PointXYZI)(pcl::PointXYZRGBA)(pcl::PointXYZRGB)(pcl::PointNormal)(pcl::PointXYZRGBNormal))
 #else
   PCL_INSTANTIATE(RandomSampleConsensus, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(MEstimatorSampleConsensus, PCL_XYZ_POINT_TYPES)
@@ -63,6 +65,7 @@
   PCL_INSTANTIATE(ProgressiveSampleConsensus, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(MaximumLikelihoodSampleConsensus, PCL_XYZ_POINT_TYPES)
   PCL_INSTANTIATE(LeastMedianSquares, PCL_XYZ_POINT_TYPES)
+  PCL_INSTANTIATE(SPRTSampleConsensus, PCL_XYZ_POINT_TYPES)
 #endif
 #endif    // PCL_NO_PRECOMPILE
 
@@ -0,0 +1,175 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <pcl/sample_consensus/sac_model_simd.h>
+#include "sac_model_simd_kernels.h"
+
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+#if defined (_MSC_VER) && (defined (_M_X64) || defined (_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace
+{
+  /** \brief Return whether the CPU supports AVX2, and the OS saves the AVX registers. */
+  bool
+  cpuSupportsAVX2 ()
+  {
+#if defined (_MSC_VER) && (defined (_M_X64) || defined (_M_IX86))
+    int info[4];
+    __cpuid (info, 0);
+    if (info[0] < 7)
+      return (false);
+    __cpuid (info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv (0) & 0x6) != 0x6)
+      return (false);
+    __cpuidex (info, 7, 0);
+    return ((info[1] & (1 << 5)) != 0);
+#elif (defined (__GNUC__) || defined (__clang__)) && (defined (__x86_64__) || defined (__i386__))
+    __builtin_cpu_init ();
+    return (__builtin_cpu_supports ("avx2"));
+#else
+    return (false);
+#endif
+  }
+
+  /** \brief Return whether the CPU supports SSE2. */
+  bool
+  cpuSupportsSSE2 ()
+  {
+#if defined (_M_X64) || defined (__x86_64__)
+    return (true);
+#elif defined (_MSC_VER) && defined (_M_IX86)
+    int info[4];
+    __cpuid (info, 1);
+    return ((info[3] & (1 << 26)) != 0);
+#elif (defined (__GNUC__) || defined (__clang__)) && defined (__i386__)
+    __builtin_cpu_init ();
+    return (__builtin_cpu_supports ("sse2"));
+#else
+    return (false);
+#endif
+  }
+
+  /** \brief The fastest level supported by both PCL and the CPU. */
+  pcl::SacSimdLevel
+  detectSacSimdLevel ()
+  {
+    if (pcl::detail::getSacSimdFunctionsAVX2 () && cpuSupportsAVX2 ())
+      return (pcl::SacSimdLevel::AVX2);
+    if (pcl::detail::getSacSimdFunctionsSSE2 () && cpuSupportsSSE2 ())
+      return (pcl::SacSimdLevel::SSE2);
+    return (pcl::SacSimdLevel::NONE);
+  }
+
+  const pcl::SacSimdLevel detected_level = detectSacSimdLevel ();
+  std::atomic<pcl::SacSimdLevel> current_level (detected_level);
+
+  const pcl::detail::SacSimdFunctions*
+  getFunctions ()
+  {
+    switch (current_level.load (std::memory_order_relaxed))
+    {
+      case pcl::SacSimdLevel::AVX2: return (pcl::detail::getSacSimdFunctionsAVX2 ());
+      case pcl::SacSimdLevel::SSE2: return (pcl::detail::getSacSimdFunctionsSSE2 ());
+      case pcl::SacSimdLevel::NONE: break;
+    }
+    return (nullptr);
+  }
+
+  /** \brief The smallest float that is not smaller than value, so that for any float
+    * x, x < value if and only if x < roundUp (value). */
+  float
+  roundUp (double value)
+  {
+    if (!(value < static_cast<double> (std::numeric_limits<float>::max ())))
+      return (value != value ? static_cast<float> (value) : std::numeric_limits<float>::infinity ());
+    float res = static_cast<float> (value);
+    if (static_cast<double> (res) < value)
+      res = std::nextafter (res, std::numeric_limits<float>::infinity ());
+    return (res);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+pcl::SacSimdLevel
+pcl::getSacSimdLevel ()
+{
+  return (current_level.load (std::memory_order_relaxed));
+}
+
+//////////////////////////////////////////////////////////////////////////
+pcl::SacSimdLevel
+pcl::setSacSimdLevel (SacSimdLevel level)
+{
+  if (static_cast<int> (level) > static_cast<int> (detected_level))
+    level = detected_level;
+  current_level.store (level, std::memory_order_relaxed);
+  return (level);
+}
+
+//////////////////////////////////////////////////////////////////////////
+bool
+pcl::detail::sacSimdAvailable ()
+{
+  return (getSacSimdLevel () != SacSimdLevel::NONE);
+}
+
+//////////////////////////////////////////////////////////////////////////
+std::size_t
+pcl::detail::sacSimdCountWithinDistance (const SacSimdModel &model, const SacSimdPoints &points, double threshold)
+{
+  const SacSimdFunctions *functions = getFunctions ();
+  if (!functions || points.size == 0)
+    return (0);
+  return (functions->count (model, points, roundUp (threshold), roundUp (threshold * threshold)));
+}
+
+//////////////////////////////////////////////////////////////////////////
+void
+pcl::detail::sacSimdGetDistancesToModel (const SacSimdModel &model, const SacSimdPoints &points, double *distances)
+{
+  const SacSimdFunctions *functions = getFunctions ();
+  if (!functions || points.size == 0)
+    return;
+  functions->distances (model, points, distances);
+}
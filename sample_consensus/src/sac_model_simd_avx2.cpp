@@ -0,0 +1,144 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Compiled with the flags enabling AVX2, see sac_model_simd_kernels.h. FMA is left
+// disabled, so that the results are the same as with SSE2.
+
+#ifdef __AVX2__
+#define PCL_SAC_SIMD_AVX2
+#endif
+
+#ifdef PCL_SAC_SIMD_AVX2
+#include <cstddef>
+#include <immintrin.h>
+
+namespace
+{
+  /** \brief The vector operations of the kernels, on 8 points. */
+  struct Ops
+  {
+    using Vector = __m256;
+    using Int = __m256i;
+    static constexpr std::size_t size = 8;
+
+    static Vector set1 (float v) { return (_mm256_set1_ps (v)); }
+    static Vector zero () { return (_mm256_setzero_ps ()); }
+    static Vector add (Vector a, Vector b) { return (_mm256_add_ps (a, b)); }
+    static Vector sub (Vector a, Vector b) { return (_mm256_sub_ps (a, b)); }
+    static Vector mul (Vector a, Vector b) { return (_mm256_mul_ps (a, b)); }
+    static Vector div (Vector a, Vector b) { return (_mm256_div_ps (a, b)); }
+    static Vector sqrt (Vector a) { return (_mm256_sqrt_ps (a)); }
+    static Vector abs (Vector a) { return (_mm256_andnot_ps (_mm256_set1_ps (-0.0f), a)); }
+    static Vector min (Vector a, Vector b) { return (_mm256_min_ps (a, b)); }
+    static Vector lt (Vector a, Vector b) { return (_mm256_cmp_ps (a, b, _CMP_LT_OQ)); }
+    static Vector le (Vector a, Vector b) { return (_mm256_cmp_ps (a, b, _CMP_LE_OQ)); }
+    static Vector andMask (Vector a, Vector b) { return (_mm256_and_ps (a, b)); }
+    /** \brief b and not a */
+    static Vector andNotMask (Vector a, Vector b) { return (_mm256_andnot_ps (a, b)); }
+    /** \brief a where mask is set, b elsewhere */
+    static Vector select (Vector mask, Vector a, Vector b) { return (_mm256_blendv_ps (b, a, mask)); }
+
+    static Int zeroInt () { return (_mm256_setzero_si256 ()); }
+    /** \brief Add 1 to the lanes whose mask is set (all bits set is -1). */
+    static Int addMask (Int acc, Vector mask) { return (_mm256_sub_epi32 (acc, _mm256_castps_si256 (mask))); }
+    static Int subMask (Int acc, Vector mask) { return (_mm256_add_epi32 (acc, _mm256_castps_si256 (mask))); }
+    static long long
+    sum (Int acc)
+    {
+      alignas (32) int lanes[8];
+      _mm256_store_si256 (reinterpret_cast<__m256i*> (lanes), acc);
+      long long res = 0;
+      for (int k = 0; k < 8; ++k)
+        res += lanes[k];
+      return (res);
+    }
+    /** \brief The mask of the first n lanes. */
+    static Vector
+    firstLanes (std::size_t n)
+    {
+      return (_mm256_castsi256_ps (_mm256_cmpgt_epi32 (_mm256_set1_epi32 (static_cast<int> (n)), _mm256_setr_epi32 (0, 1, 2, 3, 4, 5, 6, 7))));
+    }
+
+    static void
+    load3 (const float *const *p, bool padded, Vector &x, Vector &y, Vector &z)
+    {
+      if (padded)
+      {
+        // Transpose the first and the last 4 points, then join the halves
+        __m128 r0 = _mm_loadu_ps (p[0]), r1 = _mm_loadu_ps (p[1]), r2 = _mm_loadu_ps (p[2]), r3 = _mm_loadu_ps (p[3]);
+        __m128 r4 = _mm_loadu_ps (p[4]), r5 = _mm_loadu_ps (p[5]), r6 = _mm_loadu_ps (p[6]), r7 = _mm_loadu_ps (p[7]);
+        _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+        _MM_TRANSPOSE4_PS (r4, r5, r6, r7);
+        x = _mm256_insertf128_ps (_mm256_castps128_ps256 (r0), r4, 1);
+        y = _mm256_insertf128_ps (_mm256_castps128_ps256 (r1), r5, 1);
+        z = _mm256_insertf128_ps (_mm256_castps128_ps256 (r2), r6, 1);
+        return;
+      }
+      x = _mm256_setr_ps (p[0][0], p[1][0], p[2][0], p[3][0], p[4][0], p[5][0], p[6][0], p[7][0]);
+      y = _mm256_setr_ps (p[0][1], p[1][1], p[2][1], p[3][1], p[4][1], p[5][1], p[6][1], p[7][1]);
+      z = _mm256_setr_ps (p[0][2], p[1][2], p[2][2], p[3][2], p[4][2], p[5][2], p[6][2], p[7][2]);
+    }
+
+    static Vector
+    load1 (const float *const *p)
+    {
+      return (_mm256_setr_ps (*p[0], *p[1], *p[2], *p[3], *p[4], *p[5], *p[6], *p[7]));
+    }
+
+    static void
+    store (double *out, Vector v)
+    {
+      _mm256_storeu_pd (out, _mm256_cvtps_pd (_mm256_castps256_ps128 (v)));
+      _mm256_storeu_pd (out + 4, _mm256_cvtps_pd (_mm256_extractf128_ps (v, 1)));
+    }
+  };
+}
+
+#define PCL_SAC_SIMD_OPS
+#endif // PCL_SAC_SIMD_AVX2
+
+#include "sac_model_simd_kernels.h"
+
+const pcl::detail::SacSimdFunctions*
+pcl::detail::getSacSimdFunctionsAVX2 ()
+{
+#ifdef PCL_SAC_SIMD_AVX2
+  return (&functions);
+#else
+  return (nullptr);
+#endif
+}
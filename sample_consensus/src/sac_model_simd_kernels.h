@@ -0,0 +1,593 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// The distance kernels of the sample consensus models, written once over a small set
+// of vector operations. This header is included by one translation unit per
+// instruction set (sac_model_simd_sse2.cpp, sac_model_simd_avx2.cpp), each compiled
+// with the flags of its instruction set and defining the vector operations as `Ops`
+// before including it. As these translation units may contain instructions the CPU
+// does not support, everything they define has internal linkage and they do not call
+// inline functions of the standard library or of other headers: the linker could
+// otherwise keep their copy of such a function for the whole program.
+
+#pragma once
+
+#include <pcl/sample_consensus/sac_model_simd.h>
+
+#include <cstddef>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief The kernels compiled for one instruction set. */
+    struct SacSimdFunctions
+    {
+      /** \brief Count the inliers; the thresholds are the smallest floats not below the
+        * threshold and its square, so that comparing floats with them gives the same
+        * result as comparing with the double values. */
+      std::size_t (*count) (const SacSimdModel &model, const SacSimdPoints &points,
+                            float threshold, float sqr_threshold);
+      /** \brief Compute the distances of all the points. */
+      void (*distances) (const SacSimdModel &model, const SacSimdPoints &points,
+                         double *distances);
+    };
+
+    /** \brief Return the kernels of an instruction set, or nullptr if PCL was built
+      * without them. */
+    const SacSimdFunctions*
+    getSacSimdFunctionsSSE2 ();
+    const SacSimdFunctions*
+    getSacSimdFunctionsAVX2 ();
+
+#ifdef PCL_SAC_SIMD_OPS
+    namespace
+    {
+      using Vector = Ops::Vector;
+      using Int = Ops::Int;
+      constexpr std::size_t Width = Ops::size;
+
+      enum SacSimdFields
+      {
+        XYZ = 1,
+        NORMALS = 2,
+        CURVATURES = 4,
+        TARGET = 8
+      };
+
+      /** \brief The fields of Width points. */
+      struct Lanes
+      {
+        Vector x, y, z;
+        Vector nx, ny, nz, curvature;
+        Vector tx, ty, tz;
+      };
+
+      inline void
+      pointers (const float *data, std::size_t step, const index_t *indices,
+                std::size_t i, std::size_t valid, const float **p)
+      {
+        const char *base = reinterpret_cast<const char*> (data);
+        // The missing lanes of the last batch repeat its last point, and are masked
+        for (std::size_t k = 0; k < Width; ++k)
+          p[k] = reinterpret_cast<const float*> (base + static_cast<std::size_t> (indices[i + (k < valid ? k : valid - 1)]) * step);
+      }
+
+      inline void
+      load (const SacSimdPoints &points, unsigned fields, std::size_t i, std::size_t valid, Lanes &lanes)
+      {
+        const float *p[Width];
+        pointers (points.xyz, points.xyz_step, points.indices, i, valid, p);
+        Ops::load3 (p, points.xyz_padded, lanes.x, lanes.y, lanes.z);
+        if (fields & NORMALS)
+        {
+          pointers (points.normals, points.normal_step, points.indices, i, valid, p);
+          Ops::load3 (p, points.normals_padded, lanes.nx, lanes.ny, lanes.nz);
+        }
+        if (fields & CURVATURES)
+        {
+          pointers (points.curvatures, points.normal_step, points.indices, i, valid, p);
+          lanes.curvature = Ops::load1 (p);
+        }
+        if (fields & TARGET)
+        {
+          pointers (points.target_xyz, points.target_step, points.target_indices, i, valid, p);
+          Ops::load3 (p, points.target_padded, lanes.tx, lanes.ty, lanes.tz);
+        }
+      }
+
+      inline Vector
+      dot (Vector ax, Vector ay, Vector az, Vector bx, Vector by, Vector bz)
+      {
+        return (Ops::add (Ops::add (Ops::mul (ax, bx), Ops::mul (ay, by)), Ops::mul (az, bz)));
+      }
+
+      /** \brief 1 / sqrt (sqr_norm), or 0 for a null vector (like Eigen's normalized). */
+      inline Vector
+      invNorm (Vector sqr_norm)
+      {
+        return (Ops::select (Ops::lt (Ops::zero (), sqr_norm),
+                             Ops::div (Ops::set1 (1.0f), Ops::sqrt (sqr_norm)), Ops::zero ()));
+      }
+
+      /** \brief min (acos (c), pi - acos (c)) = acos (|c|), with the single precision
+        * arcsine of Cephes. NaN gives NaN. */
+      inline Vector
+      acuteAngle (Vector c)
+      {
+        // Ops::min returns its second argument if one of them is NaN
+        const Vector x = Ops::min (Ops::set1 (1.0f), Ops::abs (c));
+        const Vector large = Ops::lt (Ops::set1 (0.5f), x);
+        // acos (x) = 2 asin (sqrt ((1 - x) / 2)) for x > 0.5, pi / 2 - asin (x) otherwise
+        const Vector a = Ops::select (large, Ops::sqrt (Ops::mul (Ops::set1 (0.5f), Ops::sub (Ops::set1 (1.0f), x))), x);
+        const Vector z = Ops::mul (a, a);
+        Vector p = Ops::set1 (4.2163199048E-2f);
+        p = Ops::add (Ops::mul (p, z), Ops::set1 (2.4181311049E-2f));
+        p = Ops::add (Ops::mul (p, z), Ops::set1 (4.5470025998E-2f));
+        p = Ops::add (Ops::mul (p, z), Ops::set1 (7.4953002686E-2f));
+        p = Ops::add (Ops::mul (p, z), Ops::set1 (1.6666752422E-1f));
+        const Vector asin_a = Ops::add (Ops::mul (Ops::mul (p, z), a), a);
+        return (Ops::select (large, Ops::add (asin_a, asin_a), Ops::sub (Ops::set1 (1.57079632679489661923f), asin_a)));
+      }
+
+      /** \brief The angle between the normals and a vector, weighted with the distance. */
+      inline Vector
+      weightedDistance (const Lanes &l, Vector vx, Vector vy, Vector vz, Vector weight, Vector weighted_euclid)
+      {
+        const Vector c = Ops::mul (Ops::mul (dot (l.nx, l.ny, l.nz, vx, vy, vz),
+                                             invNorm (dot (l.nx, l.ny, l.nz, l.nx, l.ny, l.nz))),
+                                   invNorm (dot (vx, vy, vz, vx, vy, vz)));
+        return (Ops::abs (Ops::add (Ops::mul (weight, acuteAngle (c)), weighted_euclid)));
+      }
+
+      /** \brief Kernels whose count is the number of points with distance < threshold. */
+      template <typename Kernel> struct ThresholdCount
+      {
+        Int
+        count (const Lanes &l, Vector threshold, Vector, Vector valid, Int acc) const
+        {
+          const Vector d = static_cast<const Kernel*> (this)->distance (l);
+          return (Ops::addMask (acc, Ops::andMask (valid, Ops::lt (d, threshold))));
+        }
+      };
+
+      /** \brief Kernels whose count is the number of points with squared distance < squared threshold. */
+      template <typename Kernel> struct SqrThresholdCount
+      {
+        Int
+        count (const Lanes &l, Vector, Vector sqr_threshold, Vector valid, Int acc) const
+        {
+          const Vector d = static_cast<const Kernel*> (this)->sqrDistance (l);
+          return (Ops::addMask (acc, Ops::andMask (valid, Ops::lt (d, sqr_threshold))));
+        }
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          return (Ops::sqrt (static_cast<const Kernel*> (this)->sqrDistance (l)));
+        }
+      };
+
+      struct PlaneKernel : ThresholdCount<PlaneKernel>
+      {
+        static constexpr unsigned fields = XYZ;
+        Vector a, b, c, d;
+
+        PlaneKernel (const SacSimdModel &m)
+          : a (Ops::set1 (m.c[0])), b (Ops::set1 (m.c[1])), c (Ops::set1 (m.c[2])), d (Ops::set1 (m.c[3])) {}
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          return (Ops::abs (Ops::add (Ops::add (Ops::mul (a, l.x), Ops::mul (b, l.y)),
+                                      Ops::add (Ops::mul (c, l.z), d))));
+        }
+      };
+
+      struct NormalPlaneKernel : ThresholdCount<NormalPlaneKernel>
+      {
+        static constexpr unsigned fields = XYZ | NORMALS | CURVATURES;
+        PlaneKernel plane;
+        Vector ux, uy, uz, w;
+
+        NormalPlaneKernel (const SacSimdModel &m)
+          : plane (m), ux (Ops::set1 (m.c[4])), uy (Ops::set1 (m.c[5])), uz (Ops::set1 (m.c[6])),
+            w (Ops::set1 (m.normal_distance_weight)) {}
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          const Vector d_euclid = plane.distance (l);
+          const Vector c = Ops::mul (dot (l.nx, l.ny, l.nz, ux, uy, uz),
+                                     invNorm (dot (l.nx, l.ny, l.nz, l.nx, l.ny, l.nz)));
+          // Weight with the point curvature. On flat surfaces, curvature -> 0, which means the normal will have a higher influence
+          const Vector weight = Ops::mul (w, Ops::sub (Ops::set1 (1.0f), l.curvature));
+          return (Ops::abs (Ops::add (Ops::mul (weight, acuteAngle (c)),
+                                      Ops::mul (Ops::sub (Ops::set1 (1.0f), weight), d_euclid))));
+        }
+      };
+
+      struct SphereKernel
+      {
+        static constexpr unsigned fields = XYZ;
+        Vector cx, cy, cz, r, sqr_inner, sqr_outer;
+
+        SphereKernel (const SacSimdModel &m)
+          : cx (Ops::set1 (m.c[0])), cy (Ops::set1 (m.c[1])), cz (Ops::set1 (m.c[2])), r (Ops::set1 (m.c[3])),
+            sqr_inner (Ops::set1 (m.c[4])), sqr_outer (Ops::set1 (m.c[5])) {}
+
+        Vector
+        sqrDistance (const Lanes &l) const
+        {
+          const Vector dx = Ops::sub (l.x, cx), dy = Ops::sub (l.y, cy), dz = Ops::sub (l.z, cz);
+          return (dot (dx, dy, dz, dx, dy, dz));
+        }
+
+        Int
+        count (const Lanes &l, Vector, Vector, Vector valid, Int acc) const
+        {
+          // To avoid sqrt computation: consider one larger sphere (radius + threshold) and one smaller sphere (radius - threshold).
+          const Vector d = sqrDistance (l);
+          return (Ops::addMask (acc, Ops::andMask (valid, Ops::andMask (Ops::le (sqr_inner, d), Ops::le (d, sqr_outer)))));
+        }
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          return (Ops::abs (Ops::sub (Ops::sqrt (sqrDistance (l)), r)));
+        }
+      };
+
+      struct NormalSphereKernel : ThresholdCount<NormalSphereKernel>
+      {
+        static constexpr unsigned fields = XYZ | NORMALS;
+        Vector cx, cy, cz, r, w, euclid_w;
+
+        NormalSphereKernel (const SacSimdModel &m)
+          : cx (Ops::set1 (m.c[0])), cy (Ops::set1 (m.c[1])), cz (Ops::set1 (m.c[2])), r (Ops::set1 (m.c[3])),
+            w (Ops::set1 (m.normal_distance_weight)), euclid_w (Ops::set1 (1.0f - m.normal_distance_weight)) {}
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          const Vector dx = Ops::sub (l.x, cx), dy = Ops::sub (l.y, cy), dz = Ops::sub (l.z, cz);
+          const Vector weighted_euclid = Ops::mul (euclid_w, Ops::abs (Ops::sub (Ops::sqrt (dot (dx, dy, dz, dx, dy, dz)), r)));
+          return (weightedDistance (l, dx, dy, dz, w, weighted_euclid));
+        }
+      };
+
+      struct Circle2DKernel
+      {
+        static constexpr unsigned fields = XYZ;
+        Vector cx, cy, r, sqr_inner, sqr_outer;
+
+        Circle2DKernel (const SacSimdModel &m)
+          : cx (Ops::set1 (m.c[0])), cy (Ops::set1 (m.c[1])), r (Ops::set1 (m.c[2])),
+            sqr_inner (Ops::set1 (m.c[3])), sqr_outer (Ops::set1 (m.c[4])) {}
+
+        Vector
+        sqrDistance (const Lanes &l) const
+        {
+          const Vector dx = Ops::sub (l.x, cx), dy = Ops::sub (l.y, cy);
+          return (Ops::add (Ops::mul (dx, dx), Ops::mul (dy, dy)));
+        }
+
+        Int
+        count (const Lanes &l, Vector, Vector, Vector valid, Int acc) const
+        {
+          const Vector d = sqrDistance (l);
+          return (Ops::addMask (acc, Ops::andMask (valid, Ops::andMask (Ops::le (sqr_inner, d), Ops::le (d, sqr_outer)))));
+        }
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          return (Ops::abs (Ops::sub (Ops::sqrt (sqrDistance (l)), r)));
+        }
+      };
+
+      struct Circle3DKernel : SqrThresholdCount<Circle3DKernel>
+      {
+        static constexpr unsigned fields = XYZ;
+        Vector cx, cy, cz, r, nx, ny, nz, s;
+
+        Circle3DKernel (const SacSimdModel &m)
+          : cx (Ops::set1 (m.c[0])), cy (Ops::set1 (m.c[1])), cz (Ops::set1 (m.c[2])), r (Ops::set1 (m.c[3])),
+            nx (Ops::set1 (m.c[4])), ny (Ops::set1 (m.c[5])), nz (Ops::set1 (m.c[6])), s (Ops::set1 (m.c[7])) {}
+
+        Vector
+        sqrDistance (const Lanes &l) const
+        {
+          // Project the point on the plane of the circle, then take the closest point of the circle
+          const Vector pcx = Ops::sub (l.x, cx), pcy = Ops::sub (l.y, cy), pcz = Ops::sub (l.z, cz);
+          const Vector lambda = Ops::mul (dot (pcx, pcy, pcz, nx, ny, nz), s);
+          const Vector qx = Ops::add (pcx, Ops::mul (lambda, nx));
+          const Vector qy = Ops::add (pcy, Ops::mul (lambda, ny));
+          const Vector qz = Ops::add (pcz, Ops::mul (lambda, nz));
+          const Vector k = Ops::mul (r, invNorm (dot (qx, qy, qz, qx, qy, qz)));
+          const Vector dx = Ops::sub (pcx, Ops::mul (k, qx));
+          const Vector dy = Ops::sub (pcy, Ops::mul (k, qy));
+          const Vector dz = Ops::sub (pcz, Ops::mul (k, qz));
+          return (dot (dx, dy, dz, dx, dy, dz));
+        }
+      };
+
+      struct LineKernel : SqrThresholdCount<LineKernel>
+      {
+        static constexpr unsigned fields = XYZ;
+        Vector px, py, pz, dx, dy, dz;
+
+        LineKernel (const SacSimdModel &m)
+          : px (Ops::set1 (m.c[0])), py (Ops::set1 (m.c[1])), pz (Ops::set1 (m.c[2])),
+            dx (Ops::set1 (m.c[3])), dy (Ops::set1 (m.c[4])), dz (Ops::set1 (m.c[5])) {}
+
+        Vector
+        sqrDistance (const Lanes &l) const
+        {
+          // D = ||(P2-P1) x (P1-P0)|| / ||P2-P1||, with a normalized direction
+          const Vector vx = Ops::sub (px, l.x), vy = Ops::sub (py, l.y), vz = Ops::sub (pz, l.z);
+          const Vector cx = Ops::sub (Ops::mul (vy, dz), Ops::mul (vz, dy));
+          const Vector cy = Ops::sub (Ops::mul (vz, dx), Ops::mul (vx, dz));
+          const Vector cz = Ops::sub (Ops::mul (vx, dy), Ops::mul (vy, dx));
+          return (dot (cx, cy, cz, cx, cy, cz));
+        }
+      };
+
+      struct StickKernel
+      {
+        static constexpr unsigned fields = XYZ;
+        LineKernel line;
+        Vector sqr_radius, sqr_outer;
+
+        StickKernel (const SacSimdModel &m)
+          : line (m), sqr_radius (Ops::set1 (m.c[6])), sqr_outer (Ops::set1 (4.0f * m.c[6])) {}
+
+        Int
+        count (const Lanes &l, Vector, Vector, Vector valid, Int acc) const
+        {
+          // Count the inliers, minus the points that are close but outside of the stick
+          const Vector d = line.sqrDistance (l);
+          const Vector inlier = Ops::andMask (valid, Ops::lt (d, sqr_radius));
+          const Vector close = Ops::andNotMask (inlier, Ops::andMask (valid, Ops::lt (d, sqr_outer)));
+          return (Ops::subMask (Ops::addMask (acc, inlier), close));
+        }
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          // Penalize outliers by doubling the distance
+          const Vector d = line.sqrDistance (l);
+          const Vector distance = Ops::sqrt (d);
+          return (Ops::select (Ops::lt (d, sqr_radius), distance, Ops::add (distance, distance)));
+        }
+      };
+
+      struct CylinderKernel : ThresholdCount<CylinderKernel>
+      {
+        static constexpr unsigned fields = XYZ | NORMALS;
+        Vector px, py, pz, dx, dy, dz, r, ptdotdir, inv_dirdotdir, dirdotdir, w, euclid_w;
+
+        CylinderKernel (const SacSimdModel &m)
+          : px (Ops::set1 (m.c[0])), py (Ops::set1 (m.c[1])), pz (Ops::set1 (m.c[2])),
+            dx (Ops::set1 (m.c[3])), dy (Ops::set1 (m.c[4])), dz (Ops::set1 (m.c[5])), r (Ops::set1 (m.c[6])),
+            ptdotdir (Ops::set1 (m.c[7])), inv_dirdotdir (Ops::set1 (m.c[8])), dirdotdir (Ops::set1 (m.c[9])),
+            w (Ops::set1 (m.normal_distance_weight)), euclid_w (Ops::set1 (1.0f - m.normal_distance_weight)) {}
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          // Approximate the distance from the point to the cylinder as the difference between
+          // dist(point,cylinder_axis) and cylinder radius
+          const Vector vx = Ops::sub (px, l.x), vy = Ops::sub (py, l.y), vz = Ops::sub (pz, l.z);
+          const Vector cx = Ops::sub (Ops::mul (dy, vz), Ops::mul (dz, vy));
+          const Vector cy = Ops::sub (Ops::mul (dz, vx), Ops::mul (dx, vz));
+          const Vector cz = Ops::sub (Ops::mul (dx, vy), Ops::mul (dy, vx));
+          const Vector axis_distance = Ops::sqrt (Ops::div (dot (cx, cy, cz, cx, cy, cz), dirdotdir));
+          const Vector weighted_euclid = Ops::mul (euclid_w, Ops::abs (Ops::sub (axis_distance, r)));
+
+          // The direction from the projection of the point on the axis to the point
+          const Vector k = Ops::mul (Ops::sub (dot (l.x, l.y, l.z, dx, dy, dz), ptdotdir), inv_dirdotdir);
+          const Vector ux = Ops::sub (l.x, Ops::add (px, Ops::mul (k, dx)));
+          const Vector uy = Ops::sub (l.y, Ops::add (py, Ops::mul (k, dy)));
+          const Vector uz = Ops::sub (l.z, Ops::add (pz, Ops::mul (k, dz)));
+          return (weightedDistance (l, ux, uy, uz, w, weighted_euclid));
+        }
+      };
+
+      struct ConeKernel : ThresholdCount<ConeKernel>
+      {
+        static constexpr unsigned fields = XYZ | NORMALS;
+        Vector ax, ay, az, dx, dy, dz, tan_angle, sin_angle, cos_angle, apexdotdir, inv_dirdotdir, dirdotdir, w, euclid_w;
+
+        ConeKernel (const SacSimdModel &m)
+          : ax (Ops::set1 (m.c[0])), ay (Ops::set1 (m.c[1])), az (Ops::set1 (m.c[2])),
+            dx (Ops::set1 (m.c[3])), dy (Ops::set1 (m.c[4])), dz (Ops::set1 (m.c[5])),
+            tan_angle (Ops::set1 (m.c[6])), sin_angle (Ops::set1 (m.c[7])), cos_angle (Ops::set1 (m.c[8])),
+            apexdotdir (Ops::set1 (m.c[9])), inv_dirdotdir (Ops::set1 (m.c[10])), dirdotdir (Ops::set1 (m.c[11])),
+            w (Ops::set1 (m.normal_distance_weight)), euclid_w (Ops::set1 (1.0f - m.normal_distance_weight)) {}
+
+        Vector
+        distance (const Lanes &l) const
+        {
+          // Calculate the point's projection on the cone axis, and the radius of the cone there
+          const Vector k = Ops::mul (Ops::sub (dot (l.x, l.y, l.z, dx, dy, dz), apexdotdir), inv_dirdotdir);
+          const Vector hx = Ops::mul (Ops::sub (Ops::zero (), k), dx);
+          const Vector hy = Ops::mul (Ops::sub (Ops::zero (), k), dy);
+          const Vector hz = Ops::mul (Ops::sub (Ops::zero (), k), dz);
+          const Vector sqr_height = dot (hx, hy, hz, hx, hy, hz);
+          const Vector actual_cone_radius = Ops::mul (tan_angle, Ops::sqrt (sqr_height));
+
+          const Vector vx = Ops::sub (ax, l.x), vy = Ops::sub (ay, l.y), vz = Ops::sub (az, l.z);
+          const Vector cx = Ops::sub (Ops::mul (dy, vz), Ops::mul (dz, vy));
+          const Vector cy = Ops::sub (Ops::mul (dz, vx), Ops::mul (dx, vz));
+          const Vector cz = Ops::sub (Ops::mul (dx, vy), Ops::mul (dy, vx));
+          const Vector axis_distance = Ops::sqrt (Ops::div (dot (cx, cy, cz, cx, cy, cz), dirdotdir));
+          const Vector weighted_euclid = Ops::mul (euclid_w, Ops::abs (Ops::sub (axis_distance, actual_cone_radius)));
+
+          // The perfect normal of the cone at the point, from the direction of the point from the axis
+          const Vector ux = Ops::add (Ops::sub (l.x, ax), hx);
+          const Vector uy = Ops::add (Ops::sub (l.y, ay), hy);
+          const Vector uz = Ops::add (Ops::sub (l.z, az), hz);
+          const Vector inv_u = Ops::mul (cos_angle, invNorm (dot (ux, uy, uz, ux, uy, uz)));
+          const Vector inv_h = Ops::mul (sin_angle, invNorm (sqr_height));
+          const Vector nx = Ops::add (Ops::mul (inv_h, hx), Ops::mul (inv_u, ux));
+          const Vector ny = Ops::add (Ops::mul (inv_h, hy), Ops::mul (inv_u, uy));
+          const Vector nz = Ops::add (Ops::mul (inv_h, hz), Ops::mul (inv_u, uz));
+          return (weightedDistance (l, nx, ny, nz, w, weighted_euclid));
+        }
+      };
+
+      struct RegistrationKernel : SqrThresholdCount<RegistrationKernel>
+      {
+        static constexpr unsigned fields = XYZ | TARGET;
+        Vector t[16];
+
+        RegistrationKernel (const SacSimdModel &m)
+        {
+          for (int i = 0; i < 16; ++i)
+            t[i] = Ops::set1 (m.c[i]);
+        }
+
+        Vector
+        row (int i, const Lanes &l) const
+        {
+          return (Ops::add (Ops::add (Ops::add (Ops::mul (t[4 * i], l.x), Ops::mul (t[4 * i + 1], l.y)),
+                                      Ops::mul (t[4 * i + 2], l.z)), t[4 * i + 3]));
+        }
+
+        Vector
+        sqrDistance (const Lanes &l) const
+        {
+          // The homogeneous coordinate of the target is 1
+          const Vector dx = Ops::sub (row (0, l), l.tx);
+          const Vector dy = Ops::sub (row (1, l), l.ty);
+          const Vector dz = Ops::sub (row (2, l), l.tz);
+          const Vector dw = Ops::sub (row (3, l), Ops::set1 (1.0f));
+          return (Ops::add (dot (dx, dy, dz, dx, dy, dz), Ops::mul (dw, dw)));
+        }
+      };
+
+      template <typename Kernel> std::size_t
+      countWithinDistance (const SacSimdModel &model, const SacSimdPoints &points, float threshold, float sqr_threshold)
+      {
+        const Kernel kernel (model);
+        const Vector threshold_vec = Ops::set1 (threshold);
+        const Vector sqr_threshold_vec = Ops::set1 (sqr_threshold);
+        const Vector all = Ops::firstLanes (Width);
+        Int acc = Ops::zeroInt ();
+        Lanes lanes;
+        std::size_t i = 0;
+        for (; i + Width <= points.size; i += Width)
+        {
+          load (points, Kernel::fields, i, Width, lanes);
+          acc = kernel.count (lanes, threshold_vec, sqr_threshold_vec, all, acc);
+        }
+        if (i < points.size)
+        {
+          load (points, Kernel::fields, i, points.size - i, lanes);
+          acc = kernel.count (lanes, threshold_vec, sqr_threshold_vec, Ops::firstLanes (points.size - i), acc);
+        }
+        // Only the stick kernel can give a negative count
+        const long long nr_p = Ops::sum (acc);
+        return (nr_p > 0 ? static_cast<std::size_t> (nr_p) : 0);
+      }
+
+      template <typename Kernel> void
+      getDistancesToModel (const SacSimdModel &model, const SacSimdPoints &points, double *distances)
+      {
+        const Kernel kernel (model);
+        Lanes lanes;
+        std::size_t i = 0;
+        for (; i + Width <= points.size; i += Width)
+        {
+          load (points, Kernel::fields, i, Width, lanes);
+          Ops::store (distances + i, kernel.distance (lanes));
+        }
+        if (i < points.size)
+        {
+          load (points, Kernel::fields, i, points.size - i, lanes);
+          double last[Width];
+          Ops::store (last, kernel.distance (lanes));
+          for (std::size_t k = 0; i + k < points.size; ++k)
+            distances[i + k] = last[k];
+        }
+      }
+
+      std::size_t
+      countWithinDistance (const SacSimdModel &model, const SacSimdPoints &points, float threshold, float sqr_threshold)
+      {
+        switch (model.kernel)
+        {
+          case SacSimdKernel::PLANE:         return (countWithinDistance<PlaneKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::NORMAL_PLANE:  return (countWithinDistance<NormalPlaneKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::SPHERE:        return (countWithinDistance<SphereKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::NORMAL_SPHERE: return (countWithinDistance<NormalSphereKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::CIRCLE2D:      return (countWithinDistance<Circle2DKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::CIRCLE3D:      return (countWithinDistance<Circle3DKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::LINE:          return (countWithinDistance<LineKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::STICK:         return (countWithinDistance<StickKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::CYLINDER:      return (countWithinDistance<CylinderKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::CONE:          return (countWithinDistance<ConeKernel> (model, points, threshold, sqr_threshold));
+          case SacSimdKernel::REGISTRATION:  return (countWithinDistance<RegistrationKernel> (model, points, threshold, sqr_threshold));
+        }
+        return (0);
+      }
+
+      void
+      getDistancesToModel (const SacSimdModel &model, const SacSimdPoints &points, double *distances)
+      {
+        switch (model.kernel)
+        {
+          case SacSimdKernel::PLANE:         getDistancesToModel<PlaneKernel> (model, points, distances); break;
+          case SacSimdKernel::NORMAL_PLANE:  getDistancesToModel<NormalPlaneKernel> (model, points, distances); break;
+          case SacSimdKernel::SPHERE:        getDistancesToModel<SphereKernel> (model, points, distances); break;
+          case SacSimdKernel::NORMAL_SPHERE: getDistancesToModel<NormalSphereKernel> (model, points, distances); break;
+          case SacSimdKernel::CIRCLE2D:      getDistancesToModel<Circle2DKernel> (model, points, distances); break;
+          case SacSimdKernel::CIRCLE3D:      getDistancesToModel<Circle3DKernel> (model, points, distances); break;
+          case SacSimdKernel::LINE:          getDistancesToModel<LineKernel> (model, points, distances); break;
+          case SacSimdKernel::STICK:         getDistancesToModel<StickKernel> (model, points, distances); break;
+          case SacSimdKernel::CYLINDER:      getDistancesToModel<CylinderKernel> (model, points, distances); break;
+          case SacSimdKernel::CONE:          getDistancesToModel<ConeKernel> (model, points, distances); break;
+          case SacSimdKernel::REGISTRATION:  getDistancesToModel<RegistrationKernel> (model, points, distances); break;
+        }
+      }
+
+      const SacSimdFunctions functions = {&countWithinDistance, &getDistancesToModel};
+    }
+#endif // PCL_SAC_SIMD_OPS
+  }
+}
@@ -0,0 +1,135 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+// Compiled with the flags enabling SSE2, see sac_model_simd_kernels.h
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PCL_SAC_SIMD_SSE2
+#endif
+
+#ifdef PCL_SAC_SIMD_SSE2
+#include <cstddef>
+#include <emmintrin.h>
+
+namespace
+{
+  /** \brief The vector operations of the kernels, on 4 points. */
+  struct Ops
+  {
+    using Vector = __m128;
+    using Int = __m128i;
+    static constexpr std::size_t size = 4;
+
+    static Vector set1 (float v) { return (_mm_set1_ps (v)); }
+    static Vector zero () { return (_mm_setzero_ps ()); }
+    static Vector add (Vector a, Vector b) { return (_mm_add_ps (a, b)); }
+    static Vector sub (Vector a, Vector b) { return (_mm_sub_ps (a, b)); }
+    static Vector mul (Vector a, Vector b) { return (_mm_mul_ps (a, b)); }
+    static Vector div (Vector a, Vector b) { return (_mm_div_ps (a, b)); }
+    static Vector sqrt (Vector a) { return (_mm_sqrt_ps (a)); }
+    static Vector abs (Vector a) { return (_mm_andnot_ps (_mm_set1_ps (-0.0f), a)); }
+    static Vector min (Vector a, Vector b) { return (_mm_min_ps (a, b)); }
+    static Vector lt (Vector a, Vector b) { return (_mm_cmplt_ps (a, b)); }
+    static Vector le (Vector a, Vector b) { return (_mm_cmple_ps (a, b)); }
+    static Vector andMask (Vector a, Vector b) { return (_mm_and_ps (a, b)); }
+    /** \brief b and not a */
+    static Vector andNotMask (Vector a, Vector b) { return (_mm_andnot_ps (a, b)); }
+    /** \brief a where mask is set, b elsewhere */
+    static Vector select (Vector mask, Vector a, Vector b) { return (_mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b))); }
+
+    static Int zeroInt () { return (_mm_setzero_si128 ()); }
+    /** \brief Add 1 to the lanes whose mask is set (all bits set is -1). */
+    static Int addMask (Int acc, Vector mask) { return (_mm_sub_epi32 (acc, _mm_castps_si128 (mask))); }
+    static Int subMask (Int acc, Vector mask) { return (_mm_add_epi32 (acc, _mm_castps_si128 (mask))); }
+    static long long
+    sum (Int acc)
+    {
+      alignas (16) int lanes[4];
+      _mm_store_si128 (reinterpret_cast<__m128i*> (lanes), acc);
+      return (static_cast<long long> (lanes[0]) + lanes[1] + lanes[2] + lanes[3]);
+    }
+    /** \brief The mask of the first n lanes. */
+    static Vector
+    firstLanes (std::size_t n)
+    {
+      return (_mm_castsi128_ps (_mm_cmplt_epi32 (_mm_setr_epi32 (0, 1, 2, 3), _mm_set1_epi32 (static_cast<int> (n)))));
+    }
+
+    static void
+    load3 (const float *const *p, bool padded, Vector &x, Vector &y, Vector &z)
+    {
+      if (padded)
+      {
+        __m128 r0 = _mm_loadu_ps (p[0]), r1 = _mm_loadu_ps (p[1]), r2 = _mm_loadu_ps (p[2]), r3 = _mm_loadu_ps (p[3]);
+        _MM_TRANSPOSE4_PS (r0, r1, r2, r3);
+        x = r0; y = r1; z = r2;
+        return;
+      }
+      x = _mm_setr_ps (p[0][0], p[1][0], p[2][0], p[3][0]);
+      y = _mm_setr_ps (p[0][1], p[1][1], p[2][1], p[3][1]);
+      z = _mm_setr_ps (p[0][2], p[1][2], p[2][2], p[3][2]);
+    }
+
+    static Vector
+    load1 (const float *const *p)
+    {
+      return (_mm_setr_ps (*p[0], *p[1], *p[2], *p[3]));
+    }
+
+    static void
+    store (double *out, Vector v)
+    {
+      _mm_storeu_pd (out, _mm_cvtps_pd (v));
+      _mm_storeu_pd (out + 2, _mm_cvtps_pd (_mm_movehl_ps (v, v)));
+    }
+  };
+}
+
+#define PCL_SAC_SIMD_OPS
+#endif // PCL_SAC_SIMD_SSE2
+
+#include "sac_model_simd_kernels.h"
+
+const pcl::detail::SacSimdFunctions*
+pcl::detail::getSacSimdFunctionsSSE2 ()
+{
+#ifdef PCL_SAC_SIMD_SSE2
+  return (&functions);
+#else
+  return (nullptr);
+#endif
+}
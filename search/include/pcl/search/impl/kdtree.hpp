@@ -101,6 +101,16 @@ pcl::search::KdTree<PointT,Tree>::radiusSearch (
   return (tree_->radiusSearch (point, radius, k_indices, k_sqr_distances, max_nn));
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, class Tree> void
+pcl::search::KdTree<PointT,Tree>::batchNearestKSearch (
+    const PointCloud& cloud, const Indices& indices, int k,
+    Indices& k_indices, std::vector<float>& k_sqr_distances,
+    unsigned int nr_threads) const
+{
+  tree_->batchNearestKSearch (cloud, indices, std::max (k, 0), k_indices, k_sqr_distances, nr_threads);
+}
+
 #define PCL_INSTANTIATE_KdTree(T) template class PCL_EXPORTS pcl::search::KdTree<T>;
 
 #endif  //#ifndef _PCL_SEARCH_KDTREE_IMPL_HPP_
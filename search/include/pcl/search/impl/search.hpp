@@ -40,6 +40,13 @@
 
 #include <pcl/search/search.h>
 
+#include <algorithm>
+#include <limits>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
 pcl::search::Search<PointT>::Search (const std::string& name, bool sorted)
@@ -183,6 +190,107 @@ pcl::search::Search<PointT>::radiusSearch (
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::Search<PointT>::batchNearestKSearch (
+    const PointCloud& cloud, const Indices& indices, int k,
+    Indices& k_indices, std::vector<float>& k_sqr_distances,
+    unsigned int nr_threads) const
+{
+  const std::size_t nr_queries = indices.empty () ? cloud.size () : indices.size ();
+  const std::size_t stride = std::max (k, 0);
+  k_indices.assign (nr_queries * stride, UNAVAILABLE);
+  k_sqr_distances.assign (nr_queries * stride, std::numeric_limits<float>::infinity ());
+  if (stride == 0)
+    return;
+
+#ifdef _OPENMP
+  if (nr_threads == 0)
+    nr_threads = omp_get_num_procs ();
+#endif
+
+#pragma omp parallel \
+  num_threads(nr_threads)
+  {
+    Indices nn_indices (k);
+    std::vector<float> nn_dists (k);
+
+#pragma omp for \
+  schedule(dynamic, 64)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (nr_queries); ++i)
+    {
+      const index_t query = indices.empty () ? static_cast<index_t> (i) : indices[i];
+      const int nr_neighbors = nearestKSearch (cloud, query, k, nn_indices, nn_dists);
+      const auto nr_found = std::min<std::size_t> (
+          std::min<std::size_t> (std::max (nr_neighbors, 0), stride), nn_indices.size ());
+      std::copy_n (nn_indices.cbegin (), nr_found, k_indices.begin () + i * stride);
+      std::copy_n (nn_dists.cbegin (), nr_found, k_sqr_distances.begin () + i * stride);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::search::Search<PointT>::batchRadiusSearch (
+    const PointCloud& cloud, const Indices& indices, double radius,
+    Indices& k_indices, std::vector<float>& k_sqr_distances,
+    std::vector<std::size_t>& k_offsets, unsigned int max_nn,
+    unsigned int nr_threads) const
+{
+  const std::size_t nr_queries = indices.empty () ? cloud.size () : indices.size ();
+  k_offsets.assign (nr_queries + 1, 0);
+
+#ifdef _OPENMP
+  if (nr_threads == 0)
+    nr_threads = omp_get_num_procs ();
+#endif
+
+  // The query points are split in contiguous blocks. Each block collects the
+  // neighbors of its queries in its own buffers, which are concatenated in order
+  // afterwards. Using more blocks than threads balances the load.
+  const std::size_t nr_blocks = std::max<std::size_t> (
+      1, std::min<std::size_t> (nr_queries, nr_threads > 1 ? 4 * nr_threads : 1));
+  std::vector<Indices> block_indices (nr_blocks);
+  std::vector<std::vector<float> > block_dists (nr_blocks);
+
+#pragma omp parallel \
+  num_threads(nr_threads)
+  {
+    Indices nn_indices;
+    std::vector<float> nn_dists;
+
+#pragma omp for \
+  schedule(dynamic, 1)
+    for (std::ptrdiff_t block = 0; block < static_cast<std::ptrdiff_t> (nr_blocks); ++block)
+    {
+      const std::size_t begin = nr_queries * block / nr_blocks;
+      const std::size_t end = nr_queries * (block + 1) / nr_blocks;
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        const index_t query = indices.empty () ? static_cast<index_t> (i) : indices[i];
+        const int nr_neighbors = radiusSearch (cloud, query, radius, nn_indices, nn_dists, max_nn);
+        const auto nr_found = std::min<std::size_t> (std::max (nr_neighbors, 0), nn_indices.size ());
+        block_indices[block].insert (block_indices[block].end (), nn_indices.cbegin (), nn_indices.cbegin () + nr_found);
+        block_dists[block].insert (block_dists[block].end (), nn_dists.cbegin (), nn_dists.cbegin () + nr_found);
+        k_offsets[i + 1] = nr_found;
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < nr_queries; ++i)
+    k_offsets[i + 1] += k_offsets[i];
+
+  k_indices.clear ();
+  k_indices.reserve (k_offsets.back ());
+  k_sqr_distances.clear ();
+  k_sqr_distances.reserve (k_offsets.back ());
+  for (std::size_t block = 0; block < nr_blocks; ++block)
+  {
+    k_indices.insert (k_indices.end (), block_indices[block].cbegin (), block_indices[block].cend ());
+    k_sqr_distances.insert (k_sqr_distances.end (), block_dists[block].cbegin (), block_dists[block].cend ());
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::search::Search<PointT>::sortResults (
@@ -162,6 +162,21 @@ namespace pcl
                       Indices &k_indices,
                       std::vector<float> &k_sqr_distances,
                       unsigned int max_nn = 0) const override;
+
+        /** \brief Search for the k-nearest neighbors of several query points at once, using the multi-query
+          * search of the underlying tree. See \ref Search::batchNearestKSearch for the layout of the results.
+          * \param[in] cloud the point cloud containing the query points
+          * \param[in] indices the indices of the query points in \a cloud. If empty, all points of \a cloud are queried.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] nr_threads the number of threads used to process the query points (0 to use all the available
+          * processors)
+          */
+        void
+        batchNearestKSearch (const PointCloud& cloud, const Indices& indices, int k,
+                             Indices& k_indices, std::vector<float>& k_sqr_distances,
+                             unsigned int nr_threads = 1) const override;
       protected:
         /** \brief A pointer to the internal KdTree object. */
         KdTreePtr tree_;
@@ -396,6 +396,45 @@ namespace pcl
           }
         }
 
+        /** \brief Search for the k-nearest neighbors of several query points at once, storing the results in flat
+          * buffers. The neighbors of the i-th query point are stored at positions [i * k, (i + 1) * k) of \a k_indices
+          * and \a k_sqr_distances. If fewer than \a k neighbors are found for a query point, the remaining positions
+          * are set to UNAVAILABLE and to std::numeric_limits<float>::infinity () respectively.
+          * \param[in] cloud the point cloud containing the query points
+          * \param[in] indices the indices of the query points in \a cloud. If empty, all points of \a cloud are queried.
+          * \param[in] k the number of neighbors to search for
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[in] nr_threads the number of threads used to process the query points (0 to use all the available
+          * processors)
+          */
+        virtual void
+        batchNearestKSearch (const PointCloud& cloud, const Indices& indices, int k,
+                             Indices& k_indices, std::vector<float>& k_sqr_distances,
+                             unsigned int nr_threads = 1) const;
+
+        /** \brief Search for all the neighbors of several query points in a given radius at once, storing the
+          * results in flat buffers. The neighbors of the i-th query point are stored at positions
+          * [k_offsets[i], k_offsets[i + 1]) of \a k_indices and \a k_sqr_distances.
+          * \param[in] cloud the point cloud containing the query points
+          * \param[in] indices the indices of the query points in \a cloud. If empty, all points of \a cloud are queried.
+          * \param[in] radius the radius of the sphere bounding all of p_q's neighbors
+          * \param[out] k_indices the resultant indices of the neighboring points
+          * \param[out] k_sqr_distances the resultant squared distances to the neighboring points
+          * \param[out] k_offsets the start of the neighbors of every query point in \a k_indices, followed by the total
+          * number of neighbors (i.e. one element more than the number of query points)
+          * \param[in] max_nn if given, bounds the maximum returned neighbors per query point to this value. If \a max_nn
+          * is set to 0 or to a number higher than the number of points in the input cloud, all neighbors in \a radius
+          * will be returned.
+          * \param[in] nr_threads the number of threads used to process the query points (0 to use all the available
+          * processors)
+          */
+        virtual void
+        batchRadiusSearch (const PointCloud& cloud, const Indices& indices, double radius,
+                           Indices& k_indices, std::vector<float>& k_sqr_distances,
+                           std::vector<std::size_t>& k_offsets, unsigned int max_nn = 0,
+                           unsigned int nr_threads = 1) const;
+
       protected:
         void 
         sortResults (Indices& indices, std::vector<float>& distances) const;
@@ -82,6 +82,31 @@ namespace pcl
       const typename search::Search<PointT>::Ptr &tree, float tolerance, std::vector<PointIndices> &clusters,
       unsigned int min_pts_per_cluster = 1, unsigned int max_pts_per_cluster = (std::numeric_limits<int>::max) ());
 
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief Decompose a region of space into clusters based on the Euclidean distance between points, using
+    * several threads.
+    *
+    * Instead of growing the clusters one after the other, the radius searches of all the points run concurrently
+    * and each point is merged with its neighbors in a lock-free union-find. The clusters, and their order, are the
+    * same as the ones of the serial version above.
+    * \param cloud the point cloud message
+    * \param indices a list of point indices to use from \a cloud
+    * \param tree the spatial locator (e.g., kd-tree) used for nearest neighbors searching
+    * \note the tree has to be created as a spatial locator on \a cloud and \a indices, and has to support
+    * concurrent searches
+    * \param tolerance the spatial cluster tolerance as a measure in L2 Euclidean space
+    * \param clusters the resultant clusters containing point indices (as a vector of PointIndices)
+    * \param min_pts_per_cluster minimum number of points that a cluster may contain
+    * \param max_pts_per_cluster maximum number of points that a cluster may contain
+    * \param nr_threads the number of hardware threads to use (0 for automatic)
+    * \ingroup segmentation
+    */
+  template <typename PointT> void
+  extractEuclideanClusters (
+      const PointCloud<PointT> &cloud, const Indices &indices,
+      const typename search::Search<PointT>::Ptr &tree, float tolerance, std::vector<PointIndices> &clusters,
+      unsigned int min_pts_per_cluster, unsigned int max_pts_per_cluster, unsigned int nr_threads);
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief Decompose a region of space into clusters based on the euclidean distance between points, and the normal
     * angular deviation between points. Each point added to the cluster is origin to another radius search. Each point
@@ -318,6 +343,9 @@ namespace pcl
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   /** \brief @b EuclideanClusterExtraction represents a segmentation class for cluster extraction in an Euclidean sense.
+    *
+    * With more than one thread (see \ref setNumberOfThreads), the radius searches run concurrently and the points
+    * are merged with a union-find instead of a breadth-first search. The extracted clusters are the same.
     * \author Radu Bogdan Rusu
     * \ingroup segmentation
     */
@@ -342,7 +370,8 @@ namespace pcl
       EuclideanClusterExtraction () : tree_ (), 
                                       cluster_tolerance_ (0),
                                       min_pts_per_cluster_ (1), 
-                                      max_pts_per_cluster_ (std::numeric_limits<pcl::uindex_t>::max ())
+                                      max_pts_per_cluster_ (std::numeric_limits<pcl::uindex_t>::max ()),
+                                      threads_ (1)
       {};
 
       /** \brief Provide a pointer to the search object.
@@ -411,6 +440,19 @@ namespace pcl
         return (max_pts_per_cluster_); 
       }
 
+      /** \brief Set the number of threads to use. Default: 1
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads to use. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (threads_);
+      }
+
       /** \brief Cluster extraction in a PointCloud given by <setInputCloud (), setIndices ()>
         * \param[out] clusters the resultant point clusters
         */
@@ -436,6 +478,9 @@ namespace pcl
       /** \brief The maximum number of points that a cluster needs to contain in order to be considered valid (default = MAXINT). */
       pcl::uindex_t max_pts_per_cluster_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       /** \brief Class getName method. */
       virtual std::string getClassName () const { return ("EuclideanClusterExtraction"); }
 
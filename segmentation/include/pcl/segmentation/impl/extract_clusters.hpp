@@ -41,6 +41,12 @@
 #include <pcl/segmentation/extract_clusters.h>
 #include <pcl/search/organized.h> // for OrganizedNeighbor
 
+#include <atomic>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
@@ -220,10 +226,182 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
+                               const Indices &indices,
+                               const typename search::Search<PointT>::Ptr &tree,
+                               float tolerance, std::vector<PointIndices> &clusters,
+                               unsigned int min_pts_per_cluster,
+                               unsigned int max_pts_per_cluster,
+                               unsigned int nr_threads)
+{
+  if (tree->getInputCloud()->size() != cloud.size()) {
+    PCL_ERROR("[pcl::extractEuclideanClusters] Tree built for a different point cloud "
+              "dataset (%zu) than the input cloud (%zu)!\n",
+              static_cast<std::size_t>(tree->getInputCloud()->size()),
+              static_cast<std::size_t>(cloud.size()));
+    return;
+  }
+  if (tree->getIndices()->size() != indices.size()) {
+    PCL_ERROR("[pcl::extractEuclideanClusters] Tree built for a different set of "
+              "indices (%zu) than the input set (%zu)!\n",
+              static_cast<std::size_t>(tree->getIndices()->size()),
+              indices.size());
+    return;
+  }
+#ifdef _OPENMP
+  if (nr_threads == 0)
+    nr_threads = omp_get_num_procs ();
+#else
+  nr_threads = 1;
+#endif
+
+  const auto nr_points = static_cast<std::ptrdiff_t> (indices.size ());
+  // Position of each point of the cloud in the indices vector (the first one, if it is repeated)
+  std::vector<index_t> position (cloud.size (), UNAVAILABLE);
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    if (position[indices[i]] == UNAVAILABLE)
+      position[indices[i]] = static_cast<index_t> (i);
+
+  // Union-find forest on the positions. A tree is only ever linked below a root with a smaller position,
+  // so the root of each cluster is its first point in the indices vector, i.e. the seed of the serial version
+  std::vector<std::atomic<index_t> > parent (nr_points);
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    parent[i].store (static_cast<index_t> (i), std::memory_order_relaxed);
+
+  const auto find = [&parent] (index_t x)
+  {
+    while (true)
+    {
+      index_t p = parent[x].load ();
+      if (p == x)
+        return (x);
+      // Path halving: point x to its grandparent, if no other thread did it already
+      const index_t gp = parent[p].load ();
+      if (gp != p)
+        parent[x].compare_exchange_weak (p, gp);
+      x = gp;
+    }
+  };
+
+  const auto unite = [&parent, &find] (index_t a, index_t b)
+  {
+    while (true)
+    {
+      a = find (a);
+      b = find (b);
+      if (a == b)
+        return;
+      if (a < b)
+        std::swap (a, b);
+      // Fails if another thread linked a in the meantime, in which case we search the roots again
+      index_t expected = a;
+      if (parent[a].compare_exchange_strong (expected, b))
+        return;
+    }
+  };
+
+  std::atomic<bool> search_failed (false);
+  Indices nn_indices;
+  std::vector<float> nn_distances;
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  firstprivate(nn_indices, nn_distances) \
+  schedule(dynamic, 64)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+  {
+    if (position[indices[i]] != i)
+      continue;
+
+    const int ret = tree->radiusSearch (cloud[indices[i]], tolerance, nn_indices, nn_distances);
+    if (ret == -1)
+    {
+      search_failed = true;
+      continue;
+    }
+
+    for (const auto &nn_index : nn_indices)
+    {
+      if (nn_index == UNAVAILABLE || position[nn_index] == UNAVAILABLE)
+        continue;
+      unite (static_cast<index_t> (i), position[nn_index]);
+    }
+  }
+
+  if (search_failed)
+  {
+    PCL_ERROR("[pcl::extractEuclideanClusters] Received error code -1 from radiusSearch\n");
+    return;
+  }
+
+  // Flatten the forest, and count the points of each cluster
+  std::vector<index_t> root (nr_points);
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  schedule(static)
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    root[i] = find (static_cast<index_t> (i));
+
+  std::vector<std::size_t> cluster_size (nr_points, 0);
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    if (position[indices[i]] == i)
+      ++cluster_size[root[i]];
+
+  // The clusters are created in the order of their roots, which is the order of the serial version
+  const std::size_t first_cluster = clusters.size ();
+  std::vector<index_t> cluster_idx (nr_points, UNAVAILABLE);
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+  {
+    if (root[i] != i || cluster_size[i] == 0)
+      continue;
+    if (cluster_size[i] >= min_pts_per_cluster && cluster_size[i] <= max_pts_per_cluster)
+    {
+      cluster_idx[i] = static_cast<index_t> (clusters.size () - first_cluster);
+      clusters.emplace_back ();
+      clusters.back ().header = cloud.header;
+      clusters.back ().indices.reserve (cluster_size[i]);
+    }
+    else
+    {
+      PCL_DEBUG("[pcl::extractEuclideanClusters] This cluster has %zu points, which is not between %u and %u points, so it is not a final cluster\n",
+                cluster_size[i], min_pts_per_cluster, max_pts_per_cluster);
+    }
+  }
+
+  for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+  {
+    if (position[indices[i]] != i || cluster_idx[root[i]] == UNAVAILABLE)
+      continue;
+    clusters[first_cluster + cluster_idx[root[i]]].indices.push_back (indices[i]);
+  }
+
+#pragma omp parallel for \
+  num_threads(nr_threads) \
+  schedule(dynamic, 1)
+  for (std::ptrdiff_t i = static_cast<std::ptrdiff_t> (first_cluster); i < static_cast<std::ptrdiff_t> (clusters.size ()); ++i)
+    std::sort (clusters[i].indices.begin (), clusters[i].indices.end ());
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////
 
+template <typename PointT> void
+pcl::EuclideanClusterExtraction<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+
 template <typename PointT> void 
 pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clusters)
 {
@@ -246,7 +424,10 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
 
   // Send the input dataset to the spatial locator
   tree_->setInputCloud (input_, indices_);
-  extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_);
+  if (threads_ > 1)
+    extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_, threads_);
+  else
+    extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_);
 
   //tree_->setInputCloud (input_);
   //extractEuclideanClusters (*input_, tree_, cluster_tolerance_, clusters, min_pts_per_cluster_, max_pts_per_cluster_);
@@ -260,5 +441,6 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
 #define PCL_INSTANTIATE_EuclideanClusterExtraction(T) template class PCL_EXPORTS pcl::EuclideanClusterExtraction<T>;
 #define PCL_INSTANTIATE_extractEuclideanClusters(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int);
 #define PCL_INSTANTIATE_extractEuclideanClusters_indices(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const pcl::Indices &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int);
+#define PCL_INSTANTIATE_extractEuclideanClusters_indices_threads(T) template void PCL_EXPORTS pcl::extractEuclideanClusters<T>(const pcl::PointCloud<T> &, const pcl::Indices &, const typename pcl::search::Search<T>::Ptr &, float , std::vector<pcl::PointIndices> &, unsigned int, unsigned int, unsigned int);
 
 #endif        // PCL_EXTRACT_CLUSTERS_IMPL_H_
@@ -48,10 +48,15 @@
 #include <pcl/search/search.h>
 #include <pcl/search/kdtree.h>
 
+#include <algorithm>
 #include <queue>
 #include <cmath>
 #include <ctime>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT>
 pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
@@ -67,11 +72,18 @@ pcl::RegionGrowing<PointT, NormalT>::RegionGrowing () :
   search_ (),
   normals_ (),
   point_neighbours_ (0),
+  point_neighbour_offsets_ (0),
+  point_distances_ (0),
+  graph_indices_ (),
+  graph_search_ (),
+  graph_neighbour_number_ (0),
+  graph_has_distances_ (false),
   point_labels_ (0),
   normal_flag_ (true),
   num_pts_in_segment_ (0),
   clusters_ (0),
-  number_of_segments_ (0)
+  number_of_segments_ (0),
+  threads_ (1)
 {
 }
 
@@ -80,11 +92,23 @@ template <typename PointT, typename NormalT>
 pcl::RegionGrowing<PointT, NormalT>::~RegionGrowing ()
 {
   point_neighbours_.clear ();
+  point_neighbour_offsets_.clear ();
+  point_distances_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   clusters_.clear ();
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::setInputCloud (const PointCloudConstPtr &cloud)
+{
+  PCLBase<PointT>::setInputCloud (cloud);
+  point_neighbours_.clear ();
+  point_neighbour_offsets_.clear ();
+  point_distances_.clear ();
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> pcl::uindex_t
 pcl::RegionGrowing<PointT, NormalT>::getMinClusterSize ()
@@ -217,6 +241,20 @@ pcl::RegionGrowing<PointT, NormalT>::setNumberOfNeighbours (unsigned int neighbo
   neighbour_number_ = neighbour_number;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT, typename NormalT> typename pcl::RegionGrowing<PointT, NormalT>::KdTreePtr
 pcl::RegionGrowing<PointT, NormalT>::getSearchMethod () const
@@ -251,7 +289,6 @@ pcl::RegionGrowing<PointT, NormalT>::extract (std::vector <pcl::PointIndices>& c
 {
   clusters_.clear ();
   clusters.clear ();
-  point_neighbours_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
   number_of_segments_ = 0;
@@ -326,14 +363,8 @@ pcl::RegionGrowing<PointT, NormalT>::prepareForSegmentation ()
   if (!search_)
     search_.reset (new pcl::search::KdTree<PointT>);
 
-  if (indices_)
-  {
-    if (indices_->empty ())
-      PCL_ERROR ("[pcl::RegionGrowing::prepareForSegmentation] Empty given indices!\n");
-    search_->setInputCloud (input_, indices_);
-  }
-  else
-    search_->setInputCloud (input_);
+  if (indices_->empty ())
+    PCL_ERROR ("[pcl::RegionGrowing::prepareForSegmentation] Empty given indices!\n");
 
   return (true);
 }
@@ -342,33 +373,89 @@ pcl::RegionGrowing<PointT, NormalT>::prepareForSegmentation ()
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowing<PointT, NormalT>::findPointNeighbours ()
 {
-  int point_number = static_cast<int> (indices_->size ());
-  pcl::Indices neighbours;
-  std::vector<float> distances;
+  buildNeighbourGraph (neighbour_number_, false);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT, typename NormalT> void
+pcl::RegionGrowing<PointT, NormalT>::buildNeighbourGraph (unsigned int neighbour_number, bool with_distances)
+{
+  if (point_neighbour_offsets_.size () == input_->size () + 1 &&
+      graph_indices_ == indices_ && graph_search_ == search_ &&
+      graph_neighbour_number_ == neighbour_number && (graph_has_distances_ || !with_distances))
+    return;
+
+  search_->setInputCloud (input_, indices_);
+
+  // Positions in indices_ of the points to search: the finite ones, without repetitions
+  std::vector<int> positions;
+  positions.reserve (indices_->size ());
+  std::vector<bool> listed (input_->size (), false);
+  for (std::size_t i_point = 0; i_point < indices_->size (); i_point++)
+  {
+    const auto point_index = (*indices_)[i_point];
+    if (listed[point_index] || (!input_->is_dense && !pcl::isFinite ((*input_)[point_index])))
+      continue;
+    listed[point_index] = true;
+    positions.push_back (static_cast<int> (i_point));
+  }
 
-  point_neighbours_.resize (input_->size (), neighbours);
-  if (input_->is_dense)
+  // The neighbours are searched by chunks of points, whose results are then copied in the graph
+  const std::ptrdiff_t chunk_size = 256;
+  const auto nr_chunks = (static_cast<std::ptrdiff_t> (positions.size ()) + chunk_size - 1) / chunk_size;
+  std::vector<pcl::Indices> chunk_neighbours (nr_chunks);
+  std::vector<std::vector<float> > chunk_distances (nr_chunks);
+  point_neighbour_offsets_.assign (input_->size () + 1, 0);
+
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (std::ptrdiff_t chunk = 0; chunk < nr_chunks; ++chunk)
   {
-    for (int i_point = 0; i_point < point_number; i_point++)
+    const auto begin = chunk * chunk_size;
+    const auto end = std::min (begin + chunk_size, static_cast<std::ptrdiff_t> (positions.size ()));
+    pcl::Indices neighbours;
+    std::vector<float> distances;
+    for (auto i = begin; i < end; ++i)
     {
-      int point_index = (*indices_)[i_point];
-      neighbours.clear ();
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
+      search_->nearestKSearch (positions[i], neighbour_number, neighbours, distances);
+      chunk_neighbours[chunk].insert (chunk_neighbours[chunk].end (), neighbours.begin (), neighbours.end ());
+      if (with_distances)
+        chunk_distances[chunk].insert (chunk_distances[chunk].end (), distances.begin (), distances.end ());
+      point_neighbour_offsets_[(*indices_)[positions[i]] + 1] = neighbours.size ();
     }
   }
-  else
+
+  for (std::size_t i_point = 0; i_point < input_->size (); i_point++)
+    point_neighbour_offsets_[i_point + 1] += point_neighbour_offsets_[i_point];
+
+  point_neighbours_.resize (point_neighbour_offsets_.back ());
+  point_distances_.resize (with_distances ? point_neighbour_offsets_.back () : 0);
+
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (std::ptrdiff_t chunk = 0; chunk < nr_chunks; ++chunk)
   {
-    for (int i_point = 0; i_point < point_number; i_point++)
+    const auto begin = chunk * chunk_size;
+    const auto end = std::min (begin + chunk_size, static_cast<std::ptrdiff_t> (positions.size ()));
+    std::size_t offset = 0;
+    for (auto i = begin; i < end; ++i)
     {
-      neighbours.clear ();
-      int point_index = (*indices_)[i_point];
-      if (!pcl::isFinite ((*input_)[point_index]))
-        continue;
-      search_->nearestKSearch (i_point, neighbour_number_, neighbours, distances);
-      point_neighbours_[point_index].swap (neighbours);
+      const auto point_index = (*indices_)[positions[i]];
+      const auto first = point_neighbour_offsets_[point_index];
+      const auto count = point_neighbour_offsets_[point_index + 1] - first;
+      std::copy_n (chunk_neighbours[chunk].begin () + offset, count, point_neighbours_.begin () + first);
+      if (with_distances)
+        std::copy_n (chunk_distances[chunk].begin () + offset, count, point_distances_.begin () + first);
+      offset += count;
     }
   }
+
+  graph_indices_ = indices_;
+  graph_search_ = search_;
+  graph_neighbour_number_ = neighbour_number;
+  graph_has_distances_ = with_distances;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -444,10 +531,12 @@ pcl::RegionGrowing<PointT, NormalT>::growRegion (int initial_seed, int segment_n
     curr_seed = seeds.front ();
     seeds.pop ();
 
+    const std::size_t first_nghbr = point_neighbour_offsets_[curr_seed];
+    const std::size_t nghbr_number = point_neighbour_offsets_[curr_seed + 1] - first_nghbr;
     std::size_t i_nghbr = 0;
-    while ( i_nghbr < neighbour_number_ && i_nghbr < point_neighbours_[curr_seed].size () )
+    while ( i_nghbr < neighbour_number_ && i_nghbr < nghbr_number )
     {
-      int index = point_neighbours_[curr_seed][i_nghbr];
+      int index = point_neighbours_[first_nghbr + i_nghbr];
       if (point_labels_[index] != -1)
       {
         i_nghbr++;
@@ -591,7 +680,6 @@ pcl::RegionGrowing<PointT, NormalT>::getSegmentFromPoint (pcl::index_t index, pc
   {
     if (clusters_.empty ())
     {
-      point_neighbours_.clear ();
       point_labels_.clear ();
       num_pts_in_segment_.clear ();
       number_of_segments_ = 0;
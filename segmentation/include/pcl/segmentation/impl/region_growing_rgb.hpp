@@ -54,7 +54,6 @@ pcl::RegionGrowingRGB<PointT, NormalT>::RegionGrowingRGB () :
   color_r2r_threshold_ (10.0f),
   distance_threshold_ (0.05f),
   region_neighbour_number_ (100),
-  point_distances_ (0),
   segment_neighbours_ (0),
   segment_distances_ (0),
   segment_labels_ (0)
@@ -69,7 +68,6 @@ pcl::RegionGrowingRGB<PointT, NormalT>::RegionGrowingRGB () :
 template <typename PointT, typename NormalT>
 pcl::RegionGrowingRGB<PointT, NormalT>::~RegionGrowingRGB ()
 {
-  point_distances_.clear ();
   segment_neighbours_.clear ();
   segment_distances_.clear ();
   segment_labels_.clear ();
@@ -165,10 +163,8 @@ pcl::RegionGrowingRGB<PointT, NormalT>::extract (std::vector <pcl::PointIndices>
 {
   clusters_.clear ();
   clusters.clear ();
-  point_neighbours_.clear ();
   point_labels_.clear ();
   num_pts_in_segment_.clear ();
-  point_distances_.clear ();
   segment_neighbours_.clear ();
   segment_distances_.clear ();
   segment_labels_.clear ();
@@ -256,14 +252,8 @@ pcl::RegionGrowingRGB<PointT, NormalT>::prepareForSegmentation ()
   if (!search_)
     search_.reset (new pcl::search::KdTree<PointT>);
 
-  if (indices_)
-  {
-    if (indices_->empty ())
-      PCL_ERROR ("[pcl::RegionGrowingRGB::prepareForSegmentation] Empty given indices!\n");
-    search_->setInputCloud (input_, indices_);
-  }
-  else
-    search_->setInputCloud (input_);
+  if (indices_->empty ())
+    PCL_ERROR ("[pcl::RegionGrowingRGB::prepareForSegmentation] Empty given indices!\n");
 
   return (true);
 }
@@ -272,22 +262,7 @@ pcl::RegionGrowingRGB<PointT, NormalT>::prepareForSegmentation ()
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowingRGB<PointT, NormalT>::findPointNeighbours ()
 {
-  int point_number = static_cast<int> (indices_->size ());
-  pcl::Indices neighbours;
-  std::vector<float> distances;
-
-  point_neighbours_.resize (input_->size (), neighbours);
-  point_distances_.resize (input_->size (), distances);
-
-  for (int i_point = 0; i_point < point_number; i_point++)
-  {
-    int point_index = (*indices_)[i_point];
-    neighbours.clear ();
-    distances.clear ();
-    search_->nearestKSearch (i_point, region_neighbour_number_, neighbours, distances);
-    point_neighbours_[point_index].swap (neighbours);
-    point_distances_[point_index].swap (distances);
-  }
+  this->buildNeighbourGraph (region_neighbour_number_, true);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -299,14 +274,11 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findSegmentNeighbours ()
   segment_neighbours_.resize (number_of_segments_, neighbours);
   segment_distances_.resize (number_of_segments_, distances);
 
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 16)
   for (int i_seg = 0; i_seg < number_of_segments_; i_seg++)
-  {
-    pcl::Indices nghbrs;
-    std::vector<float> dist;
-    findRegionsKNN (i_seg, region_neighbour_number_, nghbrs, dist);
-    segment_neighbours_[i_seg].swap (nghbrs);
-    segment_distances_[i_seg].swap (dist);
-  }
+    findRegionsKNN (i_seg, region_neighbour_number_, segment_neighbours_[i_seg], segment_distances_[i_seg]);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -322,19 +294,20 @@ pcl::RegionGrowingRGB<PointT, NormalT>::findRegionsKNN (pcl::index_t index, pcl:
   for (pcl::uindex_t i_point = 0; i_point < number_of_points; i_point++)
   {
     const auto point_index = clusters_[index].indices[i_point];
-    const auto number_of_neighbours = point_neighbours_[point_index].size ();
+    const auto first_neighbour = point_neighbour_offsets_[point_index];
+    const auto number_of_neighbours = point_neighbour_offsets_[point_index + 1] - first_neighbour;
     //loop through every neighbour of the current point, find out to which segment it belongs
     //and if it belongs to neighbouring segment and is close enough then remember segment and its distance
     for (std::size_t i_nghbr = 0; i_nghbr < number_of_neighbours; i_nghbr++)
     {
       // find segment
-      const pcl::index_t segment_index = point_labels_[ point_neighbours_[point_index][i_nghbr] ];
+      const pcl::index_t segment_index = point_labels_[ point_neighbours_[first_neighbour + i_nghbr] ];
 
       if ( segment_index != index )
       {
         // try to push it to the queue
-        if (distances[segment_index] > point_distances_[point_index][i_nghbr])
-          distances[segment_index] = point_distances_[point_index][i_nghbr];
+        if (distances[segment_index] > point_distances_[first_neighbour + i_nghbr])
+          distances[segment_index] = point_distances_[first_neighbour + i_nghbr];
       }
     }
   }// next point
@@ -700,10 +673,8 @@ pcl::RegionGrowingRGB<PointT, NormalT>::getSegmentFromPoint (pcl::index_t index,
     if (clusters_.empty ())
     {
       clusters_.clear ();
-      point_neighbours_.clear ();
       point_labels_.clear ();
       num_pts_in_segment_.clear ();
-      point_distances_.clear ();
       segment_neighbours_.clear ();
       segment_distances_.clear ();
       segment_labels_.clear ();
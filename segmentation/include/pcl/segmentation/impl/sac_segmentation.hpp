@@ -52,6 +52,7 @@
 #include <pcl/sample_consensus/rmsac.h>
 #include <pcl/sample_consensus/rransac.h>
 #include <pcl/sample_consensus/prosac.h>
+#include <pcl/sample_consensus/sprt.h>
 
 // Sample Consensus models
 #include <pcl/sample_consensus/sac_model.h>
@@ -319,6 +320,12 @@ pcl::SACSegmentation<PointT>::initSAC (const int method_type)
       sac_.reset (new ProgressiveSampleConsensus<PointT> (model_, threshold_));
       break;
     }
+    case SAC_SPRT:
+    {
+      PCL_DEBUG ("[pcl::%s::initSAC] Using a method of type: SAC_SPRT with a model threshold of %f\n", getClassName ().c_str (), threshold_);
+      sac_.reset (new SPRTSampleConsensus<PointT> (model_, threshold_));
+      break;
+    }
   }
   // Set the Sample Consensus parameters if they are given/changed
   if (sac_->getProbability () != probability_)
@@ -43,6 +43,13 @@
 #include <pcl/segmentation/supervoxel_clustering.h>
 #include <pcl/common/io.h> // for copyPointCloud
 
+#include <algorithm>
+#include <tuple>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT>
 pcl::SupervoxelClustering<PointT>::SupervoxelClustering (float voxel_resolution, float seed_resolution) :
@@ -53,7 +60,8 @@ pcl::SupervoxelClustering<PointT>::SupervoxelClustering (float voxel_resolution,
   color_importance_ (0.1f),
   spatial_importance_ (0.4f),
   normal_importance_ (1.0f),
-  use_default_transform_behaviour_ (true)
+  use_default_transform_behaviour_ (true),
+  threads_ (1)
 {
   adjacency_octree_.reset (new OctreeAdjacencyT (resolution_));
 }
@@ -157,10 +165,14 @@ pcl::SupervoxelClustering<PointT>::refineSupervoxels (int num_itr, std::map<std:
   int max_depth = static_cast<int> (1.8f*seed_resolution_/resolution_);
   for (int i = 0; i < num_itr; ++i)
   {
-    for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
-    {
-      sv_itr->refineNormals ();
-    }
+    // Each helper only modifies the normals of its own voxels
+    std::vector<SupervoxelHelper*> helpers;
+    getHelperPointers (helpers);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+    for (std::ptrdiff_t i_helper = 0; i_helper < static_cast<std::ptrdiff_t> (helpers.size ()); ++i_helper)
+      helpers[i_helper]->refineNormals ();
     
     reseedSupervoxels ();
     expandSupervoxels (max_depth);
@@ -210,15 +222,17 @@ pcl::SupervoxelClustering<PointT>::computeVoxelData ()
 {
   voxel_centroid_cloud_.reset (new PointCloudT);
   voxel_centroid_cloud_->resize (adjacency_octree_->getLeafCount ());
-  typename LeafVectorT::iterator leaf_itr = adjacency_octree_->begin ();
-  typename PointCloudT::iterator cent_cloud_itr = voxel_centroid_cloud_->begin ();
-  for (int idx = 0 ; leaf_itr != adjacency_octree_->end (); ++leaf_itr, ++cent_cloud_itr, ++idx)
+  const LeafVectorT leaves (adjacency_octree_->begin (), adjacency_octree_->end ());
+  const auto nr_leaves = static_cast<std::ptrdiff_t> (leaves.size ());
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(static)
+  for (std::ptrdiff_t idx = 0; idx < nr_leaves; ++idx)
   {
-    VoxelData& new_voxel_data = (*leaf_itr)->getData ();
+    VoxelData& new_voxel_data = leaves[idx]->getData ();
     //Add the point to the centroid cloud
-    new_voxel_data.getPoint (*cent_cloud_itr);
-    //voxel_centroid_cloud_->push_back(new_voxel_data.getPoint ());
-    new_voxel_data.idx_ = idx;
+    new_voxel_data.getPoint ((*voxel_centroid_cloud_)[idx]);
+    new_voxel_data.idx_ = static_cast<int> (idx);
   }
   
   //If normals were provided
@@ -227,44 +241,57 @@ pcl::SupervoxelClustering<PointT>::computeVoxelData ()
     //Verify that input normal cloud size is same as input cloud size
     assert (input_normals_->size () == input_->size ());
     //For every point in the input cloud, find its corresponding leaf
-    typename NormalCloudT::const_iterator normal_itr = input_normals_->begin ();
-    for (typename PointCloudT::const_iterator input_itr = input_->begin (); input_itr != input_->end (); ++input_itr, ++normal_itr)
+    const auto nr_points = static_cast<std::ptrdiff_t> (input_->size ());
+    LeafVectorT point_leaves (nr_points, nullptr);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 256)
+    for (std::ptrdiff_t i = 0; i < nr_points; ++i)
     {
       //If the point is not finite we ignore it
-      if ( !pcl::isFinite<PointT> (*input_itr))
+      if (pcl::isFinite<PointT> ((*input_)[i]))
+        point_leaves[i] = adjacency_octree_->getLeafContainerAtPoint ((*input_)[i]);
+    }
+    //Sum the normals in point order, so that the result does not depend on the number of threads
+    for (std::ptrdiff_t i = 0; i < nr_points; ++i)
+    {
+      if (!point_leaves[i])
         continue;
-      //Otherwise look up its leaf container
-      LeafContainerT* leaf = adjacency_octree_->getLeafContainerAtPoint (*input_itr);
-
       //Get the voxel data object
-      VoxelData& voxel_data = leaf->getData ();
+      VoxelData& voxel_data = point_leaves[i]->getData ();
       //Add this normal in (we will normalize at the end)
-      voxel_data.normal_ += normal_itr->getNormalVector4fMap ();
-      voxel_data.curvature_ += normal_itr->curvature;
+      voxel_data.normal_ += (*input_normals_)[i].getNormalVector4fMap ();
+      voxel_data.curvature_ += (*input_normals_)[i].curvature;
     }
     //Now iterate through the leaves and normalize 
-    for (leaf_itr = adjacency_octree_->begin (); leaf_itr != adjacency_octree_->end (); ++leaf_itr)
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(static)
+    for (std::ptrdiff_t idx = 0; idx < nr_leaves; ++idx)
     {
-      VoxelData& voxel_data = (*leaf_itr)->getData ();
+      VoxelData& voxel_data = leaves[idx]->getData ();
       voxel_data.normal_.normalize ();
       voxel_data.owner_ = nullptr;
       voxel_data.distance_ = std::numeric_limits<float>::max ();
       //Get the number of points in this leaf
-      int num_points = (*leaf_itr)->getPointCounter ();
+      int num_points = leaves[idx]->getPointCounter ();
       voxel_data.curvature_ /= num_points;
     }
   }
   else //Otherwise just compute the normals
   {
-    for (leaf_itr = adjacency_octree_->begin (); leaf_itr != adjacency_octree_->end (); ++leaf_itr)
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 64)
+    for (std::ptrdiff_t idx = 0; idx < nr_leaves; ++idx)
     {
-      VoxelData& new_voxel_data = (*leaf_itr)->getData ();
+      VoxelData& new_voxel_data = leaves[idx]->getData ();
       //For every point, get its neighbors, build an index vector, compute normal
       Indices indices;
       indices.reserve (81); 
       //Push this point
       indices.push_back (new_voxel_data.idx_);
-      for (typename LeafContainerT::const_iterator neighb_itr=(*leaf_itr)->cbegin (); neighb_itr!=(*leaf_itr)->cend (); ++neighb_itr)
+      for (typename LeafContainerT::const_iterator neighb_itr=leaves[idx]->cbegin (); neighb_itr!=leaves[idx]->cend (); ++neighb_itr)
       {
         VoxelData& neighb_voxel_data = (*neighb_itr)->getData ();
         //Push neighbor index
@@ -295,30 +322,83 @@ pcl::SupervoxelClustering<PointT>::expandSupervoxels ( int depth )
 {
   
   
+  std::vector<SupervoxelHelper*> helpers;
   for (int i = 1; i < depth; ++i)
   {
       //Expand the the supervoxels by one iteration
-      for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+      if (threads_ > 1)
+        expandSupervoxelsSynchronously ();
+      else
       {
-        sv_itr->expand ();
+        for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+        {
+          sv_itr->expand ();
+        }
       }
       
-      //Update the centers to reflect new centers
+      //Remove the supervoxels which lost all their voxels
       for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); )
       {
         if (sv_itr->size () == 0)
-        {
           sv_itr = supervoxel_helpers_.erase (sv_itr);
-        }
         else
-        {
-          sv_itr->updateCentroid ();
           ++sv_itr;
-        } 
       }
 
+      //Update the centers to reflect new centers
+      getHelperPointers (helpers);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+      for (std::ptrdiff_t i_helper = 0; i_helper < static_cast<std::ptrdiff_t> (helpers.size ()); ++i_helper)
+        helpers[i_helper]->updateCentroid ();
+  }
+
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::expandSupervoxelsSynchronously ()
+{
+  std::vector<SupervoxelHelper*> helpers;
+  getHelperPointers (helpers);
+
+  //Every supervoxel looks for the voxels it could take, without modifying them
+  std::vector<std::vector<std::pair<LeafContainerT*, float> > > candidates (helpers.size ());
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (std::ptrdiff_t i_helper = 0; i_helper < static_cast<std::ptrdiff_t> (helpers.size ()); ++i_helper)
+    helpers[i_helper]->findExpansionCandidates (candidates[i_helper]);
+
+  //Each voxel goes to the closest candidate supervoxel, the first one in the list on ties
+  std::vector<std::tuple<int, float, std::size_t, LeafContainerT*> > claims;
+  for (std::size_t i_helper = 0; i_helper < helpers.size (); ++i_helper)
+    for (const auto &candidate : candidates[i_helper])
+      claims.emplace_back (candidate.first->getData ().idx_, candidate.second, i_helper, candidate.first);
+  std::sort (claims.begin (), claims.end ());
+
+  for (std::size_t i_claim = 0; i_claim < claims.size (); ++i_claim)
+  {
+    if (i_claim > 0 && std::get<0> (claims[i_claim]) == std::get<0> (claims[i_claim - 1]))
+      continue;
+    LeafContainerT* leaf = std::get<3> (claims[i_claim]);
+    VoxelData& voxel = leaf->getData ();
+    if (voxel.owner_)
+      voxel.owner_->removeLeaf (leaf);
+    voxel.distance_ = std::get<1> (claims[i_claim]);
+    helpers[std::get<2> (claims[i_claim])]->addLeaf (leaf);
   }
+}
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::getHelperPointers (std::vector<SupervoxelHelper*> &helpers)
+{
+  helpers.clear ();
+  helpers.reserve (supervoxel_helpers_.size ());
+  for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+    helpers.push_back (&(*sv_itr));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -326,16 +406,25 @@ template <typename PointT> void
 pcl::SupervoxelClustering<PointT>::makeSupervoxels (std::map<std::uint32_t,typename Supervoxel<PointT>::Ptr > &supervoxel_clusters)
 {
   supervoxel_clusters.clear ();
-  for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+  std::vector<SupervoxelHelper*> helpers;
+  getHelperPointers (helpers);
+  std::vector<typename Supervoxel<PointT>::Ptr> supervoxels (helpers.size ());
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (std::ptrdiff_t i_helper = 0; i_helper < static_cast<std::ptrdiff_t> (helpers.size ()); ++i_helper)
   {
-    std::uint32_t label = sv_itr->getLabel ();
-    supervoxel_clusters[label].reset (new Supervoxel<PointT>);
-    sv_itr->getXYZ (supervoxel_clusters[label]->centroid_.x,supervoxel_clusters[label]->centroid_.y,supervoxel_clusters[label]->centroid_.z);
-    sv_itr->getRGB (supervoxel_clusters[label]->centroid_.rgba);
-    sv_itr->getNormal (supervoxel_clusters[label]->normal_);
-    sv_itr->getVoxels (supervoxel_clusters[label]->voxels_);
-    sv_itr->getNormals (supervoxel_clusters[label]->normals_);
+    const SupervoxelHelper* helper = helpers[i_helper];
+    typename Supervoxel<PointT>::Ptr supervoxel (new Supervoxel<PointT>);
+    helper->getXYZ (supervoxel->centroid_.x, supervoxel->centroid_.y, supervoxel->centroid_.z);
+    helper->getRGB (supervoxel->centroid_.rgba);
+    helper->getNormal (supervoxel->normal_);
+    helper->getVoxels (supervoxel->voxels_);
+    helper->getNormals (supervoxel->normals_);
+    supervoxels[i_helper] = supervoxel;
   }
+  for (std::size_t i_helper = 0; i_helper < helpers.size (); ++i_helper)
+    supervoxel_clusters[helpers[i_helper]->getLabel ()] = supervoxels[i_helper];
 }
 
 
@@ -391,6 +480,10 @@ pcl::SupervoxelClustering<PointT>::selectInitialSupervoxelSeeds (Indices &seed_i
     voxel_kdtree_ ->setInputCloud (voxel_centroid_cloud_);
   }
   
+#pragma omp parallel for \
+  num_threads(threads_) \
+  firstprivate(closest_index, distance) \
+  schedule(dynamic, 64)
   for (int i = 0; i < num_seeds; ++i)  
   {
     voxel_kdtree_->nearestKSearch (voxel_centers[i], 1, closest_index, distance);
@@ -404,14 +497,20 @@ pcl::SupervoxelClustering<PointT>::selectInitialSupervoxelSeeds (Indices &seed_i
   // This is 1/20th of the number of voxels which fit in a planar slice through search volume
   // Area of planar slice / area of voxel side. (Note: This is smaller than the value mentioned in the original paper)
   float min_points = 0.05f * (search_radius)*(search_radius) * 3.1415926536f  / (resolution_*resolution_);
-  for (const auto &index_orig : seed_indices_orig)
+  std::vector<char> keep_seed (seed_indices_orig.size (), 0);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  firstprivate(neighbors, sqr_distances) \
+  schedule(dynamic, 16)
+  for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (seed_indices_orig.size ()); ++i)
   {
-    int num = voxel_kdtree_->radiusSearch (index_orig, search_radius , neighbors, sqr_distances);
-    if ( num > min_points)
-    {
-      seed_indices.push_back (index_orig);
-    }
-    
+    int num = voxel_kdtree_->radiusSearch (seed_indices_orig[i], search_radius , neighbors, sqr_distances);
+    keep_seed[i] = (num > min_points);
+  }
+  for (std::size_t i = 0; i < seed_indices_orig.size (); ++i)
+  {
+    if (keep_seed[i])
+      seed_indices.push_back (seed_indices_orig[i]);
   }
  // std::cout << "Number of seed points after filtering="<<seed_points.size ()<<std::endl;
   
@@ -431,16 +530,27 @@ pcl::SupervoxelClustering<PointT>::reseedSupervoxels ()
   Indices closest_index;
   std::vector<float> distance;
   //Now go through each supervoxel, find voxel closest to its center, add it in
-  for (typename HelperListT::iterator sv_itr = supervoxel_helpers_.begin (); sv_itr != supervoxel_helpers_.end (); ++sv_itr)
+  std::vector<SupervoxelHelper*> helpers;
+  getHelperPointers (helpers);
+  Indices closest_indices (helpers.size ());
+#pragma omp parallel for \
+  num_threads(threads_) \
+  firstprivate(closest_index, distance) \
+  schedule(dynamic, 16)
+  for (std::ptrdiff_t i_helper = 0; i_helper < static_cast<std::ptrdiff_t> (helpers.size ()); ++i_helper)
   {
     PointT point;
-    sv_itr->getXYZ (point.x, point.y, point.z);
+    helpers[i_helper]->getXYZ (point.x, point.y, point.z);
     voxel_kdtree_->nearestKSearch (point, 1, closest_index, distance);
-    
-    LeafContainerT* seed_leaf = adjacency_octree_->at (closest_index[0]);
+    closest_indices[i_helper] = closest_index[0];
+  }
+
+  for (std::size_t i_helper = 0; i_helper < helpers.size (); ++i_helper)
+  {
+    LeafContainerT* seed_leaf = adjacency_octree_->at (closest_indices[i_helper]);
     if (seed_leaf)
     {
-      sv_itr->addLeaf (seed_leaf);
+      helpers[i_helper]->addLeaf (seed_leaf);
     }
     else
     {
@@ -678,6 +788,20 @@ pcl::SupervoxelClustering<PointT>::setUseSingleCameraTransform (bool val)
   use_single_camera_transform_ = val;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::SupervoxelClustering<PointT>::getMaxLabel () const
@@ -828,6 +952,28 @@ pcl::SupervoxelClustering<PointT>::SupervoxelHelper::expand ()
   }  
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::SupervoxelClustering<PointT>::SupervoxelHelper::findExpansionCandidates (std::vector<std::pair<LeafContainerT*, float> > &candidates) const
+{
+  candidates.clear ();
+  //For each leaf belonging to this supervoxel
+  for (auto leaf_itr = leaves_.cbegin (); leaf_itr != leaves_.cend (); ++leaf_itr)
+  {
+    //for each neighbor of the leaf
+    for (typename LeafContainerT::const_iterator neighb_itr=(*leaf_itr)->cbegin (); neighb_itr!=(*leaf_itr)->cend (); ++neighb_itr)
+    {
+      const VoxelData& neighbor_voxel = ((*neighb_itr)->getData ());
+      if (neighbor_voxel.owner_ == this)
+        continue;
+      //Only keep it if we are closer than its current owner
+      float dist = parent_->voxelDataDistance (centroid_, neighbor_voxel);
+      if (dist < neighbor_voxel.distance_)
+        candidates.emplace_back (*neighb_itr, dist);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::SupervoxelClustering<PointT>::SupervoxelHelper::refineNormals ()
@@ -54,6 +54,12 @@ namespace pcl
     * "Segmentation of point clouds using smoothness constraint"
     * by T. Rabbania, F. A. van den Heuvelb, G. Vosselmanc.
     * In addition to residual test, the possibility to test curvature is added.
+    *
+    * The nearest neighbours of all the points are searched in parallel (see \ref setNumberOfThreads) and stored
+    * in a compact neighbour graph, which is kept between segmentations: calling \ref extract again with
+    * different thresholds does not search the neighbours again, as long as the input cloud, the indices, the
+    * search method and the number of neighbours are unchanged. If the points of the input cloud are modified in
+    * place, call \ref setInputCloud again to discard the graph.
     * \ingroup segmentation
     */
   template <typename PointT, typename NormalT>
@@ -66,6 +72,7 @@ namespace pcl
       using Normal = pcl::PointCloud<NormalT>;
       using NormalPtr = typename Normal::Ptr;
       using PointCloud = pcl::PointCloud<PointT>;
+      using PointCloudConstPtr = typename PointCloud::ConstPtr;
 
       using PCLBase <PointT>::input_;
       using PCLBase <PointT>::indices_;
@@ -83,6 +90,13 @@ namespace pcl
 
       ~RegionGrowing ();
 
+      /** \brief Provide a pointer to the input dataset. This discards the neighbour graph of the previous
+        * segmentations.
+        * \param[in] cloud the const boost shared pointer to a PointCloud message
+        */
+      void
+      setInputCloud (const PointCloudConstPtr &cloud) override;
+
       /** \brief Get the minimum number of points that a cluster needs to contain in order to be considered valid. */
       pcl::uindex_t
       getMinClusterSize ();
@@ -179,6 +193,12 @@ namespace pcl
       void
       setNumberOfNeighbours (unsigned int neighbour_number);
 
+      /** \brief Set the number of threads used to search the neighbours of the points. Default: 1
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief Returns the pointer to the search method that is used for KNN. */
       KdTreePtr
       getSearchMethod () const;
@@ -246,6 +266,14 @@ namespace pcl
       virtual void
       findPointNeighbours ();
 
+      /** \brief Search the nearest neighbours of all the points in parallel and store them in the neighbour
+        * graph, unless the graph built by a previous segmentation can be reused.
+        * \param[in] neighbour_number the number of nearest neighbours to search for each point
+        * \param[in] with_distances whether to store the squared distances to the neighbours as well
+        */
+      void
+      buildNeighbourGraph (unsigned int neighbour_number, bool with_distances);
+
       /** \brief This function implements the algorithm described in the article
         * "Segmentation of point clouds using smoothness constraint"
         * by T. Rabbania, F. A. van den Heuvelb, G. Vosselmanc.
@@ -311,8 +339,24 @@ namespace pcl
       /** \brief Contains normals of the points that will be segmented. */
       NormalPtr normals_;
 
-      /** \brief Contains neighbours of each point. */
-      std::vector<pcl::Indices> point_neighbours_;
+      /** \brief Contains neighbours of each point, in compressed sparse row layout: the neighbours of the
+        * point i are point_neighbours_[point_neighbour_offsets_[i]] to point_neighbours_[point_neighbour_offsets_[i + 1] - 1].
+        */
+      pcl::Indices point_neighbours_;
+
+      /** \brief Offsets of the neighbours of each point in point_neighbours_, with one more element than the input cloud. */
+      std::vector<std::size_t> point_neighbour_offsets_;
+
+      /** \brief Squared distances to the neighbours in point_neighbours_, if they were requested. */
+      std::vector<float> point_distances_;
+
+      /** \brief The indices, search method and number of neighbours the neighbour graph was built with. */
+      pcl::IndicesPtr graph_indices_;
+      KdTreePtr graph_search_;
+      unsigned int graph_neighbour_number_;
+
+      /** \brief Whether point_distances_ was filled along with the neighbour graph. */
+      bool graph_has_distances_;
 
       /** \brief Point labels that tells to which segment each point belongs. */
       std::vector<int> point_labels_;
@@ -331,6 +375,9 @@ namespace pcl
       /** \brief Stores the number of segments. */
       int number_of_segments_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
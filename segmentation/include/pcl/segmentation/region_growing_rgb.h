@@ -74,10 +74,13 @@ namespace pcl
       using RegionGrowing<PointT, NormalT>::theta_threshold_;
       using RegionGrowing<PointT, NormalT>::curvature_threshold_;
       using RegionGrowing<PointT, NormalT>::point_neighbours_;
+      using RegionGrowing<PointT, NormalT>::point_neighbour_offsets_;
+      using RegionGrowing<PointT, NormalT>::point_distances_;
       using RegionGrowing<PointT, NormalT>::point_labels_;
       using RegionGrowing<PointT, NormalT>::num_pts_in_segment_;
       using RegionGrowing<PointT, NormalT>::clusters_;
       using RegionGrowing<PointT, NormalT>::number_of_segments_;
+      using RegionGrowing<PointT, NormalT>::threads_;
       using RegionGrowing<PointT, NormalT>::applySmoothRegionGrowingAlgorithm;
       using RegionGrowing<PointT, NormalT>::assembleRegions;
 
@@ -186,8 +189,8 @@ namespace pcl
       bool
       prepareForSegmentation () override;
 
-      /** \brief This method finds KNN for each point and saves them to the array
-        * because the algorithm needs to find KNN a few times.
+      /** \brief This method finds KNN for each point, with their distances, and saves them to the
+        * neighbour graph because the algorithm needs to find KNN a few times.
         */
       void
       findPointNeighbours () override;
@@ -263,9 +266,6 @@ namespace pcl
       /** \brief Number of neighbouring segments to find. */
       unsigned int region_neighbour_number_;
 
-      /** \brief Stores distances for the point neighbours from point_neighbours_ */
-      std::vector< std::vector<float> > point_distances_;
-
       /** \brief Stores the neighboures for the corresponding segments. */
       std::vector< pcl::Indices > segment_neighbours_;
 
@@ -164,7 +164,7 @@ namespace pcl
 
       /** \brief Set the number of threads to use or turn off parallelization.
         * \param[in] nr_threads the number of hardware threads to use (0 sets the value automatically, a negative number turns parallelization off)
-        * \note Not all SAC methods have a parallel implementation. Some will ignore this setting.
+        * \note The segmentation is the same for any number of threads, see \ref pcl::SampleConsensus::setNumberOfThreads.
         */
       inline void
       setNumberOfThreads (const int nr_threads = -1) { threads_ = nr_threads; }
@@ -53,6 +53,9 @@
 #include <pcl/search/search.h>
 #include <boost/ptr_container/ptr_list.hpp> // for ptr_list
 
+#include <utility> // for pair
+#include <vector>
+
 
 
 //DEBUG TODO REMOVE
@@ -242,6 +245,18 @@ namespace pcl
       void
       setUseSingleCameraTransform (bool val);
 
+      /** \brief Set the number of threads to use. Default: 1
+       *  \note The voxel data, the seeds and the centroids are computed in parallel, with the same result as
+       *  with a single thread. With more than one thread, the supervoxels are also expanded in parallel,
+       *  synchronously: in each iteration, all supervoxels compete for the voxels adjacent to them as they were
+       *  at the start of the iteration, and every voxel goes to the closest one (the lowest label on ties).
+       *  The result does not depend on the number of threads, but can differ slightly from the single threaded
+       *  expansion, in which the supervoxels take voxels from each other one after the other.
+       *  \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+       */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
       /** \brief This method launches the segmentation algorithm and returns the supervoxels that were
        * obtained during the segmentation.
        * \param[out] supervoxel_clusters A map of labels to pointers to supervoxel structures
@@ -334,6 +349,14 @@ namespace pcl
       void
       expandSupervoxels (int depth);
 
+      /** \brief Expands all the supervoxels by one iteration in parallel, see \ref setNumberOfThreads */
+      void
+      expandSupervoxelsSynchronously ();
+
+      /** \brief Gets pointers to the supervoxel helpers, for parallel loops */
+      void
+      getHelperPointers (std::vector<SupervoxelHelper*> &helpers);
+
       /** \brief This sets the data of the voxels in the tree */
       void
       computeVoxelData ();
@@ -387,6 +410,9 @@ namespace pcl
       /** \brief Whether to use default transform behavior or not */
       bool use_default_transform_behaviour_;
 
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
       /** \brief Internal storage class for supervoxels
        * \note Stores pointers to leaves of clustering internal octree,
        * \note so should not be used outside of clustering class
@@ -427,6 +453,13 @@ namespace pcl
           void
           expand ();
 
+          /** \brief Finds the neighboring voxels this supervoxel is closer to than their current owner,
+           *  without taking them (used for the synchronous expansion)
+           *  \param[out] candidates the voxels and their distance to the centroid of this supervoxel
+           */
+          void
+          findExpansionCandidates (std::vector<std::pair<LeafContainerT*, float> > &candidates) const;
+
           void
           refineNormals ();
 
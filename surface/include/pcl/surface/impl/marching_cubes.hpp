@@ -41,12 +41,33 @@
 #include <pcl/common/vector_average.h>
 #include <pcl/Vertices.h>
 
+#include <limits>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT>
 pcl::MarchingCubes<PointNT>::~MarchingCubes ()
 {
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+#ifdef _OPENMP
+    threads_ = omp_get_num_procs ();
+#else
+    threads_ = 1;
+#endif
+  else
+    threads_ = nr_threads;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
 pcl::MarchingCubes<PointNT>::getBoundingBox ()
@@ -65,6 +86,28 @@ pcl::MarchingCubes<PointNT>::getBoundingBox ()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::initGrid ()
+{
+  bricks_.clear ();
+  grid_ = std::vector<float> (res_x_*res_y_*res_z_, NAN);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::initSparseGrid (const std::vector<bool> &used)
+{
+  bricks_.assign (used.size (), -1);
+  int nr_bricks = 0;
+  for (std::size_t i = 0; i < used.size (); ++i)
+    if (used[i])
+      bricks_[i] = nr_bricks++;
+  grid_ = std::vector<float> (static_cast<std::size_t> (nr_bricks) * brick_size_ * brick_size_ * brick_size_, NAN);
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
 pcl::MarchingCubes<PointNT>::interpolateEdge (Eigen::Vector3f &p1,
@@ -83,6 +126,18 @@ template <typename PointNT> void
 pcl::MarchingCubes<PointNT>::createSurface (const std::vector<float> &leaf_node,
                                             const Eigen::Vector3i &index_3d,
                                             pcl::PointCloud<PointNT> &cloud)
+{
+  std::vector<std::uint64_t> edges;
+  createSurface (leaf_node, index_3d, cloud, edges);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubes<PointNT>::createSurface (const std::vector<float> &leaf_node,
+                                            const Eigen::Vector3i &index_3d,
+                                            pcl::PointCloud<PointNT> &cloud,
+                                            std::vector<std::uint64_t> &edges)
 {
   int cubeindex = 0;
   if (leaf_node[0] < iso_level_) cubeindex |= 1;
@@ -146,16 +201,29 @@ pcl::MarchingCubes<PointNT>::createSurface (const std::vector<float> &leaf_node,
   if (edgeTable[cubeindex] & 2048)
     interpolateEdge (p[3], p[7], leaf_node[3], leaf_node[7], vertex_list[11]);
 
+  // Grid point (relative to index_3d) and axis of each edge of the cube
+  static const int edge_origin[12][4] = {
+    {0, 0, 0, 0}, {1, 0, 0, 2}, {0, 0, 1, 0}, {0, 0, 0, 2},
+    {0, 1, 0, 0}, {1, 1, 0, 2}, {0, 1, 1, 0}, {0, 1, 0, 2},
+    {0, 0, 0, 1}, {1, 0, 0, 1}, {1, 0, 1, 1}, {0, 0, 1, 1}
+  };
+
   // Create the triangle
   for (int i = 0; triTable[cubeindex][i] != -1; i += 3)
   {
-    PointNT p1, p2, p3;
-    p1.getVector3fMap () = vertex_list[triTable[cubeindex][i]];
-    cloud.push_back (p1);
-    p2.getVector3fMap () = vertex_list[triTable[cubeindex][i+1]];
-    cloud.push_back (p2);
-    p3.getVector3fMap () = vertex_list[triTable[cubeindex][i+2]];
-    cloud.push_back (p3);
+    for (int j = 0; j < 3; ++j)
+    {
+      const int edge = triTable[cubeindex][i+j];
+      PointNT p;
+      p.getVector3fMap () = vertex_list[edge];
+      cloud.push_back (p);
+
+      const std::uint64_t grid_index =
+        (static_cast<std::uint64_t> (index_3d[0] + edge_origin[edge][0]) * res_y_
+         + index_3d[1] + edge_origin[edge][1]) * res_z_
+        + index_3d[2] + edge_origin[edge][2];
+      edges.push_back (3 * grid_index + edge_origin[edge][3]);
+    }
   }
 }
 
@@ -199,7 +267,10 @@ pcl::MarchingCubes<PointNT>::getGridValue (Eigen::Vector3i pos)
   if (pos[2] < 0 || pos[2] >= res_z_)
     return -1.0f;
 
-  return grid_[pos[0]*res_y_*res_z_ + pos[1]*res_z_ + pos[2]];
+  const std::ptrdiff_t index = getGridIndex (pos[0], pos[1], pos[2]);
+  if (index < 0)
+    return (std::numeric_limits<float>::quiet_NaN ());
+  return grid_[index];
 }
 
 
@@ -232,44 +303,172 @@ pcl::MarchingCubes<PointNT>::performReconstruction (pcl::PointCloud<PointNT> &po
   // the point cloud really generated from Marching Cubes, prev intermediate_cloud_
   pcl::PointCloud<PointNT> intermediate_cloud;
 
-  // Create grid
-  grid_ = std::vector<float> (res_x_*res_y_*res_z_, NAN);
-
   // Compute bounding box and voxel size
   getBoundingBox ();
   size_voxel_ = (upper_boundary_ - lower_boundary_) 
     * Eigen::Array3f (res_x_, res_y_, res_z_).inverse ();
 
+  // Create grid
+  nr_bricks_x_ = (res_x_ + brick_size_ - 1) / brick_size_;
+  nr_bricks_y_ = (res_y_ + brick_size_ - 1) / brick_size_;
+  nr_bricks_z_ = (res_z_ + brick_size_ - 1) / brick_size_;
+  initGrid ();
+
   // Transform the point cloud into a voxel grid
   // This needs to be implemented in a child class
   voxelizeData ();
 
-  // preallocate memory assuming a hull. suppose 6 point per voxel
-  double size_reserve = std::min((double) intermediate_cloud.points.max_size (),
-      2.0 * 6.0 * (double) (res_y_*res_z_ + res_x_*res_z_ + res_x_*res_y_));
-  intermediate_cloud.reserve ((std::size_t) size_reserve);
-
-  for (int x = 1; x < res_x_-1; ++x)
+  // Extract the triangles of each slab of cells along x in parallel, along with the
+  // grid edge of each of their vertices
+  const int nr_slabs = std::max (res_x_ - 2, 0);
+  std::vector<pcl::PointCloud<PointNT> > slab_points (nr_slabs);
+  std::vector<std::vector<std::uint64_t> > slab_edges (nr_slabs);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (int slab = 0; slab < nr_slabs; ++slab)
+  {
+    std::vector<float> leaf_node;
     for (int y = 1; y < res_y_-1; ++y)
       for (int z = 1; z < res_z_-1; ++z)
       {
-        Eigen::Vector3i index_3d (x, y, z);
-        std::vector<float> leaf_node;
+        // The first corner of the cell is NaN in the bricks of a sparse grid which are not allocated
+        if (getGridIndex (slab + 1, y, z) < 0)
+        {
+          z = (z / brick_size_ + 1) * brick_size_ - 1;
+          continue;
+        }
+        Eigen::Vector3i index_3d (slab + 1, y, z);
         getNeighborList1D (leaf_node, index_3d);
         if (!leaf_node.empty ())
-          createSurface (leaf_node, index_3d, intermediate_cloud);
+          createSurface (leaf_node, index_3d, slab_points[slab], slab_edges[slab]);
       }
+  }
+
+  if (!merge_vertices_)
+  {
+    // Triangle soup: concatenate the slabs in order
+    std::size_t nr_points = 0;
+    for (const auto &cloud : slab_points)
+      nr_points += cloud.size ();
+    intermediate_cloud.reserve (nr_points);
+    for (const auto &cloud : slab_points)
+      intermediate_cloud.insert (intermediate_cloud.end (), cloud.begin (), cloud.end ());
+
+    points.swap (intermediate_cloud);
+
+    polygons.resize (points.size () / 3);
+    for (std::size_t i = 0; i < polygons.size (); ++i)
+    {
+      pcl::Vertices v;
+      v.vertices.resize (3);
+      for (int j = 0; j < 3; ++j)
+        v.vertices[j] = static_cast<int> (i) * 3 + j;
+      polygons[i] = v;
+    }
+    return;
+  }
+
+  // Welded mesh. First merge the vertices lying on the same edge within each slab.
+  std::vector<std::unordered_map<std::uint64_t, index_t> > slab_vertices (nr_slabs);
+  std::vector<pcl::Indices> slab_triangles (nr_slabs);
+  std::vector<pcl::Indices> slab_unique (nr_slabs);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (int slab = 0; slab < nr_slabs; ++slab)
+  {
+    const auto &edges = slab_edges[slab];
+    slab_triangles[slab].resize (edges.size ());
+    for (std::size_t i = 0; i < edges.size (); ++i)
+    {
+      const auto res = slab_vertices[slab].emplace (edges[i], static_cast<index_t> (slab_unique[slab].size ()));
+      if (res.second)
+        slab_unique[slab].push_back (static_cast<index_t> (i));
+      slab_triangles[slab][i] = res.first->second;
+    }
+  }
+
+  // The vertices on the plane between two slabs appear in both of them: the ones of
+  // the previous slab are kept. Number the vertices kept in each slab.
+  const std::uint64_t plane_size = static_cast<std::uint64_t> (res_y_) * res_z_;
+  std::vector<std::vector<bool> > slab_aliased (nr_slabs);
+  std::vector<std::size_t> slab_offset (nr_slabs + 1, 0);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (int slab = 0; slab < nr_slabs; ++slab)
+  {
+    auto &aliased = slab_aliased[slab];
+    aliased.resize (slab_unique[slab].size (), false);
+    std::size_t nr_kept = aliased.size ();
+    if (slab > 0)
+    {
+      for (std::size_t v = 0; v < aliased.size (); ++v)
+      {
+        // Shared vertices lie on the lower plane (x = slab + 1) along y or z
+        const std::uint64_t edge = slab_edges[slab][slab_unique[slab][v]];
+        if (edge % 3 != 0 && edge / 3 / plane_size == static_cast<std::uint64_t> (slab + 1) &&
+            slab_vertices[slab - 1].count (edge) != 0)
+        {
+          aliased[v] = true;
+          --nr_kept;
+        }
+      }
+    }
+    slab_offset[slab + 1] = nr_kept;
+  }
+  for (int slab = 0; slab < nr_slabs; ++slab)
+    slab_offset[slab + 1] += slab_offset[slab];
+
+  // Global index of the vertices kept in each slab, then of the merged ones
+  std::vector<pcl::Indices> slab_global (nr_slabs);
+  for (int slab = 0; slab < nr_slabs; ++slab)
+    slab_global[slab].resize (slab_unique[slab].size ());
+  intermediate_cloud.resize (slab_offset[nr_slabs]);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (int slab = 0; slab < nr_slabs; ++slab)
+  {
+    std::size_t next = slab_offset[slab];
+    for (std::size_t v = 0; v < slab_unique[slab].size (); ++v)
+    {
+      if (slab_aliased[slab][v])
+        continue;
+      intermediate_cloud[next] = slab_points[slab][slab_unique[slab][v]];
+      slab_global[slab][v] = static_cast<index_t> (next++);
+    }
+  }
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (int slab = 1; slab < nr_slabs; ++slab)
+  {
+    for (std::size_t v = 0; v < slab_unique[slab].size (); ++v)
+      if (slab_aliased[slab][v])
+        slab_global[slab][v] = slab_global[slab - 1][slab_vertices[slab - 1].at (slab_edges[slab][slab_unique[slab][v]])];
+  }
 
   points.swap (intermediate_cloud);
 
-  polygons.resize (points.size () / 3);
-  for (std::size_t i = 0; i < polygons.size (); ++i)
+  // Connectivity, with the triangles in the same order as the soup
+  std::vector<std::size_t> slab_first_triangle (nr_slabs + 1, 0);
+  for (int slab = 0; slab < nr_slabs; ++slab)
+    slab_first_triangle[slab + 1] = slab_first_triangle[slab] + slab_triangles[slab].size () / 3;
+  polygons.resize (slab_first_triangle[nr_slabs]);
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
+  for (int slab = 0; slab < nr_slabs; ++slab)
   {
-    pcl::Vertices v;
-    v.vertices.resize (3);
-    for (int j = 0; j < 3; ++j)
-      v.vertices[j] = static_cast<int> (i) * 3 + j;
-    polygons[i] = v;
+    for (std::size_t i = 0; i < slab_triangles[slab].size () / 3; ++i)
+    {
+      pcl::Vertices &v = polygons[slab_first_triangle[slab] + i];
+      v.vertices.resize (3);
+      for (int j = 0; j < 3; ++j)
+        v.vertices[j] = slab_global[slab][slab_triangles[slab][3 * i + j]];
+    }
   }
 }
 
@@ -38,6 +38,8 @@
 
 #include <pcl/surface/marching_cubes_hoppe.h>
 
+#include <limits>
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT>
 pcl::MarchingCubesHoppe<PointNT>::~MarchingCubesHoppe ()
@@ -45,40 +47,107 @@ pcl::MarchingCubesHoppe<PointNT>::~MarchingCubesHoppe ()
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointNT> void
+pcl::MarchingCubesHoppe<PointNT>::initGrid ()
+{
+  if (!sparse_grid_)
+  {
+    MarchingCubes<PointNT>::initGrid ();
+    return;
+  }
+
+  // The values further than sqrt (dist_ignore_) from the input points are ignored (see
+  // voxelizeData): allocate the bricks within that distance of a point. Without distance,
+  // allocate the bricks of the points and their neighbors.
+  const Eigen::Array3f margin = dist_ignore_ > 0.0f ?
+    Eigen::Array3f::Constant (std::sqrt (dist_ignore_)) :
+    Eigen::Array3f (size_voxel_ * static_cast<float> (brick_size_));
+  const Eigen::Array3i max_brick (nr_bricks_x_ - 1, nr_bricks_y_ - 1, nr_bricks_z_ - 1);
+  const Eigen::Array3f brick_extent = size_voxel_ * static_cast<float> (brick_size_);
+  std::vector<bool> used (static_cast<std::size_t> (nr_bricks_x_) * nr_bricks_y_ * nr_bricks_z_, false);
+  for (const auto &point : *input_)
+  {
+    if (!std::isfinite (point.x) || !std::isfinite (point.y) || !std::isfinite (point.z))
+      continue;
+    const Eigen::Array3f p = point.getArray3fMap () - lower_boundary_;
+    const Eigen::Array3i lo = ((p - margin) / brick_extent).floor ().template cast<int> ().max (0).min (max_brick);
+    const Eigen::Array3i hi = ((p + margin) / brick_extent).floor ().template cast<int> ().max (0).min (max_brick);
+    for (int x = lo[0]; x <= hi[0]; ++x)
+      for (int y = lo[1]; y <= hi[1]; ++y)
+        for (int z = lo[2]; z <= hi[2]; ++z)
+          used[(static_cast<std::size_t> (x) * nr_bricks_y_ + y) * nr_bricks_z_ + z] = true;
+  }
+  initSparseGrid (used);
+}
+
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointNT> void
 pcl::MarchingCubesHoppe<PointNT>::voxelizeData ()
 {
   const bool is_far_ignored = dist_ignore_ > 0.0f;
 
+  // Signed distance to the tangent plane of the nearest point, or NaN if ignored
+  const auto distance = [&] (int x, int y, int z, pcl::Indices &nn_indices, std::vector<float> &nn_sqr_dists)
+  {
+    const Eigen::Vector3f point = (lower_boundary_ + size_voxel_ * Eigen::Array3f (x, y, z)).matrix ();
+    PointNT p;
+
+    p.getVector3fMap () = point;
+
+    tree_->nearestKSearch (p, 1, nn_indices, nn_sqr_dists);
+
+    if (!is_far_ignored || nn_sqr_dists[0] < dist_ignore_)
+    {
+      const Eigen::Vector3f normal = (*input_)[nn_indices[0]].getNormalVector3fMap ();
+
+      if (!std::isnan (normal (0)) && normal.norm () > 0.5f)
+        return (normal.dot (point - (*input_)[nn_indices[0]].getVector3fMap ()));
+    }
+    return (std::numeric_limits<float>::quiet_NaN ());
+  };
+
+  if (!bricks_.empty ())
+  {
+    // Sparse grid: only fill the allocated bricks
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 64)
+    for (std::ptrdiff_t brick = 0; brick < static_cast<std::ptrdiff_t> (bricks_.size ()); ++brick)
+    {
+      if (bricks_[brick] < 0)
+        continue;
+      const int x0 = static_cast<int> (brick / (nr_bricks_y_ * nr_bricks_z_)) * brick_size_;
+      const int y0 = static_cast<int> (brick / nr_bricks_z_ % nr_bricks_y_) * brick_size_;
+      const int z0 = static_cast<int> (brick % nr_bricks_z_) * brick_size_;
+      pcl::Indices nn_indices (1, 0);
+      std::vector<float> nn_sqr_dists (1, 0.0f);
+
+      for (int x = x0; x < std::min (x0 + brick_size_, res_x_); ++x)
+        for (int y = y0; y < std::min (y0 + brick_size_, res_y_); ++y)
+          for (int z = z0; z < std::min (z0 + brick_size_, res_z_); ++z)
+            grid_[getGridIndex (x, y, z)] = distance (x, y, z, nn_indices, nn_sqr_dists);
+    }
+    return;
+  }
+
+  // Each slab along x is filled independently
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
   for (int x = 0; x < res_x_; ++x)
   {
     const int y_start = x * res_y_ * res_z_;
+    pcl::Indices nn_indices (1, 0);
+    std::vector<float> nn_sqr_dists (1, 0.0f);
 
     for (int y = 0; y < res_y_; ++y)
     {
       const int z_start = y_start + y * res_z_;
 
       for (int z = 0; z < res_z_; ++z)
-      {
-        pcl::Indices nn_indices (1, 0);
-        std::vector<float> nn_sqr_dists (1, 0.0f);
-        const Eigen::Vector3f point = (lower_boundary_ + size_voxel_ * Eigen::Array3f (x, y, z)).matrix ();
-        PointNT p;
-
-        p.getVector3fMap () = point;
-
-        tree_->nearestKSearch (p, 1, nn_indices, nn_sqr_dists);
-
-        if (!is_far_ignored || nn_sqr_dists[0] < dist_ignore_)
-        {
-          const Eigen::Vector3f normal = (*input_)[nn_indices[0]].getNormalVector3fMap ();
-
-          if (!std::isnan (normal (0)) && normal.norm () > 0.5f)
-            grid_[z_start + z] = normal.dot (
-                point - (*input_)[nn_indices[0]].getVector3fMap ());
-        }
-      }
+        grid_[z_start + z] = distance (x, y, z, nn_indices, nn_sqr_dists);
     }
   }
 }
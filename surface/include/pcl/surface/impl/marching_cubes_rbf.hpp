@@ -56,14 +56,16 @@ pcl::MarchingCubesRBF<PointNT>::voxelizeData ()
   Eigen::MatrixXd M (2*N, 2*N),
                   d (2*N, 1);
 
-  for (unsigned int row_i = 0; row_i < 2*N; ++row_i)
+#pragma omp parallel for \
+  num_threads(threads_)
+  for (int row_i = 0; row_i < static_cast<int> (2*N); ++row_i)
   {
     // boolean variable to determine whether we are in the off_surface domain for the rows
-    bool row_off = (row_i >= N);
-    for (unsigned int col_i = 0; col_i < 2*N; ++col_i)
+    bool row_off = (row_i >= static_cast<int> (N));
+    for (int col_i = 0; col_i < static_cast<int> (2*N); ++col_i)
     {
       // boolean variable to determine whether we are in the off_surface domain for the columns
-      bool col_off = (col_i >= N);
+      bool col_off = (col_i >= static_cast<int> (N));
       M (row_i, col_i) = kernel (Eigen::Vector3f ((*input_)[col_i%N].getVector3fMap ()).cast<double> () + Eigen::Vector3f ((*input_)[col_i%N].getNormalVector3fMap ()).cast<double> () * col_off * off_surface_epsilon_,
                                  Eigen::Vector3f ((*input_)[row_i%N].getVector3fMap ()).cast<double> () + Eigen::Vector3f ((*input_)[row_i%N].getNormalVector3fMap ()).cast<double> () * row_off * off_surface_epsilon_);
     }
@@ -87,6 +89,10 @@ pcl::MarchingCubesRBF<PointNT>::voxelizeData ()
     weights[i + N] = w (i + N, 0);
   }
 
+  // Each slab along x is filled independently
+#pragma omp parallel for \
+  num_threads(threads_) \
+  schedule(dynamic, 1)
   for (int x = 0; x < res_x_; ++x)
     for (int y = 0; y < res_y_; ++y)
       for (int z = 0; z < res_z_; ++z)
@@ -52,9 +52,8 @@
 #include <Eigen/Geometry> // for cross
 #include <Eigen/LU> // for inverse
 
-#ifdef _OPENMP
-#include <omp.h>
-#endif
+#include <algorithm> // for set_union, sort, unique
+#include <iterator> // for back_inserter
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
@@ -114,8 +113,6 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::process (PointCloudOut &output)
     // Initialize random number generator if necessary
     case (RANDOM_UNIFORM_DENSITY):
     {
-      std::random_device rd;
-      rng_.seed (rd());
       const double tmp = search_radius_ / 2.0;
       rng_uniform_distribution_.reset (new std::uniform_real_distribution<> (-tmp, tmp));
 
@@ -219,11 +216,16 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (pcl::index_
       }
       else
       {
+        // Seed the generator with the index of the query point, so that the samples do not
+        // depend on the thread processing it
+        pcl::detail::MLSRandomEngine rng (rng_seed_, static_cast<std::uint64_t> (index));
+        std::uniform_real_distribution<> rng_uniform_distribution (rng_uniform_distribution_->param ());
+
         // Sample the local plane
         for (int num_added = 0; num_added < num_points_to_add;)
         {
-          const double u = (*rng_uniform_distribution_) (rng_);
-          const double v = (*rng_uniform_distribution_) (rng_);
+          const double u = rng_uniform_distribution (rng);
+          const double v = rng_uniform_distribution (rng);
 
           // Check if inside circle; if not, try another coin flip
           if (u * u + v * v > search_radius_ * search_radius_ / 4)
@@ -286,80 +288,58 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performProcessing (PointCloudOut &
   // Compute the number of coefficients
   nr_coeff_ = (order_ + 1) * (order_ + 2) / 2;
 
-#ifdef _OPENMP
   // (Maximum) number of threads
   const unsigned int threads = threads_ == 0 ? 1 : threads_;
-  // Create temporaries for each thread in order to avoid synchronization
-  typename PointCloudOut::CloudVectorType projected_points (threads);
-  typename NormalCloud::CloudVectorType projected_points_normals (threads);
-  std::vector<PointIndices> corresponding_input_indices (threads);
-#endif
 
-  // For all points
+  // The points are processed in chunks, each with its own temporaries in order to avoid
+  // synchronization. The chunks are concatenated in order, so the output does not depend on
+  // the number of threads
+  const std::size_t chunk_size = 256;
+  const std::size_t nr_chunks = (indices_->size () + chunk_size - 1) / chunk_size;
+  typename PointCloudOut::CloudVectorType projected_points (nr_chunks);
+  typename NormalCloud::CloudVectorType projected_points_normals (nr_chunks);
+  std::vector<PointIndices> corresponding_input_indices (nr_chunks);
+
 #pragma omp parallel for \
-  default(none) \
-  shared(corresponding_input_indices, projected_points, projected_points_normals) \
-  schedule(dynamic,1000) \
+  schedule(dynamic, 1) \
   num_threads(threads)
-  for (int cp = 0; cp < static_cast<int> (indices_->size ()); ++cp)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
   {
     // Allocate enough space to hold the results of nearest neighbor searches
     // \note resize is irrelevant for a radiusSearch ().
     pcl::Indices nn_indices;
     std::vector<float> nn_sqr_dists;
 
-    // Get the initial estimates of point positions and their neighborhoods
-    if (searchForNeighbors ((*indices_)[cp], nn_indices, nn_sqr_dists))
+    // Dummy result, used when the MLS results are not cached
+    MLSResult mls_result;
+
+    const std::size_t chunk_end = (std::min) ((chunk + 1) * chunk_size, indices_->size ());
+    for (std::size_t cp = chunk * chunk_size; cp < chunk_end; ++cp)
     {
+      // Get the initial estimates of point positions and their neighborhoods
+      if (!searchForNeighbors ((*indices_)[cp], nn_indices, nn_sqr_dists))
+        continue;
+
       // Check the number of nearest neighbors for normal estimation (and later for polynomial fit as well)
-      if (nn_indices.size () >= 3)
-      {
-        // This thread's ID (range 0 to threads-1)
-#ifdef _OPENMP
-        const int tn = omp_get_thread_num ();
-        // Size of projected points before computeMLSPointNormal () adds points
-        std::size_t pp_size = projected_points[tn].size ();
-#else
-        PointCloudOut projected_points;
-        NormalCloud projected_points_normals;
-#endif
-
-        // Get a plane approximating the local surface's tangent and project point onto it
-        const int index = (*indices_)[cp];
-
-        std::size_t mls_result_index = 0;
-        if (cache_mls_results_)
-          mls_result_index = index; // otherwise we give it a dummy location.
-
-#ifdef _OPENMP
-        computeMLSPointNormal (index, nn_indices, projected_points[tn], projected_points_normals[tn], corresponding_input_indices[tn], mls_results_[mls_result_index]);
-
-        // Copy all information from the input cloud to the output points (not doing any interpolation)
-        for (std::size_t pp = pp_size; pp < projected_points[tn].size (); ++pp)
-          copyMissingFields ((*input_)[(*indices_)[cp]], projected_points[tn][pp]);
-#else
-        computeMLSPointNormal (index, nn_indices, projected_points, projected_points_normals, *corresponding_input_indices_, mls_results_[mls_result_index]);
-
-        // Append projected points to output
-        output.insert (output.end (), projected_points.begin (), projected_points.end ());
-        if (compute_normals_)
-          normals_->insert (normals_->end (), projected_points_normals.begin (), projected_points_normals.end ());
-#endif
-      }
+      if (nn_indices.size () < 3)
+        continue;
+
+      // Get a plane approximating the local surface's tangent and project point onto it
+      const int index = (*indices_)[cp];
+      computeMLSPointNormal (index, nn_indices, projected_points[chunk], projected_points_normals[chunk], corresponding_input_indices[chunk],
+                             cache_mls_results_ ? mls_results_[index] : mls_result);
     }
   }
 
-#ifdef _OPENMP
-  // Combine all threads' results into the output vectors
-  for (unsigned int tn = 0; tn < threads; ++tn)
+  // Combine all chunks' results into the output vectors
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
   {
-    output.insert (output.end (), projected_points[tn].begin (), projected_points[tn].end ());
+    output.insert (output.end (), projected_points[chunk].begin (), projected_points[chunk].end ());
     corresponding_input_indices_->indices.insert (corresponding_input_indices_->indices.end (),
-                                                  corresponding_input_indices[tn].indices.begin (), corresponding_input_indices[tn].indices.end ());
+                                                  corresponding_input_indices[chunk].indices.begin (), corresponding_input_indices[chunk].indices.end ());
     if (compute_normals_)
-      normals_->insert (normals_->end (), projected_points_normals[tn].begin (), projected_points_normals[tn].end ());
+      normals_->insert (normals_->end (), projected_points_normals[chunk].begin (), projected_points_normals[chunk].end ());
   }
-#endif
 
   // Perform the distinct-cloud or voxel-grid upsampling
   performUpsampling (output);
@@ -369,32 +349,10 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performProcessing (PointCloudOut &
 template <typename PointInT, typename PointOutT> void
 pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &output)
 {
-
   if (upsample_method_ == DISTINCT_CLOUD)
   {
     corresponding_input_indices_.reset (new PointIndices);
-    for (std::size_t dp_i = 0; dp_i < distinct_cloud_->size (); ++dp_i) // dp_i = distinct_point_i
-    {
-      // Distinct cloud may have nan points, skip them
-      if (!std::isfinite ((*distinct_cloud_)[dp_i].x))
-        continue;
-
-      // Get 3D position of point
-      //Eigen::Vector3f pos = (*distinct_cloud_)[dp_i].getVector3fMap ();
-      pcl::Indices nn_indices;
-      std::vector<float> nn_dists;
-      tree_->nearestKSearch ((*distinct_cloud_)[dp_i], 1, nn_indices, nn_dists);
-      const auto input_index = nn_indices.front ();
-
-      // If the closest point did not have a valid MLS fitting result
-      // OR if it is too far away from the sampled point
-      if (mls_results_[input_index].valid == false)
-        continue;
-
-      Eigen::Vector3d add_point = (*distinct_cloud_)[dp_i].getVector3fMap ().template cast<double> ();
-      MLSResult::MLSProjectionResults proj =  mls_results_[input_index].projectPoint (add_point, projection_method_,  5 * nr_coeff_);
-      addProjectedPointNormal (input_index, proj.point, proj.normal, mls_results_[input_index].curvature, output, *normals_, *corresponding_input_indices_);
-    }
+    projectToNearestMLSSurface (*distinct_cloud_, output);
   }
 
   // For the voxel grid upsampling method, generate the voxel grid and dilate it
@@ -403,24 +361,60 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &
   {
     corresponding_input_indices_.reset (new PointIndices);
 
-    MLSVoxelGrid voxel_grid (input_, indices_, voxel_size_);
+    const unsigned int threads = threads_ == 0 ? 1 : threads_;
+    MLSVoxelGrid voxel_grid (input_, indices_, voxel_size_, threads);
     for (int iteration = 0; iteration < dilation_iteration_num_; ++iteration)
       voxel_grid.dilate ();
 
-    for (typename MLSVoxelGrid::HashMap::iterator m_it = voxel_grid.voxel_grid_.begin (); m_it != voxel_grid.voxel_grid_.end (); ++m_it)
+    // Get the 3D positions of the voxels
+    PointCloudIn voxel_points;
+    voxel_points.resize (voxel_grid.voxel_grid_.size ());
+
+#pragma omp parallel for \
+  schedule(static) \
+  num_threads(threads)
+    for (std::ptrdiff_t i = 0; i < static_cast<std::ptrdiff_t> (voxel_points.size ()); ++i)
     {
-      // Get 3D position of point
       Eigen::Vector3f pos;
-      voxel_grid.getPosition (m_it->first, pos);
+      voxel_grid.getPosition (voxel_grid.voxel_grid_[i], pos);
+      voxel_points[i].x = pos[0];
+      voxel_points[i].y = pos[1];
+      voxel_points[i].z = pos[2];
+    }
+
+    projectToNearestMLSSurface (voxel_points, output);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MovingLeastSquares<PointInT, PointOutT>::projectToNearestMLSSurface (const PointCloudIn &query_points, PointCloudOut &output)
+{
+  const unsigned int threads = threads_ == 0 ? 1 : threads_;
+
+  // Same chunked scheme as performProcessing, the chunks are concatenated in order
+  const std::size_t chunk_size = 256;
+  const std::size_t nr_chunks = (query_points.size () + chunk_size - 1) / chunk_size;
+  typename PointCloudOut::CloudVectorType projected_points (nr_chunks);
+  typename NormalCloud::CloudVectorType projected_points_normals (nr_chunks);
+  std::vector<PointIndices> corresponding_input_indices (nr_chunks);
+
+#pragma omp parallel for \
+  schedule(dynamic, 1) \
+  num_threads(threads)
+  for (std::ptrdiff_t chunk = 0; chunk < static_cast<std::ptrdiff_t> (nr_chunks); ++chunk)
+  {
+    pcl::Indices nn_indices;
+    std::vector<float> nn_dists;
 
-      PointInT p;
-      p.x = pos[0];
-      p.y = pos[1];
-      p.z = pos[2];
+    const std::size_t chunk_end = (std::min) ((chunk + 1) * chunk_size, query_points.size ());
+    for (std::size_t qp = chunk * chunk_size; qp < chunk_end; ++qp)
+    {
+      // The query points may have nan points, skip them
+      if (!std::isfinite (query_points[qp].x))
+        continue;
 
-      pcl::Indices nn_indices;
-      std::vector<float> nn_dists;
-      tree_->nearestKSearch (p, 1, nn_indices, nn_dists);
+      tree_->nearestKSearch (query_points[qp], 1, nn_indices, nn_dists);
       const auto input_index = nn_indices.front ();
 
       // If the closest point did not have a valid MLS fitting result
@@ -428,11 +422,21 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::performUpsampling (PointCloudOut &
       if (mls_results_[input_index].valid == false)
         continue;
 
-      Eigen::Vector3d add_point = p.getVector3fMap ().template cast<double> ();
+      Eigen::Vector3d add_point = query_points[qp].getVector3fMap ().template cast<double> ();
       MLSResult::MLSProjectionResults proj = mls_results_[input_index].projectPoint (add_point, projection_method_,  5 * nr_coeff_);
-      addProjectedPointNormal (input_index, proj.point, proj.normal, mls_results_[input_index].curvature, output, *normals_, *corresponding_input_indices_);
+      addProjectedPointNormal (input_index, proj.point, proj.normal, mls_results_[input_index].curvature,
+                               projected_points[chunk], projected_points_normals[chunk], corresponding_input_indices[chunk]);
     }
   }
+
+  for (std::size_t chunk = 0; chunk < nr_chunks; ++chunk)
+  {
+    output.insert (output.end (), projected_points[chunk].begin (), projected_points[chunk].end ());
+    corresponding_input_indices_->indices.insert (corresponding_input_indices_->indices.end (),
+                                                  corresponding_input_indices[chunk].indices.begin (), corresponding_input_indices[chunk].indices.end ());
+    if (compute_normals_)
+      normals_->insert (normals_->end (), projected_points_normals[chunk].begin (), projected_points_normals[chunk].end ());
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -837,8 +841,9 @@ pcl::MLSResult::computeMLSSurface (const pcl::PointCloud<PointT> &cloud,
 template <typename PointInT, typename PointOutT>
 pcl::MovingLeastSquares<PointInT, PointOutT>::MLSVoxelGrid::MLSVoxelGrid (PointCloudInConstPtr& cloud,
                                                                           IndicesPtr &indices,
-                                                                          float voxel_size) :
-  voxel_grid_ (), data_size_ (), voxel_size_ (voxel_size)
+                                                                          float voxel_size,
+                                                                          unsigned int threads) :
+  voxel_grid_ (), data_size_ (), voxel_size_ (voxel_size), threads_ (threads == 0 ? 1 : threads)
 {
   pcl::getMinMax3D (*cloud, *indices, bounding_min_, bounding_max_);
 
@@ -846,45 +851,110 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::MLSVoxelGrid::MLSVoxelGrid (PointC
   const double max_size = (std::max) ((std::max)(bounding_box_size.x (), bounding_box_size.y ()), bounding_box_size.z ());
   // Put initial cloud in voxel grid
   data_size_ = static_cast<std::uint64_t> (1.5 * max_size / voxel_size_);
-  for (std::size_t i = 0; i < indices->size (); ++i)
-    if (std::isfinite ((*cloud)[(*indices)[i]].x))
-    {
-      Eigen::Vector3i pos;
-      getCellIndex ((*cloud)[(*indices)[i]].getVector3fMap (), pos);
 
-      std::uint64_t index_1d;
-      getIndexIn1D (pos, index_1d);
-      Leaf leaf;
-      voxel_grid_[index_1d] = leaf;
-    }
+  const std::size_t block_size = 4096;
+  std::vector<std::vector<std::uint64_t> > blocks ((indices->size () + block_size - 1) / block_size);
+
+#pragma omp parallel for \
+  schedule(static) \
+  num_threads(threads_)
+  for (std::ptrdiff_t block = 0; block < static_cast<std::ptrdiff_t> (blocks.size ()); ++block)
+  {
+    const std::size_t block_end = (std::min) ((block + 1) * block_size, indices->size ());
+    for (std::size_t i = block * block_size; i < block_end; ++i)
+      if (std::isfinite ((*cloud)[(*indices)[i]].x))
+      {
+        Eigen::Vector3i pos;
+        getCellIndex ((*cloud)[(*indices)[i]].getVector3fMap (), pos);
+
+        std::uint64_t index_1d;
+        getIndexIn1D (pos, index_1d);
+        blocks[block].push_back (index_1d);
+      }
+  }
+
+  setVoxels (blocks);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
 pcl::MovingLeastSquares<PointInT, PointOutT>::MLSVoxelGrid::dilate ()
 {
-  HashMap new_voxel_grid = voxel_grid_;
-  for (typename MLSVoxelGrid::HashMap::iterator m_it = voxel_grid_.begin (); m_it != voxel_grid_.end (); ++m_it)
+  // Each block holds the voxels of a range of the grid and all of their neighbors
+  const std::size_t block_size = 1024;
+  std::vector<std::vector<std::uint64_t> > blocks ((voxel_grid_.size () + block_size - 1) / block_size);
+
+#pragma omp parallel for \
+  schedule(static) \
+  num_threads(threads_)
+  for (std::ptrdiff_t block = 0; block < static_cast<std::ptrdiff_t> (blocks.size ()); ++block)
+  {
+    const std::size_t block_end = (std::min) ((block + 1) * block_size, voxel_grid_.size ());
+    blocks[block].reserve (27 * (block_end - block * block_size));
+    for (std::size_t i = block * block_size; i < block_end; ++i)
+    {
+      Eigen::Vector3i index;
+      getIndexIn3D (voxel_grid_[i], index);
+      blocks[block].push_back (voxel_grid_[i]);
+
+      // Now dilate all of its voxels
+      for (int x = -1; x <= 1; ++x)
+        for (int y = -1; y <= 1; ++y)
+          for (int z = -1; z <= 1; ++z)
+            if (x != 0 || y != 0 || z != 0)
+            {
+              Eigen::Vector3i new_index;
+              new_index = index + Eigen::Vector3i (x, y, z);
+
+              std::uint64_t index_1d;
+              getIndexIn1D (new_index, index_1d);
+              blocks[block].push_back (index_1d);
+            }
+    }
+  }
+
+  setVoxels (blocks);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::MovingLeastSquares<PointInT, PointOutT>::MLSVoxelGrid::setVoxels (std::vector<std::vector<std::uint64_t> > &blocks)
+{
+  if (blocks.empty ())
   {
-    Eigen::Vector3i index;
-    getIndexIn3D (m_it->first, index);
+    voxel_grid_.clear ();
+    return;
+  }
 
-    // Now dilate all of its voxels
-    for (int x = -1; x <= 1; ++x)
-      for (int y = -1; y <= 1; ++y)
-        for (int z = -1; z <= 1; ++z)
-          if (x != 0 || y != 0 || z != 0)
-          {
-            Eigen::Vector3i new_index;
-            new_index = index + Eigen::Vector3i (x, y, z);
+#pragma omp parallel for \
+  schedule(dynamic, 1) \
+  num_threads(threads_)
+  for (std::ptrdiff_t block = 0; block < static_cast<std::ptrdiff_t> (blocks.size ()); ++block)
+  {
+    std::sort (blocks[block].begin (), blocks[block].end ());
+    blocks[block].erase (std::unique (blocks[block].begin (), blocks[block].end ()), blocks[block].end ());
+  }
 
-            std::uint64_t index_1d;
-            getIndexIn1D (new_index, index_1d);
-            Leaf leaf;
-            new_voxel_grid[index_1d] = leaf;
-          }
+  // Merge the blocks pairwise, the result being in blocks[0]
+  for (std::size_t step = 1; step < blocks.size (); step *= 2)
+  {
+#pragma omp parallel for \
+  schedule(dynamic, 1) \
+  num_threads(threads_)
+    for (std::ptrdiff_t block = 0; block < static_cast<std::ptrdiff_t> (blocks.size () - step); block += 2 * step)
+    {
+      std::vector<std::uint64_t> merged;
+      merged.reserve (blocks[block].size () + blocks[block + step].size ());
+      std::set_union (blocks[block].begin (), blocks[block].end (),
+                      blocks[block + step].begin (), blocks[block + step].end (),
+                      std::back_inserter (merged));
+      blocks[block].swap (merged);
+      std::vector<std::uint64_t> ().swap (blocks[block + step]);
+    }
   }
-  voxel_grid_ = new_voxel_grid;
+
+  voxel_grid_.swap (blocks[0]);
+  blocks.clear ();
 }
 
 
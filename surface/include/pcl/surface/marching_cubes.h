@@ -39,6 +39,9 @@
 #include <pcl/pcl_macros.h>
 #include <pcl/surface/reconstruction.h>
 
+#include <cstddef>
+#include <cstdint>
+
 namespace pcl
 {
   /*
@@ -356,6 +359,9 @@ namespace pcl
     * Lorensen W.E., Cline H.E., "Marching cubes: A high resolution 3d surface construction algorithm",
     * SIGGRAPH '87
     *
+    * The grid is filled and the surface is extracted in slabs along the x axis, which are processed in
+    * parallel (see \ref setNumberOfThreads). The output does not depend on the number of threads.
+    *
     * \author Alexandru E. Ichim
     * \ingroup surface
     */
@@ -378,7 +384,9 @@ namespace pcl
       MarchingCubes (const float percentage_extend_grid = 0.0f,
                      const float iso_level = 0.0f) :
         percentage_extend_grid_ (percentage_extend_grid),
-        iso_level_ (iso_level) 
+        iso_level_ (iso_level),
+        merge_vertices_ (false),
+        threads_ (1)
       {
       }
 
@@ -433,10 +441,43 @@ namespace pcl
       getPercentageExtendGrid ()
       { return percentage_extend_grid_; }
 
+      /** \brief Set whether the vertices shared by adjacent triangles are merged.
+        * By default, every triangle has its own three vertices (a triangle soup). When set to true, the
+        * vertices lying on the same edge of the grid are merged, which gives a welded, indexed mesh with about
+        * six times fewer vertices.
+        * \param[in] merge_vertices true to merge the shared vertices
+        */
+      inline void
+      setMergeVertices (bool merge_vertices)
+      { merge_vertices_ = merge_vertices; }
+
+      /** \brief Get whether the vertices shared by adjacent triangles are merged. */
+      inline bool
+      getMergeVertices () const
+      { return merge_vertices_; }
+
+      /** \brief Set the number of threads used to fill the grid and extract the surface.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
     protected:
-      /** \brief The data structure storing the 3D grid */
+      /** \brief The data structure storing the 3D grid. If \a bricks_ is empty, the grid is dense and the value
+        * of (x, y, z) is at (x * res_y_ + y) * res_z_ + z. Otherwise it stores the allocated bricks one after
+        * the other. */
       std::vector<float> grid_;
 
+      /** \brief The number of grid points along each side of a brick of a sparse grid. */
+      int brick_size_ = 8;
+
+      /** \brief The number of bricks of a sparse grid along each axis. */
+      int nr_bricks_x_ = 0, nr_bricks_y_ = 0, nr_bricks_z_ = 0;
+
+      /** \brief For a sparse grid, the position of each brick in \a grid_ (in bricks), or -1 if the brick
+        * is not allocated, in which case all its values are NaN. Empty for a dense grid. */
+      std::vector<int> bricks_;
+
       /** \brief The grid resolution */
       int res_x_ = 32, res_y_ = 32, res_z_ = 32;
 
@@ -454,6 +495,43 @@ namespace pcl
       /** \brief The iso level to be extracted. */
       float iso_level_;
 
+      /** \brief Whether the vertices shared by adjacent triangles are merged. */
+      bool merge_vertices_;
+
+      /** \brief The number of threads the scheduler should use. */
+      unsigned int threads_;
+
+      /** \brief Allocate the grid, with all the values set to NaN. Called before \ref voxelizeData, once the
+        * bounding box and the voxel size are known. The default implementation allocates a dense grid.
+        */
+      virtual void
+      initGrid ();
+
+      /** \brief Allocate a sparse grid made of the bricks for which \a used is true, with all the values set to
+        * NaN.
+        * \param[in] used whether each brick is allocated, in the order of \a bricks_
+        */
+      void
+      initSparseGrid (const std::vector<bool> &used);
+
+      /** \brief Get the position in \a grid_ of the value at the given grid position.
+        * \param[in] x the position along the x-axis
+        * \param[in] y the position along the y-axis
+        * \param[in] z the position along the z-axis
+        * \return the position, or -1 if it lies in a brick which is not allocated
+        */
+      inline std::ptrdiff_t
+      getGridIndex (int x, int y, int z) const
+      {
+        if (bricks_.empty ())
+          return ((static_cast<std::ptrdiff_t> (x) * res_y_ + y) * res_z_ + z);
+        const int brick = bricks_[(static_cast<std::size_t> (x / brick_size_) * nr_bricks_y_ + y / brick_size_) * nr_bricks_z_ + z / brick_size_];
+        if (brick < 0)
+          return (-1);
+        return ((static_cast<std::ptrdiff_t> (brick) * brick_size_ + x % brick_size_) * brick_size_ * brick_size_
+                + (y % brick_size_) * brick_size_ + z % brick_size_);
+      }
+
       /** \brief Convert the point cloud into voxel data. 
         */
       virtual void
@@ -480,6 +558,19 @@ namespace pcl
                      const Eigen::Vector3i &index_3d,
                      pcl::PointCloud<PointNT> &cloud);
 
+      /** \brief Calculate out the corresponding polygons in the leaf node, and identify the grid edge on
+        * which each vertex lies.
+        * \param leaf_node the leaf node to be checked
+        * \param index_3d the 3d index of the leaf node to be checked
+        * \param cloud point cloud to store the vertices of the polygon
+        * \param edges the key of the grid edge of each vertex added to \a cloud
+        */
+      void
+      createSurface (const std::vector<float> &leaf_node,
+                     const Eigen::Vector3i &index_3d,
+                     pcl::PointCloud<PointNT> &cloud,
+                     std::vector<std::uint64_t> &edges);
+
       /** \brief Get the bounding box for the input data points. 
         */
       void
@@ -64,6 +64,14 @@ namespace pcl
       using MarchingCubes<PointNT>::size_voxel_;
       using MarchingCubes<PointNT>::upper_boundary_;
       using MarchingCubes<PointNT>::lower_boundary_;
+      using MarchingCubes<PointNT>::threads_;
+      using MarchingCubes<PointNT>::brick_size_;
+      using MarchingCubes<PointNT>::nr_bricks_x_;
+      using MarchingCubes<PointNT>::nr_bricks_y_;
+      using MarchingCubes<PointNT>::nr_bricks_z_;
+      using MarchingCubes<PointNT>::bricks_;
+      using MarchingCubes<PointNT>::getGridIndex;
+      using MarchingCubes<PointNT>::initSparseGrid;
 
       using PointCloudPtr = typename pcl::PointCloud<PointNT>::Ptr;
 
@@ -76,7 +84,8 @@ namespace pcl
                           const float percentage_extend_grid = 0.0f,
                           const float iso_level = 0.0f) :
         MarchingCubes<PointNT> (percentage_extend_grid, iso_level),
-        dist_ignore_ (dist_ignore)
+        dist_ignore_ (dist_ignore),
+        sparse_grid_ (false)
       {
       }
 
@@ -104,12 +113,39 @@ namespace pcl
       getDistanceIgnore () const
       { return dist_ignore_; }
 
+      /** \brief Set whether the grid is only allocated near the input points, as bricks of 8x8x8 values.
+        * The memory then grows with the area of the surface instead of the volume of the grid, which allows
+        * much higher resolutions.
+        *
+        * With a positive distance to ignore (see \ref setDistanceIgnore), the bricks cover all the grid
+        * points which are not ignored, and the surface is the same as with a dense grid. Otherwise, the
+        * bricks containing input points and their neighbors are allocated, and the surface is only extracted
+        * within them.
+        * \param[in] sparse_grid true to use a sparse grid. Default: false
+        */
+      inline void
+      setSparseGrid (bool sparse_grid)
+      { sparse_grid_ = sparse_grid; }
+
+      /** \brief Get whether the grid is only allocated near the input points. */
+      inline bool
+      getSparseGrid () const
+      { return sparse_grid_; }
+
     protected:
       /** \brief ignore the distance function
        * if it is negative
        * or distance between voxel centroid and point are larger that it. */
       float dist_ignore_;
 
+      /** \brief Whether the grid is only allocated near the input points. */
+      bool sparse_grid_;
+
+      /** \brief Allocate the bricks of the grid near the input points if \a sparse_grid_ is set, or the whole
+        * grid otherwise. */
+      void
+      initGrid () override;
+
     public:
       PCL_MAKE_ALIGNED_OPERATOR_NEW
   };
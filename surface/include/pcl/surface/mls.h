@@ -39,9 +39,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
-#include <map>
 #include <random>
+#include <vector>
 #include <Eigen/Core> // for Vector3i, Vector3d, ...
 
 // PCL includes
@@ -244,16 +245,56 @@ namespace pcl
 
   };
 
+  namespace detail
+  {
+    /** \brief Small random number engine for the RANDOM_UNIFORM_DENSITY upsampling of
+      * \ref MovingLeastSquares. The state is initialized with a splitmix64 hash of a seed and
+      * of the index of the query point, so each point gets its own stream without the cost of
+      * seeding a large engine.
+      */
+    class MLSRandomEngine
+    {
+      public:
+        using result_type = std::uint64_t;
+
+        MLSRandomEngine (std::uint64_t seed, std::uint64_t index) : state_ (mix (seed ^ mix (index))) {}
+
+        static constexpr result_type
+        min () { return (0); }
+
+        static constexpr result_type
+        max () { return (~result_type (0)); }
+
+        /** \brief Advance the state and return the next number of the splitmix64 sequence. */
+        inline result_type
+        operator() ()
+        {
+          state_ += 0x9E3779B97F4A7C15ull;
+          return (mix (state_));
+        }
+
+      private:
+        static inline std::uint64_t
+        mix (std::uint64_t z)
+        {
+          z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+          z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+          return (z ^ (z >> 31));
+        }
+
+        std::uint64_t state_;
+    };
+  }
+
   /** \brief MovingLeastSquares represent an implementation of the MLS (Moving Least Squares) algorithm
     * for data smoothing and improved normal estimation. It also contains methods for upsampling the
     * resulting cloud based on the parametric fit.
     * Reference paper: "Computing and Rendering Point Set Surfaces" by Marc Alexa, Johannes Behr,
     * Daniel Cohen-Or, Shachar Fleishman, David Levin and Claudio T. Silva
     * www.sci.utah.edu/~shachar/Publications/crpss.pdf
-    * \note There is a parallelized version of the processing step, using the OpenMP standard.
-    * Compared to the standard version, an overhead is incurred in terms of runtime and memory usage.
-    * The upsampling methods DISTINCT_CLOUD and VOXEL_GRID_DILATION are not parallelized completely,
-    * i.e. parts of the algorithm run on a single thread only.
+    * \note The processing step and all the upsampling methods are parallelized using the OpenMP
+    * standard (see \ref setNumberOfThreads). The points are processed in chunks whose results are
+    * concatenated in order, so the output does not depend on the number of threads.
     * \author Zoltan Csaba Marton, Radu B. Rusu, Alexandru E. Ichim, Suat Gedikli, Robert Huitl
     * \ingroup surface
     */
@@ -320,6 +361,7 @@ namespace pcl
                               voxel_size_ (1.0),
                               dilation_iteration_num_ (0),
                               nr_coeff_ (),
+                              rng_seed_ (std::random_device () ()),
                               rng_uniform_distribution_ ()
                               {};
 
@@ -441,6 +483,20 @@ namespace pcl
       inline int
       getPointDensity () const { return (desired_num_points_in_radius_); }
 
+      /** \brief Set the seed of the random samples, to get the same output on every call to process
+        * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling. By default the seed is
+        * drawn from std::random_device at construction.
+        * \param[in] seed the seed of the random samples
+        */
+      inline void
+      setRandomSeed (std::uint64_t seed) { rng_seed_ = seed; }
+
+      /** \brief Get the seed of the random samples
+        * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
+        */
+      inline std::uint64_t
+      getRandomSeed () const { return (rng_seed_); }
+
       /** \brief Set the voxel size for the voxel grid
         * \note Used only in the VOXEL_GRID_DILATION upsampling method
         * \param[in] voxel_size the edge length of a cubic voxel in the voxel grid
@@ -586,12 +642,18 @@ namespace pcl
       class MLSVoxelGrid
       {
         public:
-          struct Leaf { Leaf () : valid (true) {} bool valid; };
-
+          /** \brief Constructor, putting the points of the cloud in the voxel grid.
+            * \param[in] cloud the input cloud
+            * \param[in] indices the indices of the points to put in the voxel grid
+            * \param[in] voxel_size the size of the voxels
+            * \param[in] threads the number of threads used to build and dilate the voxel grid
+            */
           MLSVoxelGrid (PointCloudInConstPtr& cloud,
                         IndicesPtr &indices,
-                        float voxel_size);
+                        float voxel_size,
+                        unsigned int threads = 1);
 
+          /** \brief Add the 26 neighbors of all the voxels to the voxel grid. */
           void
           dilate ();
 
@@ -628,12 +690,21 @@ namespace pcl
               point[i] = static_cast<Eigen::Vector3f::Scalar> (index_3d[i]) * voxel_size_ + bounding_min_[i];
           }
 
-          typedef std::map<std::uint64_t, Leaf> HashMap;
-          HashMap voxel_grid_;
+          /** \brief The 1D indices of the occupied voxels, sorted and unique. */
+          std::vector<std::uint64_t> voxel_grid_;
           Eigen::Vector4f bounding_min_, bounding_max_;
           std::uint64_t data_size_;
           float voxel_size_;
+          unsigned int threads_;
           PCL_MAKE_ALIGNED_OPERATOR_NEW
+
+        private:
+          /** \brief Set the voxel grid to the union of blocks of 1D indices. The blocks are sorted
+            * and merged pairwise in parallel.
+            * \param[in,out] blocks the blocks of 1D indices, emptied on return
+            */
+          void
+          setVoxels (std::vector<std::vector<std::uint64_t> > &blocks);
       };
 
 
@@ -715,9 +786,20 @@ namespace pcl
       void
       performUpsampling (PointCloudOut &output);
 
+      /** \brief Project points onto the MLS surface of their nearest neighbor in the input cloud,
+        * in parallel, and append them to the output in order.
+        * \param[in] query_points the points to project (non-finite points are skipped)
+        * \param[out] output the result of the reconstruction
+        */
+      void
+      projectToNearestMLSSurface (const PointCloudIn &query_points, PointCloudOut &output);
+
     private:
-      /** \brief Random number generator algorithm. */
-      mutable std::mt19937 rng_;
+      /** \brief Seed of the random number generators, hashed with the index of each query point
+        * so that the samples do not depend on the thread processing the point.
+        * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
+        */
+      std::uint64_t rng_seed_;
 
       /** \brief Random number generator using an uniform distribution of floats
         * \note Used only in the case of RANDOM_UNIFORM_DENSITY upsampling
@@ -45,6 +45,8 @@
 #include <pcl/test/gtest.h>
 #include <pcl/point_cloud.h>
 #include <pcl/features/pfh.h>
+#include <pcl/features/pfh_omp.h>
+#include <pcl/features/pfh_tools.h>
 #include <pcl/features/fpfh.h>
 #include <pcl/features/fpfh_omp.h>
 #include <pcl/features/vfh.h>
@@ -259,6 +261,130 @@ TEST (PCL, PFHEstimation)
   (cloud, cloud, test_indices, 125);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PairFeaturesBatch)
+{
+  // The pairs between the first point and all the points of the cloud, in SoA form
+  const std::size_t nr_pairs = cloud->size () + 2;
+  std::vector<float> x, y, z, nx, ny, nz;
+  for (const auto &point : cloud->points)
+  {
+    x.push_back (point.x); y.push_back (point.y); z.push_back (point.z);
+    nx.push_back (point.normal_x); ny.push_back (point.normal_y); nz.push_back (point.normal_z);
+  }
+  // Degenerate pair: the second point is along the normal of the first one
+  const Eigen::Vector4f p1 = (*cloud)[0].getVector4fMap ();
+  const Eigen::Vector4f n1 (0.0f, 0.0f, 1.0f, 0.0f);
+  x.push_back (p1[0]); y.push_back (p1[1]); z.push_back (p1[2] + 0.5f);
+  nx.push_back (1.0f); ny.push_back (0.0f); nz.push_back (0.0f);
+  // Degenerate pair: both points are equal
+  x.push_back (p1[0]); y.push_back (p1[1]); z.push_back (p1[2]);
+  nx.push_back (1.0f); ny.push_back (0.0f); nz.push_back (0.0f);
+
+  std::vector<float> f1 (nr_pairs), f2 (nr_pairs), f3 (nr_pairs), f4 (nr_pairs);
+  std::vector<std::uint8_t> valid (nr_pairs);
+  for (const Eigen::Vector4f &normal : {Eigen::Vector4f ((*cloud)[0].getNormalVector4fMap ()), n1})
+  {
+    const std::size_t nr_valid = pcl::computePairFeatures (p1, normal, x.data (), y.data (), z.data (),
+                                                           nx.data (), ny.data (), nz.data (), nr_pairs,
+                                                           f1.data (), f2.data (), f3.data (), f4.data (), valid.data ());
+
+    std::size_t nr_expected_valid = 0;
+    for (std::size_t i = 0; i < nr_pairs; ++i)
+    {
+      float g1, g2, g3, g4;
+      const bool ok = pcl::computePairFeatures (p1, normal, Eigen::Vector4f (x[i], y[i], z[i], 1.0f),
+                                                Eigen::Vector4f (nx[i], ny[i], nz[i], 0.0f), g1, g2, g3, g4);
+      nr_expected_valid += ok;
+      ASSERT_EQ (valid[i], ok) << "pair " << i;
+      EXPECT_NEAR (f1[i], g1, 1e-5) << "pair " << i;
+      EXPECT_NEAR (f2[i], g2, 1e-5) << "pair " << i;
+      EXPECT_NEAR (f3[i], g3, 1e-5) << "pair " << i;
+      EXPECT_NEAR (f4[i], g4, 1e-6) << "pair " << i;
+    }
+    EXPECT_EQ (nr_valid, nr_expected_valid);
+  }
+  // The first point with itself, and the two degenerate pairs
+  EXPECT_FALSE (valid[0]);
+  EXPECT_FALSE (valid[nr_pairs - 2]);
+  EXPECT_FALSE (valid[nr_pairs - 1]);
+
+  // All the SIMD instruction sets supported by the CPU give the same features
+  const auto previous = pcl::getPairFeaturesSimdLevel ();
+  const Eigen::Vector4f n1_cloud = (*cloud)[0].getNormalVector4fMap ();
+  pcl::setPairFeaturesSimdLevel (pcl::PairFeaturesSimdLevel::SSE2);
+  pcl::computePairFeatures (p1, n1_cloud, x.data (), y.data (), z.data (), nx.data (), ny.data (), nz.data (), nr_pairs,
+                            f1.data (), f2.data (), f3.data (), f4.data (), valid.data ());
+  for (const auto level : {pcl::PairFeaturesSimdLevel::AVX, pcl::PairFeaturesSimdLevel::AVX512})
+  {
+    std::vector<float> g1 (nr_pairs), g2 (nr_pairs), g3 (nr_pairs), g4 (nr_pairs);
+    std::vector<std::uint8_t> g_valid (nr_pairs);
+    pcl::setPairFeaturesSimdLevel (level);
+    pcl::computePairFeatures (p1, n1_cloud, x.data (), y.data (), z.data (), nx.data (), ny.data (), nz.data (), nr_pairs,
+                              g1.data (), g2.data (), g3.data (), g4.data (), g_valid.data ());
+    EXPECT_EQ (g1, f1);
+    EXPECT_EQ (g2, f2);
+    EXPECT_EQ (g3, f3);
+    EXPECT_EQ (g4, f4);
+    EXPECT_EQ (g_valid, valid);
+  }
+  pcl::setPairFeaturesSimdLevel (previous);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PFHEstimationOMP)
+{
+  using pcl::PFHSignature125;
+
+  pcl::IndicesPtr indicesptr (new pcl::Indices (indices));
+
+  // Reference features, without and with the internal cache
+  PointCloud<PFHSignature125> pfhs, pfhs_cache;
+  pcl::PFHEstimation<PointT, PointT, PFHSignature125> pfh;
+  pfh.setInputCloud (cloud);
+  pfh.setInputNormals (cloud);
+  pfh.setIndices (indicesptr);
+  pfh.setSearchMethod (tree);
+  pfh.setKSearch (10);
+  pfh.compute (pfhs);
+  pfh.setUseInternalCache (true);
+  pfh.compute (pfhs_cache);
+
+  for (const unsigned int nr_threads : {1u, 4u})
+  {
+    for (const bool use_cache : {false, true})
+    {
+      pcl::PFHEstimationOMP<PointT, PointT, PFHSignature125> pfh_omp (nr_threads);
+      pfh_omp.setInputCloud (cloud);
+      pfh_omp.setInputNormals (cloud);
+      pfh_omp.setIndices (indicesptr);
+      pfh_omp.setSearchMethod (tree);
+      pfh_omp.setKSearch (10);
+      pfh_omp.setUseInternalCache (use_cache);
+      // A small cache, to exercise the eviction of pairs
+      pfh_omp.setMaximumCacheSize (1000);
+
+      PointCloud<PFHSignature125> pfhs_omp;
+      pfh_omp.compute (pfhs_omp);
+      ASSERT_EQ (pfhs_omp.size (), pfhs.size ());
+      EXPECT_EQ (pfhs_omp.is_dense, pfhs.is_dense);
+
+      const PointCloud<PFHSignature125> &reference = use_cache ? pfhs_cache : pfhs;
+      for (std::size_t i = 0; i < pfhs_omp.size (); ++i)
+        for (int d = 0; d < 125; ++d)
+          ASSERT_EQ (pfhs_omp[i].histogram[d], reference[i].histogram[d]);
+    }
+  }
+
+  // Test results when setIndices and/or setSearchSurface are used
+  pcl::IndicesPtr test_indices (new pcl::Indices (0));
+  for (std::size_t i = 0; i < cloud->size (); i+=3)
+    test_indices->push_back (static_cast<int> (i));
+
+  testIndicesAndSearchSurface<pcl::PFHEstimationOMP, PointT, PointT, PFHSignature125>
+  (cloud, cloud, test_indices, 125);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 using pcl::FPFHEstimation;
@@ -720,6 +720,48 @@ TEST (VoxelGrid, Filters)
   EXPECT_LE (output[neighbors2.at (0)].z - output[centroidIdx2].z, 0.02 * 2);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGrid_Parallel, Filters)
+{
+  PointCloud<PointXYZ> output_serial, output_parallel;
+  VoxelGrid<PointXYZ> grid;
+
+  grid.setLeafSize (0.005f, 0.005f, 0.005f);
+  grid.setInputCloud (cloud);
+  grid.setSaveLeafLayout (true);
+  grid.filter (output_serial);
+  const std::vector<int> leaf_layout_serial = grid.getLeafLayout ();
+
+  grid.setNumberOfThreads (4);
+  EXPECT_EQ (grid.getNumberOfThreads (), 4);
+  grid.filter (output_parallel);
+
+  // The parallel filter has to produce exactly the same centroids, in the same order
+  ASSERT_EQ (output_parallel.size (), output_serial.size ());
+  for (std::size_t i = 0; i < output_serial.size (); ++i)
+  {
+    EXPECT_EQ (output_parallel[i].x, output_serial[i].x);
+    EXPECT_EQ (output_parallel[i].y, output_serial[i].y);
+    EXPECT_EQ (output_parallel[i].z, output_serial[i].z);
+  }
+  EXPECT_EQ (grid.getLeafLayout (), leaf_layout_serial);
+
+  grid.setFilterFieldName ("z");
+  grid.setFilterLimits (0.05, 0.1);
+  grid.setDownsampleAllData (false);
+  grid.filter (output_parallel);
+  grid.setNumberOfThreads (1);
+  grid.filter (output_serial);
+
+  ASSERT_EQ (output_parallel.size (), output_serial.size ());
+  for (std::size_t i = 0; i < output_serial.size (); ++i)
+  {
+    EXPECT_EQ (output_parallel[i].x, output_serial[i].x);
+    EXPECT_EQ (output_parallel[i].y, output_serial[i].y);
+    EXPECT_EQ (output_parallel[i].z, output_serial[i].z);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (VoxelGrid_No_DownsampleAllData, Filters)
 {
@@ -1325,6 +1367,58 @@ TEST (VoxelGridCovariance, Filters)
   EXPECT_NEAR (leaves[2]->getMean ()[2], 0.0508024, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGridCovariance_Parallel, Filters)
+{
+  PointCloud<PointXYZ> output_serial, output_parallel;
+  VoxelGridCovariance<PointXYZ> grid_serial, grid_parallel;
+
+  grid_serial.setLeafSize (0.02f, 0.02f, 0.02f);
+  grid_serial.setInputCloud (cloud);
+  grid_serial.filter (output_serial, true);
+
+  grid_parallel.setLeafSize (0.02f, 0.02f, 0.02f);
+  grid_parallel.setInputCloud (cloud);
+  grid_parallel.setNumberOfThreads (4);
+  grid_parallel.filter (output_parallel, true);
+
+  ASSERT_EQ (output_parallel.size (), output_serial.size ());
+  for (std::size_t i = 0; i < output_serial.size (); ++i)
+  {
+    EXPECT_EQ (output_parallel[i].x, output_serial[i].x);
+    EXPECT_EQ (output_parallel[i].y, output_serial[i].y);
+    EXPECT_EQ (output_parallel[i].z, output_serial[i].z);
+  }
+
+  // The leaves are stored in increasing voxel index order and can be looked up by voxel index
+  const auto &leaves_serial = grid_serial.getLeaves ();
+  const auto &leaves_parallel = grid_parallel.getLeaves ();
+  ASSERT_EQ (leaves_parallel.size (), leaves_serial.size ());
+  std::size_t previous_index = 0;
+  for (auto it = leaves_serial.begin (); it != leaves_serial.end (); ++it)
+  {
+    if (it != leaves_serial.begin ())
+      EXPECT_LT (previous_index, it->first);
+    previous_index = it->first;
+
+    const auto leaf = leaves_parallel.find (it->first);
+    ASSERT_NE (leaf, leaves_parallel.end ());
+    EXPECT_EQ (leaf->second.getPointCount (), it->second.getPointCount ());
+    EXPECT_EQ (leaf->second.getMean (), it->second.getMean ());
+    EXPECT_EQ (leaf->second.getCov (), it->second.getCov ());
+    EXPECT_EQ (grid_parallel.getLeaf (static_cast<int> (it->first)), &leaf->second);
+  }
+  EXPECT_EQ (leaves_parallel.find (std::numeric_limits<std::size_t>::max ()), leaves_parallel.end ());
+
+  std::vector<VoxelGridCovariance<PointXYZ>::LeafConstPtr> leaves;
+  std::vector<float> distances;
+  grid_parallel.nearestKSearch (PointXYZ (0, 1, 0), 1, leaves, distances);
+  ASSERT_EQ (leaves.size (), 1);
+  EXPECT_NEAR (leaves[0]->getMean ()[0], -0.0284687, 1e-4);
+  EXPECT_NEAR (leaves[0]->getMean ()[1], 0.170919, 1e-4);
+  EXPECT_NEAR (leaves[0]->getMean ()[2], -0.00765753, 1e-4);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (VoxelGridMinPoints, Filters)
 {
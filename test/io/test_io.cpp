@@ -45,6 +45,7 @@
 #include <pcl/console/print.h>
 #include <pcl/io/auto_io.h>
 #include <pcl/io/pcd_io.h>
+#include <pcl/io/pcd_stream.h>
 #include <pcl/io/ply_io.h>
 #include <pcl/io/ascii_io.h>
 #include <pcl/io/obj_io.h>
@@ -732,6 +733,291 @@ TEST (PCL, PCDReaderWriter)
   remove ("test_pcl_io.pcd");
 }
 
+TEST (PCL, PCDReaderView)
+{
+  PointCloud<PointXYZI> cloud;
+  cloud.width  = 64;
+  cloud.height = 48;
+  cloud.resize (cloud.width * cloud.height);
+  cloud.sensor_origin_ = Eigen::Vector4f (1.0f, 2.0f, 3.0f, 0.0f);
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    cloud[i].x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].intensity = static_cast<float> (i);
+  }
+
+  // Write the cloud with the padding of the point type, so that the layout matches
+  pcl::PCLPointCloud2 cloud_blob;
+  toPCLPointCloud2 (cloud, cloud_blob);
+  PCDWriter writer;
+  writer.writeBinary ("test_pcl_io_view.pcd", cloud_blob, cloud.sensor_origin_);
+  std::ifstream fs ("test_pcl_io_view.pcd", std::ios::binary);
+  const std::string file_content ((std::istreambuf_iterator<char> (fs)), std::istreambuf_iterator<char> ());
+  fs.close ();
+
+  // The writer pads the header, so that the points are aligned and can be mapped. With a
+  // prefix in front of the file, they are misaligned and copied instead.
+  PCDReader reader;
+  for (int prefix = 0; prefix < static_cast<int> (alignof (PointXYZI)); ++prefix)
+  {
+    std::ofstream ofs ("test_pcl_io_view_offset.pcd", std::ios::binary);
+    ofs << std::string (prefix, ' ') << file_content;
+    ofs.close ();
+
+    PointCloudView<PointXYZI> view;
+    ASSERT_EQ (0, reader.readView ("test_pcl_io_view_offset.pcd", view, prefix));
+    EXPECT_EQ (prefix == 0, view.isMapped ());
+    EXPECT_EQ (cloud.width, view.width);
+    EXPECT_EQ (cloud.height, view.height);
+    ASSERT_EQ (cloud.size (), view.size ());
+    EXPECT_EQ (cloud.sensor_origin_, view.sensor_origin_);
+    for (std::size_t i = 0; i < cloud.size (); ++i)
+    {
+      EXPECT_EQ (cloud[i].x, view[i].x);
+      EXPECT_EQ (cloud[i].y, view[i].y);
+      EXPECT_EQ (cloud[i].z, view[i].z);
+      EXPECT_EQ (cloud[i].intensity, view[i].intensity);
+    }
+  }
+
+  // The writer of point clouds, which packs the fields, pads the header too
+  {
+    pcl::PCLPointCloud2 blob;
+    Eigen::Vector4f origin;
+    Eigen::Quaternionf orientation;
+    int pcd_version, data_type;
+    unsigned int data_idx;
+    writer.writeBinary ("test_pcl_io_view_offset.pcd", cloud);
+    ASSERT_EQ (0, reader.readHeader ("test_pcl_io_view_offset.pcd", blob, origin, orientation, pcd_version, data_type, data_idx));
+    EXPECT_EQ (0u, data_idx % 64);
+    writer.writeBinary ("test_pcl_io_view_offset.pcd", cloud, Indices {3, 1, 4, 1, 5});
+    ASSERT_EQ (0, reader.readHeader ("test_pcl_io_view_offset.pcd", blob, origin, orientation, pcd_version, data_type, data_idx));
+    EXPECT_EQ (0u, data_idx % 64);
+    PointCloud<PointXYZI> cloud_in;
+    ASSERT_EQ (0, reader.read ("test_pcl_io_view_offset.pcd", cloud_in));
+    ASSERT_EQ (5u, cloud_in.size ());
+    EXPECT_EQ (cloud[5].intensity, cloud_in[4].intensity);
+  }
+
+  // The view keeps the points alive when copied, and can be turned into a cloud
+  PointCloudView<PointXYZI> view;
+  {
+    PointCloudView<PointXYZI> tmp_view;
+    ASSERT_EQ (0, pcl::io::loadPCDFile ("test_pcl_io_view.pcd", tmp_view));
+    view = tmp_view;
+  }
+  const PointCloud<PointXYZI> cloud_copy = view.toPointCloud ();
+  ASSERT_EQ (cloud.size (), cloud_copy.size ());
+  EXPECT_EQ (cloud.back ().intensity, cloud_copy.back ().intensity);
+  EXPECT_EQ (cloud.back ().intensity, view.at (cloud.width - 1, cloud.height - 1).intensity);
+
+  // A different layout requires a conversion, be it another point type or packed fields
+  PointCloudView<PointXYZ> view_xyz;
+  ASSERT_EQ (0, reader.readView ("test_pcl_io_view.pcd", view_xyz));
+  EXPECT_FALSE (view_xyz.isMapped ());
+  ASSERT_EQ (cloud.size (), view_xyz.size ());
+  EXPECT_EQ (cloud.back ().z, view_xyz.back ().z);
+
+  writer.writeBinary ("test_pcl_io_view.pcd", cloud);
+  ASSERT_EQ (0, reader.readView ("test_pcl_io_view.pcd", view));
+  EXPECT_FALSE (view.isMapped ());
+  ASSERT_EQ (cloud.size (), view.size ());
+  EXPECT_EQ (cloud.back ().intensity, view.back ().intensity);
+
+  // So do ASCII files
+  writer.writeASCII ("test_pcl_io_view.pcd", cloud);
+  ASSERT_EQ (0, reader.readView ("test_pcl_io_view.pcd", view));
+  EXPECT_FALSE (view.isMapped ());
+  ASSERT_EQ (cloud.size (), view.size ());
+  EXPECT_FLOAT_EQ (cloud.back ().x, view.back ().x);
+
+  remove ("test_pcl_io_view.pcd");
+  remove ("test_pcl_io_view_offset.pcd");
+}
+
+TEST (PCL, PCDReaderWriterChunked)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width  = 64;
+  cloud.height = 50;
+  cloud.resize (cloud.width * cloud.height);
+  cloud.is_dense = false;
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    cloud[i].x = static_cast<float> (i % 64);
+    cloud[i].y = static_cast<float> (i / 64);
+    cloud[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].rgba = static_cast<std::uint32_t> (i * 97);
+    cloud[i].normal_x = cloud[i].normal_y = 0.0f;
+    cloud[i].normal_z = 1.0f;
+    cloud[i].curvature = static_cast<float> (i);
+  }
+  cloud[1000].z = std::numeric_limits<float>::quiet_NaN ();
+
+  const auto expectEqual = [&cloud] (const PointCloud<PointXYZRGBNormal> &res, std::size_t begin)
+  {
+    for (std::size_t i = 0; i < res.size (); ++i)
+    {
+      const auto &p = cloud[begin + i];
+      if (std::isnan (p.z))
+        EXPECT_TRUE (std::isnan (res[i].z));
+      else
+        EXPECT_EQ (res[i].z, p.z);
+      EXPECT_EQ (res[i].x, p.x);
+      EXPECT_EQ (res[i].y, p.y);
+      EXPECT_EQ (res[i].rgba, p.rgba);
+      EXPECT_EQ (res[i].normal_z, p.normal_z);
+      EXPECT_EQ (res[i].curvature, p.curvature);
+    }
+  };
+
+  PCDWriter writer;
+  PCDReader reader;
+  // Parallelism is opt-in
+  EXPECT_EQ (1u, writer.getNumberOfThreads ());
+  EXPECT_EQ (1u, reader.getNumberOfThreads ());
+  for (const uindex_t chunk_size : {1u, 100u, 1000u, 3200u, 65536u})
+  {
+    for (const unsigned int nr_threads : {1u, 4u})
+    {
+      writer.setChunkSize (chunk_size);
+      writer.setNumberOfThreads (nr_threads);
+      reader.setNumberOfThreads (nr_threads);
+      ASSERT_EQ (writer.writeBinaryCompressedChunked ("test_pcl_io_chunked.pcd", cloud), 0);
+
+      // Whole cloud
+      PointCloud<PointXYZRGBNormal> res;
+      ASSERT_EQ (reader.read ("test_pcl_io_chunked.pcd", res), 0);
+      EXPECT_EQ (res.width, cloud.width);
+      EXPECT_EQ (res.height, cloud.height);
+      EXPECT_FALSE (res.is_dense);
+      ASSERT_EQ (res.size (), cloud.size ());
+      expectEqual (res, 0);
+
+      // Ranges within a chunk and over chunk boundaries
+      for (const auto &range : {std::make_pair (0u, 1u), std::make_pair (999u, 1001u),
+                                std::make_pair (1500u, 3200u), std::make_pair (3100u, 5000u)})
+      {
+        ASSERT_EQ (reader.readRange ("test_pcl_io_chunked.pcd", res, range.first, range.second), 0);
+        EXPECT_EQ (res.height, 1);
+        ASSERT_EQ (res.size (), std::min<std::size_t> (range.second, cloud.size ()) - range.first);
+        expectEqual (res, range.first);
+      }
+    }
+  }
+
+  // The other formats support ranges too
+  PointCloud<PointXYZRGBNormal> res;
+  writer.writeBinary ("test_pcl_io_chunked.pcd", cloud);
+  ASSERT_EQ (reader.readRange ("test_pcl_io_chunked.pcd", res, 999, 1001), 0);
+  ASSERT_EQ (res.size (), 2);
+  expectEqual (res, 999);
+  writer.writeBinaryCompressed ("test_pcl_io_chunked.pcd", cloud);
+  ASSERT_EQ (reader.readRange ("test_pcl_io_chunked.pcd", res, 2000, 2100), 0);
+  ASSERT_EQ (res.size (), 100);
+  expectEqual (res, 2000);
+
+  remove ("test_pcl_io_chunked.pcd");
+}
+
+TEST (PCL, PCDStreamReaderWriter)
+{
+  PointCloud<PointXYZI> cloud;
+  cloud.resize (2500);
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    cloud[i].x = static_cast<float> (i);
+    cloud[i].y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud[i].intensity = static_cast<float> (i % 255);
+  }
+
+  // Append batches of varying sizes
+  PCDStreamWriter stream_writer;
+  ASSERT_EQ (stream_writer.open<PointXYZI> ("test_pcl_io_stream.pcd"), 0);
+  for (std::size_t begin = 0, size = 1; begin < cloud.size (); begin += size, size *= 3)
+  {
+    PointCloud<PointXYZI> batch;
+    batch.points.assign (cloud.begin () + begin, cloud.begin () + std::min (begin + size, cloud.size ()));
+    batch.width = batch.size ();
+    batch.height = 1;
+    ASSERT_EQ (stream_writer.write (batch), 0);
+  }
+  EXPECT_EQ (stream_writer.getNumberOfPoints (), cloud.size ());
+  ASSERT_EQ (stream_writer.close (), 0);
+
+  // The result is a regular PCD file
+  PointCloud<PointXYZI> res;
+  ASSERT_EQ (loadPCDFile ("test_pcl_io_stream.pcd", res), 0);
+  EXPECT_EQ (res.width, cloud.size ());
+  EXPECT_EQ (res.height, 1);
+  ASSERT_EQ (res.size (), cloud.size ());
+  for (std::size_t i = 0; i < cloud.size (); ++i)
+  {
+    EXPECT_EQ (res[i].x, cloud[i].x);
+    EXPECT_EQ (res[i].intensity, cloud[i].intensity);
+  }
+
+  // Read the file in batches, in all the formats
+  PCDWriter writer;
+  writer.setChunkSize (300);
+  const auto readAll = [&cloud] (const std::string &file_name, bool read_ahead)
+  {
+    PCDStreamReader reader;
+    reader.setBatchSize (1000);
+    reader.setReadAhead (read_ahead);
+    ASSERT_EQ (reader.open (file_name), 0);
+    EXPECT_EQ (reader.getNumberOfPoints (), cloud.size ());
+
+    PointCloud<PointXYZI> batch;
+    std::size_t nr_points = 0;
+    int res;
+    while ((res = reader.read (batch)) > 0)
+    {
+      EXPECT_EQ (res, std::min<std::size_t> (1000, cloud.size () - nr_points));
+      ASSERT_EQ (batch.size (), res);
+      EXPECT_EQ (batch.height, 1);
+      for (const auto &p : batch)
+      {
+        EXPECT_EQ (p.x, cloud[nr_points].x);
+        EXPECT_NEAR (p.y, cloud[nr_points].y, 1e-4);
+        EXPECT_NEAR (p.z, cloud[nr_points].z, 1e-4);
+        EXPECT_EQ (p.intensity, cloud[nr_points].intensity);
+        ++nr_points;
+      }
+    }
+    EXPECT_EQ (res, 0);
+    EXPECT_EQ (nr_points, cloud.size ());
+  };
+  for (const bool read_ahead : {false, true})
+  {
+    readAll ("test_pcl_io_stream.pcd", read_ahead);
+    writer.writeASCII ("test_pcl_io_stream.pcd", cloud);
+    readAll ("test_pcl_io_stream.pcd", read_ahead);
+    writer.writeBinaryCompressed ("test_pcl_io_stream.pcd", cloud);
+    readAll ("test_pcl_io_stream.pcd", read_ahead);
+    writer.writeBinaryCompressedChunked ("test_pcl_io_stream.pcd", cloud);
+    readAll ("test_pcl_io_stream.pcd", read_ahead);
+    writer.writeBinary ("test_pcl_io_stream.pcd", cloud);
+  }
+
+  // The batch read ahead keeps its size, the next ones get the new one
+  PCDStreamReader reader;
+  reader.setBatchSize (1000);
+  ASSERT_EQ (reader.open ("test_pcl_io_stream.pcd"), 0);
+  PointCloud<PointXYZI> batch;
+  EXPECT_EQ (reader.read (batch), 1000);
+  reader.setBatchSize (200);
+  reader.setNumberOfThreads (2);
+  EXPECT_EQ (reader.read (batch), 1000);
+  EXPECT_EQ (reader.read (batch), 200);
+  EXPECT_EQ (batch[0].x, cloud[2000].x);
+
+  remove ("test_pcl_io_stream.pcd");
+}
+
 TEST (PCL, PCDReaderWriterASCIIColorPrecision)
 {
   PointCloud<PointXYZRGB> cloud;
@@ -121,6 +121,93 @@ TYPED_TEST (OctreeDeCompressionTest, RandomClouds)
   } // small clouds, large clouds
 } // TEST
 
+TYPED_TEST (OctreeDeCompressionTest, ChunkedEncoding)
+{
+  srand(static_cast<unsigned int> (time(NULL)));
+  // iterate over all pre-defined compression profiles
+  for (int compression_profile = pcl::io::LOW_RES_ONLINE_COMPRESSION_WITHOUT_COLOR;
+    compression_profile != pcl::io::COMPRESSION_PROFILE_COUNT; ++compression_profile) {
+    // the chunked stream must decode to the same clouds as the original one, for I- and P-frames
+    pcl::io::OctreePointCloudCompression<TypeParam> encoder((pcl::io::compression_Profiles_e) compression_profile, false);
+    pcl::io::OctreePointCloudCompression<TypeParam> chunked_encoder((pcl::io::compression_Profiles_e) compression_profile, false);
+    chunked_encoder.setEncodingChunkSize(100);
+    chunked_encoder.setNumberOfThreads(4);
+    pcl::io::OctreePointCloudCompression<TypeParam> decoder;
+    pcl::io::OctreePointCloudCompression<TypeParam> chunked_decoder;
+    chunked_decoder.setNumberOfThreads(4);
+    for (int test_idx = 0; test_idx < NUMBER_OF_TEST_RUNS; test_idx++, total_runs++)
+    {
+      auto cloud = generateRandomCloud<TypeParam>(1.0);
+      std::stringstream compressed_data, chunked_compressed_data;
+      encoder.encodePointCloud(cloud, compressed_data);
+      chunked_encoder.encodePointCloud(cloud, chunked_compressed_data);
+
+      typename pcl::PointCloud<TypeParam>::Ptr cloud_out(new pcl::PointCloud<TypeParam>());
+      typename pcl::PointCloud<TypeParam>::Ptr chunked_cloud_out(new pcl::PointCloud<TypeParam>());
+      decoder.decodePointCloud(compressed_data, cloud_out);
+      chunked_decoder.decodePointCloud(chunked_compressed_data, chunked_cloud_out);
+      ASSERT_EQ(cloud_out->size(), chunked_cloud_out->size()) << "Profile: " << compression_profile;
+      for (std::size_t i = 0; i < cloud_out->size(); ++i) {
+        EXPECT_EQ((*cloud_out)[i].x, (*chunked_cloud_out)[i].x);
+        EXPECT_EQ((*cloud_out)[i].y, (*chunked_cloud_out)[i].y);
+        EXPECT_EQ((*cloud_out)[i].z, (*chunked_cloud_out)[i].z);
+      }
+    } // runs
+  } // compression profiles
+} // TEST
+
+TYPED_TEST (OctreeDeCompressionTest, RANSEncoding)
+{
+  srand(static_cast<unsigned int> (time(NULL)));
+  for (const bool do_voxel_grid : {false, true}) {
+    // the rANS coded stream must decode to the same clouds as the range coded one, for I- and P-frames
+    pcl::io::OctreePointCloudCompression<TypeParam> encoder(pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, do_voxel_grid,
+                                                            30, true, 6, pcl::io::STATIC_RANGE_CODER);
+    pcl::io::OctreePointCloudCompression<TypeParam> rans_encoder(pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, do_voxel_grid,
+                                                                 30, true, 6, pcl::io::RANS_CODER);
+    pcl::io::OctreePointCloudCompression<TypeParam> decoder;
+    pcl::io::OctreePointCloudCompression<TypeParam> rans_decoder;
+    for (int test_idx = 0; test_idx < NUMBER_OF_TEST_RUNS; test_idx++, total_runs++)
+    {
+      auto cloud = generateRandomCloud<TypeParam>(1.0);
+      std::stringstream compressed_data, rans_compressed_data;
+      encoder.encodePointCloud(cloud, compressed_data);
+      rans_encoder.encodePointCloud(cloud, rans_compressed_data);
+
+      typename pcl::PointCloud<TypeParam>::Ptr cloud_out(new pcl::PointCloud<TypeParam>());
+      typename pcl::PointCloud<TypeParam>::Ptr rans_cloud_out(new pcl::PointCloud<TypeParam>());
+      decoder.decodePointCloud(compressed_data, cloud_out);
+      rans_decoder.decodePointCloud(rans_compressed_data, rans_cloud_out);
+      ASSERT_EQ(cloud_out->size(), rans_cloud_out->size());
+      for (std::size_t i = 0; i < cloud_out->size(); ++i) {
+        EXPECT_EQ((*cloud_out)[i].x, (*rans_cloud_out)[i].x);
+        EXPECT_EQ((*cloud_out)[i].y, (*rans_cloud_out)[i].y);
+        EXPECT_EQ((*cloud_out)[i].z, (*rans_cloud_out)[i].z);
+      }
+    } // runs
+  } // voxel grid
+} // TEST
+
+TYPED_TEST (OctreeDeCompressionTest, TruncatedRANSStream)
+{
+  srand(static_cast<unsigned int> (time(NULL)));
+  pcl::io::OctreePointCloudCompression<TypeParam> encoder(pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false,
+                                                          30, true, 6, pcl::io::RANS_CODER);
+  auto cloud = generateRandomCloud<TypeParam>(1.0);
+  std::stringstream compressed_data;
+  encoder.encodePointCloud(cloud, compressed_data);
+  const std::string data = compressed_data.str();
+
+  // a truncated frame must be rejected, without reading or allocating past the stream
+  for (const double fraction : {0.99, 0.9, 0.75, 0.6}) {
+    pcl::io::OctreePointCloudCompression<TypeParam> decoder;
+    std::istringstream truncated_data(data.substr(0, static_cast<std::size_t>(fraction * data.size())));
+    typename pcl::PointCloud<TypeParam>::Ptr cloud_out(new pcl::PointCloud<TypeParam>());
+    decoder.decodePointCloud(truncated_data, cloud_out);
+    EXPECT_TRUE(cloud_out->empty()) << "Fraction: " << fraction;
+  }
+} // TEST
+
 TEST (PCL, OctreeDeCompressionRandomPointXYZRGBASameCloud)
 {
   // Generate a random cloud. Put it into the encoder several times and make
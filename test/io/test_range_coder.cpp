@@ -41,6 +41,7 @@
 
 #include <pcl/compression/entropy_range_coder.h>
 #include <pcl/compression/impl/entropy_range_coder.hpp>
+#include <pcl/compression/rans_coder.h>
 
 #include <pcl/test/gtest.h>
 #include <vector>
@@ -166,7 +167,50 @@ TEST (PCL, Static_Range_Coder_Test)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, RANS_Coder_Test)
+{
+  // Run test for different vector sizes, including sizes that are not multiples of the number of interleaved states
+  for (unsigned int vectorSize: { 0, 1, 3, 253, 10000 })
+  {
+    std::vector<char> inputCharData (vectorSize);
+    std::vector<char> skewedCharData (vectorSize);
+    std::vector<unsigned int> inputIntData (vectorSize);
+
+    // fill vectors with random data
+    for (std::size_t i=0; i<vectorSize; i++)
+    {
+      inputCharData[i] = static_cast<char> (rand () & 0xFF);
+      skewedCharData[i] = static_cast<char> ((rand () & 0xFF) < 250 ? 0 : rand () & 0xFF);
+      inputIntData[i] = static_cast<unsigned int> (rand () & 0xFFFFF);
+    }
+
+    pcl::RANSCoder ransCoder;
+
+    for (const auto& charData : { inputCharData, skewedCharData })
+    {
+      std::vector<char> compressedData;
+      const std::size_t writeByteLen = ransCoder.encode (charData.data (), charData.size (), compressedData);
+      EXPECT_EQ (writeByteLen, compressedData.size ());
+
+      std::vector<char> outputCharData (vectorSize);
+      const std::size_t readByteLen = ransCoder.decode (compressedData.data (), compressedData.size (), outputCharData.data (), vectorSize);
+      EXPECT_EQ (writeByteLen, readByteLen);
+      EXPECT_EQ (charData, outputCharData);
+
+      // truncated data is rejected
+      if (vectorSize > 0)
+        EXPECT_EQ (ransCoder.decode (compressedData.data (), compressedData.size () - 1, outputCharData.data (), vectorSize), 0);
+    }
 
+    std::vector<char> compressedData;
+    const std::size_t writeByteLen = ransCoder.encode (inputIntData.data (), inputIntData.size (), compressedData);
+    std::vector<unsigned int> outputIntData (vectorSize);
+    const std::size_t readByteLen = ransCoder.decode (compressedData.data (), compressedData.size (), outputIntData.data (), vectorSize);
+    EXPECT_EQ (writeByteLen, readByteLen);
+    EXPECT_EQ (inputIntData, outputIntData);
+  }
+}
 
 /* ---[ */
 int
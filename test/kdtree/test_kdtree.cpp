@@ -207,6 +207,39 @@ TEST (PCL, KdTreeFLANN_nearestKSearch)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, KdTreeFLANN_SearchBuffers)
+{
+  // Use a subset of the cloud, so that the indices have to be mapped back to the cloud
+  pcl::IndicesPtr indices (new pcl::Indices);
+  for (std::size_t i = 0; i < cloud.size (); i += 2)
+    indices->push_back (static_cast<int> (i));
+
+  KdTreeFLANN<MyPoint> kdtree;
+  kdtree.setInputCloud (cloud.makeShared (), indices);
+
+  KdTreeFLANN<MyPoint>::SearchBuffers buffers;
+  pcl::Indices k_indices;
+  std::vector<float> k_distances;
+  for (const auto &point : cloud.points)
+  {
+    const int nr_knn = kdtree.nearestKSearch (point, 10, k_indices, k_distances);
+    EXPECT_EQ (nr_knn, kdtree.nearestKSearch (point, 10, buffers));
+    EXPECT_EQ (k_indices, buffers.indices);
+    EXPECT_EQ (k_distances, buffers.sqr_distances);
+
+    const int nr_radius = kdtree.radiusSearch (point, 0.25, k_indices, k_distances);
+    EXPECT_EQ (nr_radius, kdtree.radiusSearch (point, 0.25, buffers));
+    EXPECT_EQ (k_indices, buffers.indices);
+    EXPECT_EQ (k_distances, buffers.sqr_distances);
+
+    const int nr_radius_max_nn = kdtree.radiusSearch (point, 0.25, k_indices, k_distances, 5);
+    EXPECT_EQ (nr_radius_max_nn, kdtree.radiusSearch (point, 0.25, buffers, 5));
+    EXPECT_EQ (k_indices, buffers.indices);
+    EXPECT_EQ (k_distances, buffers.sqr_distances);
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 class MyPointRepresentationXY : public PointRepresentation<MyPoint>
 {
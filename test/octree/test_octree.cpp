@@ -237,6 +237,77 @@ TEST (PCL, Octree_Test)
   ASSERT_EQ (octreeA.getLeafCount (), leaf_count);
 }
 
+TEST (PCL, Octree_Contiguous_Children_Test)
+{
+  // the same leaves are created in octrees with and without contiguous children
+  OctreeBase<int> octreeA;
+  OctreeBase<int> octreeB;
+  octreeA.setTreeDepth (8);
+  octreeB.setTreeDepth (8);
+  octreeB.setContiguousChildren (true);
+  ASSERT_TRUE (octreeB.getContiguousChildren ());
+
+  srand (static_cast<unsigned int> (time (nullptr)));
+
+  // refill the octrees after deleting them, reusing the memory of their nodes
+  for (unsigned int run = 0; run < 3; run++)
+  {
+    std::vector<OctreeKey> keys;
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+      OctreeKey key (rand () % 256, rand () % 256, rand () % 256);
+      *octreeA.createLeaf (key.x, key.y, key.z) = i;
+      *octreeB.createLeaf (key.x, key.y, key.z) = i;
+      keys.push_back (key);
+    }
+
+    // remove some leaves, which may release groups of children
+    for (unsigned int i = 0; i < 1000; i += 3)
+    {
+      octreeA.removeLeaf (keys[i].x, keys[i].y, keys[i].z);
+      octreeB.removeLeaf (keys[i].x, keys[i].y, keys[i].z);
+    }
+
+    ASSERT_EQ (octreeA.getLeafCount (), octreeB.getLeafCount ());
+    ASSERT_EQ (octreeA.getBranchCount (), octreeB.getBranchCount ());
+
+    // the storage of the children cannot change while the octrees hold nodes
+    octreeA.setContiguousChildren (true);
+    octreeB.setContiguousChildren (false);
+    ASSERT_FALSE (octreeA.getContiguousChildren ());
+    ASSERT_TRUE (octreeB.getContiguousChildren ());
+
+    // copies keep the structure and the leaf data
+    OctreeBase<int> octreeC (octreeB);
+    OctreeBase<int> octreeD;
+    octreeD = octreeB;
+    ASSERT_TRUE (octreeC.getContiguousChildren ());
+    ASSERT_TRUE (octreeD.getContiguousChildren ());
+
+    std::vector<char> treeBinaryA, treeBinaryB, treeBinaryC, treeBinaryD;
+    std::vector<int*> leafVectorA, leafVectorB, leafVectorC, leafVectorD;
+    octreeA.serializeTree (treeBinaryA, leafVectorA);
+    octreeB.serializeTree (treeBinaryB, leafVectorB);
+    octreeC.serializeTree (treeBinaryC, leafVectorC);
+    octreeD.serializeTree (treeBinaryD, leafVectorD);
+    ASSERT_EQ (treeBinaryA, treeBinaryB);
+    ASSERT_EQ (treeBinaryA, treeBinaryC);
+    ASSERT_EQ (treeBinaryA, treeBinaryD);
+    ASSERT_EQ (leafVectorA.size (), leafVectorB.size ());
+    for (std::size_t i = 0; i < leafVectorA.size (); i++)
+    {
+      ASSERT_EQ (*leafVectorA[i], *leafVectorB[i]);
+      ASSERT_EQ (*leafVectorA[i], *leafVectorC[i]);
+      ASSERT_EQ (*leafVectorA[i], *leafVectorD[i]);
+    }
+
+    octreeA.deleteTree ();
+    octreeB.deleteTree ();
+    ASSERT_EQ (octreeB.getLeafCount (), 0);
+    ASSERT_EQ (octreeB.getBranchCount (), 1);
+  }
+}
+
 TEST (PCL, Octree_Dynamic_Depth_Test)
 {
   constexpr int test_runs = 100;
@@ -810,6 +881,100 @@ TEST (PCL, Octree_Pointcloud_Test)
   }
 }
 
+TEST (PCL, Octree_Pointcloud_Bulk_Construction_Test)
+{
+  // the bulk construction of addPointsFromInputCloud gives the same octree as adding
+  // the points one at a time
+  PointCloud<PointXYZ>::Ptr cloudIn (new PointCloud<PointXYZ> ());
+
+  srand (static_cast<unsigned int> (time (nullptr)));
+
+  // the points added one at a time get their keys before the bounding box reaches its
+  // final size: keep the points away from the voxel borders, which the first point
+  // aligns on multiples of the resolution
+  constexpr double resolution = 0.125;
+  const auto coordinate = [] (int range)
+  {
+    return static_cast<float> ((rand () % range + 0.25 + 0.5 * rand () / RAND_MAX) * resolution);
+  };
+  cloudIn->push_back (PointXYZ (20.5 * resolution, 20.5 * resolution, 20.5 * resolution));
+  for (std::size_t i = 1; i < 10000; i++)
+  {
+    if (i % 100 == 0)
+      cloudIn->push_back (PointXYZ (std::numeric_limits<float>::quiet_NaN (), 0.0f, 0.0f));
+    else
+      cloudIn->push_back (PointXYZ (coordinate (80), coordinate (80), coordinate (40)));
+  }
+
+  using OctreeT = OctreePointCloudPointVector<PointXYZ>;
+  OctreeT::IndicesPtr indices (new Indices);
+  for (index_t i = 0; i < static_cast<index_t> (cloudIn->size ()); i += 3)
+    indices->push_back (i);
+
+  for (const unsigned int threads : {1, 4})
+  for (const bool contiguous : {false, true})
+  {
+    for (const auto& subset : {OctreeT::IndicesPtr (), indices})
+    {
+      OctreeT octreeA (resolution);
+      octreeA.setNumberOfThreads (threads);
+      octreeA.setContiguousChildren (contiguous);
+      octreeA.setInputCloud (cloudIn, subset);
+      octreeA.addPointsFromInputCloud ();
+
+      OctreeT octreeB (resolution);
+      octreeB.setInputCloud (cloudIn);
+      if (subset)
+      {
+        for (const auto& index : *subset)
+          if (isFinite ((*cloudIn)[index]))
+            octreeB.addPointFromCloud (index, nullptr);
+      }
+      else
+      {
+        for (index_t i = 0; i < static_cast<index_t> (cloudIn->size ()); i++)
+          if (isFinite ((*cloudIn)[i]))
+            octreeB.addPointFromCloud (i, nullptr);
+      }
+
+      ASSERT_EQ (octreeA.getTreeDepth (), octreeB.getTreeDepth ());
+      ASSERT_EQ (octreeA.getLeafCount (), octreeB.getLeafCount ());
+      ASSERT_EQ (octreeA.getBranchCount (), octreeB.getBranchCount ());
+
+      double minA[3], maxA[3], minB[3], maxB[3];
+      octreeA.getBoundingBox (minA[0], minA[1], minA[2], maxA[0], maxA[1], maxA[2]);
+      octreeB.getBoundingBox (minB[0], minB[1], minB[2], maxB[0], maxB[1], maxB[2]);
+      for (int i = 0; i < 3; i++)
+      {
+        ASSERT_EQ (minA[i], minB[i]);
+        ASSERT_EQ (maxA[i], maxB[i]);
+      }
+
+      std::vector<char> treeBinaryA, treeBinaryB;
+      std::vector<OctreeContainerPointIndices*> leafVectorA, leafVectorB;
+      octreeA.serializeTree (treeBinaryA, leafVectorA);
+      octreeB.serializeTree (treeBinaryB, leafVectorB);
+      ASSERT_EQ (treeBinaryA, treeBinaryB);
+
+      // the points of each voxel keep their order
+      ASSERT_EQ (leafVectorA.size (), leafVectorB.size ());
+      for (std::size_t i = 0; i < leafVectorA.size (); i++)
+        ASSERT_EQ (leafVectorA[i]->getPointIndicesVector (),
+                   leafVectorB[i]->getPointIndicesVector ());
+
+      // the nodes built by several threads are reused after deleting the tree
+      octreeA.deleteTree ();
+      octreeA.defineBoundingBox (minA[0], minA[1], minA[2], maxA[0], maxA[1], maxA[2]);
+      octreeA.setInputCloud (cloudIn, subset);
+      octreeA.addPointsFromInputCloud ();
+      ASSERT_EQ (octreeA.getLeafCount (), octreeB.getLeafCount ());
+      ASSERT_EQ (octreeA.getBranchCount (), octreeB.getBranchCount ());
+      octreeA.serializeTree (treeBinaryA);
+      ASSERT_EQ (treeBinaryA, treeBinaryB);
+    }
+  }
+}
+
 TEST (PCL, Octree_Pointcloud_Density_Test)
 {
   // instantiate point cloud and fill it with point data
@@ -1403,6 +1568,8 @@ TEST (PCL, Octree_Pointcloud_Neighbours_Within_Radius_Search)
       }
 
       OctreePointCloudSearch<PointXYZ> octree (0.001);
+      // every other octree stores the children of its branches contiguously
+      octree.setContiguousChildren (test_id % 2 == 1);
 
       // build octree
       octree.setInputCloud (cloudIn);
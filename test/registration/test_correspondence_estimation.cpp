@@ -119,6 +119,53 @@ TEST (CorrespondenceEstimation, CorrespondenceEstimationSetSearchMethod)
   
 }
 
+//////////////////////////////////////////////////////////////////////////////////////
+TEST (CorrespondenceEstimation, CorrespondenceEstimationParallel)
+{
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud1 (new pcl::PointCloud<pcl::PointXYZ> ());
+  pcl::PointCloud<pcl::PointXYZ>::Ptr cloud2 (new pcl::PointCloud<pcl::PointXYZ> ());
+  for (std::size_t i = 0; i < 5000; i++)
+  {
+    cloud1->points.emplace_back(float (rand () % 1000), float (rand () % 1000), float (rand () % 1000));
+    cloud2->points.emplace_back(float (rand () % 1000), float (rand () % 1000), float (rand () % 1000));
+  }
+
+  pcl::registration::CorrespondenceEstimation<pcl::PointXYZ, pcl::PointXYZ> ce;
+  ce.setInputSource (cloud1);
+  ce.setInputTarget (cloud2);
+  EXPECT_EQ (ce.getNumberOfThreads (), 1u);
+
+  // A maximum distance which rejects part of the correspondences
+  const double max_distance = 40.0;
+  pcl::Correspondences corr_serial, corr_reciprocal_serial;
+  ce.determineCorrespondences (corr_serial, max_distance);
+  ce.determineReciprocalCorrespondences (corr_reciprocal_serial, max_distance);
+  EXPECT_LT (corr_serial.size (), cloud1->size ());
+  EXPECT_LT (corr_reciprocal_serial.size (), corr_serial.size ());
+
+  ce.setNumberOfThreads (4);
+  EXPECT_EQ (ce.getNumberOfThreads (), 4u);
+  pcl::Correspondences corr_parallel, corr_reciprocal_parallel;
+  ce.determineCorrespondences (corr_parallel, max_distance);
+  ce.determineReciprocalCorrespondences (corr_reciprocal_parallel, max_distance);
+
+  // Same correspondences, in the same order
+  ASSERT_EQ (corr_serial.size (), corr_parallel.size ());
+  for (std::size_t i = 0; i < corr_serial.size (); i++)
+  {
+    EXPECT_EQ (corr_serial[i].index_query, corr_parallel[i].index_query);
+    EXPECT_EQ (corr_serial[i].index_match, corr_parallel[i].index_match);
+    EXPECT_EQ (corr_serial[i].distance, corr_parallel[i].distance);
+  }
+  ASSERT_EQ (corr_reciprocal_serial.size (), corr_reciprocal_parallel.size ());
+  for (std::size_t i = 0; i < corr_reciprocal_serial.size (); i++)
+  {
+    EXPECT_EQ (corr_reciprocal_serial[i].index_query, corr_reciprocal_parallel[i].index_query);
+    EXPECT_EQ (corr_reciprocal_serial[i].index_match, corr_reciprocal_parallel[i].index_match);
+    EXPECT_EQ (corr_reciprocal_serial[i].distance, corr_reciprocal_parallel[i].distance);
+  }
+}
+
 /* ---[ */
 int
   main (int argc, char** argv)
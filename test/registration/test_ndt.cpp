@@ -94,6 +94,46 @@ TEST (PCL, NormalDistributionsTransform)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, NormalDistributionsTransformParallel)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT> (cloud_source));
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT> (cloud_target));
+  PointCloud<PointT> output;
+
+  NormalDistributionsTransform<PointT, PointT> reg;
+  reg.setStepSize (0.05);
+  reg.setResolution (0.025f);
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  EXPECT_EQ (reg.getNumberOfThreads (), 1u);
+
+  reg.align (output);
+  const Eigen::Matrix4f serial_transformation = reg.getFinalTransformation ();
+  EXPECT_LT (reg.getFitnessScore (), 0.001);
+
+  reg.setNumberOfThreads (4);
+  EXPECT_EQ (reg.getNumberOfThreads (), 4u);
+  reg.align (output);
+  const Eigen::Matrix4f parallel_transformation = reg.getFinalTransformation ();
+  EXPECT_EQ (output.size (), cloud_source.size ());
+  EXPECT_LT (reg.getFitnessScore (), 0.001);
+  // The serial run sums the points in another order, only rounding differs
+  EXPECT_TRUE (parallel_transformation.isApprox (serial_transformation, 1e-4f));
+
+  // Same number of threads, same result
+  reg.align (output);
+  EXPECT_EQ (reg.getFinalTransformation (), parallel_transformation);
+
+  // Any number of threads above one sums the same blocks in the same order
+  reg.setNumberOfThreads (2);
+  reg.align (output);
+  EXPECT_EQ (reg.getFinalTransformation (), parallel_transformation);
+}
+
 int
 main (int argc, char** argv)
 {
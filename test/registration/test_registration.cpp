@@ -232,6 +232,34 @@ TEST (PCL, IterativeClosestPoint)
   EXPECT_EQ (transformation (3, 3), 1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, IterativeClosestPointThreads)
+{
+  for (const bool reciprocal : {false, true})
+  {
+    Eigen::Matrix4f transformation[2];
+    const unsigned int threads[2] = {1, 4};
+    for (int i = 0; i < 2; ++i)
+    {
+      IterativeClosestPoint<PointXYZ, PointXYZ> reg;
+      reg.setInputSource (cloud_source.makeShared ());
+      reg.setInputTarget (cloud_target.makeShared ());
+      reg.setMaximumIterations (50);
+      reg.setTransformationEpsilon (1e-8);
+      reg.setMaxCorrespondenceDistance (0.05);
+      reg.setUseReciprocalCorrespondences (reciprocal);
+      reg.setNumberOfThreads (threads[i]);
+      EXPECT_EQ (threads[i], reg.getNumberOfThreads ());
+      reg.align (cloud_reg);
+      EXPECT_TRUE (reg.hasConverged ());
+      transformation[i] = reg.getFinalTransformation ();
+    }
+    // The correspondences, and therefore the transformations, do not depend on the
+    // number of threads
+    EXPECT_EQ (transformation[0], transformation[1]);
+  }
+}
+
 TEST (PCL, IterativeClosestPointWithNormals)
 {
   IterativeClosestPointWithNormals<PointNormal, PointNormal, float> reg_float;
@@ -585,6 +613,77 @@ TEST (PCL, GeneralizedIterativeClosestPoint)
   EXPECT_LT (reg.getFitnessScore (), 0.0001);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, GeneralizedIterativeClosestPointCovariances)
+{
+  using PointT = PointXYZ;
+  PointCloud<PointT>::Ptr src (new PointCloud<PointT>);
+  copyPointCloud (cloud_source, *src);
+  PointCloud<PointT>::Ptr tgt (new PointCloud<PointT>);
+  copyPointCloud (cloud_target, *tgt);
+  PointCloud<PointT> output;
+
+  GeneralizedIterativeClosestPoint<PointT, PointT> reg;
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.setMaximumIterations (50);
+  reg.setTransformationEpsilon (1e-8);
+  EXPECT_EQ (reg.getNumberOfThreads (), 1u);
+  reg.align (output);
+  const Eigen::Matrix4f serial_transformation = reg.getFinalTransformation ();
+  const auto source_covariances = reg.getSourceCovariances ();
+  const auto target_covariances = reg.getTargetCovariances ();
+  ASSERT_TRUE (source_covariances && target_covariances);
+  ASSERT_EQ (source_covariances->size (), src->size ());
+  ASSERT_EQ (target_covariances->size (), tgt->size ());
+
+  // Compare against the covariances reconstituted from a SVD, with the two biggest
+  // singular values replaced by 1 and the smallest one by the gicp epsilon (0.001)
+  pcl::search::KdTree<PointT> tree;
+  tree.setInputCloud (src);
+  pcl::Indices nn_indices;
+  std::vector<float> nn_dists;
+  for (std::size_t i = 0; i < src->size (); ++i)
+  {
+    tree.nearestKSearch ((*src)[i], reg.getCorrespondenceRandomness (), nn_indices, nn_dists);
+    Eigen::Matrix<double, 3, Eigen::Dynamic> neighbors (3, nn_indices.size ());
+    for (std::size_t j = 0; j < nn_indices.size (); ++j)
+      neighbors.col (j) = (*src)[nn_indices[j]].getVector3fMap ().cast<double> ();
+    const Eigen::Matrix<double, 3, Eigen::Dynamic> centered = neighbors.colwise () - neighbors.rowwise ().mean ();
+    const Eigen::Matrix3d cov = centered * centered.transpose () / static_cast<double> (nn_indices.size ());
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd (cov, Eigen::ComputeFullU);
+    const Eigen::Matrix3d expected = svd.matrixU () * Eigen::Vector3d (1., 1., 0.001).asDiagonal () * svd.matrixU ().transpose ();
+    EXPECT_TRUE ((*source_covariances)[i].isApprox (expected, 1e-4)) << "point " << i;
+  }
+
+  // The covariances do not depend on the number of threads
+  reg.setNumberOfThreads (4);
+  EXPECT_EQ (reg.getNumberOfThreads (), 4u);
+  reg.setInputSource (src);
+  reg.setInputTarget (tgt);
+  reg.align (output);
+  for (std::size_t i = 0; i < src->size (); ++i)
+    EXPECT_EQ ((*reg.getSourceCovariances ())[i], (*source_covariances)[i]);
+  for (std::size_t i = 0; i < tgt->size (); ++i)
+    EXPECT_EQ ((*reg.getTargetCovariances ())[i], (*target_covariances)[i]);
+  EXPECT_EQ (reg.getFinalTransformation (), serial_transformation);
+
+  // Reuse the target covariances and search tree in another registration
+  pcl::search::KdTree<PointT>::Ptr target_tree (new pcl::search::KdTree<PointT>);
+  target_tree->setInputCloud (tgt);
+  GeneralizedIterativeClosestPoint<PointT, PointT> reg_reuse;
+  reg_reuse.setInputSource (src);
+  reg_reuse.setInputTarget (tgt);
+  reg_reuse.setSearchMethodTarget (target_tree, true);
+  reg_reuse.setTargetCovariances (target_covariances);
+  reg_reuse.setMaximumIterations (50);
+  reg_reuse.setTransformationEpsilon (1e-8);
+  reg_reuse.align (output);
+  EXPECT_EQ (reg_reuse.getTargetCovariances (), target_covariances);
+  EXPECT_EQ (reg_reuse.getFinalTransformation (), serial_transformation);
+  EXPECT_LT (reg_reuse.getFitnessScore (), 0.0001);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, GeneralizedIterativeClosestPoint6D)
 {
@@ -42,15 +42,21 @@
 #include <pcl/sample_consensus/lmeds.h>
 #include <pcl/sample_consensus/rmsac.h>
 #include <pcl/sample_consensus/mlesac.h>
+#include <pcl/sample_consensus/prosac.h>
 #include <pcl/sample_consensus/ransac.h>
 #include <pcl/sample_consensus/rransac.h>
+#include <pcl/sample_consensus/sac_model_plane.h>
 #include <pcl/sample_consensus/sac_model_sphere.h>
+#include <pcl/sample_consensus/sac_model_registration.h>
+#include <pcl/sample_consensus/sprt.h>
 
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
 
+#include "test_sample_consensus_simd.h"
+
 using namespace pcl;
 
 using SampleConsensusModelSpherePtr = SampleConsensusModelSphere<PointXYZ>::Ptr;
@@ -89,7 +95,8 @@ using sacTypes = ::testing::Types<
   MEstimatorSampleConsensus<PointXYZ>,
   RandomizedRandomSampleConsensus<PointXYZ>,
   RandomizedMEstimatorSampleConsensus<PointXYZ>,
-  MaximumLikelihoodSampleConsensus<PointXYZ>
+  MaximumLikelihoodSampleConsensus<PointXYZ>,
+  SPRTSampleConsensus<PointXYZ>
 >;
 TYPED_TEST_SUITE(SacTest, sacTypes);
 
@@ -149,6 +156,116 @@ TYPED_TEST(SacTest, InfiniteLoop)
   pcl::console::setVerbosityLevel(previous_verbosity_level); // reset verbosity level
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Test if the model found is the same for any number of threads.
+template <typename SacT>
+class SacThreadsTest : public ::testing::Test {};
+
+using sacThreadsTypes = ::testing::Types<
+  RandomSampleConsensus<PointXYZ>,
+  LeastMedianSquares<PointXYZ>,
+  MEstimatorSampleConsensus<PointXYZ>,
+  RandomizedRandomSampleConsensus<PointXYZ>,
+  RandomizedMEstimatorSampleConsensus<PointXYZ>,
+  MaximumLikelihoodSampleConsensus<PointXYZ>,
+  ProgressiveSampleConsensus<PointXYZ>,
+  SPRTSampleConsensus<PointXYZ>
+>;
+TYPED_TEST_SUITE(SacThreadsTest, sacThreadsTypes);
+
+// The pre-test of the randomized methods only passes if all its points are inliers
+template <typename SacT> void
+setSmallPretest (SacT &) {}
+
+template <typename PointT> void
+setSmallPretest (RandomizedRandomSampleConsensus<PointT> &sac) { sac.setFractionNrPretest (1.0); }
+
+template <typename PointT> void
+setSmallPretest (RandomizedMEstimatorSampleConsensus<PointT> &sac) { sac.setFractionNrPretest (1.0); }
+
+TYPED_TEST(SacThreadsTest, Deterministic)
+{
+  // A noisy plane, with 20% of outliers
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  srand (0);
+  const auto random = [] () { return (static_cast<float> (rand ()) / static_cast<float> (RAND_MAX)); };
+  for (std::size_t i = 0; i < 2000; ++i)
+  {
+    const float x = random (), y = random ();
+    if (i % 5 == 0)
+      cloud->emplace_back (x, y, random ());
+    else
+      cloud->emplace_back (x, y, 0.5f * x - 0.2f * y + 0.3f + 0.01f * (random () - 0.5f));
+  }
+
+  Indices model_serial, inliers_serial;
+  Eigen::VectorXf coefficients_serial;
+  for (const int threads : {-1, 1, 2, 3, 8})
+  {
+    SampleConsensusModelPlane<PointXYZ>::Ptr model (new SampleConsensusModelPlane<PointXYZ> (cloud));
+    TypeParam sac (model, 0.02);
+    sac.setMaxIterations (200);
+    sac.setNumberOfThreads (threads);
+    setSmallPretest (sac);
+    ASSERT_TRUE (sac.computeModel ());
+
+    Indices sample, inliers;
+    Eigen::VectorXf coefficients;
+    sac.getModel (sample);
+    sac.getInliers (inliers);
+    sac.getModelCoefficients (coefficients);
+    EXPECT_LT (1000, inliers.size ());
+    if (threads < 0)
+    {
+      model_serial = sample;
+      inliers_serial = inliers;
+      coefficients_serial = coefficients;
+      continue;
+    }
+    EXPECT_EQ (model_serial, sample) << threads << " threads";
+    EXPECT_EQ (inliers_serial, inliers) << threads << " threads";
+    EXPECT_EQ (coefficients_serial, coefficients) << threads << " threads";
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensus, SimdLevel)
+{
+  const SacSimdLevel level = getSacSimdLevel ();
+  EXPECT_EQ (SacSimdLevel::NONE, setSacSimdLevel (SacSimdLevel::NONE));
+  EXPECT_EQ (SacSimdLevel::NONE, getSacSimdLevel ());
+  // Levels above the one detected are lowered to it
+  EXPECT_EQ (level, setSacSimdLevel (SacSimdLevel::AVX2));
+  EXPECT_EQ (level, getSacSimdLevel ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelRegistration, SIMD_levels)
+{
+  srand (0);
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  PointCloud<PointXYZ>::Ptr target (new PointCloud<PointXYZ>);
+  PointCloud<Normal> normals;
+  pcl::Indices indices;
+  for (int i = 0; i < 20; ++i)
+  {
+    makeRandomCloud (*cloud, normals, indices);
+    // The target is the cloud rotated and translated, plus noise
+    const Eigen::Affine3f transform (Eigen::AngleAxisf (0.1f * static_cast<float> (i), normals.front ().getNormalVector3fMap ()) *
+                                     Eigen::Translation3f (cloud->back ().getVector3fMap ()));
+    target->resize (cloud->size ());
+    for (std::size_t idx = 0; idx < cloud->size (); ++idx)
+      (*target)[idx].getVector3fMap () = transform * (*cloud)[idx].getVector3fMap () + 0.05f * normals[idx].getNormalVector3fMap ();
+    Eigen::VectorXf registration (16);
+    for (int row = 0; row < 4; ++row)
+      registration.segment<4> (4 * row) = transform.matrix ().row (row);
+
+    SampleConsensusModelRegistration<PointXYZ> registration_model (cloud, indices);
+    registration_model.setInputTarget (target, indices);
+    checkSacSimdLevels (registration_model, registration, 0.03, 1, 1e-5);
+  }
+}
+
 int
 main (int argc, char** argv)
 {
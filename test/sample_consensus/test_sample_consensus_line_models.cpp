@@ -44,6 +44,9 @@
 #include <pcl/sample_consensus/ransac.h>
 #include <pcl/sample_consensus/sac_model_line.h>
 #include <pcl/sample_consensus/sac_model_parallel_line.h>
+#include <pcl/sample_consensus/sac_model_stick.h>
+
+#include "test_sample_consensus_simd.h"
 
 using namespace pcl;
 
@@ -213,6 +216,28 @@ TEST (SampleConsensusModelParallelLine, RANSAC)
   EXPECT_XYZ_NEAR (PointXYZ (-1.05, 5.05, 4.0), proj_points[14], 0.1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelLine, SIMD_levels)
+{
+  srand (0);
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  PointCloud<Normal> normals;
+  pcl::Indices indices;
+  for (int i = 0; i < 20; ++i)
+  {
+    makeRandomCloud (*cloud, normals, indices);
+    Eigen::VectorXf line (6), stick (7);
+    line << cloud->front ().getVector3fMap (), normals.front ().getNormalVector3fMap ();
+    stick << cloud->front ().getVector3fMap (), cloud->back ().getVector3fMap (), 0.1f;
+
+    SampleConsensusModelLine<PointXYZ> line_model (cloud, indices);
+    checkSacSimdLevels (line_model, line, 0.1, 1, 1e-5);
+    SampleConsensusModelStick<PointXYZ> stick_model (cloud, indices);
+    stick_model.setRadiusLimits (0.0, 0.2);
+    checkSacSimdLevels (stick_model, stick, 0.1, 1, 1e-5);
+  }
+}
+
 int
 main (int argc, char** argv)
 {
@@ -52,6 +52,9 @@
 #include <pcl/sample_consensus/sac_model_plane.h>
 #include <pcl/sample_consensus/sac_model_normal_plane.h>
 #include <pcl/sample_consensus/sac_model_normal_parallel_plane.h>
+#include <pcl/sample_consensus/sprt.h>
+
+#include "test_sample_consensus_simd.h"
 
 using namespace pcl;
 using namespace pcl::io;
@@ -224,6 +227,31 @@ TEST (SampleConsensusModelPlane, RMSAC)
   verifyPlaneSac (model, sac, 600, 1.0f, 1.0f, 0.01f);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, SPRT)
+{
+  srand (0);
+
+  // Create a shared plane model pointer directly
+  SampleConsensusModelPlanePtr model (new SampleConsensusModelPlane<PointXYZ> (cloud_));
+
+  // Create the SPRT object
+  SPRTSampleConsensus<PointXYZ> sac (model, 0.03);
+
+  sac.setInitialInlierRatio (0.2);
+  ASSERT_EQ (0.2, sac.getInitialInlierRatio ());
+  sac.setInitialBadModelInlierRatio (0.05);
+  ASSERT_EQ (0.05, sac.getInitialBadModelInlierRatio ());
+  sac.setModelComputationTime (100.0);
+  ASSERT_EQ (100.0, sac.getModelComputationTime ());
+
+  verifyPlaneSac (model, sac);
+
+  // The indices of the model are restored after checking the models against parts of them
+  ASSERT_EQ (indices_.size (), model->getIndices ()->size ());
+  EXPECT_TRUE (std::equal (indices_.begin (), indices_.end (), model->getIndices ()->begin ()));
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelNormalPlane, RANSAC)
 {
@@ -447,6 +475,26 @@ TEST (SampleConsensusModelNormalPlane, SIMD_countWithinDistance) // Test if all
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelPlane, SIMD_levels)
+{
+  // Planes through the points of the test file, with the normal of another point
+  for (std::size_t i = 0; i < 20; ++i)
+  {
+    const PointXYZ &pt = (*cloud_)[i * 97];
+    const Normal &nt = (*normals_)[i * 89];
+    Eigen::VectorXf plane (4);
+    plane << nt.getNormalVector3fMap (), -nt.getNormalVector3fMap ().dot (pt.getVector3fMap ());
+
+    SampleConsensusModelPlane<PointXYZ> plane_model (cloud_, indices_);
+    checkSacSimdLevels (plane_model, plane, 0.03, 1, 1e-5);
+    SampleConsensusModelNormalPlane<PointXYZ, Normal> normal_plane_model (cloud_, indices_);
+    normal_plane_model.setInputNormals (normals_);
+    normal_plane_model.setNormalDistanceWeight (0.01);
+    checkSacSimdLevels (normal_plane_model, plane, 0.03, 2, 1e-4);
+  }
+}
+
 int
 main (int argc, char** argv)
 {
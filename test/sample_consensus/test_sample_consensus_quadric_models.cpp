@@ -39,6 +39,7 @@
 #include <pcl/test/gtest.h>
 
 #include <pcl/sample_consensus/ransac.h>
+#include <pcl/sample_consensus/sprt.h>
 #include <pcl/sample_consensus/sac_model_sphere.h>
 #include <pcl/sample_consensus/sac_model_cone.h>
 #include <pcl/sample_consensus/sac_model_cylinder.h>
@@ -46,6 +47,8 @@
 #include <pcl/sample_consensus/sac_model_circle3d.h>
 #include <pcl/sample_consensus/sac_model_normal_sphere.h>
 
+#include "test_sample_consensus_simd.h"
+
 using namespace pcl;
 
 using SampleConsensusModelSpherePtr = SampleConsensusModelSphere<PointXYZ>::Ptr;
@@ -458,6 +461,51 @@ TEST (SampleConsensusModelCylinder, RANSAC)
   EXPECT_NEAR (0.5, coeff_refined[6], 1e-3);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelCylinder, SPRT)
+{
+  srand (0);
+
+  // A cylinder of radius 0.5 along the z axis through (-0.5, 1.7), and as many random points
+  PointCloud<PointXYZ> cloud;
+  PointCloud<Normal> normals;
+  const auto random = [] () { return (static_cast<float> (rand ()) / static_cast<float> (RAND_MAX)); };
+  for (std::size_t i = 0; i < 4000; ++i)
+  {
+    const float angle = 2.0f * static_cast<float> (M_PI) * random ();
+    Normal normal (std::cos (angle), std::sin (angle), 0.0f);
+    if (i % 2 == 0)
+      cloud.emplace_back (-0.5f + 0.5f * normal.normal_x, 1.7f + 0.5f * normal.normal_y, random ());
+    else
+      cloud.emplace_back (-1.5f + 2.0f * random (), 0.7f + 2.0f * random (), random ());
+    normals.push_back (normal);
+  }
+
+  // Create a shared cylinder model pointer directly
+  SampleConsensusModelCylinderPtr model (new SampleConsensusModelCylinder<PointXYZ, Normal> (cloud.makeShared ()));
+  model->setInputNormals (normals.makeShared ());
+
+  // Create the SPRT object
+  SPRTSampleConsensus<PointXYZ> sac (model, 0.01);
+
+  // Algorithm tests
+  bool result = sac.computeModel ();
+  ASSERT_TRUE (result);
+
+  pcl::Indices inliers;
+  sac.getInliers (inliers);
+  EXPECT_LT (2000, inliers.size ());
+
+  Eigen::VectorXf coeff;
+  sac.getModelCoefficients (coeff);
+  EXPECT_EQ (7, coeff.size ());
+  const Eigen::Vector3f axis = coeff.segment<3> (3).normalized ();
+  EXPECT_NEAR (1.0f, std::abs (axis[2]), 1e-3);
+  EXPECT_NEAR (-0.5f, coeff[0] - coeff[2] * coeff[3] / coeff[5], 1e-2);
+  EXPECT_NEAR ( 1.7f, coeff[1] - coeff[2] * coeff[4] / coeff[5], 1e-2);
+  EXPECT_NEAR ( 0.5f, coeff[6], 1e-2);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SampleConsensusModelCircle2D, RANSAC)
 {
@@ -650,6 +698,62 @@ TEST (SampleConsensusModelCircle3D, RANSAC)
   EXPECT_NEAR ( 0.0, coeff_refined[6], 1e-3);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelSphere, SIMD_levels)
+{
+  srand (0);
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal>);
+  pcl::Indices indices;
+  for (int i = 0; i < 20; ++i)
+  {
+    makeRandomCloud (*cloud, *normals, indices);
+    Eigen::VectorXf sphere (4), circle2d (3), circle3d (7);
+    sphere << 0.5f * cloud->front ().getVector3fMap (), 0.8f;
+    circle2d << 0.5f * cloud->back ().x, 0.5f * cloud->back ().y, 0.7f;
+    circle3d << 0.5f * cloud->front ().getVector3fMap (), 0.6f, normals->back ().getNormalVector3fMap ();
+
+    SampleConsensusModelSphere<PointXYZ> sphere_model (cloud, indices);
+    checkSacSimdLevels (sphere_model, sphere, 0.05, 1, 1e-5);
+    SampleConsensusModelCircle2D<PointXYZ> circle2d_model (cloud, indices);
+    checkSacSimdLevels (circle2d_model, circle2d, 0.05, 1, 1e-5);
+    SampleConsensusModelCircle3D<PointXYZ> circle3d_model (cloud, indices);
+    checkSacSimdLevels (circle3d_model, circle3d, 0.1, 1, 1e-5);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SampleConsensusModelCylinder, SIMD_levels)
+{
+  srand (0);
+  PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+  PointCloud<Normal>::Ptr normals (new PointCloud<Normal>);
+  pcl::Indices indices;
+  for (int i = 0; i < 20; ++i)
+  {
+    makeRandomCloud (*cloud, *normals, indices);
+    Eigen::VectorXf sphere (4), cylinder (7), cone (7);
+    sphere << 0.5f * cloud->front ().getVector3fMap (), 0.8f;
+    cylinder << 0.5f * cloud->front ().getVector3fMap (), normals->front ().getNormalVector3fMap (), 0.5f;
+    cone << cloud->back ().getVector3fMap (), normals->back ().getNormalVector3fMap (), 0.4f;
+
+    // The models using normals are compared with a larger tolerance, as their scalar
+    // implementations compute the angles in double precision
+    SampleConsensusModelNormalSphere<PointXYZ, Normal> sphere_model (cloud, indices);
+    sphere_model.setInputNormals (normals);
+    sphere_model.setNormalDistanceWeight (0.1);
+    checkSacSimdLevels (sphere_model, sphere, 0.1, 2, 1e-4);
+    SampleConsensusModelCylinder<PointXYZ, Normal> cylinder_model (cloud, indices);
+    cylinder_model.setInputNormals (normals);
+    cylinder_model.setNormalDistanceWeight (0.1);
+    checkSacSimdLevels (cylinder_model, cylinder, 0.1, 2, 1e-4);
+    SampleConsensusModelCone<PointXYZ, Normal> cone_model (cloud, indices);
+    cone_model.setInputNormals (normals);
+    cone_model.setNormalDistanceWeight (0.1);
+    checkSacSimdLevels (cone_model, cone, 0.1, 2, 1e-4);
+  }
+}
+
 int
 main (int argc, char** argv)
 {
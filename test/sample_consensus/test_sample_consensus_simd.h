@@ -0,0 +1,120 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2020-, Open Perception
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#pragma once
+
+#include <pcl/test/gtest.h>
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#include <pcl/sample_consensus/sac_model_simd.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////
+
+/** \brief Compare the results of the SIMD kernels of all the instruction sets with
+  * the scalar implementation of a model (see pcl::setSacSimdLevel).
+  */
+template <typename ModelT> void
+checkSacSimdLevels (const ModelT &model, const Eigen::VectorXf &model_coefficients, const double threshold,
+                    const std::size_t count_tolerance, const double distance_tolerance)
+{
+  const pcl::SacSimdLevel level = pcl::getSacSimdLevel ();
+  pcl::setSacSimdLevel (pcl::SacSimdLevel::NONE);
+  const std::size_t count_standard = model.countWithinDistance (model_coefficients, threshold);
+  std::vector<double> distances_standard, distances_sse2;
+  model.getDistancesToModel (model_coefficients, distances_standard);
+
+  for (const auto simd_level : {pcl::SacSimdLevel::SSE2, pcl::SacSimdLevel::AVX2})
+  {
+    if (pcl::setSacSimdLevel (simd_level) != simd_level)
+      break;
+    const std::size_t count = model.countWithinDistance (model_coefficients, threshold);
+    EXPECT_NEAR (static_cast<double> (count_standard), static_cast<double> (count), static_cast<double> (count_tolerance));
+    std::vector<double> distances;
+    model.getDistancesToModel (model_coefficients, distances);
+    ASSERT_EQ (distances_standard.size (), distances.size ());
+    for (std::size_t i = 0; i < distances.size (); ++i)
+    {
+      // Points with invalid normals have invalid distances
+      if (std::isnan (distances_standard[i]))
+      {
+        EXPECT_TRUE (std::isnan (distances[i]));
+      }
+      else
+      {
+        EXPECT_NEAR (distances_standard[i], distances[i], distance_tolerance);
+      }
+    }
+    // All the instruction sets give the same results
+    if (simd_level == pcl::SacSimdLevel::SSE2)
+      distances_sse2 = distances;
+    else
+    {
+      for (std::size_t i = 0; i < distances.size (); ++i)
+      {
+        if (!std::isnan (distances_sse2[i]))
+        {
+          EXPECT_EQ (distances_sse2[i], distances[i]);
+        }
+      }
+    }
+  }
+  pcl::setSacSimdLevel (level);
+}
+
+/** \brief Random points and normals in [-1, 1]^3, and a random subset of their indices. */
+inline void
+makeRandomCloud (pcl::PointCloud<pcl::PointXYZ> &cloud, pcl::PointCloud<pcl::Normal> &normals, pcl::Indices &indices)
+{
+  const auto random = [] { return (2.0f * static_cast<float> (rand ()) / RAND_MAX - 1.0f); };
+  cloud.resize (1001);
+  normals.resize (cloud.size ());
+  indices.clear ();
+  for (std::size_t idx = 0; idx < cloud.size (); ++idx)
+  {
+    cloud[idx].getVector3fMap () << random (), random (), random ();
+    normals[idx].getNormalVector3fMap () << random (), random (), random ();
+    normals[idx].getNormalVector3fMap ().normalize ();
+    normals[idx].curvature = 0.05f * (random () + 1.0f);
+    if (rand () % 3 != 0)
+      indices.push_back (static_cast<pcl::index_t> (idx));
+  }
+}
@@ -538,6 +538,78 @@ TEST (PCL, Organized_Sparse_View_Radius)
 }
 #endif
 
+/** \brief does batched knn and radius search and tests the results to be identical to the ones of the single query
+  * searches, independent of the number of threads.
+  * \param cloud the input point cloud
+  * \param search_methods vector of all search methods to be tested
+  * \param query_indices indices of query points in the point cloud
+  */
+template<typename PointT> void
+testBatchSearch (typename PointCloud<PointT>::ConstPtr point_cloud, std::vector<search::Search<PointT>*> search_methods,
+                 const pcl::Indices& query_indices)
+{
+  const int knn = 16;
+  const double radius = 0.04;
+  for (const auto& search_method : search_methods)
+  {
+    search_method->setInputCloud (point_cloud);
+    for (const unsigned int nr_threads : {1u, 4u})
+    {
+      pcl::Indices k_indices;
+      std::vector<float> k_distances;
+      std::vector<std::size_t> k_offsets;
+      pcl::Indices indices;
+      std::vector<float> distances;
+
+      search_method->batchNearestKSearch (*point_cloud, query_indices, knn, k_indices, k_distances, nr_threads);
+      ASSERT_EQ (query_indices.size () * knn, k_indices.size ()) << search_method->getName ();
+      ASSERT_EQ (query_indices.size () * knn, k_distances.size ()) << search_method->getName ();
+      for (std::size_t qIdx = 0; qIdx < query_indices.size (); ++qIdx)
+      {
+        search_method->nearestKSearch ((*point_cloud)[query_indices [qIdx]], knn, indices, distances);
+        for (std::size_t nIdx = 0; nIdx < static_cast<std::size_t> (knn); ++nIdx)
+        {
+          if (nIdx < indices.size ())
+          {
+            EXPECT_EQ (indices [nIdx], k_indices [qIdx * knn + nIdx]) << search_method->getName ();
+            EXPECT_EQ (distances [nIdx], k_distances [qIdx * knn + nIdx]) << search_method->getName ();
+          }
+          else
+          {
+            EXPECT_EQ (UNAVAILABLE, k_indices [qIdx * knn + nIdx]) << search_method->getName ();
+            EXPECT_EQ (std::numeric_limits<float>::infinity (), k_distances [qIdx * knn + nIdx]) << search_method->getName ();
+          }
+        }
+      }
+
+      search_method->batchRadiusSearch (*point_cloud, query_indices, radius, k_indices, k_distances, k_offsets, 0, nr_threads);
+      ASSERT_EQ (query_indices.size () + 1, k_offsets.size ()) << search_method->getName ();
+      ASSERT_EQ (k_offsets.back (), k_indices.size ()) << search_method->getName ();
+      ASSERT_EQ (k_offsets.back (), k_distances.size ()) << search_method->getName ();
+      for (std::size_t qIdx = 0; qIdx < query_indices.size (); ++qIdx)
+      {
+        search_method->radiusSearch ((*point_cloud)[query_indices [qIdx]], radius, indices, distances);
+        ASSERT_EQ (indices.size (), k_offsets [qIdx + 1] - k_offsets [qIdx]) << search_method->getName ();
+        for (std::size_t nIdx = 0; nIdx < indices.size (); ++nIdx)
+        {
+          EXPECT_EQ (indices [nIdx], k_indices [k_offsets [qIdx] + nIdx]) << search_method->getName ();
+          EXPECT_EQ (distances [nIdx], k_distances [k_offsets [qIdx] + nIdx]) << search_method->getName ();
+        }
+      }
+    }
+  }
+}
+
+TEST (PCL, unorganized_dense_cloud_Batch)
+{
+  testBatchSearch (unorganized_dense_cloud, unorganized_search_methods, unorganized_dense_cloud_query_indices);
+}
+
+TEST (PCL, Organized_Sparse_Batch)
+{
+  testBatchSearch (organized_sparse_cloud, organized_search_methods, organized_sparse_query_indices);
+}
+
 /** \brief create subset of point in cloud to use as query points
   * \param[out] query_indices resulting query indices - not guaranteed to have size of query_count but guaranteed not to exceed that value
   * \param cloud input cloud required to check for nans and to get number of points
@@ -44,11 +44,13 @@
 #include <pcl/search/search.h>
 #include <pcl/features/normal_3d.h>
 
+#include <pcl/segmentation/extract_clusters.h>
 #include <pcl/segmentation/extract_polygonal_prism_data.h>
 #include <pcl/segmentation/segment_differences.h>
 #include <pcl/segmentation/region_growing.h>
 #include <pcl/segmentation/region_growing_rgb.h>
 #include <pcl/segmentation/min_cut_segmentation.h>
+#include <pcl/segmentation/supervoxel_clustering.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -79,6 +81,27 @@ TEST (RegionGrowingRGBTest, Segment)
   EXPECT_NE (0, num_of_segments);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingRGBTest, SegmentWithThreads)
+{
+  RegionGrowingRGB<pcl::PointXYZRGB> rg;
+  rg.setInputCloud (colored_cloud);
+  rg.setDistanceThreshold (10);
+  rg.setRegionColorThreshold (5);
+  rg.setPointColorThreshold (6);
+  rg.setMinClusterSize (20);
+  std::vector <pcl::PointIndices> serial_clusters;
+  rg.extract (serial_clusters);
+
+  rg.setNumberOfThreads (4);
+  std::vector <pcl::PointIndices> clusters;
+  rg.extract (clusters);
+
+  ASSERT_EQ (serial_clusters.size (), clusters.size ());
+  for (std::size_t i = 0; i < clusters.size (); ++i)
+    EXPECT_EQ (serial_clusters[i].indices, clusters[i].indices);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (RegionGrowingTest, Segment)
 {
@@ -92,6 +115,62 @@ TEST (RegionGrowingTest, Segment)
   EXPECT_NE (0, num_of_segments);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingTest, SegmentWithThreads)
+{
+  pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> rg;
+  rg.setInputCloud (cloud_);
+  rg.setInputNormals (normals_);
+  std::vector <pcl::PointIndices> serial_clusters;
+  rg.extract (serial_clusters);
+
+  pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> rg_threads;
+  rg_threads.setInputCloud (cloud_);
+  rg_threads.setInputNormals (normals_);
+  rg_threads.setNumberOfThreads (4);
+  std::vector <pcl::PointIndices> clusters;
+  rg_threads.extract (clusters);
+
+  ASSERT_EQ (serial_clusters.size (), clusters.size ());
+  for (std::size_t i = 0; i < clusters.size (); ++i)
+    EXPECT_EQ (serial_clusters[i].indices, clusters[i].indices);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (RegionGrowingTest, SegmentTwice)
+{
+  // The second segmentation reuses the neighbours found by the first one
+  pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> rg;
+  rg.setInputCloud (cloud_);
+  rg.setInputNormals (normals_);
+  std::vector <pcl::PointIndices> clusters;
+  rg.extract (clusters);
+  rg.setSmoothnessThreshold (10.0f / 180.0f * static_cast<float> (M_PI));
+  rg.setCurvatureThreshold (0.02f);
+  rg.extract (clusters);
+
+  pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> rg_fresh;
+  rg_fresh.setInputCloud (cloud_);
+  rg_fresh.setInputNormals (normals_);
+  rg_fresh.setSmoothnessThreshold (10.0f / 180.0f * static_cast<float> (M_PI));
+  rg_fresh.setCurvatureThreshold (0.02f);
+  std::vector <pcl::PointIndices> fresh_clusters;
+  rg_fresh.extract (fresh_clusters);
+
+  ASSERT_EQ (fresh_clusters.size (), clusters.size ());
+  for (std::size_t i = 0; i < clusters.size (); ++i)
+    EXPECT_EQ (fresh_clusters[i].indices, clusters[i].indices);
+
+  // A different number of neighbours requires a new search
+  rg.setNumberOfNeighbours (10);
+  rg_fresh.setNumberOfNeighbours (10);
+  rg.extract (clusters);
+  rg_fresh.extract (fresh_clusters);
+  ASSERT_EQ (fresh_clusters.size (), clusters.size ());
+  for (std::size_t i = 0; i < clusters.size (); ++i)
+    EXPECT_EQ (fresh_clusters[i].indices, clusters[i].indices);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (RegionGrowingTest, SegmentWithoutCloud)
 {
@@ -334,6 +413,73 @@ TEST (MinCutSegmentationTest, SegmentWithWrongParameters)
   EXPECT_EQ (2, num_of_segments);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (EuclideanClusterExtraction, Threads)
+{
+  // Keep every other point, so that the cloud falls apart in several clusters
+  pcl::IndicesPtr indices (new pcl::Indices);
+  for (index_t i = 0; i < static_cast<index_t> (cloud_->size ()); i += 2)
+    indices->push_back (i);
+
+  EuclideanClusterExtraction<PointXYZ> ec;
+  ec.setInputCloud (cloud_);
+  ec.setIndices (indices);
+  ec.setClusterTolerance (0.004);
+  ec.setMinClusterSize (2);
+  ec.setMaxClusterSize (500);
+
+  std::vector<PointIndices> serial_clusters;
+  ec.extract (serial_clusters);
+  ASSERT_GT (serial_clusters.size (), 1);
+
+  for (const unsigned int threads : {2, 4})
+  {
+    ec.setNumberOfThreads (threads);
+    EXPECT_EQ (threads, ec.getNumberOfThreads ());
+    std::vector<PointIndices> clusters;
+    ec.extract (clusters);
+    ASSERT_EQ (serial_clusters.size (), clusters.size ());
+    for (std::size_t i = 0; i < clusters.size (); ++i)
+      EXPECT_EQ (serial_clusters[i].indices, clusters[i].indices);
+  }
+
+  // The free functions return the clusters in the same order
+  search::KdTree<PointXYZ>::Ptr tree (new search::KdTree<PointXYZ> (false));
+  tree->setInputCloud (cloud_, indices);
+  std::vector<PointIndices> serial_unsorted, parallel_unsorted;
+  extractEuclideanClusters (*cloud_, *indices, tree, 0.004f, serial_unsorted, 1, 500);
+  extractEuclideanClusters (*cloud_, *indices, tree, 0.004f, parallel_unsorted, 1, 500, 4);
+  ASSERT_EQ (serial_unsorted.size (), parallel_unsorted.size ());
+  for (std::size_t i = 0; i < serial_unsorted.size (); ++i)
+    EXPECT_EQ (serial_unsorted[i].indices, parallel_unsorted[i].indices);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (SupervoxelClustering, Threads)
+{
+  std::map<std::uint32_t, Supervoxel<PointXYZRGB>::Ptr> supervoxels;
+  SupervoxelClustering<PointXYZRGB> serial (0.1f, 1.0f);
+  serial.setInputCloud (colored_cloud);
+  serial.extract (supervoxels);
+  EXPECT_LT (1, supervoxels.size ());
+
+  // The synchronous expansion does not depend on the number of threads
+  std::vector<PointCloud<PointXYZL>::Ptr> labeled_clouds;
+  for (const unsigned int threads : {2, 4})
+  {
+    SupervoxelClustering<PointXYZRGB> parallel (0.1f, 1.0f);
+    parallel.setInputCloud (colored_cloud);
+    parallel.setNumberOfThreads (threads);
+    parallel.extract (supervoxels);
+    EXPECT_LT (1, supervoxels.size ());
+    parallel.refineSupervoxels (2, supervoxels);
+    labeled_clouds.push_back (parallel.getLabeledCloud ());
+  }
+  ASSERT_EQ (labeled_clouds[0]->size (), labeled_clouds[1]->size ());
+  for (std::size_t i = 0; i < labeled_clouds[0]->size (); ++i)
+    EXPECT_EQ ((*labeled_clouds[0])[i].label, (*labeled_clouds[1])[i].label);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (SegmentDifferences, Segmentation)
 {
@@ -100,6 +100,101 @@ TEST (PCL, MarchingCubesTest)
 }
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MarchingCubesParallelWelded)
+{
+  MarchingCubesHoppe<PointNormal> hoppe;
+  hoppe.setIsoLevel (0);
+  hoppe.setGridResolution (30, 30, 30);
+  hoppe.setPercentageExtendGrid (0.3f);
+  hoppe.setInputCloud (cloud_with_normals);
+  PointCloud<PointNormal> soup;
+  std::vector<Vertices> soup_polygons;
+  hoppe.reconstruct (soup, soup_polygons);
+  ASSERT_FALSE (soup.empty ());
+
+  // The triangle soup does not depend on the number of threads
+  hoppe.setNumberOfThreads (4);
+  PointCloud<PointNormal> points;
+  std::vector<Vertices> polygons;
+  hoppe.reconstruct (points, polygons);
+  ASSERT_EQ (points.size (), soup.size ());
+  ASSERT_EQ (polygons.size (), soup_polygons.size ());
+  for (std::size_t i = 0; i < points.size (); ++i)
+    EXPECT_EQ (points[i].getVector3fMap (), soup[i].getVector3fMap ());
+
+  // The welded mesh has the same triangles, with shared vertices
+  hoppe.setMergeVertices (true);
+  for (const unsigned int nr_threads : {1u, 4u})
+  {
+    hoppe.setNumberOfThreads (nr_threads);
+    hoppe.reconstruct (points, polygons);
+    ASSERT_EQ (polygons.size (), soup_polygons.size ());
+    EXPECT_LT (points.size (), soup.size () / 3);
+
+    std::vector<int> nr_uses (points.size (), 0);
+    for (std::size_t i = 0; i < polygons.size (); ++i)
+    {
+      ASSERT_EQ (polygons[i].vertices.size (), 3);
+      for (int j = 0; j < 3; ++j)
+      {
+        const auto v = polygons[i].vertices[j];
+        ASSERT_LT (v, points.size ());
+        ++nr_uses[v];
+        EXPECT_LT ((points[v].getVector3fMap () - soup[3 * i + j].getVector3fMap ()).norm (), 1e-5);
+      }
+    }
+    // Every vertex is used, and the vertices are shared between triangles
+    EXPECT_EQ (std::count (nr_uses.begin (), nr_uses.end (), 0), 0);
+    EXPECT_GT (*std::max_element (nr_uses.begin (), nr_uses.end ()), 1);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MarchingCubesSparseGrid)
+{
+  // Expose the size of the grid
+  struct MarchingCubesGrid : public MarchingCubesHoppe<PointNormal>
+  {
+    using MarchingCubesHoppe<PointNormal>::grid_;
+  };
+
+  MarchingCubesGrid hoppe;
+  hoppe.setIsoLevel (0);
+  hoppe.setGridResolution (60, 60, 60);
+  hoppe.setPercentageExtendGrid (0.3f);
+  hoppe.setDistanceIgnore (1e-4f);
+  hoppe.setInputCloud (cloud_with_normals);
+  PointCloud<PointNormal> dense_points;
+  std::vector<Vertices> dense_polygons;
+  hoppe.reconstruct (dense_points, dense_polygons);
+  const std::size_t dense_size = hoppe.grid_.size ();
+  ASSERT_FALSE (dense_points.empty ());
+
+  // Within the distance to ignore, the sparse grid gives the same surface with less memory
+  hoppe.setSparseGrid (true);
+  for (const unsigned int nr_threads : {1u, 4u})
+  {
+    hoppe.setNumberOfThreads (nr_threads);
+    PointCloud<PointNormal> points;
+    std::vector<Vertices> polygons;
+    hoppe.reconstruct (points, polygons);
+    EXPECT_LT (hoppe.grid_.size (), dense_size);
+    ASSERT_EQ (points.size (), dense_points.size ());
+    ASSERT_EQ (polygons.size (), dense_polygons.size ());
+    for (std::size_t i = 0; i < points.size (); ++i)
+      EXPECT_EQ (points[i].getVector3fMap (), dense_points[i].getVector3fMap ());
+  }
+
+  // Without distance to ignore, the surface is extracted near the points
+  hoppe.setDistanceIgnore (-1.0f);
+  PointCloud<PointNormal> points;
+  std::vector<Vertices> polygons;
+  hoppe.reconstruct (points, polygons);
+  EXPECT_LT (hoppe.grid_.size (), dense_size);
+  EXPECT_FALSE (points.empty ());
+}
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -167,6 +167,54 @@ TEST (PCL, MovingLeastSquaresOMP)
   EXPECT_NEAR (std::abs ((*mls_normals)[0].normal[2]), 0.795969, 1e-3);
   EXPECT_NEAR ((*mls_normals)[0].curvature, 0.012019, 1e-3);
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MovingLeastSquaresUpsamplingThreads)
+{
+  using MLS = MovingLeastSquares<PointXYZ, PointNormal>;
+  const MLS::UpsamplingMethod methods[] = {MLS::NONE, MLS::SAMPLE_LOCAL_PLANE, MLS::RANDOM_UNIFORM_DENSITY,
+                                           MLS::VOXEL_GRID_DILATION, MLS::DISTINCT_CLOUD};
+  for (const auto method : methods)
+  {
+    PointCloud<PointNormal> output[2];
+    PointIndices::Ptr corresponding_indices[2];
+    const unsigned int threads[2] = {1, 4};
+    for (int i = 0; i < 2; ++i)
+    {
+      MLS mls;
+      mls.setInputCloud (cloud);
+      mls.setComputeNormals (true);
+      mls.setPolynomialOrder (2);
+      mls.setSearchMethod (tree);
+      mls.setSearchRadius (0.03);
+      mls.setUpsamplingMethod (method);
+      mls.setUpsamplingRadius (0.025);
+      mls.setUpsamplingStepSize (0.01);
+      mls.setPointDensity (100);
+      mls.setDilationIterations (2);
+      mls.setDilationVoxelSize (0.005f);
+      mls.setDistinctCloud (cloud);
+      mls.setNumberOfThreads (threads[i]);
+      mls.setRandomSeed (42);
+      mls.process (output[i]);
+      corresponding_indices[i] = mls.getCorrespondingIndices ();
+    }
+
+    ASSERT_FALSE (output[0].empty ());
+    ASSERT_EQ (output[0].size (), output[1].size ());
+    EXPECT_EQ (corresponding_indices[0]->indices, corresponding_indices[1]->indices);
+
+    for (std::size_t i = 0; i < output[0].size (); ++i)
+    {
+      EXPECT_EQ (output[0][i].x, output[1][i].x);
+      EXPECT_EQ (output[0][i].y, output[1][i].y);
+      EXPECT_EQ (output[0][i].z, output[1][i].z);
+      EXPECT_EQ (output[0][i].normal_x, output[1][i].normal_x);
+      EXPECT_EQ (output[0][i].normal_y, output[1][i].normal_y);
+      EXPECT_EQ (output[0][i].normal_z, output[1][i].normal_z);
+    }
+  }
+}
 #endif
 
 /* ---[ */